@@ -107,6 +107,7 @@ MCObjectPropertyTable MCAudioClip::kPropertyTable =
 	&MCObject::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -276,6 +276,7 @@ MCObjectPropertyTable MCButton::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,376 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "prefix.h"
+
+#include "globdefs.h"
+#include "parsedef.h"
+#include "filedefs.h"
+
+#include "handler.h"
+#include "variable.h"
+#include "osspec.h"
+
+#include "bytecode.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MCbytecodeenabled = true;
+
+////////////////////////////////////////////////////////////////////////////////
+
+MCBytecode::MCBytecode(void)
+    : m_op_count(0),
+      m_depth(0)
+{
+}
+
+bool MCBytecode::Append(const MCBytecodeOp& p_op, int p_stack_change, bool p_is_boolean)
+{
+	if (m_op_count == kMaxOps)
+		return false;
+
+	if (p_stack_change > 0)
+	{
+		if (m_depth == kMaxDepth)
+			return false;
+		m_is_boolean[m_depth++] = p_is_boolean;
+	}
+	else if (p_stack_change < 0)
+	{
+		// Binary ops replace their two operands with their result.
+		m_depth -= 1;
+		m_is_boolean[m_depth - 1] = p_is_boolean;
+	}
+
+	m_ops[m_op_count++] = p_op;
+	return true;
+}
+
+bool MCBytecode::PushNumber(real64_t p_number)
+{
+	MCBytecodeOp t_op;
+	t_op . opcode = kMCBytecodeOpPushNumber;
+	t_op . index = 0;
+	t_op . number = p_number;
+	return Append(t_op, 1, false);
+}
+
+bool MCBytecode::PushVariable(MCHandler *p_handler, uint2 p_index, bool p_is_param)
+{
+	MCBytecodeOp t_op;
+	t_op . opcode = p_is_param ? kMCBytecodeOpPushParam : kMCBytecodeOpPushLocal;
+	t_op . index = p_index;
+	t_op . handler = p_handler;
+	return Append(t_op, 1, false);
+}
+
+bool MCBytecode::Binary(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right, bool p_is_boolean)
+{
+	if (p_right == nil)
+		return false;
+
+	if (p_left == nil)
+	{
+		if (!PushNumber(0.0))
+			return false;
+	}
+	else if (!p_left -> lower(*this))
+		return false;
+
+	if (!p_right -> lower(*this))
+		return false;
+
+	// Comparisons only produce a boolean for the whole expression; a boolean
+	// operand would need converting back to a string first.
+	if (m_is_boolean[m_depth - 2] || m_is_boolean[m_depth - 1])
+		return false;
+
+	MCBytecodeOp t_op;
+	t_op . opcode = p_opcode;
+	t_op . index = 0;
+	t_op . number = 0.0;
+	return Append(t_op, -1, p_is_boolean);
+}
+
+bool MCBytecode::Arithmetic(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right)
+{
+	return Binary(p_opcode, p_left, p_right, false);
+}
+
+bool MCBytecode::Comparison(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right)
+{
+	return Binary(p_opcode, p_left, p_right, true);
+}
+
+bool MCBytecode::Finish(MCBytecodeOp*& r_ops, uindex_t& r_count)
+{
+	if (m_depth != 1)
+		return false;
+
+	MCBytecodeOp t_op;
+	t_op . opcode = m_is_boolean[0] ? kMCBytecodeOpReturnBoolean : kMCBytecodeOpReturnNumber;
+	t_op . index = 0;
+	t_op . number = 0.0;
+	if (!Append(t_op, 0, m_is_boolean[0]))
+		return false;
+
+	MCBytecodeOp *t_ops;
+	t_ops = new (nothrow) MCBytecodeOp[m_op_count];
+	if (t_ops == nil)
+		return false;
+
+	MCMemoryCopy(t_ops, m_ops, sizeof(MCBytecodeOp) * m_op_count);
+	r_ops = t_ops;
+	r_count = m_op_count;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Fetch the value of a variable as a number, if it already holds one. Anything
+// else needs the conversions the tree does.
+static inline bool MCBytecodeFetchNumber(MCVariable *p_var, real64_t& r_number)
+{
+	MCExecValue t_value = p_var -> getexecvalue();
+	switch(t_value . type)
+	{
+		case kMCExecValueTypeDouble:
+			r_number = t_value . double_value;
+			return true;
+		case kMCExecValueTypeInt:
+			r_number = t_value . int_value;
+			return true;
+		case kMCExecValueTypeUInt:
+			r_number = t_value . uint_value;
+			return true;
+		case kMCExecValueTypeNumberRef:
+			r_number = MCNumberFetchAsReal(t_value . numberref_value);
+			return true;
+		case kMCExecValueTypeValueRef:
+			if (MCValueGetTypeCode(t_value . valueref_value) != kMCValueTypeCodeNumber)
+				return false;
+			r_number = MCNumberFetchAsReal((MCNumberRef)t_value . valueref_value);
+			return true;
+		default:
+			return false;
+	}
+}
+
+// The arithmetic operators throw if a finite pair of operands gives a
+// non-finite result, so leave that case to the tree.
+static inline bool MCBytecodeCheckResult(real64_t p_left, real64_t p_right, real64_t p_result)
+{
+	return MCS_isfinite(p_result) || !MCS_isfinite(p_left) || !MCS_isfinite(p_right);
+}
+
+// The numeric ordering used by the comparison operators, which treats numbers
+// within a relative epsilon of each other as equal.
+static inline compare_t MCBytecodeCompare(real64_t p_left, real64_t p_right)
+{
+	if (p_left == p_right)
+		return 0;
+
+	real64_t t_min;
+	t_min = MCMin(fabs(p_left), fabs(p_right));
+
+	if (t_min < MC_EPSILON)
+	{
+		if (fabs(p_left - p_right) < MC_EPSILON)
+			return 0;
+	}
+	else if (fabs(p_left - p_right) / t_min < MC_EPSILON)
+		return 0;
+
+	return p_left < p_right ? -1 : 1;
+}
+
+// Run the ops, returning false if the tree must be evaluated instead. With GCC
+// and clang each op jumps directly to the next op's code; elsewhere the ops
+// are dispatched by a switch in a loop.
+static bool MCBytecodeRun(const MCBytecodeOp *p_ops, MCExecValue& r_value)
+{
+	real64_t t_stack[MCBytecode::kMaxDepth];
+	real64_t *t_top = t_stack;
+	const MCBytecodeOp *t_op = p_ops;
+
+#if defined(__GNUC__)
+	static const void *s_ops[] =
+	{
+		&&op_PushNumber,
+		&&op_PushLocal,
+		&&op_PushParam,
+		&&op_Add,
+		&&op_Subtract,
+		&&op_Multiply,
+		&&op_Over,
+		&&op_LessThan,
+		&&op_LessThanOrEqualTo,
+		&&op_GreaterThan,
+		&&op_GreaterThanOrEqualTo,
+		&&op_ReturnNumber,
+		&&op_ReturnBoolean,
+	};
+#	define BYTECODE_DISPATCH() goto *s_ops[t_op -> opcode]
+#	define BYTECODE_OP(name) op_##name:
+#	define BYTECODE_NEXT() t_op++; BYTECODE_DISPATCH()
+
+	BYTECODE_DISPATCH();
+	{
+#else
+#	define BYTECODE_OP(name) case kMCBytecodeOp##name:
+#	define BYTECODE_NEXT() t_op++; continue
+
+	for(;;)
+	switch(t_op -> opcode)
+	{
+#endif
+		BYTECODE_OP(PushNumber)
+		{
+			*t_top++ = t_op -> number;
+			BYTECODE_NEXT();
+		}
+
+		BYTECODE_OP(PushLocal)
+		{
+			if (!MCBytecodeFetchNumber(t_op -> handler -> getvar(t_op -> index, False), *t_top))
+				return false;
+			t_top++;
+			BYTECODE_NEXT();
+		}
+
+		BYTECODE_OP(PushParam)
+		{
+			// A parameter passed by reference to an array element has a path
+			// which has to be resolved by the tree.
+			MCContainer *t_container;
+			t_container = t_op -> handler -> getcontainer(t_op -> index, True);
+			if (t_container -> getpath() . length() != 0 ||
+			    !MCBytecodeFetchNumber(t_container -> getvar(), *t_top))
+				return false;
+			t_top++;
+			BYTECODE_NEXT();
+		}
+
+#define BYTECODE_ARITHMETIC(name, op) \
+		BYTECODE_OP(name) \
+		{ \
+			real64_t t_left = t_top[-2], t_right = t_top[-1]; \
+			real64_t t_result = t_left op t_right; \
+			if (!MCBytecodeCheckResult(t_left, t_right, t_result)) \
+				return false; \
+			*(--t_top - 1) = t_result; \
+			BYTECODE_NEXT(); \
+		}
+
+		BYTECODE_ARITHMETIC(Add, +)
+		BYTECODE_ARITHMETIC(Subtract, -)
+		BYTECODE_ARITHMETIC(Multiply, *)
+		BYTECODE_ARITHMETIC(Over, /)
+
+#define BYTECODE_COMPARISON(name, op) \
+		BYTECODE_OP(name) \
+		{ \
+			compare_t t_order = MCBytecodeCompare(t_top[-2], t_top[-1]); \
+			*(--t_top - 1) = (t_order op 0) ? 1.0 : 0.0; \
+			BYTECODE_NEXT(); \
+		}
+
+		BYTECODE_COMPARISON(LessThan, <)
+		BYTECODE_COMPARISON(LessThanOrEqualTo, <=)
+		BYTECODE_COMPARISON(GreaterThan, >)
+		BYTECODE_COMPARISON(GreaterThanOrEqualTo, >=)
+
+		BYTECODE_OP(ReturnNumber)
+		{
+			MCExecValueTraits<double>::set(r_value, t_top[-1]);
+			return true;
+		}
+
+		BYTECODE_OP(ReturnBoolean)
+		{
+			MCExecValueTraits<bool>::set(r_value, t_top[-1] != 0.0);
+			return true;
+		}
+	}
+
+#undef BYTECODE_COMPARISON
+#undef BYTECODE_ARITHMETIC
+#undef BYTECODE_NEXT
+#undef BYTECODE_OP
+#undef BYTECODE_DISPATCH
+
+	MCUnreachableReturn(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MCBytecodeExpression::MCBytecodeExpression(MCExpression *p_tree, MCBytecodeOp *p_ops)
+    : m_tree(p_tree),
+      m_ops(p_ops)
+{
+	rank = p_tree -> getrank();
+}
+
+MCBytecodeExpression::~MCBytecodeExpression(void)
+{
+	delete m_tree;
+	delete[] m_ops; /* Allocated with new[] */
+}
+
+MCExpression *MCBytecodeExpression::compile(MCExpression *p_tree)
+{
+	MCBytecode t_code;
+	if (!p_tree -> lower(t_code))
+		return p_tree;
+
+	MCBytecodeOp *t_ops;
+	uindex_t t_op_count;
+	if (!t_code . Finish(t_ops, t_op_count))
+		return p_tree;
+
+	// A lone literal or variable, and its return, gain nothing from bytecode.
+	if (t_op_count <= 2)
+	{
+		delete[] t_ops;
+		return p_tree;
+	}
+
+	MCBytecodeExpression *t_expression;
+	t_expression = new (nothrow) MCBytecodeExpression(p_tree, t_ops);
+	if (t_expression == nil)
+	{
+		delete[] t_ops;
+		return p_tree;
+	}
+
+	return t_expression;
+}
+
+void MCBytecodeExpression::eval_ctxt(MCExecContext& ctxt, MCExecValue& r_value)
+{
+	if (MCBytecodeRun(m_ops, r_value))
+		return;
+
+	m_tree -> eval_ctxt(ctxt, r_value);
+}
+
+bool MCBytecodeExpression::lower(MCBytecode& x_code)
+{
+	// Subexpressions such as handler arguments are compiled separately, so
+	// an enclosing expression lowers the tree again rather than our ops.
+	return m_tree -> lower(x_code);
+}
@@ -0,0 +1,125 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+//
+// Bytecode for numeric expressions
+//
+// Expressions made up only of the arithmetic operators, the numeric
+// comparisons, numeric literals and plain handler variables are lowered as
+// they are parsed to a linear sequence of ops which run on a stack of reals,
+// rather than walking the tree with a virtual call and an MCExecValue
+// conversion at every node. The tree is kept, and is evaluated instead
+// whenever the bytecode can't produce exactly the value the tree would - if a
+// variable doesn't hold a number, or an operation overflows - so the tree is
+// still what reports errors.
+//
+
+#ifndef	BYTECODE_H
+#define	BYTECODE_H
+
+#include "express.h"
+
+// When false, expressions are not compiled to bytecode as they are parsed
+// and the tree is always used.
+extern bool MCbytecodeenabled;
+
+enum MCBytecodeOpcode : uint8_t
+{
+	kMCBytecodeOpPushNumber,
+	kMCBytecodeOpPushLocal,
+	kMCBytecodeOpPushParam,
+	kMCBytecodeOpAdd,
+	kMCBytecodeOpSubtract,
+	kMCBytecodeOpMultiply,
+	kMCBytecodeOpOver,
+	kMCBytecodeOpLessThan,
+	kMCBytecodeOpLessThanOrEqualTo,
+	kMCBytecodeOpGreaterThan,
+	kMCBytecodeOpGreaterThanOrEqualTo,
+	kMCBytecodeOpReturnNumber,
+	kMCBytecodeOpReturnBoolean,
+};
+
+struct MCBytecodeOp
+{
+	MCBytecodeOpcode opcode;
+	uint16_t index;
+	union
+	{
+		real64_t number;
+		MCHandler *handler;
+	};
+};
+
+// MCBytecode accumulates the ops for an expression as its tree is lowered by
+// the MCExpression::lower implementations.
+class MCBytecode
+{
+public:
+	enum
+	{
+		kMaxOps = 64,
+		kMaxDepth = 16,
+	};
+
+	MCBytecode(void);
+
+	bool PushNumber(real64_t p_number);
+	bool PushVariable(MCHandler *p_handler, uint2 p_index, bool p_is_param);
+
+	// Lower both operands and then the operator. A nil left operand is taken
+	// to be 0, as it is for the unary form of + and -.
+	bool Arithmetic(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right);
+	bool Comparison(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right);
+
+	// Append the final op and copy the ops into a new array.
+	bool Finish(MCBytecodeOp*& r_ops, uindex_t& r_count);
+
+private:
+	bool Append(const MCBytecodeOp& p_op, int p_stack_change, bool p_is_boolean);
+	bool Binary(MCBytecodeOpcode p_opcode, MCExpression *p_left, MCExpression *p_right, bool p_is_boolean);
+
+	MCBytecodeOp m_ops[kMaxOps];
+	uindex_t m_op_count;
+
+	// Whether each value on the stack at this point is a boolean (the
+	// result of a comparison), rather than a number.
+	bool m_is_boolean[kMaxDepth];
+	uindex_t m_depth;
+};
+
+// An MCBytecodeExpression runs the bytecode for the tree it wraps, falling back
+// to the tree when the bytecode can't be used.
+class MCBytecodeExpression : public MCExpression
+{
+public:
+	~MCBytecodeExpression(void);
+
+	virtual void eval_ctxt(MCExecContext& ctxt, MCExecValue& r_value);
+	virtual bool lower(MCBytecode& x_code);
+
+	// Return a bytecode expression wrapping p_tree, or p_tree itself if it
+	// has no bytecode form or is too simple to benefit from one.
+	static MCExpression *compile(MCExpression *p_tree);
+
+private:
+	MCBytecodeExpression(MCExpression *p_tree, MCBytecodeOp *p_ops);
+
+	MCExpression *m_tree;
+	MCBytecodeOp *m_ops;
+};
+
+#endif
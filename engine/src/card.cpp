@@ -152,6 +152,7 @@ MCObjectPropertyTable MCCard::kPropertyTable =
 	&MCObject::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
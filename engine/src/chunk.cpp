@@ -2371,20 +2371,6 @@ bool MCChunk::getobjforprop(MCExecContext& ctxt, MCObject*& r_object, uint4& r_p
 	return false;
 }
 
-static MCPropertyInfo *lookup_object_property(const MCObjectPropertyTable *p_table, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type)
-{
-	for(uindex_t i = 0; i < p_table -> size; i++)
-		if (p_table -> table[i] . property == p_which && (!p_table -> table[i] . has_effective || p_table -> table[i] . effective == p_effective) &&
-            (p_array_prop == p_table -> table[i] . is_array_prop) &&
-            (p_chunk_type == p_table -> table[i] . chunk_type))
-			return &p_table -> table[i];
-	
-	if (p_table -> parent != nil)
-		return lookup_object_property(p_table -> parent, p_which, p_effective, p_array_prop, p_chunk_type);
-	
-	return nil;
-}
-
 // SN-2015-02-13: [[ Bug 14467 ]] [[ Bug 14053 ]] Refactored object properties
 //  lookup, to ensure it is done the same way in MCChunk::getprop / setprop
 bool MCChunk::getsetprop(MCExecContext &ctxt, Properties which, MCNameRef index, Boolean effective, bool p_is_get_operation, MCExecValue &r_value)
@@ -2425,12 +2411,12 @@ bool MCChunk::getsetprop(MCExecContext &ctxt, Properties which, MCNameRef index,
         bool t_is_array_prop;
         t_is_array_prop = (index != nil && !MCNameIsEmpty(index));
         
-        t_info = lookup_object_property(t_obj_chunk . object -> getpropertytable(), which, effective == True, t_is_array_prop, islinechunk() ? kMCPropertyInfoChunkTypeLine : kMCPropertyInfoChunkTypeChar);
+        t_info = MCObjectPropertyTableLookup(t_obj_chunk . object -> getpropertytable(), which, effective == True, t_is_array_prop, islinechunk() ? kMCPropertyInfoChunkTypeLine : kMCPropertyInfoChunkTypeChar);
         
         // If we could not get the line property for this chunk, then we try to get the char prop.
         // If we could not get the char property for this chunk, then we try to get the line prop.
         if (t_info == nil)
-            t_info = lookup_object_property(t_obj_chunk . object -> getpropertytable(), which, effective == True, t_is_array_prop, islinechunk() ? kMCPropertyInfoChunkTypeChar : kMCPropertyInfoChunkTypeLine);
+            t_info = MCObjectPropertyTableLookup(t_obj_chunk . object -> getpropertytable(), which, effective == True, t_is_array_prop, islinechunk() ? kMCPropertyInfoChunkTypeChar : kMCPropertyInfoChunkTypeLine);
         
         if (t_info == nil
                 || (p_is_get_operation && t_info -> getter == nil)
@@ -496,9 +496,11 @@ void MCDispatchCmd::exec_ctxt(MCExecContext &ctxt)
 	else
 		t_target_ptr = nil;
     
-    /* Attempt to allocate the number of containers needed for the call. */
-    MCAutoPointer<MCContainer[]> t_containers = new MCContainer[container_count];
-    if (!t_containers)
+    /* Attempt to allocate the number of containers needed for the call. These
+     * only live as long as the call, so come from the exec arena. */
+    MCExecArenaFrame t_frame(MCExecContext::GetArena());
+    MCExecArenaArray<MCContainer> t_containers(MCExecContext::GetArena(), container_count);
+    if (!t_containers.IsValid())
     {
         ctxt.LegacyThrow(EE_NO_MEMORY);
         return;
@@ -567,9 +569,11 @@ void MCLogCmd::exec_ctxt(MCExecContext &ctxt)
         return;
     }
     
-    /* Attempt to allocate the number of containers needed for the call. */
-    MCAutoPointer<MCContainer[]> t_containers = new MCContainer[container_count];
-    if (!t_containers)
+    /* Attempt to allocate the number of containers needed for the call. These
+     * only live as long as the call, so come from the exec arena. */
+    MCExecArenaFrame t_frame(MCExecContext::GetArena());
+    MCExecArenaArray<MCContainer> t_containers(MCExecContext::GetArena(), container_count);
+    if (!t_containers.IsValid())
     {
         ctxt.LegacyThrow(EE_NO_MEMORY);
         return;
@@ -81,6 +81,7 @@ MCObjectPropertyTable MCControl::kPropertyTable =
 	&MCObject::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
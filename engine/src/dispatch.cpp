@@ -119,6 +119,7 @@ MCObjectPropertyTable MCDispatch::kPropertyTable =
 	&MCObject::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
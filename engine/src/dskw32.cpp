@@ -1163,6 +1163,11 @@ struct MCMemoryMappedFileHandle: public MCMemoryFileHandle
 		MCMemoryFileHandle::Close();
 	}
 
+	virtual const void *GetMappedContents(void)
+	{
+		return m_buffer;
+	}
+
 private:
 	MCWinSysHandle m_handle;
 };
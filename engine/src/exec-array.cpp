@@ -1281,6 +1281,31 @@ void MCArraysEvalVectorDotProduct(MCExecContext& ctxt, MCArrayRef p_left, MCArra
     r_result = t_sum;
 }
 
+void MCArraysEvalOrderedArray(MCExecContext& ctxt, MCArrayRef p_array, MCArrayRef& r_result)
+{
+    // The result iterates in the order its keys were first stored; copying the
+    // source gives the order the source iterates in.
+    MCAutoArrayRef t_result;
+    if (!MCArrayCreateMutableWithOptions(kMCArrayOptionKeepOrder, &t_result))
+    {
+        ctxt . Throw();
+        return;
+    }
+
+    MCNameRef t_key;
+    MCValueRef t_value;
+    uintptr_t t_index = 0;
+    while (MCArrayIterate(p_array, t_index, t_key, t_value))
+        if (!MCArrayStoreValue(*t_result, true, t_key, t_value))
+        {
+            ctxt . Throw();
+            return;
+        }
+
+    if (!MCArrayCopy(*t_result, r_result))
+        ctxt . Throw();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool MCArraysCopyTransposed(MCArrayRef self, MCArrayRef& r_transposed)
@@ -2652,6 +2652,16 @@ void MCFilesSetHideConsoleWindows(MCExecContext& ctxt, bool p_value)
 	MChidewindows = p_value ? True : False;
 }
 
+void MCFilesGetMapBinaryFiles(MCExecContext& ctxt, bool& r_value)
+{
+	r_value = MCmapbinaryfiles == True;
+}
+
+void MCFilesSetMapBinaryFiles(MCExecContext& ctxt, bool p_value)
+{
+	MCmapbinaryfiles = p_value ? True : False;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void MCFilesGetShellCommand(MCExecContext& ctxt, MCStringRef& r_value)
@@ -498,24 +498,12 @@ void MCFiltersEvalBinaryDecode(MCExecContext& ctxt, MCStringRef p_format, MCData
 				char_t *dest;
 				dest = t_buffer.Chars();
 				static char hexdigit[] = "0123456789abcdef";
-				if (cmd == 'h')
-					for (uindex_t i = 0 ; i < count ; i++)
-					{
-						if (i % 2)
-							value >>= 4;
-						else
-							value = *src++;
-						*dest++ = hexdigit[value & 0xf];
-					}
-				else
-					for (uindex_t i = 0 ; i < count ; i++)
-					{
-						if (i % 2)
-							value <<= 4;
-						else
-							value = *src++;
-						*dest++ = hexdigit[(value >> 4) & 0xf];
-					}
+				MCFiltersHexEncodeBytes(src, count / 2, cmd == 'H', dest);
+				if (count % 2)
+				{
+					value = src[count / 2];
+					dest[count - 1] = hexdigit[cmd == 'H' ? value >> 4 : value & 0xf];
+				}
 				
 				t_success = t_buffer.CreateStringAndRelease((MCStringRef&)r_results[t_index]);
 
@@ -935,34 +923,25 @@ void MCFiltersEvalBinaryEncode(MCExecContext& ctxt, MCStringRef p_format, MCValu
 						uint1 value = 0;
                         if (count > t_length)
                             count = t_length;
-						uindex_t offset;
-						bool t_bigendian = cmd == 'H';
-						for (offset = 0 ; offset < count ; offset++)
+						if (!MCFiltersHexDecodeChars(t_native, count / 2, cmd == 'H', cursor))
+						{
+							ctxt.LegacyThrow(EE_BINARYE_BADFORMAT, t_value);
+							return;
+						}
+						cursor += count / 2;
+						if (count % 2)
 						{
-							value = t_bigendian ? (value << 4) : (value >> 4);
-                            if (!isxdigit(t_native[offset]))
+							if (!isxdigit(t_native[count - 1]))
 							{
-                                ctxt.LegacyThrow(EE_BINARYE_BADFORMAT, t_value);
+								ctxt.LegacyThrow(EE_BINARYE_BADFORMAT, t_value);
 								return;
 							}
-                            c = t_native[offset] - '0';
+							c = t_native[count - 1] - '0';
 							if (c > 9)
 								c += ('0' - 'A') + 10;
 							if (c > 16)
 								c += ('A' - 'a');
-							value |= t_bigendian ? (c & 0xf) : ((c << 4) & 0xf0);
-							if (offset % 2)
-							{
-								*cursor++ = value;
-								value = 0;
-							}
-						}
-						if (offset % 2)
-						{
-							if (cmd == 'H')
-								value <<= 4;
-							else
-								value >>= 4;
+							value = cmd == 'H' ? (c << 4) & 0xf0 : c & 0xf;
 							*cursor++ = (unsigned char) value;
 						}
 						while (cursor < buffer_end)
@@ -1587,6 +1587,9 @@ void MCObject::SetScript(MCExecContext& ctxt, MCStringRef new_script)
 	bool t_success;
 	t_success = true;
 
+	// Whatever happens below the object's handlers may change.
+	flushunhandledmessages();
+
 	uint4 length;
 	length = MCStringGetLength(new_script);
 
@@ -26,6 +26,7 @@
 #include "handler.h"
 #include "scriptpt.h"
 #include "statemnt.h"
+#include "keywords.h"
 #include "object.h"
 #include "chunk.h"
 #include "param.h"
@@ -311,7 +312,7 @@ void MCKeywordsExecCommandOrFunction(MCExecContext& ctxt, MCHandler *handler, MC
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void MCKeywordsExecSwitch(MCExecContext& ctxt, MCExpression *condition, MCExpression **cases, uindex_t case_count, int2 default_case, uint2 *case_offsets, MCStatement *statements, uint2 line, uint2 pos)
+void MCKeywordsExecSwitch(MCExecContext& ctxt, MCExpression *condition, MCExpression **cases, uindex_t case_count, const MCSwitchCaseTable *case_table, int2 default_case, uint2 *case_offsets, MCStatement *statements, uint2 line, uint2 pos)
 {
     MCAutoValueRef t_value;
     MCAutoStringRef t_cond;
@@ -330,27 +331,38 @@ void MCKeywordsExecSwitch(MCExecContext& ctxt, MCExpression *condition, MCExpres
         t_cond = MCValueRetain(kMCTrueString);
     
 	int2 match = default_case;
-	uint2 i;
-	for (i = 0 ; i < case_count ; i++)
-	{
-        MCAutoValueRef t_case;
-        MCAutoStringRef t_case_string;
-        
-        if (!ctxt . TryToEvaluateExpression(cases[i], line, pos, EE_SWITCH_BADCASE, &t_case))
-            return;
-        
-        if (!ctxt . ConvertToString(*t_case, &t_case_string))
-        {
-            ctxt . LegacyThrow(EE_SWITCH_BADCASE);
-            return;
-        }
-        
-		if (MCStringIsEqualTo(*t_cond, *t_case_string, ctxt . GetStringComparisonType()))
+    if (case_table != NULL)
+    {
+        // The labels are all constant strings, so evaluating them can't fail
+        // or have side effects and a single lookup finds the matching case.
+        uindex_t t_case;
+        if (case_table -> Lookup(*t_cond, t_case))
+            match = case_offsets[t_case];
+    }
+    else
+    {
+        uint2 i;
+        for (i = 0 ; i < case_count ; i++)
         {
-            match = case_offsets[i];
-            break;
+            MCAutoValueRef t_case;
+            MCAutoStringRef t_case_string;
+            
+            if (!ctxt . TryToEvaluateExpression(cases[i], line, pos, EE_SWITCH_BADCASE, &t_case))
+                return;
+            
+            if (!ctxt . ConvertToString(*t_case, &t_case_string))
+            {
+                ctxt . LegacyThrow(EE_SWITCH_BADCASE);
+                return;
+            }
+            
+            if (MCStringIsEqualTo(*t_cond, *t_case_string, ctxt . GetStringComparisonType()))
+            {
+                match = case_offsets[i];
+                break;
+            }
         }
-	}
+    }
     
 	if (match >= 0)
 	{
@@ -51,6 +51,108 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Chunks are carved up in order, and form a list back to the first one so that
+// releasing to a mark only has to walk the chunks allocated since.
+struct MCExecArena::Chunk
+{
+    Chunk *previous;
+    size_t size;
+};
+
+enum
+{
+    kMCExecArenaAlignment = 16,
+    kMCExecArenaChunkSize = 4096,
+};
+
+static inline size_t MCExecArenaAlign(size_t p_size)
+{
+    return (p_size + kMCExecArenaAlignment - 1) & ~size_t(kMCExecArenaAlignment - 1);
+}
+
+MCExecArena::MCExecArena(void)
+    : m_chunk(nullptr), m_spare(nullptr), m_used(0)
+{
+}
+
+MCExecArena::~MCExecArena(void)
+{
+    ReleaseToMark(Mark { nullptr, 0 });
+    MCMemoryDeallocate(m_spare);
+}
+
+void *MCExecArena::Allocate(size_t p_size)
+{
+    size_t t_size;
+    t_size = MCExecArenaAlign(p_size);
+    
+    // The chunk header is padded so that allocations stay aligned.
+    size_t t_header_size;
+    t_header_size = MCExecArenaAlign(sizeof(Chunk));
+    
+    if (m_chunk == nullptr || m_chunk -> size - m_used < t_size)
+    {
+        // Large requests get a chunk to themselves, everything else comes from
+        // a standard size chunk - reusing the spare if there is one so that a
+        // loop which repeatedly crosses a chunk boundary doesn't thrash.
+        size_t t_chunk_size;
+        t_chunk_size = MCMax(size_t(kMCExecArenaChunkSize), t_header_size + t_size);
+        
+        Chunk *t_chunk;
+        if (m_spare != nullptr && m_spare -> size >= t_chunk_size)
+        {
+            t_chunk = m_spare;
+            m_spare = nullptr;
+        }
+        else if (!MCMemoryAllocate(t_chunk_size, t_chunk))
+            return nullptr;
+        else
+            t_chunk -> size = t_chunk_size;
+        
+        t_chunk -> previous = m_chunk;
+        m_chunk = t_chunk;
+        m_used = t_header_size;
+    }
+    
+    void *t_ptr;
+    t_ptr = reinterpret_cast<char *>(m_chunk) + m_used;
+    m_used += t_size;
+    
+    return t_ptr;
+}
+
+MCExecArena::Mark MCExecArena::GetMark(void) const
+{
+    return Mark { m_chunk, m_used };
+}
+
+void MCExecArena::ReleaseToMark(const Mark& p_mark)
+{
+    while(m_chunk != p_mark . chunk)
+    {
+        Chunk *t_chunk;
+        t_chunk = m_chunk;
+        m_chunk = t_chunk -> previous;
+        
+        // Keep the most recently released standard size chunk around, as the
+        // next call is likely to need it again.
+        if (t_chunk -> size == kMCExecArenaChunkSize && m_spare == nullptr)
+            m_spare = t_chunk;
+        else
+            MCMemoryDeallocate(t_chunk);
+    }
+    
+    m_used = p_mark . used;
+}
+
+MCExecArena& MCExecContext::GetArena(void)
+{
+    static MCExecArena s_arena;
+    return s_arena;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool MCExecContext::ForceToString(MCValueRef p_value, MCStringRef& r_string)
 {
     return ConvertToString(p_value, r_string);
@@ -1218,6 +1218,117 @@ template<typename A, void Method(MCExecContext&, MCPurchase *, A)> inline void M
 void MCExecFetchProperty(MCExecContext& ctxt, const MCPropertyInfo *prop, void *mark, MCExecValue& r_value);
 void MCExecStoreProperty(MCExecContext& ctxt, const MCPropertyInfo *prop, void *mark, MCExecValue p_value);
 
+// Find the entry for the property in an object property table or its parents,
+// returning nil if there isn't one. If several entries match, the first in the
+// table is used (and entries in the table come before those in its parents).
+struct MCObjectPropertyTable;
+MCPropertyInfo *MCObjectPropertyTableLookup(const MCObjectPropertyTable *p_table, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type);
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The exec arena is a bump allocator for scratch memory which is needed for
+// the duration of a handler call - such as the parameter and argument
+// container arrays - and which never escapes it. Script execution nests
+// strictly, so each frame takes a mark on entry and releases everything
+// allocated above it in one go on exit. Allocations are never freed
+// individually, and anything which needs to outlive the frame (in particular
+// any valueref) must be allocated on the heap as normal.
+class MCExecArena
+{
+    struct Chunk;
+    
+public:
+    struct Mark
+    {
+        Chunk *chunk;
+        size_t used;
+    };
+    
+    MCExecArena(void);
+    ~MCExecArena(void);
+    
+    // Allocate p_size bytes suitably aligned for any type. Returns nullptr if
+    // the memory could not be allocated.
+    void *Allocate(size_t p_size);
+    
+    Mark GetMark(void) const;
+    void ReleaseToMark(const Mark& p_mark);
+    
+private:
+    Chunk *m_chunk;
+    Chunk *m_spare;
+    size_t m_used;
+};
+
+// An MCExecArenaFrame scopes allocations from the exec arena to a C++ block.
+class MCExecArenaFrame
+{
+public:
+    explicit MCExecArenaFrame(MCExecArena& p_arena)
+        : m_arena(p_arena), m_mark(p_arena . GetMark())
+    {
+    }
+    
+    ~MCExecArenaFrame(void)
+    {
+        m_arena . ReleaseToMark(m_mark);
+    }
+    
+private:
+    MCExecArenaFrame(const MCExecArenaFrame&) = delete;
+    MCExecArenaFrame& operator = (const MCExecArenaFrame&) = delete;
+    
+    MCExecArena& m_arena;
+    MCExecArena::Mark m_mark;
+};
+
+// An MCExecArenaArray default-constructs an array of objects in the exec arena
+// and destroys them when it goes out of scope. The memory itself is reclaimed
+// by the enclosing MCExecArenaFrame.
+template<typename T> class MCExecArenaArray
+{
+public:
+    MCExecArenaArray(MCExecArena& p_arena, size_t p_count)
+        : m_elements(nullptr), m_count(0), m_valid(p_count == 0)
+    {
+        if (p_count == 0)
+            return;
+        
+        m_elements = static_cast<T *>(p_arena . Allocate(sizeof(T) * p_count));
+        if (m_elements == nullptr)
+            return;
+        
+        m_valid = true;
+        for(; m_count < p_count; m_count++)
+            new (&m_elements[m_count]) T;
+    }
+    
+    ~MCExecArenaArray(void)
+    {
+        while(m_count > 0)
+            m_elements[--m_count] . ~T();
+    }
+    
+    T *operator * (void) const
+    {
+        return m_elements;
+    }
+    
+    // Returns false if the elements could not be allocated.
+    bool IsValid(void) const
+    {
+        return m_valid;
+    }
+    
+private:
+    MCExecArenaArray(const MCExecArenaArray&) = delete;
+    MCExecArenaArray& operator = (const MCExecArenaArray&) = delete;
+    
+    T *m_elements;
+    size_t m_count;
+    bool m_valid;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class MCExecContext
@@ -1607,6 +1718,10 @@ public:
 	{
         return m_hlist;
 	}
+
+    // Script execution is confined to the engine thread, so all contexts
+    // share the one arena, with each handler frame scoping its use.
+    static MCExecArena& GetArena(void);
 	
 	void SetHandlerList(MCHandlerlist *p_list)
 	{
@@ -1786,7 +1901,8 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void MCKeywordsExecSwitch(MCExecContext& ctxt, MCExpression *condition, MCExpression **cases, uindex_t case_count, int2 default_case, uint2 *case_offsets, MCStatement *statements, uint2 line, uint2 pos);
+class MCSwitchCaseTable;
+void MCKeywordsExecSwitch(MCExecContext& ctxt, MCExpression *condition, MCExpression **cases, uindex_t case_count, const MCSwitchCaseTable *case_table, int2 default_case, uint2 *case_offsets, MCStatement *statements, uint2 line, uint2 pos);
 void MCKeywordsExecIf(MCExecContext& ctxt, MCExpression *condition, MCStatement *thenstatements, MCStatement *elsestatements, uint2 line, uint2 pos);
 void MCKeywordsExecRepeatCount(MCExecContext& ctxt, MCStatement *statements, MCExpression *endcond, uint2 line, uint2 pos);
 void MCKeywordsExecRepeatFor(MCExecContext& ctxt, MCStatement *statements, MCExpression *endcond, MCVarref *loopvar, File_unit each, uint2 line, uint2 pos);
@@ -1846,6 +1962,7 @@ void MCArraysEvalArrayDecode(MCExecContext& ctxt, MCDataRef p_encoding, MCArrayR
 void MCArraysEvalMatrixMultiply(MCExecContext& ctxt, MCArrayRef p_left, MCArrayRef p_right, MCArrayRef& r_result);
 void MCArraysEvalTransposeMatrix(MCExecContext& ctxt, MCArrayRef p_matrix, MCArrayRef& r_result);
 void MCArraysEvalVectorDotProduct(MCExecContext& ctxt, MCArrayRef p_left, MCArrayRef p_right, double& r_result);
+void MCArraysEvalOrderedArray(MCExecContext& ctxt, MCArrayRef p_array, MCArrayRef& r_result);
 
 void MCArraysEvalIsAnArray(MCExecContext& ctxt, MCValueRef p_value, bool& r_result);
 void MCArraysEvalIsNotAnArray(MCExecContext& ctxt, MCValueRef p_value, bool& r_result);
@@ -3258,6 +3375,8 @@ void MCFilesGetSerialControlString(MCExecContext& ctxt, MCStringRef& r_value);
 void MCFilesSetSerialControlString(MCExecContext& ctxt, MCStringRef p_value);
 void MCFilesGetHideConsoleWindows(MCExecContext& ctxt, bool& r_value);
 void MCFilesSetHideConsoleWindows(MCExecContext& ctxt, bool p_value);
+void MCFilesGetMapBinaryFiles(MCExecContext& ctxt, bool& r_value);
+void MCFilesSetMapBinaryFiles(MCExecContext& ctxt, bool p_value);
 
 void MCFilesGetShellCommand(MCExecContext& ctxt, MCStringRef& r_value);
 void MCFilesSetShellCommand(MCExecContext& ctxt, MCStringRef p_value);
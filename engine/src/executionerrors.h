@@ -2778,7 +2778,10 @@ enum Exec_errors
     EE_BAD_PERMISSION_NAME,
     
     // {EE-0910} Property: value is not a data
-    EE_PROPERTY_NOTADATA
+    EE_PROPERTY_NOTADATA,
+    
+    // {EE-0911} orderedArray: error in source
+    EE_ORDEREDARRAY_BADSOURCE,
     
 };
 
@@ -59,6 +59,16 @@ MCVarref *MCExpression::getrootvarref(void)
 	return NULL;
 }
 
+bool MCExpression::lower(MCBytecode& x_code)
+{
+	return false;
+}
+
+bool MCExpression::getconstantstring(MCStringRef& r_string)
+{
+	return false;
+}
+
 bool MCExpression::evalcontainer(MCExecContext& ctxt, MCContainer& r_container)
 {
     return false;
@@ -26,6 +26,8 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "exec.h"
 #endif
 
+class MCBytecode;
+
 class MCExpression
 {
 protected:
@@ -63,6 +65,15 @@ public:
 	// same variable. It is designed to be used at parse-time, not exec-time.
 	virtual MCVarref *getrootvarref(void);
 	
+	// Append the bytecode for the expression to x_code, returning false if it
+	// has no bytecode form (see bytecode.h).
+	virtual bool lower(MCBytecode& x_code);
+	
+	// Fetch the string the expression always evaluates to, returning false
+	// if it may evaluate to different strings. The string is not retained,
+	// and is only valid for the lifetime of the expression.
+	virtual bool getconstantstring(MCStringRef& r_string);
+	
 	//////////
 	
 	template <typename T>
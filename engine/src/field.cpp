@@ -230,6 +230,7 @@ MCObjectPropertyTable MCField::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2052,6 +2052,13 @@ public:
 	virtual void eval_ctxt(MCExecContext &, MCExecValue &);
 };
 
+class MCOrderedArray : public MCUnaryFunctionCtxt<MCArrayRef, MCArrayRef, MCArraysEvalOrderedArray, EE_ORDEREDARRAY_BADSOURCE, PE_ORDEREDARRAY_BADPARAM>
+{
+public:
+    MCOrderedArray(){}
+    virtual ~MCOrderedArray(){}
+};
+
 class MCMaxFunction : public MCParamFunctionCtxt<MCMathEvalMax, EE_MAX_BADSOURCE, PE_MAX_BADPARAM>
 {
 public:
@@ -353,6 +353,7 @@ Boolean MCsystemFS = True;
 Boolean MCsystemCS = True;
 Boolean MCsystemPS = True;
 Boolean MChidewindows;
+Boolean MCmapbinaryfiles;
 Boolean MCbufferimages;
 MCStringRef MCserialcontrolsettings;
 MCStringRef MCshellcmd;
@@ -743,6 +744,7 @@ void X_clear_globals(void)
 	MCsystemCS = True;
 	MCsystemPS = True;
 	MChidewindows = False;
+	MCmapbinaryfiles = False;
 	MCbufferimages = False;
 	MCserialcontrolsettings = MCValueRetain(kMCEmptyString);
 	MCshellcmd = MCValueRetain(kMCEmptyString);
@@ -1413,6 +1415,7 @@ int X_close(void)
 		MCglobals = MCglobals->getnext();
 		delete tvar;
 	}
+	MCVariable::cleanuplocals();
 
 	// JS-2013-06-21: [[ EnhancedFilter ]] refactored regex caching mechanism
     MCR_clearcache();
@@ -105,6 +105,7 @@ MCObjectPropertyTable MCGraphic::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
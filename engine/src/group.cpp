@@ -110,6 +110,7 @@ MCObjectPropertyTable MCGroup::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -48,6 +48,29 @@ Boolean MCHandler::gotpass;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// A by-value parameter's container lives in the exec arena alongside the params
+// array, and its variable comes from the local variable pool.
+static MCContainer *MCHandlerNewParamContainer(MCNameRef p_name)
+{
+    void *t_memory = MCExecContext::GetArena() . Allocate(sizeof(MCContainer));
+    if (t_memory == nullptr)
+        return nullptr;
+    
+    MCVariable *t_var;
+    if (!MCVariable::createlocal(p_name, t_var))
+        return nullptr;
+    
+    return new (t_memory) MCContainer(t_var);
+}
+
+static void MCHandlerDeleteParamContainer(MCContainer *p_container)
+{
+    MCVariable::destroylocal(p_container -> getvar());
+    p_container -> ~MCContainer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MCHandler::MCHandler(uint1 htype, bool p_is_private)
     : hlist(),
       npassedparams(),
@@ -56,6 +79,8 @@ MCHandler::MCHandler(uint1 htype, bool p_is_private)
 {
 	statements = NULL;
 	vars = NULL;
+	m_spare_vars = NULL;
+	m_spare_nvars = 0;
 	params = NULL;
 	pinfo = NULL;
 	vinfo = NULL;
@@ -107,6 +132,8 @@ MCHandler::~MCHandler()
 	// MW-2013-11-08: [[ RefactorIt ]] Delete the it varref.
 	delete m_it;
 
+	delete[] m_spare_vars; /* Allocated with new[] */
+
 	MCValueRelease(name);
 }
 
@@ -328,12 +355,23 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 		tptr = tptr->getnext();
 	uint2 newnparams = MCU_max(npassedparams, npnames);
     
+    // The params array is only needed while this invocation is running, so
+    // it comes from the exec arena and goes when the frame is unwound.
+    MCExecArenaFrame t_frame(MCExecContext::GetArena());
+    
     // AL-2014-08-20: [[ ArrayElementRefParams ]] All handler params are now containers
 	MCContainer **newparams;
 	if (newnparams == 0)
 		newparams = NULL;
 	else
-		newparams = new (nothrow) MCContainer *[newnparams];
+	{
+		newparams = static_cast<MCContainer **>(MCExecContext::GetArena() . Allocate(sizeof(MCContainer *) * newnparams));
+		if (newparams == NULL)
+		{
+			MCeerror->add(EE_NO_MEMORY, firstline - 1, 1, name);
+			return ES_ERROR;
+		}
+	}
     
 	Boolean err = False;
 	for (i = 0 ; i < newnparams ; i++)
@@ -357,9 +395,13 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 					break;
 				}
                 
-                MCVariable *t_new_var;
-                /* UNCHECKED */ MCVariable::createwithname(i < npnames ? pinfo[i] . name : kMCEmptyName, t_new_var);
-                /* UNCHECKED */ newparams[i] = new(nothrow) MCContainer(t_new_var);
+                newparams[i] = MCHandlerNewParamContainer(i < npnames ? pinfo[i] . name : kMCEmptyName);
+                if (newparams[i] == NULL)
+                {
+                    MCExecTypeRelease(t_value);
+                    err = True;
+                    break;
+                }
                 
 				newparams[i]->give_value(ctxt, t_value);
 			}
@@ -378,9 +420,12 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 				err = True;
 				break;
 			}
-            MCVariable *t_new_var;
-            /* UNCHECKED */ MCVariable::createwithname(i < npnames ? pinfo[i] . name : kMCEmptyName, t_new_var);
-            /* UNCHECKED */ newparams[i] = new(nothrow) MCContainer(t_new_var);
+            newparams[i] = MCHandlerNewParamContainer(i < npnames ? pinfo[i] . name : kMCEmptyName);
+            if (newparams[i] == NULL)
+            {
+                err = True;
+                break;
+            }
 		}
 	}
 	if (err)
@@ -389,12 +434,8 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
         {
             // AL-2014-09-16: [[ Bug 13454 ]] Delete created variables before deleting containers to prevent memory leak
             if (i >= npnames || !pinfo[i].is_reference)
-            {
-				delete newparams[i] -> getvar();
-                delete newparams[i];
-            }
+                MCHandlerDeleteParamContainer(newparams[i]);
         }
-		delete newparams;
 		MCeerror->add(EE_HANDLER_BADPARAM, firstline - 1, 1, name);
 		return ES_ERROR;
 	}
@@ -410,11 +451,19 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 		vars = NULL;
 	else
 	{
-		vars = new (nothrow) MCVariable *[nvnames];
+		// The locals array from the last call that returned is reused if it is
+		// big enough, so only recursive calls need to allocate one.
+		if (m_spare_vars != NULL && m_spare_nvars >= nvnames)
+		{
+			vars = m_spare_vars;
+			m_spare_vars = NULL;
+		}
+		else
+			vars = new (nothrow) MCVariable *[nvnames];
 		i = nvnames;
 		while (i--)
 		{
-			/* UNCHECKED */ MCVariable::createwithname(vinfo[i] . name, vars[i]);
+			/* UNCHECKED */ MCVariable::createlocal(vinfo[i] . name, vars[i]);
             
 			// A UQL is indicated by 'init' being nil.
 			if (vinfo[i] . init != nil)
@@ -523,15 +572,14 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
         {
             // AL-2014-09-16: [[ Bug 13454 ]] Delete created variables before deleting containers to prevent memory leak
             if (i >= npnames || !pinfo[i].is_reference)
-            {
-				delete params[i] -> getvar();
-                delete params[i];
-            }
+                MCHandlerDeleteParamContainer(params[i]);
         }
-		delete[] params; /* Allocated with new[] */
 	}
 	if (vars != NULL)
 	{
+		// The array holds at least as many vars as there are now, as any
+		// declared while executing were added to it by newvar.
+		uint2 t_nvars = nvnames;
 		while (nvnames--)
 		{
 			if (nvnames >= oldnvnames)
@@ -539,9 +587,15 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 				MCValueRelease(vinfo[nvnames] . name);
 				MCValueRelease(vinfo[nvnames] . init);
 			}
-			delete vars[nvnames];
+			MCVariable::destroylocal(vars[nvnames]);
 		}
-		delete[] vars; /* Allocated with new[] */
+		if (m_spare_vars == NULL)
+		{
+			m_spare_vars = vars;
+			m_spare_nvars = t_nvars;
+		}
+		else
+			delete[] vars; /* Allocated with new[] */
 	}
 	params = oldparams;
 	nparams = oldnparams;
@@ -638,7 +692,7 @@ Parse_stat MCHandler::newvar(MCNameRef p_name, MCValueRef p_init, MCVarref **r_r
 	if (executing)
 	{
 		MCU_realloc((char **)&vars, nvnames, nvnames + 1, sizeof(MCVariable *));
-		/* UNCHECKED */ MCVariable::createwithname(p_name, vars[nvnames]);
+		/* UNCHECKED */ MCVariable::createlocal(p_name, vars[nvnames]);
 
 		if (p_init != nil)
 			vars[nvnames] -> setvalueref(p_init);
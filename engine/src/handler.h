@@ -71,6 +71,11 @@ class MCHandler
 	//   and this varref is used by things that want to set it.
 	MCVarref *m_it;
 	
+	// The locals array of the last call to return, kept for the next call
+	// along with the number of vars it has room for.
+	MCVariable **m_spare_vars;
+	uint2 m_spare_nvars;
+	
 	static Boolean gotpass;
 public:
 	MCHandler(uint1 htype, bool p_is_private = false);
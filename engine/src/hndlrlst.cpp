@@ -462,6 +462,9 @@ Parse_stat MCHandlerlist::parse(MCObject *objptr, MCDataRef script_utf8)
 
 	reset();
 
+	// Any object's message path might pass through this script.
+	MCObject::flushunhandledmessages();
+
 	Bool finished = False;
 	parent = objptr;
 	while (status != PS_ERROR && !finished)
@@ -653,6 +656,7 @@ void MCHandlerlist::addhandler(Handler_type type, MCHandler *handler)
 {
 	handlers[type - 1] . append(handler);
 	handlers[type - 1] . sort();
+	MCObject::flushunhandledmessages();
 }
 
 static const char *s_handler_types[] =
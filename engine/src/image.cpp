@@ -112,6 +112,7 @@ MCObjectPropertyTable MCImage::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -989,8 +989,102 @@ uint4 MCBreak::linecount()
 	return 0;
 }
 
+MCSwitchCaseTable::MCSwitchCaseTable(void)
+    : m_slots(nil),
+      m_mask(0),
+      m_options(kMCStringOptionCompareExact)
+{
+}
+
+MCSwitchCaseTable::~MCSwitchCaseTable(void)
+{
+	MCMemoryDeleteArray(m_slots);
+}
+
+bool MCSwitchCaseTable::Build(MCExpression **p_cases, uindex_t p_case_count, MCStringOptions p_options)
+{
+	// Keep the table at most half full so probe sequences stay short.
+	uindex_t t_capacity;
+	t_capacity = 1;
+	while (t_capacity < p_case_count * 2)
+		t_capacity *= 2;
+
+	Slot *t_slots;
+	if (!MCMemoryNewArray(t_capacity, t_slots))
+		return false;
+
+	for(uindex_t i = 0; i < p_case_count; i++)
+	{
+		MCStringRef t_label;
+		if (!p_cases[i] -> getconstantstring(t_label))
+			MCUnreachableReturn(false);
+
+		hash_t t_hash;
+		t_hash = MCStringHash(t_label, p_options);
+
+		// A label equal to an earlier one can never be matched, so only the
+		// first is added.
+		uindex_t t_slot;
+		t_slot = t_hash & (t_capacity - 1);
+		while (t_slots[t_slot] . label != nil &&
+		       !(t_slots[t_slot] . hash == t_hash &&
+		         MCStringIsEqualTo(t_slots[t_slot] . label, t_label, p_options)))
+			t_slot = (t_slot + 1) & (t_capacity - 1);
+
+		if (t_slots[t_slot] . label != nil)
+			continue;
+
+		t_slots[t_slot] . label = t_label;
+		t_slots[t_slot] . hash = t_hash;
+		t_slots[t_slot] . index = i;
+	}
+
+	MCMemoryDeleteArray(m_slots);
+	m_slots = t_slots;
+	m_mask = t_capacity - 1;
+	m_options = p_options;
+	return true;
+}
+
+bool MCSwitchCaseTable::Lookup(MCStringRef p_value, uindex_t& r_case) const
+{
+	hash_t t_hash;
+	t_hash = MCStringHash(p_value, m_options);
+
+	for(uindex_t t_slot = t_hash & m_mask; m_slots[t_slot] . label != nil; t_slot = (t_slot + 1) & m_mask)
+	{
+		if (m_slots[t_slot] . hash == t_hash &&
+		    MCStringIsEqualTo(m_slots[t_slot] . label, p_value, m_options))
+		{
+			r_case = m_slots[t_slot] . index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// A few cases are quicker to compare in turn than to hash the value.
+#define SWITCH_CASE_TABLE_MIN_CASES 4
+
+static bool MCSwitchHasConstantCases(MCExpression **p_cases, uindex_t p_case_count)
+{
+	if (p_case_count < SWITCH_CASE_TABLE_MIN_CASES)
+		return false;
+
+	for(uindex_t i = 0; i < p_case_count; i++)
+	{
+		MCStringRef t_label;
+		if (!p_cases[i] -> getconstantstring(t_label))
+			return false;
+	}
+
+	return true;
+}
+
 MCSwitch::~MCSwitch()
 {
+	delete casetable;
 	delete cond;
 	while (ncases--)
 		delete cases[ncases];
@@ -1078,6 +1172,7 @@ Parse_stat MCSwitch::parse(MCScriptPoint &sp)
 						(PE_SWITCH_WANTEDENDSWITCH, sp);
 						return PS_ERROR;
 					}
+					constantcases = MCSwitchHasConstantCases(cases, ncases);
 					return PS_NORMAL;
 				default: /* token type */
 					MCperror->add
@@ -1095,6 +1190,7 @@ Parse_stat MCSwitch::parse(MCScriptPoint &sp)
 			}
 			continue;
 		case PS_EOF:
+			constantcases = MCSwitchHasConstantCases(cases, ncases);
 			return PS_NORMAL;
 		default:
 			MCperror->add
@@ -1122,7 +1218,22 @@ Parse_stat MCSwitch::parse(MCScriptPoint &sp)
 
 void MCSwitch::exec_ctxt(MCExecContext& ctxt)
 {
-    MCKeywordsExecSwitch(ctxt, cond, cases, ncases, defaultcase, caseoffsets, statements, getline(), getpos());
+    // The table is rebuilt if the switch is run with different string options,
+    // and if memory runs out the cases are compared in turn instead.
+    if (constantcases &&
+        (casetable == NULL || casetable -> GetOptions() != ctxt . GetStringComparisonType()))
+    {
+        if (casetable == NULL)
+            casetable = new (nothrow) MCSwitchCaseTable;
+        if (casetable != NULL &&
+            !casetable -> Build(cases, ncases, ctxt . GetStringComparisonType()))
+        {
+            delete casetable;
+            casetable = NULL;
+        }
+    }
+    
+    MCKeywordsExecSwitch(ctxt, cond, cases, ncases, constantcases ? casetable : NULL, defaultcase, caseoffsets, statements, getline(), getpos());
 }
 
 uint4 MCSwitch::linecount()
@@ -1345,9 +1456,11 @@ void MCHandref::exec(MCExecContext& ctxt, uint2 line, uint2 pos, bool is_functio
         resolved = true;
     }
     
-    /* Attempt to allocate the number of containers needed for the call. */
-    MCAutoPointer<MCContainer[]> t_containers = new MCContainer[container_count];
-    if (!t_containers)
+    /* Attempt to allocate the number of containers needed for the call. These
+     * only live as long as the call, so come from the exec arena. */
+    MCExecArenaFrame t_frame(MCExecContext::GetArena());
+    MCExecArenaArray<MCContainer> t_containers(MCExecContext::GetArena(), container_count);
+    if (!t_containers.IsValid())
     {
         ctxt.LegacyThrow(EE_NO_MEMORY);
         return;
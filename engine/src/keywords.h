@@ -145,6 +145,41 @@ public:
 	virtual uint4 linecount();
 };
 
+// A hash table of the case labels of a switch whose labels are all constant
+// strings, so the case to run can be found without comparing the value with
+// each label in turn. The hashes depend on the string options, so the table
+// is built for the options the switch is run with.
+class MCSwitchCaseTable
+{
+public:
+	MCSwitchCaseTable(void);
+	~MCSwitchCaseTable(void);
+
+	// Build the table, returning false if memory runs out. Each case must
+	// have a constant string.
+	bool Build(MCExpression **p_cases, uindex_t p_case_count, MCStringOptions p_options);
+
+	MCStringOptions GetOptions(void) const
+	{
+		return m_options;
+	}
+
+	// Find the first case whose label is equal to the value.
+	bool Lookup(MCStringRef p_value, uindex_t& r_case) const;
+
+private:
+	struct Slot
+	{
+		MCStringRef label;
+		hash_t hash;
+		uindex_t index;
+	};
+
+	Slot *m_slots;
+	uindex_t m_mask;
+	MCStringOptions m_options;
+};
+
 class MCSwitch : public MCStatement
 {
 	MCExpression *cond;
@@ -153,6 +188,8 @@ class MCSwitch : public MCStatement
 	uint2 *caseoffsets;
 	int2 defaultcase;
 	uint2 ncases;
+	bool constantcases;
+	MCSwitchCaseTable *casetable;
 public:
 	MCSwitch()
 	{
@@ -162,6 +199,8 @@ public:
 		defaultcase = -1;
 		caseoffsets = NULL;
 		ncases = 0;
+		constantcases = false;
+		casetable = NULL;
 	}
 	~MCSwitch();
 	virtual Parse_stat parse(MCScriptPoint &sp);
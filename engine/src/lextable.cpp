@@ -1200,6 +1200,7 @@ const LT factor_table[] =
         {"magnify", TT_PROPERTY, P_MAGNIFY},
         {"mainstack", TT_PROPERTY, P_MAIN_STACK},
         {"mainstacks", TT_FUNCTION, F_MAIN_STACKS},
+        {"mapbinaryfiles", TT_PROPERTY, P_MAP_BINARY_FILES},
         {"margins", TT_PROPERTY, P_MARGINS},
         {"mark", TT_PROPERTY, P_MARKED},
         {"markchar", TT_PROPERTY, P_MARK_CHAR},
@@ -1321,6 +1322,7 @@ const LT factor_table[] =
         {"openstacks", TT_FUNCTION, F_OPEN_STACKS},
         {"optionkey", TT_FUNCTION, F_OPTION_KEY},
         {"or", TT_BINOP, O_OR},
+        {"orderedarray", TT_FUNCTION, F_ORDERED_ARRAY},
         {"orientation", TT_PROPERTY, P_ORIENTATION},
 		{"outerglow", TT_PROPERTY, P_BITMAP_EFFECT_OUTER_GLOW},
 		{"outputlineendings", TT_PROPERTY, P_OUTPUT_LINE_ENDINGS},
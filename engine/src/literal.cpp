@@ -22,6 +22,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "literal.h"
 #include "scriptpt.h"
+#include "bytecode.h"
 
 Parse_stat MCLiteral::parse(MCScriptPoint &sp, Boolean the)
 {
@@ -34,3 +35,75 @@ void MCLiteral::eval_ctxt(MCExecContext& ctxt, MCExecValue& r_value)
 	r_value . type = kMCExecValueTypeValueRef;
 	r_value . valueref_value = MCValueRetain(value);
 }
+
+// Numeric literals in scripts are parsed as names, which are only converted to
+// numbers when used. Only plain decimals are lowered, as anything else (such
+// as a leading zero, which depends on the convertOctals) is left to the tree.
+static bool MCLiteralIsPlainDecimal(MCStringRef p_string)
+{
+	uindex_t t_length;
+	t_length = MCStringGetLength(p_string);
+	if (t_length == 0 || t_length > 32)
+		return false;
+
+	uindex_t t_digits = 0;
+	bool t_seen_point = false;
+	for(uindex_t i = 0; i < t_length; i++)
+	{
+		unichar_t t_char;
+		t_char = MCStringGetCharAtIndex(p_string, i);
+		if (t_char >= '0' && t_char <= '9')
+		{
+			if (t_digits == 1 && !t_seen_point && MCStringGetCharAtIndex(p_string, 0) == '0')
+				return false;
+			t_digits++;
+		}
+		else if (t_char == '.' && !t_seen_point && t_digits != 0 && i + 1 < t_length)
+			t_seen_point = true;
+		else
+			return false;
+	}
+
+	return true;
+}
+
+bool MCLiteral::lower(MCBytecode& x_code)
+{
+	if (MCValueGetTypeCode(value) == kMCValueTypeCodeNumber)
+		return x_code . PushNumber(MCNumberFetchAsReal((MCNumberRef)value));
+
+	MCStringRef t_string;
+	if (MCValueGetTypeCode(value) == kMCValueTypeCodeName)
+		t_string = MCNameGetString((MCNameRef)value);
+	else if (MCValueGetTypeCode(value) == kMCValueTypeCodeString)
+		t_string = (MCStringRef)value;
+	else
+		return false;
+
+	real64_t t_number;
+	if (!MCLiteralIsPlainDecimal(t_string) ||
+	    !MCTypeConvertStringToReal(t_string, t_number, false))
+		return false;
+
+	return x_code . PushNumber(t_number);
+}
+
+// Numbers are converted to strings using the numberFormat, so only strings,
+// names and booleans always evaluate to the same string.
+bool MCLiteral::getconstantstring(MCStringRef& r_string)
+{
+	switch(MCValueGetTypeCode(value))
+	{
+		case kMCValueTypeCodeString:
+			r_string = (MCStringRef)value;
+			return true;
+		case kMCValueTypeCodeName:
+			r_string = MCNameGetString((MCNameRef)value);
+			return true;
+		case kMCValueTypeCodeBoolean:
+			r_string = value == kMCTrue ? kMCTrueString : kMCFalseString;
+			return true;
+		default:
+			return false;
+	}
+}
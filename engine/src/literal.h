@@ -37,6 +37,8 @@ public:
 
     virtual Parse_stat parse(MCScriptPoint &, Boolean the);
     virtual void eval_ctxt(MCExecContext &ctxt, MCExecValue &r_value);
+    virtual bool lower(MCBytecode& x_code);
+    virtual bool getconstantstring(MCStringRef& r_string);
 };
 
 #endif
@@ -110,6 +110,7 @@ MCObjectPropertyTable MCAndroidBrowserControl::kPropertyTable =
 	&MCAndroidControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,6 +55,7 @@ MCObjectPropertyTable MCAndroidControl::kPropertyTable =
 	&MCNativeControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -279,6 +279,7 @@ MCObjectPropertyTable MCAndroidInputControl::kPropertyTable =
 	&MCAndroidControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
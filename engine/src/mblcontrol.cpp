@@ -48,6 +48,7 @@ MCObjectPropertyTable MCNativeControl::kPropertyTable =
 	nil,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 MCNativeControlActionInfo MCNativeControl::kActions[] =
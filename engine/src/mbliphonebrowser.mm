@@ -134,6 +134,7 @@ MCObjectPropertyTable MCiOSBrowserControl::kPropertyTable =
 	&MCiOSControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +60,7 @@ MCObjectPropertyTable MCiOSControl::kPropertyTable =
 	&MCNativeControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -423,6 +423,7 @@ MCObjectPropertyTable MCiOSInputControl::kPropertyTable =
 	&MCiOSControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -456,6 +457,7 @@ MCObjectPropertyTable MCiOSInputFieldControl::kPropertyTable =
 	&MCiOSInputControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -504,6 +506,7 @@ MCObjectPropertyTable MCiOSMultiLineControl::kPropertyTable =
 	&MCiOSInputControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -262,6 +262,7 @@ MCObjectPropertyTable MCiOSPlayerControl::kPropertyTable =
 	&MCiOSControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
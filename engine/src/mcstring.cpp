@@ -1084,8 +1084,16 @@ const struct { const char *cstring; MCNameRef *name_var; } kInitialNames[] =
 
 void X_initialize_names(void)
 {
+    // Most of the names are pre-hashed at build time, and can be added to the
+    // name table without allocating. The rest (those whose string comes from
+    // a macro) are created as normal.
+    MCNameCreateStatic(kMCStaticNames, kMCStaticNameStorage, kMCStaticNameCount);
+    
     for(size_t i = 0; i < sizeof(kInitialNames) / sizeof(kInitialNames[0]); i++)
     {
+        if (*kInitialNames[i].name_var != nil)
+            continue;
+        
         MCNameCreateWithNativeChars((const char_t*)kInitialNames[i].cstring, strlen(kInitialNames[i].cstring), *kInitialNames[i].name_var);
     }
 }
@@ -1095,5 +1103,6 @@ void MCU_finalize_names(void)
     for(size_t i = 0; i < sizeof(kInitialNames) / sizeof(kInitialNames[0]); i++)
     {
         MCValueRelease(*kInitialNames[i].name_var);
+        *kInitialNames[i].name_var = nil;
     }
 }
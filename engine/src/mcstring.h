@@ -493,6 +493,7 @@ extern MCNameRef MCM_undo_changed;
 extern MCNameRef MCM_undo_key;
 extern MCNameRef MCM_uniconify_stack;
 extern MCNameRef MCM_unload_url;
+extern MCNameRef MCM_update_screen;
 extern MCNameRef MCM_update_var;
 
 #ifdef FEATURE_PLATFORM_URL
@@ -637,3 +638,9 @@ extern MCNameRef MCN_font_tooltip;          // Tooltip text
 extern MCNameRef MCN_font_system;           // Anything else not covered above
 
 extern MCNameRef MCM_system_appearance_changed;
+
+// The names in kInitialNames which are created in static storage, generated
+// from it at build time by util/encode_static_names.pl.
+extern const MCNameStaticInfo kMCStaticNames[];
+extern const uindex_t kMCStaticNameCount;
+extern MCNameStaticStorage kMCStaticNameStorage[];
@@ -127,6 +127,7 @@ MCObjectPropertyTable MCObject::kModePropertyTable =
 	nil,
 	sizeof(kModeProperties) / sizeof(kModeProperties[0]),
 	&kModeProperties[0],
+	nil,
 };
 
 MCPropertyInfo MCStack::kModeProperties[] =
@@ -141,6 +142,7 @@ MCObjectPropertyTable MCStack::kModePropertyTable =
     &MCObject::kModePropertyTable,
 	sizeof(kModeProperties) / sizeof(kModeProperties[0]),
 	&kModeProperties[0],
+	nil,
 };
 
 MCPropertyInfo MCProperty::kModeProperties[] =
@@ -142,6 +142,7 @@ MCObjectPropertyTable MCObject::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCObjectPropertyTable MCStack::kModePropertyTable =
@@ -149,6 +150,7 @@ MCObjectPropertyTable MCStack::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCPropertyTable MCProperty::kModePropertyTable =
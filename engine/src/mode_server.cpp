@@ -87,6 +87,7 @@ MCObjectPropertyTable MCObject::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCPropertyInfo MCStack::kModeProperties[] =
@@ -99,6 +100,7 @@ MCObjectPropertyTable MCStack::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCPropertyInfo MCProperty::kModeProperties[] =
@@ -129,6 +129,7 @@ MCObjectPropertyTable MCObject::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCObjectPropertyTable MCStack::kModePropertyTable =
@@ -136,6 +137,7 @@ MCObjectPropertyTable MCStack::kModePropertyTable =
 	nil,
 	0,
 	nil,
+	nil,
 };
 
 MCPropertyTable MCProperty::kModePropertyTable =
@@ -125,6 +125,7 @@ MCObjectPropertyTable MCObject::kModePropertyTable =
     nil,
     0,
     nil,
+    nil,
 };
 
 MCObjectPropertyTable MCStack::kModePropertyTable =
@@ -132,6 +133,7 @@ MCObjectPropertyTable MCStack::kModePropertyTable =
     nil,
     0,
     nil,
+    nil,
 };
 
 MCPropertyTable MCProperty::kModePropertyTable =
@@ -829,6 +829,8 @@ MCExpression *MCN_new_function(int2 which)
 		return new MCVariables;
     case F_VECTOR_DOT_PRODUCT:
         return new MCVectorDotProduct;
+    case F_ORDERED_ARRAY:
+        return new MCOrderedArray;
 	case F_VERSION:
 		return new MCVersion;
 	case F_WAIT_DEPTH:
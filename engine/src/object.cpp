@@ -93,6 +93,31 @@ uint2 MCObject::s_last_font_index = 0;
 
 bool MCObject::s_loaded_parent_script_reference = false;
 
+uint32_t MCObject::s_unhandled_messages_epoch = 0;
+
+// The number of unhandled messages remembered by each object. Most objects
+// only see a few messages often enough for this to matter (mouseMove, idle and
+// so on), so they are replaced in turn rather than by use.
+#define UNHANDLED_MESSAGE_COUNT 8
+
+struct MCObjectUnhandledMessages
+{
+	uint32_t epoch;
+	uindex_t next;
+	MCNameRef messages[UNHANDLED_MESSAGE_COUNT];
+	Handler_type types[UNHANDLED_MESSAGE_COUNT];
+};
+
+static void MCObjectUnhandledMessagesClear(MCObjectUnhandledMessages *self)
+{
+	for(uindex_t i = 0; i < UNHANDLED_MESSAGE_COUNT; i++)
+	{
+		MCValueRelease(self -> messages[i]);
+		self -> messages[i] = nil;
+	}
+	self -> next = 0;
+}
+
 MCColor MCObject::maccolors[MAC_NCOLORS] = {
             { 0x7070, 0x7070, 0x7070 },
             { 0xCCCC, 0xCCCC, 0xFFFF },
@@ -171,6 +196,8 @@ MCObject::MCObject()
 	// IM-2016-01-21: Initialize native layer to nil
 	m_native_layer = nil;
 
+	m_unhandled_messages = nil;
+
     // Attach ourselves to an object pool.
     MCDeletedObjectsOnObjectCreated(this);
 }
@@ -276,6 +303,9 @@ MCObject::MCObject(const MCObject &oref)
 	// IM-2016-01-21: Initialize native layer to nil
 	m_native_layer = nil;
 	
+	// The copy has no handlers until its script is parsed.
+	m_unhandled_messages = nil;
+	
     // Attach ourselves to an object pool.
     MCDeletedObjectsOnObjectCreated(this);
 }
@@ -301,6 +331,11 @@ MCObject::~MCObject()
 	IO_freeobject(this);
 	MCundos->freeobject(this);
 	delete hlist;
+	if (m_unhandled_messages != nil)
+	{
+		MCObjectUnhandledMessagesClear(m_unhandled_messages);
+		MCMemoryDelete(m_unhandled_messages);
+	}
 	delete[] colors; /* Allocated with new[] */
 	if (colornames != nil)
 	{
@@ -1080,6 +1115,12 @@ Exec_stat MCObject::handleself(Handler_type p_handler_type, MCNameRef p_message,
 	Exec_stat t_stat;
 	t_stat = ES_NOT_HANDLED;
 
+	// If nothing in the object's script or parentScripts handled the message
+	// the last time it arrived, and no script has changed since, then there's
+	// no need to search them again.
+	if (isunhandled(p_handler_type, p_message))
+		return ES_NOT_HANDLED;
+
     // TODO[19681]: This can be removed when all engine messages are sent with
     // target.
     bool t_target_was_valid = MCtargetptr.IsValid();
@@ -1153,10 +1194,88 @@ Exec_stat MCObject::handleself(Handler_type p_handler_type, MCNameRef p_message,
         }
     }
 
+	// Objects without a parent don't parse their script, so are never
+	// remembered as not handling anything.
+	if (t_main_stat == ES_NOT_HANDLED && t_stat == ES_NOT_HANDLED &&
+		parent && !mighthandle(p_handler_type, p_message))
+		setunhandled(p_handler_type, p_message);
+
 	// Return the result of executing the main handler in the object
 	return t_main_stat;
 }
 
+bool MCObject::mighthandle(Handler_type p_handler_type, MCNameRef p_message)
+{
+	MCHandler *t_handler;
+	if (hlist != NULL && hlist -> findhandler(p_handler_type, p_message, t_handler) == ES_NORMAL)
+		return true;
+
+	// Walk the same chain of parentScripts as handleparent.
+	for(MCParentScriptUse *t_parentscript = parent_script; t_parentscript != NULL; t_parentscript = t_parentscript -> GetSuper())
+	{
+		MCObject *t_parent_object;
+		t_parent_object = t_parentscript -> GetParent() -> GetObject();
+		if (t_parent_object == NULL)
+			break;
+
+		MCHandlerlist *t_hlist;
+		t_hlist = t_parent_object -> hlist;
+		if (t_hlist == NULL)
+			continue;
+
+		if (t_hlist -> findhandler(p_handler_type, p_message, t_handler) == ES_NORMAL)
+			return true;
+
+		if (p_handler_type == HT_MESSAGE &&
+			(t_hlist -> findhandler(HT_BEFORE, p_message, t_handler) == ES_NORMAL ||
+			 t_hlist -> findhandler(HT_AFTER, p_message, t_handler) == ES_NORMAL))
+			return true;
+	}
+
+	return false;
+}
+
+bool MCObject::isunhandled(Handler_type p_handler_type, MCNameRef p_message)
+{
+	if (m_unhandled_messages == nil ||
+		m_unhandled_messages -> epoch != s_unhandled_messages_epoch)
+		return false;
+
+	for(uindex_t i = 0; i < UNHANDLED_MESSAGE_COUNT; i++)
+		if (m_unhandled_messages -> messages[i] != nil &&
+			m_unhandled_messages -> types[i] == p_handler_type &&
+			MCNameIsEqualToCaseless(m_unhandled_messages -> messages[i], p_message))
+			return true;
+
+	return false;
+}
+
+void MCObject::setunhandled(Handler_type p_handler_type, MCNameRef p_message)
+{
+	if (m_unhandled_messages == nil &&
+		!MCMemoryNew(m_unhandled_messages))
+		return;
+
+	if (m_unhandled_messages -> epoch != s_unhandled_messages_epoch)
+	{
+		MCObjectUnhandledMessagesClear(m_unhandled_messages);
+		m_unhandled_messages -> epoch = s_unhandled_messages_epoch;
+	}
+
+	uindex_t t_index;
+	t_index = m_unhandled_messages -> next;
+	m_unhandled_messages -> next = (t_index + 1) % UNHANDLED_MESSAGE_COUNT;
+
+	MCValueRelease(m_unhandled_messages -> messages[t_index]);
+	m_unhandled_messages -> messages[t_index] = MCValueRetain(p_message);
+	m_unhandled_messages -> types[t_index] = p_handler_type;
+}
+
+void MCObject::flushunhandledmessages(void)
+{
+	s_unhandled_messages_epoch++;
+}
+
 Exec_stat MCObject::handle(Handler_type htype, MCNameRef mess, MCParameter *params, MCObject *pass_from)
 {
 	// MW-2009-01-28: [[ Bug ]] Card and stack parentScripts don't work.
@@ -489,11 +489,16 @@ struct MCObjectFontAttrs
 };
 
 struct MCPropertyInfo;
+struct MCObjectPropertyIndex;
 struct MCObjectPropertyTable
 {
 	MCObjectPropertyTable *parent;
 	uindex_t size;
 	MCPropertyInfo *table;
+
+	// The entries of the table and its parents grouped by property, built on
+	// the first lookup in the table.
+	mutable MCObjectPropertyIndex *index;
 };
 
 struct MCInterfaceNamedColor;
@@ -503,6 +508,8 @@ struct MCInterfaceTextStyle;
 struct MCInterfaceTriState;
 struct MCExecValue;
 
+struct MCObjectUnhandledMessages;
+
 struct MCDeletedObjectPool;
 void MCDeletedObjectsSetup(void);
 void MCDeletedObjectsTeardown(void);
@@ -636,6 +643,14 @@ protected:
 
 	// The native layer associated with this object
 	MCNativeLayer* m_native_layer;
+
+	// The messages most recently found to have no handler in the object's
+	// script or its parentScripts (allocated on first use).
+	MCObjectUnhandledMessages *m_unhandled_messages;
+
+	// The unhandled messages of an object are only valid while their epoch
+	// matches this one.
+	static uint32_t s_unhandled_messages_epoch;
 	
 public:
     
@@ -1075,6 +1090,20 @@ public:
 	//   type.
 	Exec_stat handleparent(Handler_type type, MCNameRef message, MCParameter* parameters);
 
+	// Returns true if handleself could run a handler for the message - if the
+	// object's script or any of its parentScripts has a handler for it. The
+	// scripts must already have been parsed.
+	bool mighthandle(Handler_type type, MCNameRef message);
+
+	// Returns true if the message was found not to be handled by the object's
+	// script or its parentScripts, and nothing has changed since.
+	bool isunhandled(Handler_type type, MCNameRef message);
+	void setunhandled(Handler_type type, MCNameRef message);
+
+	// Forget the unhandled messages of all objects. This must be called when
+	// the handlers of any script, or the parentScript of any object, change.
+	static void flushunhandledmessages(void);
+
 	// IM-2013-07-24: [[ ResIndependence ]] Add scale factor to allow taking high-res snapshots
 	MCImageBitmap *snapshot(const MCRectangle *rect, const MCPoint *size, MCGFloat p_scale_factor, bool with_effects);
 
@@ -262,6 +262,7 @@ MCObjectPropertyTable MCObject::kPropertyTable =
 	nil,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -454,20 +455,90 @@ bool MCObject::setcustomprop(MCExecContext& ctxt, MCNameRef p_set_name, MCNameRe
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static MCPropertyInfo *lookup_object_property(const MCObjectPropertyTable *p_table, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type)
+struct MCObjectPropertyIndex
+{
+	// The entries for property p are entries[offsets[p]] up to (but not
+	// including) entries[offsets[p + 1]], in the order they are searched.
+	uint16_t offsets[__P_LAST + 1];
+	MCPropertyInfo **entries;
+};
+
+static inline bool MCObjectPropertyInfoMatches(const MCPropertyInfo& p_info, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type)
+{
+	return p_info . property == p_which && (!p_info . has_effective || p_info . effective == p_effective) &&
+		(p_array_prop == p_info . is_array_prop) &&
+		(p_chunk_type == p_info . chunk_type);
+}
+
+static MCPropertyInfo *MCObjectPropertyTableSearch(const MCObjectPropertyTable *p_table, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type)
 {
 	for(uindex_t i = 0; i < p_table -> size; i++)
-		if (p_table -> table[i] . property == p_which && (!p_table -> table[i] . has_effective || p_table -> table[i] . effective == p_effective) &&
-            (p_array_prop == p_table -> table[i] . is_array_prop) &&
-            (p_chunk_type == p_table -> table[i] . chunk_type))
+		if (MCObjectPropertyInfoMatches(p_table -> table[i], p_which, p_effective, p_array_prop, p_chunk_type))
 			return &p_table -> table[i];
 	
 	if (p_table -> parent != nil)
-		return lookup_object_property(p_table -> parent, p_which, p_effective, p_array_prop, p_chunk_type);
+		return MCObjectPropertyTableSearch(p_table -> parent, p_which, p_effective, p_array_prop, p_chunk_type);
 	
 	return nil;
 }
 
+// Group the entries of the table and its parents by property. The entries for
+// each property stay in search order, so the first match in the index is the
+// one the search would find.
+static bool MCObjectPropertyTableBuildIndex(const MCObjectPropertyTable *p_table)
+{
+	MCObjectPropertyIndex *t_index;
+	if (!MCMemoryNew(t_index))
+		return false;
+
+	// Count the entries for each property.
+	uindex_t t_count;
+	t_count = 0;
+	for(const MCObjectPropertyTable *t_table = p_table; t_table != nil; t_table = t_table -> parent)
+		for(uindex_t i = 0; i < t_table -> size; i++)
+		{
+			t_index -> offsets[t_table -> table[i] . property + 1] += 1;
+			t_count += 1;
+		}
+
+	if (t_count > UINT16_MAX ||
+		(t_count != 0 && !MCMemoryNewArray(t_count, t_index -> entries)))
+	{
+		MCMemoryDelete(t_index);
+		return false;
+	}
+
+	uint16_t t_next[__P_LAST];
+	for(uindex_t i = 0; i < __P_LAST; i++)
+	{
+		t_index -> offsets[i + 1] += t_index -> offsets[i];
+		t_next[i] = t_index -> offsets[i];
+	}
+
+	for(const MCObjectPropertyTable *t_table = p_table; t_table != nil; t_table = t_table -> parent)
+		for(uindex_t i = 0; i < t_table -> size; i++)
+			t_index -> entries[t_next[t_table -> table[i] . property]++] = &t_table -> table[i];
+
+	p_table -> index = t_index;
+	return true;
+}
+
+MCPropertyInfo *MCObjectPropertyTableLookup(const MCObjectPropertyTable *p_table, Properties p_which, bool p_effective, bool p_array_prop, MCPropertyInfoChunkType p_chunk_type)
+{
+	// If there isn't enough memory for the index, search the tables.
+	if ((p_table -> index == nil && !MCObjectPropertyTableBuildIndex(p_table)) ||
+		p_which >= __P_LAST)
+		return MCObjectPropertyTableSearch(p_table, p_which, p_effective, p_array_prop, p_chunk_type);
+
+	const MCObjectPropertyIndex *t_index;
+	t_index = p_table -> index;
+	for(uindex_t i = t_index -> offsets[p_which]; i < t_index -> offsets[p_which + 1]; i++)
+		if (MCObjectPropertyInfoMatches(*t_index -> entries[i], p_which, p_effective, p_array_prop, p_chunk_type))
+			return t_index -> entries[i];
+
+	return nil;
+}
+
 bool MCObject::getprop(MCExecContext& ctxt, uint32_t p_part_id, Properties p_which, MCNameRef p_index, Boolean p_effective, MCExecValue& r_value)
 {
 	bool t_is_array_prop;
@@ -476,9 +547,9 @@ bool MCObject::getprop(MCExecContext& ctxt, uint32_t p_part_id, Properties p_whi
 	t_is_array_prop = (p_index != nil && !MCNameIsEmpty(p_index));
 	
 	MCPropertyInfo *t_info;
-	t_info = lookup_object_property(getpropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
+	t_info = MCObjectPropertyTableLookup(getpropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
 	if (t_info == nil)
-		t_info = lookup_object_property(getmodepropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
+		t_info = MCObjectPropertyTableLookup(getmodepropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
 	
 	if (t_info == nil || t_info -> getter == nil)
 	{
@@ -515,9 +586,9 @@ bool MCObject::setprop(MCExecContext& ctxt, uint32_t p_part_id, Properties p_whi
 	t_is_array_prop = (p_index != nil && !MCNameIsEmpty(p_index));
 	
 	MCPropertyInfo *t_info;
-	t_info = lookup_object_property(getpropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
+	t_info = MCObjectPropertyTableLookup(getpropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
 	if (t_info == nil)
-		t_info = lookup_object_property(getmodepropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
+		t_info = MCObjectPropertyTableLookup(getmodepropertytable(), p_which, p_effective == True, t_is_array_prop, kMCPropertyInfoChunkTypeNone);
 	
 	if (t_info == nil || t_info -> setter == nil)
 	{
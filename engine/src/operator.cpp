@@ -34,6 +34,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "globals.h"
 #include "exec.h"
+#include "bytecode.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -936,3 +937,65 @@ void MCThere::eval_ctxt(MCExecContext &ctxt, MCExecValue &r_value)
     if (!ctxt.HasError())
         MCExecValueTraits<bool>::set(r_value, t_result);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Bytecode lowering
+//
+
+bool MCPlus::lower(MCBytecode& x_code)
+{
+    return x_code . Arithmetic(kMCBytecodeOpAdd, left, right);
+}
+
+bool MCMinus::lower(MCBytecode& x_code)
+{
+    return x_code . Arithmetic(kMCBytecodeOpSubtract, left, right);
+}
+
+bool MCTimes::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Arithmetic(kMCBytecodeOpMultiply, left, right);
+}
+
+bool MCOver::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Arithmetic(kMCBytecodeOpOver, left, right);
+}
+
+bool MCLessThan::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Comparison(kMCBytecodeOpLessThan, left, right);
+}
+
+bool MCLessThanEqual::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Comparison(kMCBytecodeOpLessThanOrEqualTo, left, right);
+}
+
+bool MCGreaterThan::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Comparison(kMCBytecodeOpGreaterThan, left, right);
+}
+
+bool MCGreaterThanEqual::lower(MCBytecode& x_code)
+{
+    if (left == nil)
+        return false;
+    return x_code . Comparison(kMCBytecodeOpGreaterThanOrEqualTo, left, right);
+}
+
+bool MCGrouping::lower(MCBytecode& x_code)
+{
+    return right != nil && right -> lower(x_code);
+}
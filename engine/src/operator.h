@@ -309,10 +309,16 @@ class MCEqual : public MCBinaryOperatorCtxt<MCValueRef, bool, MCLogicEvalIsEqual
 {};
 
 class MCGreaterThan : public MCBinaryOperatorCtxt<MCValueRef, bool, MCLogicEvalIsGreaterThan, EE_FACTOR_BADLEFT, EE_FACTOR_BADRIGHT, FR_COMPARISON>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCGreaterThanEqual : public MCBinaryOperatorCtxt<MCValueRef, bool, MCLogicEvalIsGreaterThanOrEqualTo, EE_FACTOR_BADLEFT, EE_FACTOR_BADRIGHT, FR_COMPARISON>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCGrouping : public MCExpression
 {
@@ -322,6 +328,7 @@ public:
 		rank = FR_GROUPING;
     }
     virtual void eval_ctxt(MCExecContext &ctxt, MCExecValue &r_value);
+    virtual bool lower(MCBytecode& x_code);
 };
 
 class MCIs : public MCExpression
@@ -345,10 +352,16 @@ class MCItem : public MCBinaryOperatorCtxt<MCStringRef, MCStringRef, MCStringsEv
 {};
 
 class MCLessThan : public MCBinaryOperatorCtxt<MCValueRef, bool, MCLogicEvalIsLessThan, EE_FACTOR_BADLEFT, EE_FACTOR_BADRIGHT, FR_COMPARISON>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCLessThanEqual : public MCBinaryOperatorCtxt<MCValueRef, bool, MCLogicEvalIsLessThanOrEqualTo, EE_FACTOR_BADLEFT, EE_FACTOR_BADRIGHT, FR_COMPARISON>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCMinus : public MCMultiBinaryOperator
 {
@@ -359,6 +372,7 @@ public:
     }
 
     virtual void eval_ctxt(MCExecContext &ctxt, MCExecValue &r_value);
+    virtual bool lower(MCBytecode& x_code);
 
     virtual bool canbeunary(void) const {return true;}
 };
@@ -424,7 +438,10 @@ class MCOver : public MCMultiBinaryOperatorCtxt<
         EE_OVER_MISMATCH,
         false,
         FR_MULDIV>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCPlus : public MCMultiBinaryCommutativeOperatorCtxt<
         MCMathEvalAdd,
@@ -434,7 +451,10 @@ class MCPlus : public MCMultiBinaryCommutativeOperatorCtxt<
         EE_PLUS_BADRIGHT,
         true,
         FR_ADDSUB>
-{};
+{
+public:
+    virtual bool lower(MCBytecode& x_code);
+};
 
 class MCPow : public MCBinaryOperatorCtxt<double, double, MCMathEvalPower, EE_POW_BADLEFT, EE_POW_BADRIGHT, FR_POW>
 {};
@@ -465,6 +485,8 @@ class MCTimes : public MCMultiBinaryCommutativeOperatorCtxt<
         false,
         FR_MULDIV>
 {
+public:
+    virtual bool lower(MCBytecode& x_code);
 };
 
 class MCXorBits : public MCBinaryOperatorCtxt<uinteger_t, uinteger_t, MCMathEvalBitwiseXor, EE_XORBITS_BADLEFT, EE_XORBITS_BADRIGHT, FR_XOR_BITS>
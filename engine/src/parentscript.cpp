@@ -89,6 +89,9 @@ MCParentScriptUse::MCParentScriptUse(MCParentScript *p_parent, MCObject *p_refer
 	// point the parent script's object's variable list will be copied.
 	m_local_count = 0;
 	m_locals = NULL;
+
+	// The referrer's chain of parentScripts is changing.
+	MCObject::flushunhandledmessages();
 }
 
 MCParentScriptUse::~MCParentScriptUse(void)
@@ -99,6 +102,8 @@ MCParentScriptUse::~MCParentScriptUse(void)
 	// MW-2013-05-30: [[ InheritedPscripts ]] Release the super-use chain, if any.
 	if (m_super_use != NULL)
 		m_super_use -> Release();
+
+	MCObject::flushunhandledmessages();
 }
 
 MCVariable *MCParentScriptUse::GetVariable(uint32_t i)
@@ -364,6 +369,9 @@ void MCParentScript::Resolve(MCObject *p_object)
 	// Assign the reference to the object
 	m_object = p_object;
 
+	// The uses of this parentScript now have its handlers.
+	MCObject::flushunhandledmessages();
+
 	// Unblock this
 	m_blocked = false;
 
@@ -393,6 +401,8 @@ void MCParentScript::Flush(void)
 	// Clear the reference
 	m_object = NULL;
 
+	MCObject::flushunhandledmessages();
+
 	// Iterate through all the uses, clearing out variables
 	for(MCParentScriptUse *t_use = m_first_use; t_use != NULL; t_use = t_use -> m_next_use)
 		t_use -> ClearVars();
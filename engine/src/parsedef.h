@@ -602,6 +602,8 @@ enum Functions {
     
     F_VECTOR_DOT_PRODUCT,
     
+    F_ORDERED_ARRAY,
+    
     F_EVENT_CAPSLOCK_KEY,
     F_EVENT_COMMAND_KEY,
     F_EVENT_CONTROL_KEY,
@@ -1761,6 +1763,8 @@ enum Properties {
 	
 	P_SYSTEM_APPEARANCE,
     
+    P_MAP_BINARY_FILES,
+    
     __P_LAST,
 };
 
@@ -1798,6 +1798,9 @@ enum Parse_errors
     
     // {PE-0584} out of memory
     PE_OUTOFMEMORY,
+    
+    // {PE-0585} orderedArray: bad parameter
+    PE_ORDEREDARRAY_BADPARAM,
 };
 
 extern const char *MCparsingerrors;
@@ -81,6 +81,7 @@ MCObjectPropertyTable MCPlayer::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 bool MCPlayer::visit_self(MCObjectVisitor* p_visitor)
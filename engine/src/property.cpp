@@ -405,6 +405,8 @@ static MCPropertyInfo kMCPropertyInfoTable[] =
     DEFINE_RO_PROPERTY(P_LOADED_EXTENSIONS, ProperLinesOfString, Engine, LoadedExtensions)
 	
 	DEFINE_RO_ENUM_PROPERTY(P_SYSTEM_APPEARANCE, InterfaceSystemAppearance, Interface, SystemAppearance)
+	
+	DEFINE_RW_PROPERTY(P_MAP_BINARY_FILES, Bool, Files, MapBinaryFiles)
 };
 
 static bool MCPropertyInfoTableLookup(Properties p_which, Boolean p_effective, const MCPropertyInfo*& r_info, bool p_is_array_prop)
@@ -943,6 +945,7 @@ Parse_stat MCProperty::parse(MCScriptPoint &sp, Boolean the)
     // MW-2014-12-10: [[ Extensions ]] Add support for global loadedExtensions property.
     case P_LOADED_EXTENSIONS:
 	case P_SYSTEM_APPEARANCE:
+	case P_MAP_BINARY_FILES:
         break;
     
     case P_REV_LIBRARY_MAPPING:
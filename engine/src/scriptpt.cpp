@@ -32,6 +32,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "funcs.h"
 #include "operator.h"
 #include "literal.h"
+#include "bytecode.h"
 #include "newobj.h"
 #include "mcerror.h"
 #include "util.h"
@@ -1540,6 +1541,16 @@ MCExpression *MCScriptPoint::insertbinop(MCExpression *nfact,
 
 Parse_stat MCScriptPoint::parseexp(Boolean single, Boolean items,
                                    MCExpression **top)
+{
+	Parse_stat t_stat;
+	t_stat = parseexptree(single, items, top);
+	if (t_stat == PS_NORMAL && MCbytecodeenabled && *top != NULL)
+		*top = MCBytecodeExpression::compile(*top);
+	return t_stat;
+}
+
+Parse_stat MCScriptPoint::parseexptree(Boolean single, Boolean items,
+                                       MCExpression **top)
 {
 	Symbol_type type;
 	const LT *te;
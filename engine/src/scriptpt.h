@@ -213,7 +213,9 @@ public:
 	                           MCExpression **top);
 	MCExpression *insertbinop(MCExpression *nfact, MCExpression *&cfact,
 	                          MCExpression **top);
+	// Parse an expression, compiling it to bytecode if possible.
 	Parse_stat parseexp(Boolean single, Boolean items, MCExpression **);
+	Parse_stat parseexptree(Boolean single, Boolean items, MCExpression **);
 	
 	// Search for an existing variable in scope, returning an error if it
 	// doesn't exist.
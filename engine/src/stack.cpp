@@ -214,6 +214,7 @@ MCObjectPropertyTable MCStack::kPropertyTable =
 	&MCObject::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0],
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
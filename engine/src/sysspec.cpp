@@ -48,6 +48,8 @@
 #include <signal.h>
 #ifdef _WIN32
 #include <float.h> // _isnan()
+#else
+#include <pthread.h>
 #endif 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -242,8 +244,12 @@ void MCS_common_init(void)
 	MCStackSecurityInit();
 }
 
+static void MCS_initmappedfiles(void);
+
 void MCS_preinit()
 {
+	MCS_initmappedfiles();
+	
 #if defined(_WINDOWS_SERVER)
 	MCsystem = MCDesktopCreateWindowsSystem();
 #elif defined(_MAC_SERVER)
@@ -572,6 +578,140 @@ bool MCS_getaddress(MCStringRef& r_address)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Binary files at least this big are loaded by mapping them into memory, so
+// the data uses the file's pages rather than a copy of them.
+//
+// The data is only as immutable as the file. The engine detaches the data
+// before it writes, renames or deletes a mapped file itself (see below), but
+// nothing can stop another process changing the file meanwhile: the data then
+// changes with it, and if the file is truncated, touching the pages past its
+// new end raises SIGBUS, which the engine treats as a crash. So mapping is only
+// done when asked for, by setting the mapBinaryFiles (MCmapbinaryfiles), and
+// never when it has been turned off with the -mmap command line option (MCmmap).
+#define MAPPED_BINARY_FILE_THRESHOLD (16 * 1024 * 1024)
+
+// Each data ref which uses the contents of a mapped file is recorded, so that
+// it can be given its own copy before the engine writes, renames or deletes
+// the file.
+struct MCMappedFileData
+{
+	MCMappedFileData *next;
+	MCStringRef native_path;
+	MCDataRef data;
+	IO_handle handle;
+};
+
+static MCMappedFileData *s_mapped_files = nil;
+
+// The data can be released on any thread, so the list is guarded by a lock.
+// The lock is recursive as detaching data releases its entry while the list
+// is being walked.
+#if defined(_WIN32)
+static CRITICAL_SECTION s_mapped_files_lock;
+#else
+static pthread_mutex_t s_mapped_files_lock;
+#endif
+
+static void MCS_initmappedfiles(void)
+{
+#if defined(_WIN32)
+	InitializeCriticalSection(&s_mapped_files_lock);
+#else
+	pthread_mutexattr_t t_attr;
+	pthread_mutexattr_init(&t_attr);
+	pthread_mutexattr_settype(&t_attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&s_mapped_files_lock, &t_attr);
+	pthread_mutexattr_destroy(&t_attr);
+#endif
+}
+
+static void MCS_lockmappedfiles(void)
+{
+#if defined(_WIN32)
+	EnterCriticalSection(&s_mapped_files_lock);
+#else
+	pthread_mutex_lock(&s_mapped_files_lock);
+#endif
+}
+
+static void MCS_unlockmappedfiles(void)
+{
+#if defined(_WIN32)
+	LeaveCriticalSection(&s_mapped_files_lock);
+#else
+	pthread_mutex_unlock(&s_mapped_files_lock);
+#endif
+}
+
+static void MCS_releasemappedfiledata(void *p_context)
+{
+	MCMappedFileData *t_mapped;
+	t_mapped = static_cast<MCMappedFileData *>(p_context);
+	
+	MCS_lockmappedfiles();
+	MCMappedFileData **t_link;
+	for(t_link = &s_mapped_files; *t_link != t_mapped; t_link = &(*t_link) -> next)
+		;
+	*t_link = t_mapped -> next;
+	MCS_unlockmappedfiles();
+	
+	// Closing the handle unmaps the file.
+	t_mapped -> handle -> Close();
+	MCValueRelease(t_mapped -> native_path);
+	MCMemoryDelete(t_mapped);
+}
+
+static bool MCS_createmappedfiledata(MCStringRef p_native_path, IO_handle p_handle, uint32_t p_size, MCDataRef& r_data)
+{
+	MCMappedFileData *t_mapped;
+	if (!MCMemoryNew(t_mapped))
+		return false;
+	
+	MCDataRef t_data;
+	if (!MCDataCreateWithExternalBytes((const byte_t *)p_handle -> GetMappedContents(), p_size, MCS_releasemappedfiledata, t_mapped, t_data))
+	{
+		MCMemoryDelete(t_mapped);
+		return false;
+	}
+	
+	// The data isn't retained here - the entry goes when the data does.
+	t_mapped -> native_path = MCValueRetain(p_native_path);
+	t_mapped -> data = t_data;
+	t_mapped -> handle = p_handle;
+	MCS_lockmappedfiles();
+	t_mapped -> next = s_mapped_files;
+	s_mapped_files = t_mapped;
+	MCS_unlockmappedfiles();
+	
+	r_data = t_data;
+	return true;
+}
+
+// Make any data which is using the mapped contents of the given file take its
+// own copy, as the file is about to change.
+static void MCS_detachmappedfiles(MCStringRef p_native_path)
+{
+	MCS_lockmappedfiles();
+	MCMappedFileData *t_mapped;
+	t_mapped = s_mapped_files;
+	while(t_mapped != nil)
+	{
+		// Detaching the data releases the entry, so move on first.
+		MCMappedFileData *t_next;
+		t_next = t_mapped -> next;
+		
+		// Paths are compared caselessly as some filesystems are; detaching
+		// data that didn't need it is harmless.
+		if (MCStringIsEqualTo(t_mapped -> native_path, p_native_path, kMCStringOptionCompareCaseless))
+			/* UNCHECKED */ MCDataDetachExternalBytes(t_mapped -> data);
+		
+		t_mapped = t_next;
+	}
+	MCS_unlockmappedfiles();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 Boolean MCS_mkdir(MCStringRef p_path)
 {
     MCAutoStringRef t_native_path;
@@ -614,6 +754,9 @@ Boolean MCS_rename(MCStringRef p_old_name, MCStringRef p_new_name)
     if (!MCS_pathtonative(*t_old_resolved_path, &t_old_native_path) || !MCS_pathtonative(*t_new_resolved_path, &t_new_native_path))
         return False;
 	
+	MCS_detachmappedfiles(*t_old_native_path);
+	MCS_detachmappedfiles(*t_new_native_path);
+	
 	return MCsystem -> RenameFileOrFolder(*t_old_native_path, *t_new_native_path);
 }
 
@@ -638,6 +781,8 @@ Boolean MCS_unlink(MCStringRef p_path)
     if (!MCS_pathtonative(*t_resolved_path, &t_native_path))
         return False;
 	
+	MCS_detachmappedfiles(*t_native_path);
+	
 	return MCsystem -> DeleteFile(*t_native_path);
 }
 
@@ -1237,6 +1382,9 @@ IO_handle MCS_open(MCStringRef path, intenum_t p_mode, Boolean p_map, Boolean p_
 	IO_handle t_handle;
 	if (!p_driver)
     {
+		if (p_mode != kMCOpenFileModeRead)
+			MCS_detachmappedfiles(*t_native);
+		
 		t_handle = MCsystem -> OpenFile(*t_native, p_mode, p_map && MCmmap);
     }
 	else
@@ -1448,8 +1596,11 @@ bool MCS_loadbinaryfile(MCStringRef p_filename, MCDataRef& r_data)
 	if (!(MCS_resolvepath(p_filename, &t_resolved_path) && MCS_pathtonative(*t_resolved_path, &t_native_path)))
         return false;
 	
+	// The file is opened mapped (if mapBinaryFiles is set) so that a large one
+	// can be used in place; smaller ones are read from the mapping and the
+	// handle closed as before.
 	IO_handle t_file;
-    t_file = MCsystem -> OpenFile(*t_native_path, (intenum_t)kMCOpenFileModeRead, false);
+    t_file = MCsystem -> OpenFile(*t_native_path, (intenum_t)kMCOpenFileModeRead, MCmapbinaryfiles && MCmmap);
 	
 	if (t_file == NULL)
 	{
@@ -1461,6 +1612,16 @@ bool MCS_loadbinaryfile(MCStringRef p_filename, MCDataRef& r_data)
 	uint32_t t_size;
 	t_size = (uint32_t)t_file -> GetFileSize();
 	
+	// Large files which could be mapped are used in place, in which case the
+	// handle stays open until the data is released.
+	if (t_size >= MAPPED_BINARY_FILE_THRESHOLD &&
+		t_file -> GetMappedContents() != nil &&
+		MCS_createmappedfiledata(*t_native_path, t_file, t_size, r_data))
+	{
+		MCresult -> clear();
+		return true;
+	}
+	
 	MCAutoByteArray t_buffer;
 	t_success = t_buffer . New(t_size);
 	
@@ -1504,6 +1665,8 @@ bool MCS_savetextfile(MCStringRef p_filename, MCStringRef p_string)
 	if (!(MCS_resolvepath(p_filename, &t_resolved_path) && MCS_pathtonative(*t_resolved_path, &t_native_path)))
         return false;
 	
+	MCS_detachmappedfiles(*t_native_path);
+	
     // MW-2014-10-24: [[ Bug 13797 ]] Don't create executable file.
 	IO_handle t_file;
     t_file = MCsystem -> OpenFile(*t_native_path, (intenum_t)kMCOpenFileModeWrite, false);
@@ -1557,6 +1720,8 @@ bool MCS_savebinaryfile(MCStringRef p_filename, MCDataRef p_data)
 	if (!(MCS_resolvepath(p_filename, &t_resolved_path) && MCS_pathtonative(*t_resolved_path, &t_native_path)))
         return false;
 	
+	MCS_detachmappedfiles(*t_native_path);
+	
     // MW-2014-10-24: [[ Bug 13797 ]] Don't create executable file.
 	IO_handle t_file;
     t_file = MCsystem -> OpenFile(*t_native_path, (intenum_t)kMCOpenFileModeWrite, false);
@@ -97,6 +97,13 @@ struct MCSystemFileHandle
     
     virtual bool TakeBuffer(void*& r_buffer, size_t& r_length) = 0;
 
+    // Returns the contents of the file if they are mapped into memory, in which
+    // case they remain valid until the handle is closed.
+    virtual const void *GetMappedContents(void)
+    {
+        return nil;
+    }
+
     // Polymorphic - needs virtual destructor
     virtual ~MCSystemFileHandle()
     {
@@ -313,6 +320,11 @@ public:
         MCMemoryFileHandle::Close();
     }
     
+    const void *GetMappedContents(void)
+    {
+        return m_buffer;
+    }
+    
 private:
     int m_fd;
     void *m_buffer;
@@ -627,7 +627,9 @@ uint4 MCU_r8tos(char *&d, uint4 &s, real8 n,
     
     if (MCS_isfinite(n))
     {
-        sprintf(d, "%0*.*f", fw, trailing, n);
+        uindex_t t_length;
+        if (!MCTypeConvertRealToFixedChars(n, fw, trailing, d, s, t_length))
+            return 0;
         MCU_strip(d, trailing, force);
     }
     else
@@ -37,6 +37,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "parentscript.h"
 #include "osspec.h"
 #include "variable.h"
+#include "bytecode.h"
 
 #include <utility>
 
@@ -67,6 +68,70 @@ bool MCVariable::createwithname(MCNameRef p_name, MCVariable*& r_var)
 	return true;
 }
 
+// Handler locals and parameters released by createlocal's callers are kept
+// here, chained through 'next', for the next call to reuse. The pool is
+// capped so that a burst of deep recursion doesn't pin its peak forever.
+#define LOCAL_VARIABLE_POOL_LIMIT 256
+
+static MCVariable *s_local_variable_pool = nullptr;
+static uindex_t s_local_variable_pool_count = 0;
+
+bool MCVariable::createlocal(MCNameRef p_name, MCVariable*& r_var)
+{
+	MCVariable *self = s_local_variable_pool;
+	if (self != nullptr)
+	{
+		s_local_variable_pool = self -> next;
+		s_local_variable_pool_count -= 1;
+		self -> next = nullptr;
+	}
+	else if (!create(self))
+		return false;
+
+	self->name.Reset(p_name);
+
+	r_var = self;
+
+	return true;
+}
+
+void MCVariable::destroylocal(MCVariable *p_var)
+{
+	if (p_var == nullptr)
+		return;
+
+	if (s_local_variable_pool_count == LOCAL_VARIABLE_POOL_LIMIT)
+	{
+		delete p_var;
+		return;
+	}
+
+	// Put the variable back into the state 'create' leaves it in, so nothing
+	// from this call can be seen by the next.
+	p_var -> clear();
+	p_var -> name.Reset();
+	p_var -> is_msg = false;
+	p_var -> is_env = false;
+	p_var -> is_global = false;
+	p_var -> is_deferred = false;
+	p_var -> is_uql = false;
+
+	p_var -> next = s_local_variable_pool;
+	s_local_variable_pool = p_var;
+	s_local_variable_pool_count += 1;
+}
+
+void MCVariable::cleanuplocals(void)
+{
+	while (s_local_variable_pool != nullptr)
+	{
+		MCVariable *t_var = s_local_variable_pool;
+		s_local_variable_pool = t_var -> next;
+		delete t_var;
+	}
+	s_local_variable_pool_count = 0;
+}
+
 // This is only called by MCObject to create copies of prop sets.
 bool MCVariable::createcopy(MCVariable& p_var, MCVariable*& r_new_var)
 {
@@ -534,9 +599,14 @@ bool MCVariable::modify_data(MCExecContext& ctxt, MCDataRef p_data, MCSpan<MCNam
 
     MCDataRef t_value_as_data;
     t_value_as_data = nil;
+    if (!ctxt . ConvertToData(t_current_value, t_value_as_data))
+        return false;
+    
+    bool t_detached;
+    t_detached = detachvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value, t_value_as_data);
+    
     // SN-2014-04-11 [[ FasterVariable ]] now chose between appending or prepending
-	if (ctxt . ConvertToData(t_current_value, t_value_as_data) &&
-	    MCDataMutableCopyAndRelease(t_value_as_data, t_value_as_data) &&
+	if (MCDataMutableCopyAndRelease(t_value_as_data, t_value_as_data) &&
 		((p_setting == kMCVariableSetAfter && MCDataAppend(t_value_as_data, p_data)) ||
          (p_setting == kMCVariableSetBefore && MCDataPrepend(t_value_as_data, p_data))) &&
 		setvalueref(p_path, ctxt . GetCaseSensitive(), t_value_as_data))
@@ -546,6 +616,11 @@ bool MCVariable::modify_data(MCExecContext& ctxt, MCDataRef p_data, MCSpan<MCNam
 		return true;
 	}
     
+    // The value is unchanged if the modification failed, so put it back in
+    // the element it was detached from.
+    if (t_detached)
+        /* UNCHECKED */ setvalueref(p_path, ctxt . GetCaseSensitive(), t_value_as_data);
+    
 	MCValueRelease(t_value_as_data);
 	return false;
 }
@@ -578,9 +653,14 @@ bool MCVariable::modify_string(MCExecContext& ctxt, MCStringRef p_value, MCSpan<
     
     MCStringRef t_current_value_as_string;
     t_current_value_as_string = nil;
+    if (!ctxt . ConvertToString(t_current_value, t_current_value_as_string))
+        return false;
+    
+    bool t_detached;
+    t_detached = detachvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value, t_current_value_as_string);
+    
     // SN-2014-04-11 [[ FasterVariable ]] now chose between appending or prepending
-    if (ctxt . ConvertToString(t_current_value, t_current_value_as_string) &&
-        MCStringMutableCopyAndRelease(t_current_value_as_string, t_current_value_as_string) &&
+    if (MCStringMutableCopyAndRelease(t_current_value_as_string, t_current_value_as_string) &&
         ((p_setting == kMCVariableSetAfter && MCStringAppend(t_current_value_as_string, p_value)) ||
          (p_setting == kMCVariableSetBefore && MCStringPrepend(t_current_value_as_string, p_value))) &&
         setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_string))
@@ -590,10 +670,30 @@ bool MCVariable::modify_string(MCExecContext& ctxt, MCStringRef p_value, MCSpan<
         return true;
     }
     
+    // The value is unchanged if the modification failed, so put it back in
+    // the element it was detached from.
+    if (t_detached)
+        /* UNCHECKED */ setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_string);
+    
     MCValueRelease(t_current_value_as_string);
     return false;
 }
 
+bool MCVariable::detachvalueref(MCSpan<MCNameRef> p_path, bool p_case_sensitive, MCValueRef p_element, MCValueRef p_value)
+{
+    // If the value had to be converted then the element is untouched, and if
+    // anything besides the array and the caller refers to it, it must be
+    // copied anyway.
+    if (p_value != p_element || MCValueGetRetainCount(p_value) != 2)
+        return false;
+    
+    // Otherwise empty the element - as long as the arrays on the path are only
+    // referenced by this variable this doesn't copy anything, and leaves the
+    // caller with the only reference to the value. If the element can't be
+    // emptied then it still holds the value, which will just be copied.
+    return setvalueref(p_path, p_case_sensitive, kMCEmptyString);
+}
+
 bool MCVariable::modify(MCExecContext& ctxt, MCValueRef p_value, MCSpan<MCNameRef> p_path, MCVariableSettingStyle p_setting)
 {
     if (MCValueGetTypeCode(p_value) == kMCValueTypeCodeData && can_become_data(ctxt, p_path))
@@ -659,9 +759,13 @@ bool MCVariable::replace_data(MCExecContext& ctxt, MCDataRef p_replacement, MCRa
     
     MCDataRef t_current_value_as_data;
     t_current_value_as_data = nil;
+    if (!ctxt . ConvertToData(t_current_value, t_current_value_as_data))
+        return false;
+    
+    bool t_detached;
+    t_detached = detachvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value, t_current_value_as_data);
         
-    if (ctxt . ConvertToData(t_current_value, t_current_value_as_data) &&
-        MCDataMutableCopyAndRelease(t_current_value_as_data, t_current_value_as_data) &&
+    if (MCDataMutableCopyAndRelease(t_current_value_as_data, t_current_value_as_data) &&
         MCDataReplace(t_current_value_as_data, p_range, (MCDataRef)p_replacement) &&
         setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_data))
     {
@@ -670,6 +774,11 @@ bool MCVariable::replace_data(MCExecContext& ctxt, MCDataRef p_replacement, MCRa
         return true;
     }
         
+    // The value is unchanged if the modification failed, so put it back in
+    // the element it was detached from.
+    if (t_detached)
+        /* UNCHECKED */ setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_data);
+    
     MCValueRelease(t_current_value_as_data);
     return false;
 }
@@ -694,9 +803,14 @@ bool MCVariable::replace_string(MCExecContext& ctxt, MCStringRef p_replacement,
     
     MCStringRef t_current_value_as_string;
     t_current_value_as_string = nil;
+    if (!ctxt . ConvertToString(t_current_value, t_current_value_as_string))
+        return false;
+    
+    bool t_detached;
+    t_detached = detachvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value, t_current_value_as_string);
+    
     // SN-2014-04-11 [[ FasterVariable ]] now chose between appending or prepending
-    if (ctxt . ConvertToString(t_current_value, t_current_value_as_string) &&
-        MCStringMutableCopyAndRelease(t_current_value_as_string, t_current_value_as_string) &&
+    if (MCStringMutableCopyAndRelease(t_current_value_as_string, t_current_value_as_string) &&
         MCStringReplace(t_current_value_as_string, p_range, p_replacement) &&
         setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_string))
     {
@@ -705,6 +819,11 @@ bool MCVariable::replace_string(MCExecContext& ctxt, MCStringRef p_replacement,
         return true;
     }
     
+    // The value is unchanged if the modification failed, so put it back in
+    // the element it was detached from.
+    if (t_detached)
+        /* UNCHECKED */ setvalueref(p_path, ctxt . GetCaseSensitive(), t_current_value_as_string);
+    
     MCValueRelease(t_current_value_as_string);
     return false;
 }
@@ -1207,6 +1326,16 @@ MCVarref *MCVarref::getrootvarref(void)
 	return this;
 }
 
+bool MCVarref::lower(MCBytecode& x_code)
+{
+	// Only handler locals and parameters can be fetched without a context;
+	// script locals depend on the parent script in use.
+	if (ref != nullptr || handler == nullptr || isscriptlocal || dimensions != 0)
+		return false;
+	
+	return x_code . PushVariable(handler, index, isparam);
+}
+
 bool MCVarref::set(MCExecContext& ctxt, MCValueRef p_value, MCVariableSettingStyle p_setting)
 {
 	MCContainer t_container;
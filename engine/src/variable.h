@@ -77,6 +77,12 @@ protected:
     bool modify_string(MCExecContext& ctxt, MCStringRef p_value, MCSpan<MCNameRef> p_path, MCVariableSettingStyle p_setting);
     // Modify the content of the variable - append or prepend (nested key). Target must already be data.
     bool modify_data(MCExecContext& ctxt, MCDataRef p_data, MCSpan<MCNameRef> p_path, MCVariableSettingStyle p_setting);
+    
+    // Empties the element (nested key) if the array holds the only other reference
+    // to the value about to be modified, so that the value can be changed in place.
+    // Returns true if it did, in which case the caller must put the value back
+    // if the modification fails.
+    bool detachvalueref(MCSpan<MCNameRef> p_path, bool p_case_sensitive, MCValueRef p_element, MCValueRef p_value);
 public:
 	
 	// Destructor
@@ -261,6 +267,14 @@ public:
 
 	/* CAN FAIL */ static bool createcopy(MCVariable& other, MCVariable*& r_var);
 
+	// Create a variable for a handler local or parameter, reusing one released
+	// by an earlier call if there is one. Such variables must be released with
+	// destroylocal, which resets them before they are reused.
+	/* CAN FAIL */ static bool createlocal(MCNameRef name, MCVariable*& r_var);
+	static void destroylocal(MCVariable *var);
+	// Frees the variables waiting to be reused by createlocal (on shutdown).
+	static void cleanuplocals(void);
+
     ///////////
     // Does what MCVariableValue equivalent was doing
     bool encode(void *&r_buffer, uindex_t& r_size);
@@ -385,6 +399,7 @@ public:
     virtual bool evalcontainer(MCExecContext &ctxt, MCContainer& r_container);
 
 	virtual MCVarref *getrootvarref(void);
+	virtual bool lower(MCBytecode& x_code);
 
 	Boolean getisscriptlocal() { return isscriptlocal; };
 
@@ -81,6 +81,7 @@ MCObjectPropertyTable MCWidget::kPropertyTable =
 	&MCControl::kPropertyTable,
 	sizeof(kProperties) / sizeof(kProperties[0]),
 	&kProperties[0]
+	nil,
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,90 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "prefix.h"
+
+#include "globdefs.h"
+#include "filedefs.h"
+#include "objdefs.h"
+#include "parsedef.h"
+
+#include "exec.h"
+
+struct TestObject
+{
+	static int live;
+	TestObject() { live++; }
+	~TestObject() { live--; }
+	char padding[40];
+};
+
+int TestObject::live = 0;
+
+TEST(exec_arena, nested_frames)
+{
+	MCExecArena t_arena;
+	
+	{
+		MCExecArenaFrame t_outer(t_arena);
+		MCExecArenaArray<TestObject> t_outer_objects(t_arena, 4);
+		ASSERT_TRUE(t_outer_objects.IsValid());
+		
+		{
+			MCExecArenaFrame t_inner(t_arena);
+			MCExecArenaArray<TestObject> t_inner_objects(t_arena, 200);
+			ASSERT_TRUE(t_inner_objects.IsValid());
+			EXPECT_EQ(TestObject::live, 204);
+			
+			// Oversized requests must get a chunk of their own.
+			void *t_large = t_arena.Allocate(65536);
+			ASSERT_NE(t_large, nullptr);
+			memset(t_large, 0, 65536);
+		}
+		
+		EXPECT_EQ(TestObject::live, 4);
+		
+		// Released memory is handed out again.
+		MCExecArena::Mark t_mark = t_arena.GetMark();
+		void *t_first = t_arena.Allocate(8);
+		t_arena.ReleaseToMark(t_mark);
+		EXPECT_EQ(t_arena.Allocate(8), t_first);
+	}
+	
+	EXPECT_EQ(TestObject::live, 0);
+}
+
+TEST(exec_arena, alignment)
+{
+	MCExecArena t_arena;
+	MCExecArenaFrame t_frame(t_arena);
+	
+	for(size_t i = 1; i < 64; i++)
+	{
+		void *t_ptr = t_arena.Allocate(i);
+		ASSERT_NE(t_ptr, nullptr);
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(t_ptr) % 16, 0u);
+	}
+}
+
+TEST(exec_arena, empty_array)
+{
+	MCExecArena t_arena;
+	MCExecArenaArray<TestObject> t_objects(t_arena, 0);
+	EXPECT_TRUE(t_objects.IsValid());
+	EXPECT_EQ(*t_objects, nullptr);
+}
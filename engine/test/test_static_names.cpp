@@ -0,0 +1,44 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "prefix.h"
+#include "globdefs.h"
+#include "objdefs.h"
+#include "mcstring.h"
+
+TEST(static_names, hashes)
+//
+// Checks that the hashes util/encode_static_names.pl computed for the static
+// name table are those MCStringHash computes.
+//
+{
+    MCInitialize();
+
+    ASSERT_GE(kMCStaticNameCount, (unsigned)1);
+
+    for(uindex_t i = 0; i < kMCStaticNameCount; i++)
+    {
+        const MCNameStaticInfo& t_info = kMCStaticNames[i];
+        EXPECT_EQ(t_info.length, strlen(t_info.cstring)) << t_info.cstring;
+
+        MCAutoStringRef t_string;
+        ASSERT_TRUE(MCStringCreateWithNativeChars((const char_t *)t_info.cstring, t_info.length, &t_string));
+        EXPECT_EQ(t_info.hash, MCStringHash(*t_string, kMCStringOptionCompareCaseless))
+            << "Wrong hash for \"" << t_info.cstring << "\"";
+    }
+}
@@ -30,9 +30,40 @@ bool MCFiltersIsCompressed(MCDataRef p_source);
 bool MCFiltersDecompress(MCDataRef p_source, MCDataRef& r_result);
 bool MCFiltersIsoToMac(MCDataRef p_source, MCDataRef &r_result);
 bool MCFiltersMacToIso(MCDataRef p_source, MCDataRef &r_result);
+// The framing used by the compression streams - gzip is the format produced by
+// MCFiltersCompress, zlib adds a two byte header and adler32 checksum, and
+// deflate is the raw compressed data with neither.
+enum MCFiltersCompressionFormat
+{
+	kMCFiltersCompressionFormatGzip,
+	kMCFiltersCompressionFormatZlib,
+	kMCFiltersCompressionFormatDeflate,
+};
+
+// Create a stream which compresses the data written to it, making the result
+// available to read as it is produced. The level is from 0 (store) to 9 (best),
+// or -1 for the default.
+bool MCFiltersCompressStreamCreate(MCFiltersCompressionFormat p_format, int p_level, MCStreamRef& r_stream);
+// Create a stream which decompresses the data written to it, making the result
+// available to read as it is produced.
+bool MCFiltersDecompressStreamCreate(MCFiltersCompressionFormat p_format, MCStreamRef& r_stream);
+// Returns true if the stream was created by one of the above.
+bool MCFiltersIsCompressionStream(MCStreamRef p_stream);
+// Signal that all the data has been written to a compression stream. This
+// flushes the end of the compressed data when compressing, and fails if the
+// compressed data was truncated when decompressing.
+bool MCFiltersCompressionStreamFinish(MCStreamRef p_stream);
+
 bool MCFiltersUrlEncode(MCStringRef p_source, MCStringRef& r_result);
 bool MCFiltersUrlDecode(MCStringRef p_source, MCStringRef& r_result);
 
+// Convert each byte to a pair of lowercase hex digits, with the digit for its
+// high nibble first or second.
+void MCFiltersHexEncodeBytes(const byte_t *p_bytes, uindex_t p_byte_count, bool p_high_nibble_first, char_t *r_chars);
+// Convert each pair of hex digits to a byte, returning false if any of the
+// chars isn't a hex digit.
+bool MCFiltersHexDecodeChars(const char_t *p_chars, uindex_t p_byte_count, bool p_high_nibble_first, byte_t *r_bytes);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #endif
@@ -153,6 +153,39 @@ private:
     bool m_Reverse;
 };
 
+class MCTextFilter_DecodeUTF8 : public MCTextFilter_Decoder
+{
+public:
+    
+    // Inherited from MCTextFilter
+    virtual codepoint_t GetNextCodepoint();
+    virtual bool AdvanceCursor();
+    virtual bool HasData() const;
+    virtual void MarkText();
+    virtual uindex_t GetMarkedLength() const;
+    
+    MCTextFilter_DecodeUTF8(const byte_t*, uindex_t, bool);
+    ~MCTextFilter_DecodeUTF8();
+    
+private:
+    
+    // Decodes the codepoint at the read index, setting the number of bytes
+    // it takes
+    codepoint_t Decode(uindex_t& r_length) const;
+    
+    // Text storage
+    const byte_t *m_Data;
+    uindex_t m_DataLength;
+    
+    // Reading index into the bytes, and accepted and reading indices into
+    // the UTF-16 code units they decode to (as marked lengths are counted
+    // in those)
+    uindex_t m_ReadIndex, m_AcceptedUnitIndex, m_UnitIndex;
+    
+    // Going backwards, for things like shared suffix
+    bool m_Reverse;
+};
+
 class MCTextFilter_EncodeUTF16 : public MCTextFilter_Encoder
 {
 private:
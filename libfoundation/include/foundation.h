@@ -1537,6 +1537,55 @@ MC_DLLEXPORT bool MCValueInter(MCValueRef value, MCValueRef& r_unique_value);
 //
 MC_DLLEXPORT bool MCValueInterAndRelease(MCValueRef value, MCValueRef& r_unique_value);
 
+// Returns an immutable copy of the value which can be passed to other threads
+// without copying. The copy, and every value it references, is marked as
+// shared so that its reference count is manipulated atomically by
+// MCValueRetain and MCValueRelease. Only nulls, booleans, numbers, names,
+// strings, data, sets, arrays and proper lists can be shared; the call fails
+// for any other kind of value.
+//
+// The global unique value table is not thread-safe, so the thread which
+// shares a value must keep its reference to it until every other thread has
+// released theirs - this ensures the value is destroyed on the thread that
+// created it. (Names are always shared, and can be created and released on any
+// thread.)
+//
+// Shared values are never changed in place. So functions which would convert
+// a string's chars in place (such as MCStringGetCharPtr on a native string)
+// fail for a shared string instead.
+MC_DLLEXPORT bool MCValueShare(MCValueRef value, MCValueRef& r_shared_value);
+
+// Returns true if the value has been shared with MCValueShare.
+MC_DLLEXPORT bool MCValueIsShared(MCValueRef value);
+
+// Statistics for the calling thread's value pools. Values of the fixed-size
+// types are allocated from slabs owned by the thread which creates them, and
+// are returned to those slabs (rather than the heap) when they are destroyed,
+// whichever thread destroys them.
+struct MCValuePoolStatistics
+{
+    // The number of values which were created from a slab the thread already
+    // had.
+    uindex_t hits;
+    // The number of values which needed a new slab to be allocated.
+    uindex_t misses;
+    // The number of times the pools have been trimmed.
+    uindex_t trims;
+    // The number of free values in the thread's slabs, and the memory they use.
+    uindex_t pooled;
+    size_t pooled_bytes;
+    // The number of slabs the thread owns.
+    uindex_t slabs;
+};
+
+// Fetch the statistics for the calling thread's value pools. A thread which
+// has never created a value has no pools, so all its statistics are zero.
+MC_DLLEXPORT void MCValuePoolGetStatistics(MCValuePoolStatistics& r_statistics);
+
+// Return the calling thread's slabs which have no values in use to the heap.
+// Values destroyed on other threads are collected first.
+MC_DLLEXPORT void MCValuePoolTrim(void);
+
 // Fetch the 'extra bytes' field for the given custom value.
 inline void *MCValueGetExtraBytesPtr(MCValueRef value) { return ((uint8_t *)value) + kMCValueCustomHeaderSize; }
 
@@ -1596,6 +1645,14 @@ template<typename T> inline bool MCValueInterAndRelease(T value, T& r_value)
 	return false;
 }
 
+template<typename T> inline bool MCValueShare(T value, T& r_value)
+{
+	MCValueRef t_shared_value;
+	if (MCValueShare(value, t_shared_value))
+		return r_value = (T)t_shared_value, true;
+	return false;
+}
+
 template<typename T> inline bool MCValueCreateCustom(MCTypeInfoRef type, size_t p_extra_bytes, T& r_value)
 {
 	MCValueRef t_value;
@@ -2329,14 +2386,16 @@ MC_DLLEXPORT uindex_t MCStringGetLength(const MCStringRef string);
 
 // Return a pointer to the char backing-store if possible. Note that if this
 // method returns nil, then GetChars() must be used to fetch the contents as
-// unicode codeunits.
+// unicode codeunits. This is always the case for a native shared string, as
+// it can't be converted in place.
 MC_DLLEXPORT const unichar_t *MCStringGetCharPtr(MCStringRef string);
 
 // Return a pointer to the native char backing-store if possible. Note that if
 // the method returns nil, then GetNativeChars() must be used to fetch the contents
 // in native encoding.
 MC_DLLEXPORT const char_t *MCStringGetNativeCharPtr(MCStringRef string);
-// The native length may be different from the string char count.
+// The native length may be different from the string char count. A shared
+// string which isn't native is never nativized, so this returns nil for it.
 MC_DLLEXPORT const char_t *MCStringGetNativeCharPtrAndLength(MCStringRef self, uindex_t& r_native_length);
 
 // Returns the Unicode codepoint at the given index
@@ -2361,7 +2420,7 @@ MC_DLLEXPORT uindex_t MCStringGetChars(MCStringRef string, MCRange range, unicha
 // that would be generated is returned. Any unmappable chars get generated as '?'.
 MC_DLLEXPORT uindex_t MCStringGetNativeChars(MCStringRef string, MCRange range, char_t *chars);
 
-// Nativize self
+// Nativize self (shared strings are left as they are)
 MC_DLLEXPORT void MCStringNativize(MCStringRef string);
 
 // Create a native copy of p_string
@@ -2793,6 +2852,30 @@ MC_DLLEXPORT bool MCNameCreateWithIndex(index_t p_index, MCNameRef& r_name);
 // Create a name using the given string, releasing the original.
 MC_DLLEXPORT bool MCNameCreateAndRelease(MCStringRef string, MCNameRef& r_name);
 
+// Storage for a name, and its string, which is made from constant chars
+// without allocating.
+struct MCNameStaticStorage
+{
+    uint64_t __opaque[10];
+};
+
+// A name to be made in static storage. The chars must be constant and are not
+// copied. The hash must be the caseless hash of the chars, as MCStringHash
+// computes it - it is computed when the engine is built.
+struct MCNameStaticInfo
+{
+    const char *cstring;
+    uindex_t length;
+    hash_t hash;
+    MCNameRef *name_var;
+};
+
+// Add each of the names to the name table, using the corresponding storage
+// rather than allocating, and return it retained in its name var. If a name
+// already exists, it is returned instead and its storage is left unused. The
+// storage must outlive the name table, and the names are never destroyed.
+MC_DLLEXPORT void MCNameCreateStatic(const MCNameStaticInfo *names, MCNameStaticStorage *storage, uindex_t count);
+
 // Looks for an existing name matching the given string.
 MC_DLLEXPORT MCNameRef MCNameLookupCaseless(MCStringRef string);
 // Looks for an existing name matching the given index.
@@ -2814,6 +2897,28 @@ MC_DLLEXPORT bool MCNameIsEqualTo(MCNameRef left, MCNameRef right, MCStringOptio
 // Returns true if the names are equal caselessly.
 MC_DLLEXPORT bool MCNameIsEqualToCaseless(MCNameRef left, MCNameRef right);
 
+// Statistics for the global name table. The table is split into shards, each
+// of which is a hash table of chains of caseless equivalence classes.
+struct MCNameTableStatistics
+{
+    // The number of names in the table, and the number of caseless
+    // equivalence classes they fall into.
+    uindex_t names;
+    uindex_t classes;
+    // The number of chains in the table, over all shards.
+    uindex_t capacity;
+    // The number of searches of the table made by all threads, the
+    // total number of classes they stepped over, and the most any one of them
+    // stepped over.
+    uindex_t lookups;
+    uindex_t probes;
+    uindex_t longest_probe;
+};
+
+// Fetch the statistics for the name table. Names can be created and looked up
+// on any thread, so the lookup counts cover all threads.
+MC_DLLEXPORT void MCNameTableGetStatistics(MCNameTableStatistics& r_statistics);
+
 // The empty name object;
 MC_DLLEXPORT extern MCNameRef kMCEmptyName;
 
@@ -2831,6 +2936,19 @@ MC_DLLEXPORT extern MCDataRef kMCEmptyData;
 MC_DLLEXPORT bool MCDataCreateWithBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCDataRef& r_data);
 MC_DLLEXPORT bool MCDataCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, MCDataRef& r_data);
 
+// Creates immutable data which uses the given bytes in place, rather than
+// copying them - for example, the contents of a memory-mapped file. The bytes
+// must not change while the data exists. When it is destroyed, the release
+// callback is called with the context so the bytes can be freed (or unmapped).
+typedef void (*MCDataReleaseBytesCallback)(void *context);
+MC_DLLEXPORT bool MCDataCreateWithExternalBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCDataReleaseBytesCallback p_release, void *p_context, MCDataRef& r_data);
+
+// Gives data created with MCDataCreateWithExternalBytes its own copy of the
+// bytes and calls the release callback; any slices of it follow along. This
+// is for when the external bytes are about to change, such as before a mapped
+// file is written to. Other data is left as it is.
+MC_DLLEXPORT bool MCDataDetachExternalBytes(MCDataRef p_data);
+
 // Creates data from existing data. The first variant exists to provide an
 // optimised implementation in the (very common) case of only two DataRefs.
 MC_DLLEXPORT bool MCDataCreateWithData(MCDataRef& r_string, MCDataRef p_one, MCDataRef p_two);
@@ -2913,6 +3031,20 @@ MC_DLLEXPORT bool MCArrayCreate(bool case_sensitive, const MCNameRef *keys, cons
 // Create an empty mutable array.
 MC_DLLEXPORT bool MCArrayCreateMutable(MCArrayRef& r_array);
 
+// The type describing options for creating arrays.
+typedef uint32_t MCArrayOptions;
+enum
+{
+	// Iteration visits the keys in the order they were first stored, rather
+	// than in an arbitrary order. Storing to an existing key doesn't change
+	// its position, removing a key and storing it again moves it to the end.
+	kMCArrayOptionKeepOrder = 1 << 0,
+};
+
+// Create an empty mutable array with the given options. The options are kept
+// by any copies of the array.
+MC_DLLEXPORT bool MCArrayCreateMutableWithOptions(MCArrayOptions options, MCArrayRef& r_array);
+
 // Make an immutable copy of the given array. If the 'copy and release' form is
 // used then the original array is released (has its reference count reduced by
 // one).
@@ -2928,6 +3060,10 @@ MC_DLLEXPORT bool MCArrayMutableCopyAndRelease(MCArrayRef array, MCArrayRef& r_n
 // Returns 'true' if the given array is mutable.
 MC_DLLEXPORT bool MCArrayIsMutable(MCArrayRef array);
 
+// Returns 'true' if the given array keeps its keys in the order they were
+// first stored. The order doesn't affect whether two arrays are equal.
+MC_DLLEXPORT bool MCArrayIsOrdered(MCArrayRef array);
+
 // Returns the number of elements in the array.
 MC_DLLEXPORT uindex_t MCArrayGetCount(MCArrayRef array);
 
@@ -3470,6 +3606,11 @@ MC_DLLEXPORT bool MCProperListConvertToForeignValues(MCProperListRef list, MCTyp
 // Create an empty mutable list.
 MC_DLLEXPORT bool MCProperListCreateMutable(MCProperListRef& r_list);
 
+// Make sure the given mutable list has room for 'capacity' elements, so that
+// adding elements up to that many doesn't reallocate it. The room which isn't
+// used is given back when the list is made immutable with 'copy and release'.
+MC_DLLEXPORT bool MCProperListReserve(MCProperListRef list, uindex_t capacity);
+
 // Create an immutable list taking ownership of the given array of
 // values.  Takes ownership of both the underlying MCValueRef
 // references, and the p_values buffer.
@@ -3765,6 +3906,11 @@ MC_DLLEXPORT bool MCTypeConvertStringToReal(MCStringRef p_string, real64_t& r_co
 MC_DLLEXPORT bool MCTypeConvertStringToBool(MCStringRef p_string, bool& r_converted);
 MC_DLLEXPORT bool MCTypeConvertDataToReal(MCDataRef p_data, real64_t& r_converted, bool p_convert_octals = false);
 
+// Formats a real number into the buffer exactly as the "%0*.*f" format would
+// with the given width and precision in the C locale, and nul-terminates it.
+// Returns false if the result doesn't fit into the buffer.
+MC_DLLEXPORT bool MCTypeConvertRealToFixedChars(real64_t p_real, uindex_t p_width, uindex_t p_precision, char *r_chars, uindex_t p_max_chars, uindex_t& r_length);
+
 }
     
 #endif
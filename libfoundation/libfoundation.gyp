@@ -14,6 +14,9 @@
 		'module_test_sources':
 		[
 			'test/environment.cpp',
+			'test/test_array.cpp',
+			'test/test_data.cpp',
+			'test/test_filters.cpp',
             'test/test_foreign.cpp',
 			'test/test_hash.cpp',
             'test/test_memory.cpp',
@@ -22,6 +25,7 @@
 			'test/test_string.cpp',
 			'test/test_typeconvert.cpp',
             'test/test_system-library.cpp',
+            'test/test_value.cpp',
 		],
 	},
 
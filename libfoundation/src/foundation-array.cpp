@@ -20,6 +20,18 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "foundation-private.h"
 
+#if defined(__SSE2__) || defined(__X86_64__)
+#include <emmintrin.h>
+#define __MCARRAY_USE_SSE2__ 1
+#elif defined(__ARM64__)
+#include <arm_neon.h>
+#define __MCARRAY_USE_NEON__ 1
+#endif
+
+#if defined(__VISUALC__)
+#include <intrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // Creates an indirect mutable array with contents.
@@ -46,8 +58,8 @@ static bool __MCArrayRehash(__MCArray *self, index_t by);
 // Returns the number of entries in the key-value table for the array.
 static uindex_t __MCArrayGetTableSize(__MCArray *self);
 
-// Returns the maximum number of entries for a given array size that minimises rehashing.
-static uindex_t __MCArrayGetTableCapacity(__MCArray *self);
+// Returns the maximum number of entries for a given table size index.
+static uindex_t __MCArrayGetTableCapacityForIndex(uindex_t index);
 
 // Looks for a key-value slot in the array with the given key. If the key was
 // found 'true' is returned; otherwise 'false'. On return 'slot' will be the
@@ -55,6 +67,141 @@ static uindex_t __MCArrayGetTableCapacity(__MCArray *self);
 // no more room (and the key isn't there).
 static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool case_sensitive, MCNameRef key, uindex_t& r_slot);
 
+// Returns true if a new key can be placed in the slot returned by a failed
+// lookup without rehashing first.
+static bool __MCArrayCanOccupySlot(__MCArray *self, uindex_t slot);
+
+// Places a new key-value in the given (unused) slot, retaining the key.
+static void __MCArrayOccupySlot(__MCArray *self, uindex_t slot, MCNameRef key, uintptr_t value);
+
+// Marks the given (used) slot as free, the key and value must have been
+// released by the caller.
+static void __MCArrayVacateSlot(__MCArray *self, uindex_t slot);
+
+// Frees the memory used by the key-value table of the array.
+static void __MCArrayDeallocateTable(__MCArrayKeyValue *key_values);
+
+// Returns the first free slot in the key-value table for the given hash.
+static uindex_t __MCArrayFindFreeSlot(__MCArray *self, hash_t hash);
+
+// Returns true if the array's values are stored densely.
+static bool __MCArrayIsDense(__MCArray *self);
+
+// Returns true if the array keeps its keys in insertion order.
+static bool __MCArrayIsOrdered(__MCArray *self);
+
+// Returns the insertion order list of an ordered key-value table, and its
+// length. The list holds slot indices, with UINDEX_MAX for removed keys.
+static uindex_t *__MCArrayGetTableOrder(__MCArray *self);
+static uindex_t& __MCArrayGetTableOrderLength(__MCArray *self);
+
+// Returns true if the key is the canonical form of an index which could be
+// used in a dense array (i.e. 1 or more).
+static bool __MCArrayGetKeyIndex(MCNameRef key, uindex_t& r_index);
+
+// Stores a value at the given index (1 to count + 1) of a dense (or empty)
+// array, taking ownership of the value on success.
+static bool __MCArrayDenseStoreValue(__MCArray *self, uindex_t index, MCValueRef value);
+
+// Stores a value on a path whose first element is an index of a dense (or
+// empty) array.
+static bool __MCArrayDenseStoreValueOnPath(__MCArray *self, bool case_sensitive, uindex_t index, const MCNameRef *path, uindex_t path_length, MCValueRef new_value);
+
+// Returns the name for the given index from the shared cache, creating it if
+// needed. Returns nil if the index is beyond the cache limit.
+static MCNameRef __MCArrayGetIndexName(uindex_t index);
+
+// Returns true if the array's key-values are stored in a trie.
+static bool __MCArrayIsTrie(__MCArray *self);
+
+// Builds a trie holding (and retaining) the key-values of a key-value table.
+static bool __MCArrayCreateTrieFromTable(__MCArray *table, __MCArrayTrieNode*& r_root);
+
+// Releases a reference to a trie node at the given depth (in hash bits).
+static void __MCArrayTrieNodeRelease(__MCArrayTrieNode *node, uindex_t shift);
+
+// Returns the key-value in the trie with the given key, or nil.
+static __MCArrayKeyValue *__MCArrayTrieNodeFind(__MCArrayTrieNode *node, uindex_t shift, hash_t hash, MCNameRef key, bool case_sensitive);
+
+// Returns the key-value at the given position in the trie's iteration order.
+static __MCArrayKeyValue *__MCArrayTrieNodeFetchAt(__MCArrayTrieNode *node, uindex_t shift, uindex_t ordinal);
+
+// Invokes the callback for each key-value in the trie.
+static bool __MCArrayTrieNodeApply(__MCArrayTrieNode *node, uindex_t shift, MCArrayRef array, MCArrayApplyCallback callback, void *context);
+
+// Replaces the values in the unshared nodes of the trie with immutable copies.
+static bool __MCArrayTrieNodeMakeContentsImmutable(__MCArrayTrieNode *node, uindex_t shift);
+
+// Stores or removes a value on a path in an array stored as a trie, copying
+// any shared nodes which need to change.
+static bool __MCArrayTrieStoreValueOnPath(__MCArray *self, bool case_sensitive, const MCNameRef *path, uindex_t path_length, MCValueRef new_value);
+static bool __MCArrayTrieRemoveValueOnPath(__MCArray *self, bool case_sensitive, const MCNameRef *path, uindex_t path_length);
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The key-value table is laid out as a Swiss table. The number of slots is a
+// power-of-two multiple of the group size, and alongside the slots is a control
+// byte for each one. The control byte of a used slot holds the low 7 bits of
+// the key's hash, while empty and deleted slots have the top bit set. A lookup
+// picks a group from the rest of the hash, compares the 16 control bytes in the
+// group at once and only looks at the keys whose hash fragment matches. Groups
+// are probed in turn until one containing an empty slot is found.
+//
+// The slots, control bytes and the number of empty slots which can still be
+// filled before the table must be rehashed are allocated as a single block:
+//   __MCArrayKeyValue slots[size]; uint8_t control[size]; uindex_t growth_left;
+//
+// Unused slots also keep the UINTPTR_MIN (empty) and UINTPTR_MAX (deleted)
+// value markers so that iteration doesn't need the control bytes.
+enum
+{
+	kMCArrayGroupSize = 16,
+
+	kMCArrayControlEmpty = 0x80,
+	kMCArrayControlDeleted = 0xfe,
+
+	// The largest table size index for which the table size fits in a uindex_t.
+	kMCArrayMaxTableSizeIndex = 28,
+
+	// The initial capacity index of a dense array (8 values).
+	kMCArrayDenseInitialCapacityIndex = 4,
+
+	// The largest index which will have its name cached for iterating dense
+	// arrays. Applying a function to a larger dense array uses temporary names
+	// for the rest of the keys, and iterating one converts it to a key-value
+	// table.
+	kMCArrayIndexNameCacheLimit = 65536,
+
+	// The number of key-values at which a key-value table which is about to
+	// be copied on write is switched to a trie instead.
+	kMCArrayTrieThreshold = 512,
+};
+
+// Arrays whose keys are exactly 1 to N (such as those produced by split) are
+// stored densely - the values are kept in order in a vector, and there is no
+// key-value table at all. An empty array becomes dense when index 1 is stored,
+// and a dense array reverts to a key-value table the first time a key which
+// would leave a gap is stored (or removed).
+//
+// Iteration has to hand out a name for each key, so these come from a cache of
+// index names shared by all dense arrays. Arrays can be iterated on any thread,
+// so the cache is guarded by a lock.
+static MCNameRef *s_array_index_names = nil;
+static uindex_t s_array_index_name_count = 0;
+static uint32_t s_array_index_name_lock = 0;
+
+// The low 7 bits of the hash are stored in the control byte, the rest pick the
+// group to start probing at.
+static inline uint8_t __MCArrayHashFragment(hash_t p_hash)
+{
+	return p_hash & 0x7f;
+}
+
+static inline uindex_t __MCArrayHashGroup(hash_t p_hash)
+{
+	return uindex_t(p_hash >> 7);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -104,6 +251,18 @@ bool MCArrayCreateMutable(MCArrayRef& r_array)
 	return true;
 }	
 
+MC_DLLEXPORT_DEF
+bool MCArrayCreateMutableWithOptions(MCArrayOptions p_options, MCArrayRef& r_array)
+{
+	if (!MCArrayCreateMutable(r_array))
+		return false;
+
+	if ((p_options & kMCArrayOptionKeepOrder) != 0)
+		r_array -> flags |= kMCArrayFlagIsOrdered;
+
+	return true;
+}
+
 MC_DLLEXPORT_DEF
 bool MCArrayCopy(MCArrayRef self, MCArrayRef& r_new_array)
 {
@@ -247,6 +406,59 @@ bool MCArrayApply(MCArrayRef self, MCArrayApplyCallback p_callback, void *p_cont
 	else
 		t_contents = self -> contents;
 
+	if (__MCArrayIsDense(t_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+		{
+			// Keys past the end of the index name cache are only needed for
+			// the duration of the callback.
+			if (i >= kMCArrayIndexNameCacheLimit)
+			{
+				MCNewAutoNameRef t_key;
+				if (!MCNameCreateWithIndex(i + 1, &t_key))
+					return false;
+
+				if (!p_callback(p_context, self, *t_key, t_contents -> dense_values[i]))
+					return false;
+
+				continue;
+			}
+
+			MCNameRef t_key;
+			t_key = __MCArrayGetIndexName(i + 1);
+			if (t_key == nil)
+				return false;
+
+			if (!p_callback(p_context, self, t_key, t_contents -> dense_values[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+	if (__MCArrayIsTrie(t_contents))
+		return __MCArrayTrieNodeApply(t_contents -> trie_root, 0, self, p_callback, p_context);
+
+	if (__MCArrayIsOrdered(t_contents) && t_contents -> key_values != nil)
+	{
+		uindex_t *t_order;
+		t_order = __MCArrayGetTableOrder(t_contents);
+
+		uindex_t t_order_length;
+		t_order_length = __MCArrayGetTableOrderLength(t_contents);
+		for(uindex_t i = 0; i < t_order_length; i++)
+		{
+			if (t_order[i] == UINDEX_MAX)
+				continue;
+
+			const __MCArrayKeyValue& t_entry = t_contents -> key_values[t_order[i]];
+			if (!p_callback(p_context, self, t_entry . key, (MCValueRef)t_entry . value))
+				return false;
+		}
+
+		return true;
+	}
+
 	uindex_t t_used;
 	t_used = t_contents -> key_value_count;
 
@@ -278,6 +490,74 @@ bool MCArrayIterate(MCArrayRef self, uintptr_t& x_iterator, MCNameRef& r_key, MC
 	else
 		t_contents = self -> contents;
 
+	// Dense arrays too large for the index name cache are switched to a table
+	// before iteration starts, as the keys handed out have to outlive the call.
+	// If that fails, then iteration ends.
+	if (x_iterator == 0 &&
+		__MCArrayIsDense(t_contents) &&
+		t_contents -> key_value_count > kMCArrayIndexNameCacheLimit)
+		if (!__MCArrayMakeSparse(t_contents))
+			return false;
+
+	if (__MCArrayIsDense(t_contents))
+	{
+		if (x_iterator >= t_contents -> key_value_count)
+			return false;
+
+		MCNameRef t_key;
+		t_key = __MCArrayGetIndexName(x_iterator + 1);
+		if (t_key == nil)
+			return false;
+
+		r_key = t_key;
+		r_value = t_contents -> dense_values[x_iterator];
+		x_iterator += 1;
+		return true;
+	}
+
+	// The iterator of a trie is the position in its iteration order.
+	if (__MCArrayIsTrie(t_contents))
+	{
+		if (x_iterator >= t_contents -> key_value_count)
+			return false;
+
+		__MCArrayKeyValue *t_entry;
+		t_entry = __MCArrayTrieNodeFetchAt(t_contents -> trie_root, 0, x_iterator);
+
+		r_key = t_entry -> key;
+		r_value = (MCValueRef)t_entry -> value;
+		x_iterator += 1;
+		return true;
+	}
+
+	// The iterator of an ordered table is the position in the order list.
+	if (__MCArrayIsOrdered(t_contents))
+	{
+		if (t_contents -> key_values == nil)
+			return false;
+
+		uindex_t *t_order;
+		t_order = __MCArrayGetTableOrder(t_contents);
+
+		uindex_t t_order_length;
+		t_order_length = __MCArrayGetTableOrderLength(t_contents);
+		while(x_iterator < t_order_length)
+		{
+			uindex_t t_slot;
+			t_slot = t_order[x_iterator];
+			x_iterator += 1;
+
+			if (t_slot != UINDEX_MAX)
+			{
+				r_key = t_contents -> key_values[t_slot] . key;
+				r_value = (MCValueRef)t_contents -> key_values[t_slot] . value;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	uindex_t t_count;
 	t_count = __MCArrayGetTableSize(t_contents);
 	if (x_iterator == t_count)
@@ -307,6 +587,14 @@ bool MCArrayIsMutable(MCArrayRef self)
 	return (self -> flags & kMCArrayFlagIsMutable) != 0;
 }
 
+MC_DLLEXPORT_DEF
+bool MCArrayIsOrdered(MCArrayRef self)
+{
+	__MCAssertIsArray(self);
+
+	return __MCArrayIsOrdered(self);
+}
+
 MC_DLLEXPORT_DEF
 uindex_t MCArrayGetCount(MCArrayRef self)
 {
@@ -340,14 +628,36 @@ bool MCArrayFetchValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 	else
 		t_contents = self -> contents;
 
-	// Lookup the slot for the first part of the path.
-	uindex_t t_slot;
-	if (!__MCArrayFindKeyValueSlot(t_contents, p_case_sensitive, p_path[0], t_slot))
-		return false;
-
-	// We found a slot successfully matching the key so get the value.
 	MCValueRef t_value;
-	t_value = (MCValueRef)t_contents -> key_values[t_slot] . value;
+	if (__MCArrayIsDense(t_contents))
+	{
+		// Only keys which are in-range indices can be present.
+		uindex_t t_index;
+		if (!__MCArrayGetKeyIndex(p_path[0], t_index) ||
+			t_index > t_contents -> key_value_count)
+			return false;
+
+		t_value = t_contents -> dense_values[t_index - 1];
+	}
+	else if (__MCArrayIsTrie(t_contents))
+	{
+		__MCArrayKeyValue *t_entry;
+		t_entry = __MCArrayTrieNodeFind(t_contents -> trie_root, 0, MCValueHash(p_path[0]), p_path[0], p_case_sensitive);
+		if (t_entry == nil)
+			return false;
+
+		t_value = (MCValueRef)t_entry -> value;
+	}
+	else
+	{
+		// Lookup the slot for the first part of the path.
+		uindex_t t_slot;
+		if (!__MCArrayFindKeyValueSlot(t_contents, p_case_sensitive, p_path[0], t_slot))
+			return false;
+
+		// We found a slot successfully matching the key so get the value.
+		t_value = (MCValueRef)t_contents -> key_values[t_slot] . value;
+	}
 
 	// If the path length is one, then we are done.
 	if (p_path_length == 1)
@@ -396,6 +706,22 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 		if (!__MCArrayResolveIndirect(self))
 			return false;
 
+	if (__MCArrayIsTrie(self))
+		return __MCArrayTrieStoreValueOnPath(self, p_case_sensitive, p_path, p_path_length, p_new_value);
+
+	// If the array is dense (or empty) it stays that way as long as the key is
+	// an existing index or the next one; otherwise it must become a table.
+	if (__MCArrayIsDense(self) || self -> key_value_count == 0)
+	{
+		uindex_t t_index;
+		if (__MCArrayGetKeyIndex(p_path[0], t_index) &&
+			t_index <= self -> key_value_count + 1)
+			return __MCArrayDenseStoreValueOnPath(self, p_case_sensitive, t_index, p_path, p_path_length, p_new_value);
+
+		if (!__MCArrayMakeSparse(self))
+			return false;
+	}
+
 	// Lookup the slot for the first element in the path.
 	bool t_found;
 	uindex_t t_slot;
@@ -435,7 +761,7 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 	else
 	{
         // AL-2014-07-15: [[ Bug 12532 ]] Rehash according to hash table capacities rather than sizes
-		if (t_slot == UINDEX_MAX || self -> key_value_count >= __MCArrayGetTableCapacity(self))
+		if (!__MCArrayCanOccupySlot(self, t_slot))
 		{
 			if (!__MCArrayRehash(self, 1))
 				return false;
@@ -445,9 +771,7 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 
 		if (p_path_length == 1)
 		{
-			self -> key_values[t_slot] . key = MCValueRetain(p_path[0]);
-			self -> key_values[t_slot] . value = (uintptr_t)MCValueRetain(p_new_value);
-			self -> key_value_count += 1;
+			__MCArrayOccupySlot(self, t_slot, p_path[0], (uintptr_t)MCValueRetain(p_new_value));
 			return true;
 		}
 	}
@@ -466,14 +790,12 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 
 	// We've successfully built the rest of the path, so replace or add the new key-value.
 	if (t_found)
-		MCValueRelease((MCValueRef)self -> key_values[t_slot] . value);
-	else
 	{
-		self -> key_values[t_slot] . key = MCValueRetain(p_path[0]);
-		self -> key_value_count += 1;
+		MCValueRelease((MCValueRef)self -> key_values[t_slot] . value);
+		self -> key_values[t_slot] . value = (uintptr_t)t_array;
 	}
-	
-	self -> key_values[t_slot] . value = (uintptr_t)t_array;
+	else
+		__MCArrayOccupySlot(self, t_slot, p_path[0], (uintptr_t)t_array);
 
 	return true;
 }
@@ -509,6 +831,53 @@ bool MCArrayRemoveValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNa
 		if (!__MCArrayResolveIndirect(self))
 			return false;
 
+	if (__MCArrayIsTrie(self))
+		return __MCArrayTrieRemoveValueOnPath(self, p_case_sensitive, p_path, p_path_length);
+
+	if (__MCArrayIsDense(self))
+	{
+		// If the key isn't an in-range index there is nothing to remove.
+		uindex_t t_index;
+		if (!__MCArrayGetKeyIndex(p_path[0], t_index) ||
+			t_index > self -> key_value_count)
+			return true;
+
+		MCValueRef t_value;
+		t_value = self -> dense_values[t_index - 1];
+
+		if (p_path_length == 1)
+		{
+			// Removing the last index keeps the array dense, removing any
+			// other leaves a gap so the array must become a table.
+			if (t_index == self -> key_value_count)
+			{
+				MCValueRelease(t_value);
+				self -> key_value_count -= 1;
+				return true;
+			}
+
+			if (!__MCArrayMakeSparse(self))
+				return false;
+		}
+		else
+		{
+			if (MCValueGetTypeCode(t_value) != kMCValueTypeCodeArray)
+				return true;
+
+			MCArrayRef t_mutable_array;
+			if (!MCArrayIsMutable((MCArrayRef)t_value))
+			{
+				if (!MCArrayMutableCopyAndRelease((MCArrayRef)t_value, t_mutable_array))
+					return false;
+				self -> dense_values[t_index - 1] = t_mutable_array;
+			}
+			else
+				t_mutable_array = (MCArrayRef)t_value;
+
+			return MCArrayRemoveValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1);
+		}
+	}
+
 	// Look up the first slot in the path.
 	uindex_t t_slot;
 	if (__MCArrayFindKeyValueSlot(self, p_case_sensitive, p_path[0], t_slot))
@@ -522,12 +891,10 @@ bool MCArrayRemoveValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNa
 			MCValueRelease(self -> key_values[t_slot] . key);
 			MCValueRelease(t_value);
 
-			self -> key_values[t_slot] . key = nil;
-			self -> key_values[t_slot] . value = UINTPTR_MAX;
-			self -> key_value_count -= 1;
+			__MCArrayVacateSlot(self, t_slot);
 
 			if (__MCArrayGetTableSizeIndex(self) > 2 &&
-				self -> key_value_count < __kMCValueHashTableCapacities[__MCArrayGetTableSizeIndex(self) - 2])
+				self -> key_value_count < __MCArrayGetTableCapacityForIndex(__MCArrayGetTableSizeIndex(self) - 2))
 				__MCArrayRehash(self, -1);
 
 			return true;
@@ -571,6 +938,22 @@ bool MCArrayFetchValueAtIndex(MCArrayRef self, index_t p_index, MCValueRef& r_va
 {
     __MCAssertIsArray(self);
     
+    MCArrayRef t_contents;
+    if (!__MCArrayIsIndirect(self))
+        t_contents = self;
+    else
+        t_contents = self -> contents;
+    
+    // Dense arrays can be indexed directly, without needing the name.
+    if (__MCArrayIsDense(t_contents))
+    {
+        if (p_index < 1 || uindex_t(p_index) > t_contents -> key_value_count)
+            return false;
+        
+        r_value = t_contents -> dense_values[p_index - 1];
+        return true;
+    }
+    
     MCNameRef t_key =
             MCNameLookupIndex(p_index);
     
@@ -586,6 +969,24 @@ MC_DLLEXPORT_DEF
 bool MCArrayStoreValueAtIndex(MCArrayRef self, index_t p_index, MCValueRef p_value)
 {
     __MCAssertIsArray(self);
+    MCAssert(MCArrayIsMutable(self));
+    
+    if (__MCArrayIsIndirect(self))
+        if (!__MCArrayResolveIndirect(self))
+            return false;
+    
+    // Storing an existing index, or the next one, in a dense (or empty) array
+    // doesn't need the name.
+    if ((__MCArrayIsDense(self) || self -> key_value_count == 0) &&
+        p_index >= 1 && uindex_t(p_index) <= self -> key_value_count + 1)
+    {
+        if (!__MCArrayDenseStoreValue(self, p_index, MCValueRetain(p_value)))
+        {
+            MCValueRelease(p_value);
+            return false;
+        }
+        return true;
+    }
     
     MCNewAutoNameRef t_key;
     if (!MCNameCreateWithIndex(p_index,
@@ -601,15 +1002,46 @@ bool
 MCArrayRemoveValueAtIndex(MCArrayRef self, index_t p_index)
 {
     __MCAssertIsArray(self);
+    MCAssert(MCArrayIsMutable(self));
     
+    if (__MCArrayIsIndirect(self))
+        if (!__MCArrayResolveIndirect(self))
+            return false;
+    
+    // Removing the last index of a dense array keeps it dense.
+    if (__MCArrayIsDense(self) &&
+        p_index >= 1 && uindex_t(p_index) == self -> key_value_count)
+    {
+        MCValueRelease(self -> dense_values[p_index - 1]);
+        self -> key_value_count -= 1;
+        return true;
+    }
+
+    // The keys of a dense array are never interned, so the name can't be
+    // looked up - it must be created.
+    if (__MCArrayIsDense(self))
+    {
+        if (p_index < 1 || uindex_t(p_index) > self -> key_value_count)
+            return true;
+
+        MCNewAutoNameRef t_index_key;
+        if (!MCNameCreateWithIndex(p_index,
+                                   &t_index_key))
+        {
+            return false;
+        }
+
+        return MCArrayRemoveValue(self, true, *t_index_key);
+    }
+
     MCNameRef t_key =
             MCNameLookupIndex(p_index);
-    
+
     if (t_key == nil)
     {
         return true;
     }
-    
+
     return MCArrayRemoveValue(self, true, t_key);
 }
 
@@ -627,7 +1059,8 @@ MC_DLLEXPORT_DEF
 bool MCArrayConvertToProperList(MCArrayRef p_array, MCProperListRef& r_list)
 {
     MCAutoProperListRef t_list;
-    if (!MCProperListCreateMutable(&t_list))
+    if (!MCProperListCreateMutable(&t_list) ||
+        !MCProperListReserve(*t_list, MCArrayGetCount(p_array)))
     {
         return false;
     }
@@ -663,6 +1096,15 @@ void __MCArrayDestroy(__MCArray *self)
 {
 	if (__MCArrayIsIndirect(self))
 		MCValueRelease(self -> contents);
+	else if (__MCArrayIsTrie(self))
+		__MCArrayTrieNodeRelease(self -> trie_root, 0);
+	else if (__MCArrayIsDense(self))
+	{
+		for(uindex_t i = 0; i < self -> key_value_count; i++)
+			MCValueRelease(self -> dense_values[i]);
+
+		MCMemoryDeallocate(self -> dense_values);
+	}
 	else
 	{
 		uindex_t t_used;
@@ -681,7 +1123,7 @@ void __MCArrayDestroy(__MCArray *self)
 			t_used -= 1;
 		}
 
-		MCMemoryDeleteArray(self -> key_values);
+		__MCArrayDeallocateTable(self -> key_values);
 	}
 }
 
@@ -690,6 +1132,13 @@ hash_t __MCArrayHash(__MCArray *self)
 	return (hash_t)self -> key_value_count;
 }
 
+static bool __MCArrayIsEqualToCallback(void *p_context, MCArrayRef p_array, MCNameRef p_key, MCValueRef p_value)
+{
+	MCValueRef t_other_value;
+	return MCArrayFetchValue((MCArrayRef)p_context, true, p_key, t_other_value) &&
+			MCValueIsEqualTo(p_value, t_other_value);
+}
+
 bool __MCArrayIsEqualTo(__MCArray *self, __MCArray *other_self)
 {
 	// If the array is indirect, get the contents.
@@ -709,6 +1158,50 @@ bool __MCArrayIsEqualTo(__MCArray *self, __MCArray *other_self)
 	if (t_contents -> key_value_count != t_other_contents -> key_value_count)
 		return false;
 
+	// If either array is dense then its keys are exactly 1 to count, so it is
+	// enough to check each of its values against the other array's.
+	if (__MCArrayIsDense(t_other_contents))
+	{
+		MCArrayRef t_swap;
+		t_swap = t_contents;
+		t_contents = t_other_contents;
+		t_other_contents = t_swap;
+	}
+
+	if (__MCArrayIsDense(t_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+		{
+			MCValueRef t_other_value;
+			if (!MCArrayFetchValueAtIndex(t_other_contents, i + 1, t_other_value))
+				return false;
+
+			if (!MCValueIsEqualTo(t_contents -> dense_values[i], t_other_value))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Otherwise if either array is a trie, each of its keys is looked up in
+	// the other array. Arrays sharing the same trie are trivially equal.
+	if (__MCArrayIsTrie(t_other_contents))
+	{
+		MCArrayRef t_swap;
+		t_swap = t_contents;
+		t_contents = t_other_contents;
+		t_other_contents = t_swap;
+	}
+
+	if (__MCArrayIsTrie(t_contents))
+	{
+		if (__MCArrayIsTrie(t_other_contents) &&
+			t_contents -> trie_root == t_other_contents -> trie_root)
+			return true;
+
+		return __MCArrayTrieNodeApply(t_contents -> trie_root, 0, t_contents, __MCArrayIsEqualToCallback, t_other_contents);
+	}
+
 	uindex_t t_used;
 	t_used = t_contents -> key_value_count;
 
@@ -787,6 +1280,7 @@ static bool __MCArrayCreateIndirect(__MCArray *p_contents, __MCArray*& r_array)
 		return false;
 
 	self -> flags |= kMCArrayFlagIsMutable | kMCArrayFlagIsIndirect;
+	self -> flags |= p_contents -> flags & kMCArrayFlagIsOrdered;
 	self -> contents = MCValueRetain(p_contents);
 
 	r_array = self;
@@ -803,39 +1297,1143 @@ static void __MCArraySetTableSizeIndex(__MCArray *self, uindex_t p_new_index)
 	self -> flags = (self -> flags & ~kMCArrayFlagCapacityIndexMask) | p_new_index;
 }
 
-static uindex_t __MCArrayGetTableSize(__MCArray *self)
+static uindex_t __MCArrayGetTableSizeForIndex(uindex_t p_index)
 {
-	return __kMCValueHashTableSizes[self -> flags & kMCArrayFlagCapacityIndexMask];
+	if (p_index == 0)
+		return 0;
+	return kMCArrayGroupSize << (p_index - 1);
 }
 
-static uindex_t __MCArrayGetTableCapacity(__MCArray *self)
+static uindex_t __MCArrayGetTableCapacityForIndex(uindex_t p_index)
 {
-	return __kMCValueHashTableCapacities[self -> flags & kMCArrayFlagCapacityIndexMask];
+	// Tables are allowed to become 7/8 full before they are rehashed.
+	uindex_t t_size;
+	t_size = __MCArrayGetTableSizeForIndex(p_index);
+	return t_size - t_size / 8;
 }
 
-static bool __MCArrayIsIndirect(__MCArray *self)
+static uindex_t __MCArrayGetTableSize(__MCArray *self)
 {
-	return (self -> flags & kMCArrayFlagIsIndirect) != 0;
+	return __MCArrayGetTableSizeForIndex(__MCArrayGetTableSizeIndex(self));
 }
 
-static bool __MCArrayMakeContentsImmutable(__MCArray *self)
+static uint8_t *__MCArrayGetTableControl(__MCArray *self)
 {
-	uindex_t t_used, t_count;
-	t_used = self -> key_value_count;
-	t_count = __MCArrayGetTableSize(self);
-	for(uindex_t i = 0; t_used > 0 && i < t_count; i++)
-	{
-		if (self -> key_values[i] . value != UINTPTR_MIN && self -> key_values[i] . value != UINTPTR_MAX)
-		{
-			__MCValue *t_new_value;
-			if (!__MCValueImmutableCopy((__MCValue *)self -> key_values[i] . value, true, t_new_value))
-				return false;
-
-			self -> key_values[i] . value = (uintptr_t)t_new_value;
-		}
-	}
-
-	return true;
+	return reinterpret_cast<uint8_t *>(self -> key_values + __MCArrayGetTableSize(self));
+}
+
+static uindex_t& __MCArrayGetTableGrowthLeft(__MCArray *self)
+{
+	return *reinterpret_cast<uindex_t *>(__MCArrayGetTableControl(self) + __MCArrayGetTableSize(self));
+}
+
+static uindex_t& __MCArrayGetTableOrderLength(__MCArray *self)
+{
+	return (&__MCArrayGetTableGrowthLeft(self))[1];
+}
+
+static uindex_t *__MCArrayGetTableOrder(__MCArray *self)
+{
+	return &__MCArrayGetTableGrowthLeft(self) + 2;
+}
+
+static size_t __MCArrayGetTableByteSize(uindex_t p_size, bool p_ordered)
+{
+	size_t t_byte_size;
+	t_byte_size = p_size * (sizeof(__MCArrayKeyValue) + 1) + sizeof(uindex_t);
+
+	// An ordered table has room in its order list for every slot which can be
+	// used, plus the length of the list.
+	if (p_ordered)
+		t_byte_size += (p_size - p_size / 8 + 1) * sizeof(uindex_t);
+
+	return t_byte_size;
+}
+
+static bool __MCArrayAllocateTable(uindex_t p_size, bool p_ordered, __MCArrayKeyValue*& r_key_values)
+{
+	if (p_size == 0)
+	{
+		r_key_values = nil;
+		return true;
+	}
+
+	void *t_block;
+	if (!MCMemoryAllocate(__MCArrayGetTableByteSize(p_size, p_ordered), t_block))
+		return false;
+
+	// All slots start off empty - both in the control bytes and in the
+	// key-values themselves (which is what iteration looks at).
+	__MCArrayKeyValue *t_key_values;
+	t_key_values = static_cast<__MCArrayKeyValue *>(t_block);
+	MCMemoryClear(t_key_values, p_size * sizeof(__MCArrayKeyValue));
+
+	uint8_t *t_control;
+	t_control = reinterpret_cast<uint8_t *>(t_key_values + p_size);
+	memset(t_control, kMCArrayControlEmpty, p_size);
+
+	uindex_t t_growth_left;
+	t_growth_left = p_size - p_size / 8;
+	MCMemoryCopy(t_control + p_size, &t_growth_left, sizeof(uindex_t));
+
+	if (p_ordered)
+	{
+		uindex_t t_order_length;
+		t_order_length = 0;
+		MCMemoryCopy(t_control + p_size + sizeof(uindex_t), &t_order_length, sizeof(uindex_t));
+	}
+
+	r_key_values = t_key_values;
+	return true;
+}
+
+static void __MCArrayDeallocateTable(__MCArrayKeyValue *p_key_values)
+{
+	MCMemoryDeallocate(p_key_values);
+}
+
+static bool __MCArrayIsIndirect(__MCArray *self)
+{
+	return (self -> flags & kMCArrayFlagIsIndirect) != 0;
+}
+
+static bool __MCArrayIsDense(__MCArray *self)
+{
+	return (self -> flags & kMCArrayFlagIsDense) != 0;
+}
+
+static bool __MCArrayIsOrdered(__MCArray *self)
+{
+	return (self -> flags & kMCArrayFlagIsOrdered) != 0;
+}
+
+static uindex_t __MCArrayGetDenseCapacity(__MCArray *self)
+{
+	uindex_t t_index;
+	t_index = __MCArrayGetTableSizeIndex(self);
+	if (t_index == 0)
+		return 0;
+	return 1U << (t_index - 1);
+}
+
+static bool __MCArrayGetKeyIndex(MCNameRef p_key, uindex_t& r_index)
+{
+	MCStringRef t_string;
+	t_string = MCNameGetString(p_key);
+
+	// Index names are always native, and only the canonical form (no sign, no
+	// leading zeros) is the same key as the index. Nine digits is the most
+	// which can't overflow.
+	uindex_t t_length;
+	t_length = MCStringGetLength(t_string);
+	if (t_length == 0 || t_length > 9 || !MCStringIsNative(t_string))
+		return false;
+
+	const char_t *t_chars;
+	t_chars = MCStringGetNativeCharPtr(t_string);
+	if (t_chars == nil || t_chars[0] < '1' || t_chars[0] > '9')
+		return false;
+
+	uindex_t t_index;
+	t_index = 0;
+	for(uindex_t i = 0; i < t_length; i++)
+	{
+		if (t_chars[i] < '0' || t_chars[i] > '9')
+			return false;
+		t_index = t_index * 10 + (t_chars[i] - '0');
+	}
+
+	r_index = t_index;
+	return true;
+}
+
+static bool __MCArrayDenseStoreValue(__MCArray *self, uindex_t p_index, MCValueRef p_value)
+{
+	MCAssert(p_index >= 1 && p_index <= self -> key_value_count + 1);
+
+	// An empty array switches to being dense - it might have an (empty)
+	// key-value table which is no longer needed.
+	if (!__MCArrayIsDense(self))
+	{
+		MCAssert(self -> key_value_count == 0);
+		__MCArrayDeallocateTable(self -> key_values);
+		self -> dense_values = nil;
+		__MCArraySetTableSizeIndex(self, 0);
+		self -> flags |= kMCArrayFlagIsDense;
+	}
+
+	if (p_index <= self -> key_value_count)
+	{
+		MCValueRelease(self -> dense_values[p_index - 1]);
+		self -> dense_values[p_index - 1] = p_value;
+		return true;
+	}
+
+	// Appending, so grow geometrically if there is no room.
+	if (self -> key_value_count == __MCArrayGetDenseCapacity(self))
+	{
+		uindex_t t_new_index;
+		t_new_index = MCMax(__MCArrayGetTableSizeIndex(self) + 1, uindex_t(kMCArrayDenseInitialCapacityIndex));
+		if (t_new_index > kMCArrayMaxTableSizeIndex)
+			return false;
+
+		MCValueRef *t_new_values;
+		if (!MCMemoryReallocate(self -> dense_values, (1U << (t_new_index - 1)) * sizeof(MCValueRef), t_new_values))
+			return false;
+
+		self -> dense_values = t_new_values;
+		__MCArraySetTableSizeIndex(self, t_new_index);
+	}
+
+	self -> dense_values[self -> key_value_count] = p_value;
+	self -> key_value_count += 1;
+	return true;
+}
+
+static bool __MCArrayDenseStoreValueOnPath(__MCArray *self, bool p_case_sensitive, uindex_t p_index, const MCNameRef *p_path, uindex_t p_path_length, MCValueRef p_new_value)
+{
+	if (p_path_length == 1)
+	{
+		if (!__MCArrayDenseStoreValue(self, p_index, MCValueRetain(p_new_value)))
+		{
+			MCValueRelease(p_new_value);
+			return false;
+		}
+		return true;
+	}
+
+	// If there is already an array at the index then recurse into it, making
+	// it mutable first if needs be.
+	if (p_index <= self -> key_value_count &&
+		MCValueGetTypeCode(self -> dense_values[p_index - 1]) == kMCValueTypeCodeArray)
+	{
+		MCArrayRef t_mutable_array;
+		if (!MCArrayIsMutable((MCArrayRef)self -> dense_values[p_index - 1]))
+		{
+			if (!MCArrayMutableCopyAndRelease((MCArrayRef)self -> dense_values[p_index - 1], t_mutable_array))
+				return false;
+			self -> dense_values[p_index - 1] = t_mutable_array;
+		}
+		else
+			t_mutable_array = (MCArrayRef)self -> dense_values[p_index - 1];
+
+		return MCArrayStoreValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value);
+	}
+
+	// Otherwise build a new array for the rest of the path.
+	MCArrayRef t_array;
+	if (!MCArrayCreateMutable(t_array))
+		return false;
+
+	if (!MCArrayStoreValueOnPath(t_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value) ||
+		!__MCArrayDenseStoreValue(self, p_index, t_array))
+	{
+		MCValueRelease(t_array);
+		return false;
+	}
+
+	return true;
+}
+
+static MCNameRef __MCArrayGetIndexName(uindex_t p_index)
+{
+	if (p_index > kMCArrayIndexNameCacheLimit)
+		return nil;
+
+	// The lock is only held for long while the cache grows, so just spin.
+	while(!__MCAtomicCompareAndSwap(s_array_index_name_lock, 0, 1))
+		continue;
+
+	MCNameRef t_name;
+	t_name = nil;
+
+	bool t_success;
+	t_success = true;
+
+	if (p_index > s_array_index_name_count)
+	{
+		uindex_t t_new_count;
+		t_new_count = MCMin(MCMax(p_index, s_array_index_name_count * 2), uindex_t(kMCArrayIndexNameCacheLimit));
+		t_success = MCMemoryResizeArray(t_new_count, s_array_index_names, s_array_index_name_count);
+	}
+
+	if (t_success &&
+		s_array_index_names[p_index - 1] == nil)
+		t_success = MCNameCreateWithIndex(p_index, s_array_index_names[p_index - 1]);
+
+	if (t_success)
+		t_name = s_array_index_names[p_index - 1];
+
+	__MCAtomicCompareAndSwap(s_array_index_name_lock, 1, 0);
+
+	return t_name;
+}
+
+// Large arrays which get copied are stored as a hash array mapped trie (in the
+// 'compressed' CHAMP form). Each node consumes 5 bits of the key hash and has a
+// bitmap of the fragments for which it holds a key-value inline, and another
+// for which it has a child node. Nodes are reference counted, and a node with
+// more than one reference is never modified - instead the path to it is copied
+// first. This means that copying an array just shares the root node, and a
+// subsequent store only copies the nodes on the path to the key.
+//
+// Once the hash bits run out, nodes become collision nodes which hold a plain
+// list of key-values (these occur for case-sensitive arrays whose keys differ
+// only in case).
+//
+// Any node with a single reference that is reachable from a mutable array can
+// be modified in place, and contain mutable values. A shared node, and anything
+// reachable from it, only contains immutable values since it was made
+// immutable when the array was first copied.
+struct __MCArrayTrieNode
+{
+	uint32_t references;
+	// The number of key-values in the subtree rooted at this node.
+	uint32_t count;
+	uint32_t datamap;
+	uint32_t nodemap;
+	// Followed by the inline key-values, then the child node pointers.
+};
+
+enum
+{
+	kMCArrayTrieFragmentBits = 5,
+	kMCArrayTrieHashBits = sizeof(hash_t) * 8,
+};
+
+static inline uindex_t __MCArrayPopCount(uint32_t p_bits)
+{
+#if defined(__VISUALC__)
+	return __popcnt(p_bits);
+#else
+	return __builtin_popcount(p_bits);
+#endif
+}
+
+static inline uint32_t __MCArrayTrieFragmentBit(hash_t p_hash, uindex_t p_shift)
+{
+	return 1U << ((p_hash >> p_shift) & ((1 << kMCArrayTrieFragmentBits) - 1));
+}
+
+static inline bool __MCArrayTrieIsCollisionLevel(uindex_t p_shift)
+{
+	return p_shift >= kMCArrayTrieHashBits;
+}
+
+static inline uindex_t __MCArrayTrieNodeDataCount(const __MCArrayTrieNode *p_node, uindex_t p_shift)
+{
+	if (__MCArrayTrieIsCollisionLevel(p_shift))
+		return p_node -> count;
+	return __MCArrayPopCount(p_node -> datamap);
+}
+
+static inline uindex_t __MCArrayTrieNodeChildCount(const __MCArrayTrieNode *p_node)
+{
+	return __MCArrayPopCount(p_node -> nodemap);
+}
+
+static inline __MCArrayKeyValue *__MCArrayTrieNodeData(__MCArrayTrieNode *p_node)
+{
+	return reinterpret_cast<__MCArrayKeyValue *>(p_node + 1);
+}
+
+static inline __MCArrayTrieNode **__MCArrayTrieNodeChildren(__MCArrayTrieNode *p_node, uindex_t p_shift)
+{
+	return reinterpret_cast<__MCArrayTrieNode **>(__MCArrayTrieNodeData(p_node) + __MCArrayTrieNodeDataCount(p_node, p_shift));
+}
+
+static inline size_t __MCArrayTrieNodeByteSize(uindex_t p_data_count, uindex_t p_child_count)
+{
+	return sizeof(__MCArrayTrieNode) + p_data_count * sizeof(__MCArrayKeyValue) + p_child_count * sizeof(__MCArrayTrieNode *);
+}
+
+static inline bool __MCArrayTrieEntryMatches(const __MCArrayKeyValue& p_entry, hash_t p_hash, MCNameRef p_key, bool p_case_sensitive)
+{
+	return p_entry . hash == p_hash &&
+		MCNameIsEqualTo(p_entry . key, p_key, !p_case_sensitive ? kMCStringOptionCompareCaseless : kMCStringOptionCompareExact);
+}
+
+static bool __MCArrayTrieNodeCreate(uindex_t p_data_count, uindex_t p_child_count, __MCArrayTrieNode*& r_node)
+{
+	__MCArrayTrieNode *t_node;
+	if (!MCMemoryAllocate(__MCArrayTrieNodeByteSize(p_data_count, p_child_count), t_node))
+		return false;
+
+	t_node -> references = 1;
+	t_node -> count = 0;
+	t_node -> datamap = 0;
+	t_node -> nodemap = 0;
+
+	r_node = t_node;
+	return true;
+}
+
+static void __MCArrayTrieNodeRelease(__MCArrayTrieNode *p_node, uindex_t p_shift)
+{
+	if (p_node == nil)
+		return;
+
+	p_node -> references -= 1;
+	if (p_node -> references > 0)
+		return;
+
+	uindex_t t_data_count;
+	t_data_count = __MCArrayTrieNodeDataCount(p_node, p_shift);
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(p_node);
+	for(uindex_t i = 0; i < t_data_count; i++)
+	{
+		MCValueRelease(t_data[i] . key);
+		MCValueRelease((MCValueRef)t_data[i] . value);
+	}
+
+	__MCArrayTrieNode **t_children;
+	t_children = __MCArrayTrieNodeChildren(p_node, p_shift);
+	for(uindex_t i = 0; i < __MCArrayTrieNodeChildCount(p_node); i++)
+		__MCArrayTrieNodeRelease(t_children[i], p_shift + kMCArrayTrieFragmentBits);
+
+	MCMemoryDeallocate(p_node);
+}
+
+// Ensures the node is only referenced from the slot passed in, copying it if
+// necessary.
+static bool __MCArrayTrieNodeMakeUnique(__MCArrayTrieNode*& x_node, uindex_t p_shift)
+{
+	if (x_node -> references == 1)
+		return true;
+
+	uindex_t t_data_count, t_child_count;
+	t_data_count = __MCArrayTrieNodeDataCount(x_node, p_shift);
+	t_child_count = __MCArrayTrieNodeChildCount(x_node);
+
+	__MCArrayTrieNode *t_copy;
+	if (!MCMemoryAllocateCopy(x_node, __MCArrayTrieNodeByteSize(t_data_count, t_child_count), t_copy))
+		return false;
+
+	t_copy -> references = 1;
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(t_copy);
+	for(uindex_t i = 0; i < t_data_count; i++)
+	{
+		MCValueRetain(t_data[i] . key);
+		MCValueRetain((MCValueRef)t_data[i] . value);
+	}
+
+	__MCArrayTrieNode **t_children;
+	t_children = __MCArrayTrieNodeChildren(t_copy, p_shift);
+	for(uindex_t i = 0; i < t_child_count; i++)
+		t_children[i] -> references += 1;
+
+	x_node -> references -= 1;
+	x_node = t_copy;
+
+	return true;
+}
+
+static __MCArrayKeyValue *__MCArrayTrieNodeFind(__MCArrayTrieNode *p_node, uindex_t p_shift, hash_t p_hash, MCNameRef p_key, bool p_case_sensitive)
+{
+	for(;;)
+	{
+		__MCArrayKeyValue *t_data;
+		t_data = __MCArrayTrieNodeData(p_node);
+
+		if (__MCArrayTrieIsCollisionLevel(p_shift))
+		{
+			for(uindex_t i = 0; i < p_node -> count; i++)
+				if (__MCArrayTrieEntryMatches(t_data[i], p_hash, p_key, p_case_sensitive))
+					return &t_data[i];
+			return nil;
+		}
+
+		uint32_t t_bit;
+		t_bit = __MCArrayTrieFragmentBit(p_hash, p_shift);
+
+		if ((p_node -> datamap & t_bit) != 0)
+		{
+			__MCArrayKeyValue *t_entry;
+			t_entry = &t_data[__MCArrayPopCount(p_node -> datamap & (t_bit - 1))];
+			if (!__MCArrayTrieEntryMatches(*t_entry, p_hash, p_key, p_case_sensitive))
+				return nil;
+			return t_entry;
+		}
+
+		if ((p_node -> nodemap & t_bit) == 0)
+			return nil;
+
+		p_node = __MCArrayTrieNodeChildren(p_node, p_shift)[__MCArrayPopCount(p_node -> nodemap & (t_bit - 1))];
+		p_shift += kMCArrayTrieFragmentBits;
+	}
+}
+
+// Finds the key-value for the key, making every node on the path to it unique
+// so that the value can be changed. On return r_entry is nil if the key wasn't
+// found. Returns false if memory couldn't be allocated.
+static bool __MCArrayTrieNodeFindMutable(__MCArrayTrieNode*& x_node, uindex_t p_shift, hash_t p_hash, MCNameRef p_key, bool p_case_sensitive, __MCArrayKeyValue*& r_entry)
+{
+	if (!__MCArrayTrieNodeMakeUnique(x_node, p_shift))
+		return false;
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(x_node);
+
+	if (__MCArrayTrieIsCollisionLevel(p_shift))
+	{
+		r_entry = nil;
+		for(uindex_t i = 0; i < x_node -> count; i++)
+			if (__MCArrayTrieEntryMatches(t_data[i], p_hash, p_key, p_case_sensitive))
+			{
+				r_entry = &t_data[i];
+				break;
+			}
+		return true;
+	}
+
+	uint32_t t_bit;
+	t_bit = __MCArrayTrieFragmentBit(p_hash, p_shift);
+
+	if ((x_node -> datamap & t_bit) != 0)
+	{
+		__MCArrayKeyValue *t_entry;
+		t_entry = &t_data[__MCArrayPopCount(x_node -> datamap & (t_bit - 1))];
+		r_entry = __MCArrayTrieEntryMatches(*t_entry, p_hash, p_key, p_case_sensitive) ? t_entry : nil;
+		return true;
+	}
+
+	if ((x_node -> nodemap & t_bit) == 0)
+	{
+		r_entry = nil;
+		return true;
+	}
+
+	__MCArrayTrieNode **t_child;
+	t_child = &__MCArrayTrieNodeChildren(x_node, p_shift)[__MCArrayPopCount(x_node -> nodemap & (t_bit - 1))];
+	return __MCArrayTrieNodeFindMutable(*t_child, p_shift + kMCArrayTrieFragmentBits, p_hash, p_key, p_case_sensitive, r_entry);
+}
+
+// Creates a node (and any children needed) holding two key-values whose hashes
+// agree up to the given shift.
+static bool __MCArrayTrieNodeCreatePair(uindex_t p_shift, const __MCArrayKeyValue& p_first, const __MCArrayKeyValue& p_second, __MCArrayTrieNode*& r_node)
+{
+	if (__MCArrayTrieIsCollisionLevel(p_shift))
+	{
+		if (!__MCArrayTrieNodeCreate(2, 0, r_node))
+			return false;
+
+		__MCArrayTrieNodeData(r_node)[0] = p_first;
+		__MCArrayTrieNodeData(r_node)[1] = p_second;
+		r_node -> count = 2;
+		return true;
+	}
+
+	uint32_t t_first_bit, t_second_bit;
+	t_first_bit = __MCArrayTrieFragmentBit(p_first . hash, p_shift);
+	t_second_bit = __MCArrayTrieFragmentBit(p_second . hash, p_shift);
+
+	if (t_first_bit == t_second_bit)
+	{
+		__MCArrayTrieNode *t_node;
+		if (!__MCArrayTrieNodeCreate(0, 1, t_node))
+			return false;
+
+		__MCArrayTrieNode *t_child;
+		if (!__MCArrayTrieNodeCreatePair(p_shift + kMCArrayTrieFragmentBits, p_first, p_second, t_child))
+		{
+			MCMemoryDeallocate(t_node);
+			return false;
+		}
+
+		t_node -> nodemap = t_first_bit;
+		t_node -> count = 2;
+		__MCArrayTrieNodeChildren(t_node, p_shift)[0] = t_child;
+
+		r_node = t_node;
+		return true;
+	}
+
+	if (!__MCArrayTrieNodeCreate(2, 0, r_node))
+		return false;
+
+	// Inline key-values are kept in fragment order.
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(r_node);
+	t_data[t_first_bit < t_second_bit ? 0 : 1] = p_first;
+	t_data[t_first_bit < t_second_bit ? 1 : 0] = p_second;
+	r_node -> datamap = t_first_bit | t_second_bit;
+	r_node -> count = 2;
+	return true;
+}
+
+// Inserts a key-value whose key is known not to be present into the (unique)
+// node, taking over its references on success.
+static bool __MCArrayTrieNodeInsert(__MCArrayTrieNode*& x_node, uindex_t p_shift, const __MCArrayKeyValue& p_entry)
+{
+	uindex_t t_data_count, t_child_count;
+	t_data_count = __MCArrayTrieNodeDataCount(x_node, p_shift);
+	t_child_count = __MCArrayTrieNodeChildCount(x_node);
+
+	if (__MCArrayTrieIsCollisionLevel(p_shift))
+	{
+		__MCArrayTrieNode *t_node;
+		if (!MCMemoryReallocate(x_node, __MCArrayTrieNodeByteSize(t_data_count + 1, 0), t_node))
+			return false;
+
+		__MCArrayTrieNodeData(t_node)[t_data_count] = p_entry;
+		t_node -> count += 1;
+
+		x_node = t_node;
+		return true;
+	}
+
+	uint32_t t_bit;
+	t_bit = __MCArrayTrieFragmentBit(p_entry . hash, p_shift);
+
+	if ((x_node -> nodemap & t_bit) != 0)
+	{
+		__MCArrayTrieNode **t_child;
+		t_child = &__MCArrayTrieNodeChildren(x_node, p_shift)[__MCArrayPopCount(x_node -> nodemap & (t_bit - 1))];
+		if (!__MCArrayTrieNodeMakeUnique(*t_child, p_shift + kMCArrayTrieFragmentBits) ||
+			!__MCArrayTrieNodeInsert(*t_child, p_shift + kMCArrayTrieFragmentBits, p_entry))
+			return false;
+
+		x_node -> count += 1;
+		return true;
+	}
+
+	uindex_t t_data_index;
+	t_data_index = __MCArrayPopCount(x_node -> datamap & (t_bit - 1));
+
+	if ((x_node -> datamap & t_bit) != 0)
+	{
+		// The fragment is taken by another key-value, so both move down into
+		// a new child node.
+		__MCArrayTrieNode *t_new_child;
+		if (!__MCArrayTrieNodeCreatePair(p_shift + kMCArrayTrieFragmentBits, __MCArrayTrieNodeData(x_node)[t_data_index], p_entry, t_new_child))
+			return false;
+
+		// A child pointer is never larger than a key-value, so this can be
+		// done in place.
+		uindex_t t_child_index;
+		t_child_index = __MCArrayPopCount(x_node -> nodemap & (t_bit - 1));
+
+		__MCArrayKeyValue *t_data;
+		t_data = __MCArrayTrieNodeData(x_node);
+
+		__MCArrayTrieNode **t_old_children;
+		t_old_children = reinterpret_cast<__MCArrayTrieNode **>(t_data + t_data_count);
+
+		MCMemoryMove(t_data + t_data_index, t_data + t_data_index + 1, (t_data_count - t_data_index - 1) * sizeof(__MCArrayKeyValue));
+
+		__MCArrayTrieNode **t_new_children;
+		t_new_children = reinterpret_cast<__MCArrayTrieNode **>(t_data + t_data_count - 1);
+		MCMemoryMove(t_new_children, t_old_children, t_child_index * sizeof(__MCArrayTrieNode *));
+		MCMemoryMove(t_new_children + t_child_index + 1, t_old_children + t_child_index, (t_child_count - t_child_index) * sizeof(__MCArrayTrieNode *));
+		t_new_children[t_child_index] = t_new_child;
+
+		x_node -> datamap &= ~t_bit;
+		x_node -> nodemap |= t_bit;
+		x_node -> count += 1;
+		return true;
+	}
+
+	// Otherwise the key-value goes inline in this node.
+	__MCArrayTrieNode *t_node;
+	if (!MCMemoryReallocate(x_node, __MCArrayTrieNodeByteSize(t_data_count + 1, t_child_count), t_node))
+		return false;
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(t_node);
+	MCMemoryMove(t_data + t_data_count + 1, t_data + t_data_count, t_child_count * sizeof(__MCArrayTrieNode *));
+	MCMemoryMove(t_data + t_data_index + 1, t_data + t_data_index, (t_data_count - t_data_index) * sizeof(__MCArrayKeyValue));
+	t_data[t_data_index] = p_entry;
+
+	t_node -> datamap |= t_bit;
+	t_node -> count += 1;
+
+	x_node = t_node;
+	return true;
+}
+
+// Removes the key-value for a key which is known to be present from the
+// (unique) node.
+static bool __MCArrayTrieNodeRemove(__MCArrayTrieNode*& x_node, uindex_t p_shift, hash_t p_hash, MCNameRef p_key, bool p_case_sensitive)
+{
+	uindex_t t_data_count, t_child_count;
+	t_data_count = __MCArrayTrieNodeDataCount(x_node, p_shift);
+	t_child_count = __MCArrayTrieNodeChildCount(x_node);
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(x_node);
+
+	uindex_t t_data_index;
+	if (__MCArrayTrieIsCollisionLevel(p_shift))
+	{
+		for(t_data_index = 0; t_data_index < t_data_count; t_data_index++)
+			if (__MCArrayTrieEntryMatches(t_data[t_data_index], p_hash, p_key, p_case_sensitive))
+				break;
+		MCAssert(t_data_index < t_data_count);
+	}
+	else
+	{
+		uint32_t t_bit;
+		t_bit = __MCArrayTrieFragmentBit(p_hash, p_shift);
+
+		if ((x_node -> datamap & t_bit) == 0)
+		{
+			uindex_t t_child_index;
+			t_child_index = __MCArrayPopCount(x_node -> nodemap & (t_bit - 1));
+
+			__MCArrayTrieNode **t_children;
+			t_children = __MCArrayTrieNodeChildren(x_node, p_shift);
+			if (!__MCArrayTrieNodeMakeUnique(t_children[t_child_index], p_shift + kMCArrayTrieFragmentBits) ||
+				!__MCArrayTrieNodeRemove(t_children[t_child_index], p_shift + kMCArrayTrieFragmentBits, p_hash, p_key, p_case_sensitive))
+				return false;
+
+			x_node -> count -= 1;
+
+			// Empty children are removed.
+			if (t_children[t_child_index] -> count == 0)
+			{
+				MCMemoryDeallocate(t_children[t_child_index]);
+				MCMemoryMove(t_children + t_child_index, t_children + t_child_index + 1, (t_child_count - t_child_index - 1) * sizeof(__MCArrayTrieNode *));
+				x_node -> nodemap &= ~t_bit;
+			}
+
+			return true;
+		}
+
+		t_data_index = __MCArrayPopCount(x_node -> datamap & (t_bit - 1));
+		x_node -> datamap &= ~t_bit;
+	}
+
+	MCValueRelease(t_data[t_data_index] . key);
+	MCValueRelease((MCValueRef)t_data[t_data_index] . value);
+
+	// Close up the gap, moving the children down too.
+	MCMemoryMove(t_data + t_data_index,
+				 t_data + t_data_index + 1,
+				 (t_data_count - t_data_index - 1) * sizeof(__MCArrayKeyValue) + t_child_count * sizeof(__MCArrayTrieNode *));
+	x_node -> count -= 1;
+
+	return true;
+}
+
+// Returns the key-value at the given position in the iteration order of the
+// subtree.
+static __MCArrayKeyValue *__MCArrayTrieNodeFetchAt(__MCArrayTrieNode *p_node, uindex_t p_shift, uindex_t p_ordinal)
+{
+	for(;;)
+	{
+		uindex_t t_data_count;
+		t_data_count = __MCArrayTrieNodeDataCount(p_node, p_shift);
+		if (p_ordinal < t_data_count)
+			return &__MCArrayTrieNodeData(p_node)[p_ordinal];
+
+		p_ordinal -= t_data_count;
+
+		__MCArrayTrieNode **t_children;
+		t_children = __MCArrayTrieNodeChildren(p_node, p_shift);
+
+		uindex_t t_child_count;
+		t_child_count = __MCArrayTrieNodeChildCount(p_node);
+
+		uindex_t i;
+		for(i = 0; i < t_child_count && p_ordinal >= t_children[i] -> count; i++)
+			p_ordinal -= t_children[i] -> count;
+
+		if (i == t_child_count)
+			return nil;
+
+		p_node = t_children[i];
+		p_shift += kMCArrayTrieFragmentBits;
+	}
+}
+
+static bool __MCArrayTrieNodeApply(__MCArrayTrieNode *p_node, uindex_t p_shift, MCArrayRef p_array, MCArrayApplyCallback p_callback, void *p_context)
+{
+	uindex_t t_data_count;
+	t_data_count = __MCArrayTrieNodeDataCount(p_node, p_shift);
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(p_node);
+	for(uindex_t i = 0; i < t_data_count; i++)
+		if (!p_callback(p_context, p_array, t_data[i] . key, (MCValueRef)t_data[i] . value))
+			return false;
+
+	__MCArrayTrieNode **t_children;
+	t_children = __MCArrayTrieNodeChildren(p_node, p_shift);
+	for(uindex_t i = 0; i < __MCArrayTrieNodeChildCount(p_node); i++)
+		if (!__MCArrayTrieNodeApply(t_children[i], p_shift + kMCArrayTrieFragmentBits, p_array, p_callback, p_context))
+			return false;
+
+	return true;
+}
+
+static bool __MCArrayTrieNodeMakeContentsImmutable(__MCArrayTrieNode *p_node, uindex_t p_shift)
+{
+	// Shared nodes (and so everything below them) are already immutable.
+	if (p_node -> references > 1)
+		return true;
+
+	uindex_t t_data_count;
+	t_data_count = __MCArrayTrieNodeDataCount(p_node, p_shift);
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(p_node);
+	for(uindex_t i = 0; i < t_data_count; i++)
+	{
+		__MCValue *t_new_value;
+		if (!__MCValueImmutableCopy((__MCValue *)t_data[i] . value, true, t_new_value))
+			return false;
+
+		t_data[i] . value = (uintptr_t)t_new_value;
+	}
+
+	__MCArrayTrieNode **t_children;
+	t_children = __MCArrayTrieNodeChildren(p_node, p_shift);
+	for(uindex_t i = 0; i < __MCArrayTrieNodeChildCount(p_node); i++)
+		if (!__MCArrayTrieNodeMakeContentsImmutable(t_children[i], p_shift + kMCArrayTrieFragmentBits))
+			return false;
+
+	return true;
+}
+
+static void __MCArrayTrieNodeCopyToTable(__MCArrayTrieNode *p_node, uindex_t p_shift, __MCArray *p_table)
+{
+	uindex_t t_data_count;
+	t_data_count = __MCArrayTrieNodeDataCount(p_node, p_shift);
+
+	__MCArrayKeyValue *t_data;
+	t_data = __MCArrayTrieNodeData(p_node);
+
+	uint8_t *t_control;
+	t_control = __MCArrayGetTableControl(p_table);
+	for(uindex_t i = 0; i < t_data_count; i++)
+	{
+		uindex_t t_slot;
+		t_slot = __MCArrayFindFreeSlot(p_table, t_data[i] . hash);
+
+		p_table -> key_values[t_slot] . key = MCValueRetain(t_data[i] . key);
+		p_table -> key_values[t_slot] . value = (uintptr_t)MCValueRetain((MCValueRef)t_data[i] . value);
+		p_table -> key_values[t_slot] . hash = t_data[i] . hash;
+		t_control[t_slot] = __MCArrayHashFragment(t_data[i] . hash);
+		__MCArrayGetTableGrowthLeft(p_table) -= 1;
+	}
+
+	__MCArrayTrieNode **t_children;
+	t_children = __MCArrayTrieNodeChildren(p_node, p_shift);
+	for(uindex_t i = 0; i < __MCArrayTrieNodeChildCount(p_node); i++)
+		__MCArrayTrieNodeCopyToTable(t_children[i], p_shift + kMCArrayTrieFragmentBits, p_table);
+}
+
+static bool __MCArrayIsTrie(__MCArray *self)
+{
+	return (self -> flags & kMCArrayFlagIsTrie) != 0;
+}
+
+// Builds a trie holding the same key-values as the given key-value table.
+static bool __MCArrayCreateTrieFromTable(__MCArray *p_table, __MCArrayTrieNode*& r_root)
+{
+	__MCArrayTrieNode *t_root;
+	if (!__MCArrayTrieNodeCreate(0, 0, t_root))
+		return false;
+
+	uindex_t t_size;
+	t_size = __MCArrayGetTableSize(p_table);
+	for(uindex_t i = 0; i < t_size; i++)
+	{
+		const __MCArrayKeyValue& t_entry = p_table -> key_values[i];
+		if (t_entry . value == UINTPTR_MIN || t_entry . value == UINTPTR_MAX)
+			continue;
+
+		if (!__MCArrayTrieNodeInsert(t_root, 0, t_entry))
+		{
+			__MCArrayTrieNodeRelease(t_root, 0);
+			return false;
+		}
+
+		MCValueRetain(t_entry . key);
+		MCValueRetain((MCValueRef)t_entry . value);
+	}
+
+	r_root = t_root;
+	return true;
+}
+
+static bool __MCArrayTrieStoreValueOnPath(__MCArray *self, bool p_case_sensitive, const MCNameRef *p_path, uindex_t p_path_length, MCValueRef p_new_value)
+{
+	hash_t t_hash;
+	t_hash = MCValueHash(p_path[0]);
+
+	// Find the key, copying any shared nodes on the way.
+	__MCArrayKeyValue *t_entry;
+	if (!__MCArrayTrieNodeFindMutable(self -> trie_root, 0, t_hash, p_path[0], p_case_sensitive, t_entry))
+		return false;
+
+	if (t_entry != nil)
+	{
+		MCValueRef t_value;
+		t_value = (MCValueRef)t_entry -> value;
+
+		if (p_path_length == 1)
+		{
+			MCValueRelease(t_value);
+			t_entry -> value = (uintptr_t)MCValueRetain(p_new_value);
+			return true;
+		}
+
+		if (MCValueGetTypeCode(t_value) == kMCValueTypeCodeArray)
+		{
+			MCArrayRef t_mutable_array;
+			if (!MCArrayIsMutable((MCArrayRef)t_value))
+			{
+				if (!MCArrayMutableCopyAndRelease((MCArrayRef)t_value, t_mutable_array))
+					return false;
+				t_entry -> value = (uintptr_t)t_mutable_array;
+			}
+			else
+				t_mutable_array = (MCArrayRef)t_value;
+
+			return MCArrayStoreValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value);
+		}
+	}
+
+	// Compute the value to store - either the new value or a new array
+	// holding it on the rest of the path.
+	MCValueRef t_new_value;
+	if (p_path_length == 1)
+		t_new_value = MCValueRetain(p_new_value);
+	else
+	{
+		MCArrayRef t_array;
+		if (!MCArrayCreateMutable(t_array))
+			return false;
+
+		if (!MCArrayStoreValueOnPath(t_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value))
+		{
+			MCValueRelease(t_array);
+			return false;
+		}
+
+		t_new_value = t_array;
+	}
+
+	if (t_entry != nil)
+	{
+		MCValueRelease((MCValueRef)t_entry -> value);
+		t_entry -> value = (uintptr_t)t_new_value;
+		return true;
+	}
+
+	__MCArrayKeyValue t_new_entry;
+	t_new_entry . key = p_path[0];
+	t_new_entry . value = (uintptr_t)t_new_value;
+	t_new_entry . hash = t_hash;
+	if (!__MCArrayTrieNodeInsert(self -> trie_root, 0, t_new_entry))
+	{
+		MCValueRelease(t_new_value);
+		return false;
+	}
+
+	MCValueRetain(p_path[0]);
+	self -> key_value_count += 1;
+	return true;
+}
+
+static bool __MCArrayTrieRemoveValueOnPath(__MCArray *self, bool p_case_sensitive, const MCNameRef *p_path, uindex_t p_path_length)
+{
+	hash_t t_hash;
+	t_hash = MCValueHash(p_path[0]);
+
+	// Check the key is there before copying any nodes.
+	__MCArrayKeyValue *t_entry;
+	t_entry = __MCArrayTrieNodeFind(self -> trie_root, 0, t_hash, p_path[0], p_case_sensitive);
+	if (t_entry == nil)
+		return true;
+
+	if (p_path_length > 1)
+	{
+		if (MCValueGetTypeCode((MCValueRef)t_entry -> value) != kMCValueTypeCodeArray)
+			return true;
+
+		if (!__MCArrayTrieNodeFindMutable(self -> trie_root, 0, t_hash, p_path[0], p_case_sensitive, t_entry))
+			return false;
+
+		MCArrayRef t_mutable_array;
+		if (!MCArrayIsMutable((MCArrayRef)t_entry -> value))
+		{
+			if (!MCArrayMutableCopyAndRelease((MCArrayRef)t_entry -> value, t_mutable_array))
+				return false;
+			t_entry -> value = (uintptr_t)t_mutable_array;
+		}
+		else
+			t_mutable_array = (MCArrayRef)t_entry -> value;
+
+		return MCArrayRemoveValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1);
+	}
+
+	if (!__MCArrayTrieNodeMakeUnique(self -> trie_root, 0) ||
+		!__MCArrayTrieNodeRemove(self -> trie_root, 0, t_hash, p_path[0], p_case_sensitive))
+		return false;
+
+	self -> key_value_count -= 1;
+
+	// An empty array goes back to being an (empty) key-value table.
+	if (self -> key_value_count == 0)
+	{
+		__MCArrayTrieNodeRelease(self -> trie_root, 0);
+		self -> key_values = nil;
+		self -> flags &= ~kMCArrayFlagIsTrie;
+		__MCArraySetTableSizeIndex(self, 0);
+	}
+
+	return true;
+}
+
+bool __MCArrayMakeSparse(__MCArray *self)
+{
+	if (__MCArrayIsIndirect(self))
+		self = self -> contents;
+
+	if (__MCArrayIsTrie(self))
+	{
+		uindex_t t_size_index;
+		for(t_size_index = 0;
+			self -> key_value_count > __MCArrayGetTableCapacityForIndex(t_size_index);
+			++t_size_index);
+
+		__MCArrayKeyValue *t_key_values;
+		if (t_size_index > kMCArrayMaxTableSizeIndex ||
+			!__MCArrayAllocateTable(__MCArrayGetTableSizeForIndex(t_size_index), false, t_key_values))
+			return false;
+
+		__MCArrayTrieNode *t_root;
+		t_root = self -> trie_root;
+
+		self -> flags &= ~kMCArrayFlagIsTrie;
+		__MCArraySetTableSizeIndex(self, t_size_index);
+		self -> key_values = t_key_values;
+
+		__MCArrayTrieNodeCopyToTable(t_root, 0, self);
+		__MCArrayTrieNodeRelease(t_root, 0);
+
+		return true;
+	}
+
+	if (!__MCArrayIsDense(self))
+		return true;
+
+	uindex_t t_count;
+	t_count = self -> key_value_count;
+
+	// Create the names first, as this is the only thing which can fail.
+	MCNameRef *t_keys;
+	if (!MCMemoryNewArray(t_count, t_keys))
+		return false;
+
+	bool t_success;
+	t_success = true;
+	for(uindex_t i = 0; t_success && i < t_count; i++)
+		t_success = MCNameCreateWithIndex(i + 1, t_keys[i]);
+
+	uindex_t t_size_index;
+	for(t_size_index = 0;
+		t_count > __MCArrayGetTableCapacityForIndex(t_size_index);
+		++t_size_index);
+
+	__MCArrayKeyValue *t_key_values;
+	t_key_values = nil;
+	if (t_success)
+		t_success = t_size_index <= kMCArrayMaxTableSizeIndex &&
+					__MCArrayAllocateTable(__MCArrayGetTableSizeForIndex(t_size_index), __MCArrayIsOrdered(self), t_key_values);
+
+	if (!t_success)
+	{
+		for(uindex_t i = 0; i < t_count; i++)
+			MCValueRelease(t_keys[i]);
+		MCMemoryDeleteArray(t_keys);
+		return false;
+	}
+
+	MCValueRef *t_values;
+	t_values = self -> dense_values;
+
+	self -> flags &= ~kMCArrayFlagIsDense;
+	__MCArraySetTableSizeIndex(self, t_size_index);
+	self -> key_values = t_key_values;
+
+	// The keys are all distinct, so they can go straight into free slots - the
+	// table takes over the references to both keys and values.
+	if (t_key_values != nil)
+	{
+		uint8_t *t_control;
+		t_control = __MCArrayGetTableControl(self);
+		for(uindex_t i = 0; i < t_count; i++)
+		{
+			hash_t t_hash;
+			t_hash = MCValueHash(t_keys[i]);
+
+			uindex_t t_slot;
+			t_slot = __MCArrayFindFreeSlot(self, t_hash);
+
+			t_key_values[t_slot] . key = t_keys[i];
+			t_key_values[t_slot] . value = (uintptr_t)t_values[i];
+			t_key_values[t_slot] . hash = t_hash;
+			t_key_values[t_slot] . position = i;
+			t_control[t_slot] = __MCArrayHashFragment(t_hash);
+
+			// The indices were stored in order, so that is their order.
+			if (__MCArrayIsOrdered(self))
+				__MCArrayGetTableOrder(self)[i] = t_slot;
+		}
+
+		__MCArrayGetTableGrowthLeft(self) -= t_count;
+		if (__MCArrayIsOrdered(self))
+			__MCArrayGetTableOrderLength(self) = t_count;
+	}
+
+	MCMemoryDeallocate(t_values);
+	MCMemoryDeleteArray(t_keys);
+
+	return true;
+}
+
+static bool __MCArrayMakeContentsImmutable(__MCArray *self)
+{
+	if (__MCArrayIsTrie(self))
+		return __MCArrayTrieNodeMakeContentsImmutable(self -> trie_root, 0);
+
+	if (__MCArrayIsDense(self))
+	{
+		for(uindex_t i = 0; i < self -> key_value_count; i++)
+		{
+			__MCValue *t_new_value;
+			if (!__MCValueImmutableCopy((__MCValue *)self -> dense_values[i], true, t_new_value))
+				return false;
+
+			self -> dense_values[i] = t_new_value;
+		}
+
+		return true;
+	}
+
+	uindex_t t_used, t_count;
+	t_used = self -> key_value_count;
+	t_count = __MCArrayGetTableSize(self);
+	for(uindex_t i = 0; t_used > 0 && i < t_count; i++)
+	{
+		if (self -> key_values[i] . value != UINTPTR_MIN && self -> key_values[i] . value != UINTPTR_MAX)
+		{
+			__MCValue *t_new_value;
+			if (!__MCValueImmutableCopy((__MCValue *)self -> key_values[i] . value, true, t_new_value))
+				return false;
+
+			self -> key_values[i] . value = (uintptr_t)t_new_value;
+		}
+	}
+
+	return true;
 }
 
 static bool __MCArrayMakeIndirect(__MCArray *self)
@@ -851,11 +2449,12 @@ static bool __MCArrayMakeIndirect(__MCArray *self)
 		return false;
 
 	// Fill in our new array.
-	t_array -> flags |= self -> flags & kMCArrayFlagCapacityIndexMask;
+	t_array -> flags |= self -> flags & (kMCArrayFlagCapacityIndexMask | kMCArrayFlagIsDense | kMCArrayFlagIsTrie | kMCArrayFlagIsOrdered);
 	t_array -> key_value_count = self -> key_value_count;
 	t_array -> key_values = self -> key_values;
 
 	// 'self' now becomes indirect with a reference to the new array.
+	self -> flags &= ~(kMCArrayFlagIsDense | kMCArrayFlagIsTrie);
 	self -> flags |= kMCArrayFlagIsIndirect;
 	self -> contents = t_array;
 	return true;
@@ -880,12 +2479,55 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
 		t_contents -> key_values = nil;
 		t_contents -> key_value_count = 0;
 	}
+	else if (__MCArrayIsTrie(t_contents))
+	{
+		// The trie is shared - its nodes are copied as they are changed.
+		self -> trie_root = t_contents -> trie_root;
+		self -> trie_root -> references += 1;
+		self -> key_value_count = t_contents -> key_value_count;
+	}
+	else if (__MCArrayIsDense(t_contents))
+	{
+		// Only the values need copying, but the capacity is kept so that the
+		// capacity index remains correct.
+		uindex_t t_capacity;
+		t_capacity = __MCArrayGetDenseCapacity(t_contents);
+
+		if (!MCMemoryAllocate(t_capacity * sizeof(MCValueRef), self -> dense_values))
+			return false;
+
+		self -> key_value_count = t_contents -> key_value_count;
+
+		for(uindex_t i = 0; i < self -> key_value_count; i++)
+			self -> dense_values[i] = MCValueRetain(t_contents -> dense_values[i]);
+	}
+	else if (t_contents -> key_value_count >= kMCArrayTrieThreshold &&
+			 !__MCArrayIsOrdered(t_contents))
+	{
+		// Copying a large table costs as much as building a trie from it, and
+		// once it is a trie any further copies will be cheap.
+		if (!__MCArrayCreateTrieFromTable(t_contents, self -> trie_root))
+			return false;
+
+		self -> key_value_count = t_contents -> key_value_count;
+		self -> flags |= kMCArrayFlagIsTrie;
+		__MCArraySetTableSizeIndex(self, 0);
+
+		self -> flags &= ~kMCArrayFlagIsIndirect;
+		MCValueRelease(t_contents);
+
+		return true;
+	}
 	else
 	{
 		uindex_t t_size;
 		t_size = __MCArrayGetTableSize(t_contents);
 
-		if (!MCMemoryNewArray(t_size, self -> key_values))
+		// The table is copied wholesale - including control bytes and deleted
+		// slots - so that probe sequences are preserved.
+		if (t_size == 0)
+			self -> key_values = nil;
+		else if (!MCMemoryAllocateCopy(t_contents -> key_values, __MCArrayGetTableByteSize(t_size, __MCArrayIsOrdered(t_contents)), self -> key_values))
 			return false;
 
 		self -> key_value_count = t_contents -> key_value_count;
@@ -894,19 +2536,15 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
 		{
 			if (t_contents -> key_values[i] . value != UINTPTR_MIN && t_contents -> key_values[i] . value != UINTPTR_MAX)
 			{
-				self -> key_values[i] . value = (uintptr_t)MCValueRetain((MCValueRef)t_contents -> key_values[i] . value);
-				self -> key_values[i] . key = MCValueRetain(t_contents -> key_values[i] . key);
+				MCValueRetain((MCValueRef)t_contents -> key_values[i] . value);
+				MCValueRetain(t_contents -> key_values[i] . key);
 			}
-            else
-            {
-                // Ensure we don't break any hash chains
-                self -> key_values[i] = t_contents -> key_values[i];
-            }
 		}
 	}
 
-	// Make sure we take the index from the flags.
+	// Make sure we take the index and representation from the flags.
 	__MCArraySetTableSizeIndex(self, __MCArrayGetTableSizeIndex(t_contents));
+	self -> flags |= t_contents -> flags & (kMCArrayFlagIsDense | kMCArrayFlagIsTrie);
 
 	// Make sure the array is no longer marked as indirect.
 	self -> flags &= ~kMCArrayFlagIsIndirect;
@@ -917,6 +2555,68 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
 	return true;
 }
 
+// The slot index within a group of the lowest bit set in a group mask.
+static inline uindex_t __MCArrayGroupMaskFirst(uint32_t p_mask)
+{
+#if defined(__VISUALC__)
+	unsigned long t_index;
+	_BitScanForward(&t_index, p_mask);
+	return t_index;
+#else
+	return __builtin_ctz(p_mask);
+#endif
+}
+
+#if defined(__MCARRAY_USE_NEON__)
+// NEON has no movemask, so the lanes (which are all-ones or all-zeros) are
+// weighted by their bit position and summed to get the equivalent mask.
+static inline uint32_t __MCArrayNeonMovemask(uint8x16_t p_lanes)
+{
+	static const uint8_t kWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t t_weighted;
+	t_weighted = vandq_u8(p_lanes, vld1q_u8(kWeights));
+	return vaddv_u8(vget_low_u8(t_weighted)) | (uint32_t(vaddv_u8(vget_high_u8(t_weighted))) << 8);
+}
+#endif
+
+// Returns a mask with a bit set for each control byte in the group equal to
+// the given value.
+static inline uint32_t __MCArrayGroupMatch(const uint8_t *p_group, uint8_t p_value)
+{
+#if defined(__MCARRAY_USE_SSE2__)
+	__m128i t_group;
+	t_group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_group));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(t_group, _mm_set1_epi8(char(p_value))));
+#elif defined(__MCARRAY_USE_NEON__)
+	return __MCArrayNeonMovemask(vceqq_u8(vld1q_u8(p_group), vdupq_n_u8(p_value)));
+#else
+	uint32_t t_mask;
+	t_mask = 0;
+	for(uindex_t i = 0; i < kMCArrayGroupSize; i++)
+		if (p_group[i] == p_value)
+			t_mask |= 1U << i;
+	return t_mask;
+#endif
+}
+
+// Returns a mask with a bit set for each empty or deleted slot in the group -
+// these are the control bytes with the top bit set.
+static inline uint32_t __MCArrayGroupMatchFree(const uint8_t *p_group)
+{
+#if defined(__MCARRAY_USE_SSE2__)
+	return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_group)));
+#elif defined(__MCARRAY_USE_NEON__)
+	return __MCArrayNeonMovemask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(p_group)), vdupq_n_s8(0)));
+#else
+	uint32_t t_mask;
+	t_mask = 0;
+	for(uindex_t i = 0; i < kMCArrayGroupSize; i++)
+		if ((p_group[i] & 0x80) != 0)
+			t_mask |= 1U << i;
+	return t_mask;
+#endif
+}
+
 static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MCNameRef p_key, uindex_t& r_slot)
 {
 	// Get the table size.
@@ -929,58 +2629,69 @@ static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MC
 	}
 
 	// Get the hash.
-	uindex_t t_hash;
+	hash_t t_hash;
 	t_hash = MCValueHash(p_key);
 
-	// Fold the hash code appropriately.
-	uindex_t t_h1;
-#if defined(__ARM__) && 0 // TODO	
-	t_h1 = __MCHashFold(t_hash, __MCArrayGetTableSizeIndex(self));
-#else
-	t_h1 = t_hash % t_size;
-#endif
+	const uint8_t *t_control;
+	t_control = __MCArrayGetTableControl(self);
 
-	// The initial index to probe.
-	uindex_t t_probe;
-	t_probe = t_h1;
+	uint8_t t_fragment;
+	t_fragment = __MCArrayHashFragment(t_hash);
+
+	// The table size is a power-of-two multiple of the group size, so the
+	// group count minus one is a mask.
+	uindex_t t_group_mask;
+	t_group_mask = t_size / kMCArrayGroupSize - 1;
+
+	uindex_t t_group;
+	t_group = __MCArrayHashGroup(t_hash) & t_group_mask;
 
 	// The target for a new entry - if it ends up being UINDEX_MAX it means the
 	// table is full.
 	uindex_t t_target_slot;
 	t_target_slot = UINDEX_MAX;
 
-	// Loop over all key value pairs - starting at probe.
-	for(uindex_t i = 0; i < t_size; i++)
+	// Probe the groups triangularly, which visits every group exactly once
+	// when the group count is a power of two.
+	for(uindex_t t_stride = 1; t_stride <= t_group_mask + 1; t_stride++)
 	{
-		__MCArrayKeyValue *t_entry;
-		t_entry = &self -> key_values[t_probe];
-
-		if (t_entry -> value == UINTPTR_MIN)
+		const uint8_t *t_group_control;
+		t_group_control = t_control + t_group * kMCArrayGroupSize;
+
+		// Only the keys whose hash fragment matches need to be looked at, and
+		// of those only the ones with a matching full hash need comparing.
+		uint32_t t_matches;
+		t_matches = __MCArrayGroupMatch(t_group_control, t_fragment);
+		while(t_matches != 0)
 		{
-			// The end of the chain - we are done.
-			if (t_target_slot == UINDEX_MAX)
-				t_target_slot = t_probe;
-			r_slot = t_probe;
-			return false;
-		}
+			uindex_t t_slot;
+			t_slot = t_group * kMCArrayGroupSize + __MCArrayGroupMaskFirst(t_matches);
 
-		if (t_entry -> value == UINTPTR_MAX)
-		{
-			if (t_target_slot == UINDEX_MAX)
-				t_target_slot = t_probe;
-		}
-		else
-		{
-            if (MCNameIsEqualTo(t_entry -> key, p_key, !p_case_sensitive ? kMCStringOptionCompareCaseless : kMCStringOptionCompareExact))
+			__MCArrayKeyValue *t_entry;
+			t_entry = &self -> key_values[t_slot];
+			if (t_entry -> hash == t_hash &&
+				MCNameIsEqualTo(t_entry -> key, p_key, !p_case_sensitive ? kMCStringOptionCompareCaseless : kMCStringOptionCompareExact))
 			{
-				r_slot = t_probe;
+				r_slot = t_slot;
 				return true;
 			}
+
+			t_matches &= t_matches - 1;
+		}
+
+		uint32_t t_free;
+		t_free = __MCArrayGroupMatchFree(t_group_control);
+		if (t_free != 0)
+		{
+			if (t_target_slot == UINDEX_MAX)
+				t_target_slot = t_group * kMCArrayGroupSize + __MCArrayGroupMaskFirst(t_free);
+
+			// An empty slot in the group ends the probe sequence.
+			if (__MCArrayGroupMatch(t_group_control, kMCArrayControlEmpty) != 0)
+				break;
 		}
 
-		t_probe += 1;
-		if (t_size <= t_probe)
-			t_probe -= t_size;
+		t_group = (t_group + t_stride) & t_group_mask;
 	}
 
 	// If we get here the name wasn't found.
@@ -988,50 +2699,231 @@ static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MC
 	return false;
 }
 
+// Returns the first free slot in the probe sequence for the given hash. This
+// is only used when rehashing, where the table has no deleted slots and all
+// keys are known to be distinct.
+static uindex_t __MCArrayFindFreeSlot(__MCArray *self, hash_t p_hash)
+{
+	const uint8_t *t_control;
+	t_control = __MCArrayGetTableControl(self);
+
+	uindex_t t_group_mask;
+	t_group_mask = __MCArrayGetTableSize(self) / kMCArrayGroupSize - 1;
+
+	uindex_t t_group;
+	t_group = __MCArrayHashGroup(p_hash) & t_group_mask;
+	for(uindex_t t_stride = 1; ; t_stride++)
+	{
+		uint32_t t_free;
+		t_free = __MCArrayGroupMatchFree(t_control + t_group * kMCArrayGroupSize);
+		if (t_free != 0)
+			return t_group * kMCArrayGroupSize + __MCArrayGroupMaskFirst(t_free);
+
+		t_group = (t_group + t_stride) & t_group_mask;
+	}
+}
+
+static bool __MCArrayCanOccupySlot(__MCArray *self, uindex_t p_slot)
+{
+	if (p_slot == UINDEX_MAX)
+		return false;
+
+	// Reusing a deleted slot is always possible, but filling an empty one
+	// needs there to be growth left.
+	if (__MCArrayGetTableControl(self)[p_slot] != kMCArrayControlEmpty)
+		return true;
+
+	return __MCArrayGetTableGrowthLeft(self) > 0;
+}
+
+static void __MCArrayOccupySlot(__MCArray *self, uindex_t p_slot, MCNameRef p_key, uintptr_t p_value)
+{
+	hash_t t_hash;
+	t_hash = MCValueHash(p_key);
+
+	uint8_t *t_control;
+	t_control = __MCArrayGetTableControl(self);
+	if (t_control[p_slot] == kMCArrayControlEmpty)
+		__MCArrayGetTableGrowthLeft(self) -= 1;
+	t_control[p_slot] = __MCArrayHashFragment(t_hash);
+
+	self -> key_values[p_slot] . key = MCValueRetain(p_key);
+	self -> key_values[p_slot] . value = p_value;
+	self -> key_values[p_slot] . hash = t_hash;
+	self -> key_value_count += 1;
+
+	if (!__MCArrayIsOrdered(self))
+		return;
+
+	uindex_t *t_order;
+	t_order = __MCArrayGetTableOrder(self);
+
+	uindex_t& t_order_length = __MCArrayGetTableOrderLength(self);
+
+	// If the order list is full then some of it must be removed keys (as the
+	// table itself had room), so squeeze those out.
+	if (t_order_length == __MCArrayGetTableCapacityForIndex(__MCArrayGetTableSizeIndex(self)))
+	{
+		uindex_t t_length;
+		t_length = 0;
+		for(uindex_t i = 0; i < t_order_length; i++)
+		{
+			if (t_order[i] == UINDEX_MAX)
+				continue;
+
+			t_order[t_length] = t_order[i];
+			self -> key_values[t_order[i]] . position = t_length;
+			t_length += 1;
+		}
+
+		t_order_length = t_length;
+	}
+
+	t_order[t_order_length] = p_slot;
+	self -> key_values[p_slot] . position = t_order_length;
+	t_order_length += 1;
+}
+
+static void __MCArrayVacateSlot(__MCArray *self, uindex_t p_slot)
+{
+	if (__MCArrayIsOrdered(self))
+	{
+		uindex_t *t_order;
+		t_order = __MCArrayGetTableOrder(self);
+		t_order[self -> key_values[p_slot] . position] = UINDEX_MAX;
+
+		// Removed keys at the end of the list can be dropped straight away.
+		uindex_t& t_order_length = __MCArrayGetTableOrderLength(self);
+		while(t_order_length > 0 && t_order[t_order_length - 1] == UINDEX_MAX)
+			t_order_length -= 1;
+	}
+
+	uint8_t *t_control;
+	t_control = __MCArrayGetTableControl(self);
+
+	// If the slot's group has an empty slot then no probe sequence can have
+	// continued past it, so the slot can be marked as empty rather than
+	// deleted (and becomes available for growth again).
+	uindex_t t_group_start;
+	t_group_start = p_slot - p_slot % kMCArrayGroupSize;
+	if (__MCArrayGroupMatch(t_control + t_group_start, kMCArrayControlEmpty) != 0)
+	{
+		t_control[p_slot] = kMCArrayControlEmpty;
+		self -> key_values[p_slot] . value = UINTPTR_MIN;
+		__MCArrayGetTableGrowthLeft(self) += 1;
+	}
+	else
+	{
+		t_control[p_slot] = kMCArrayControlDeleted;
+		self -> key_values[p_slot] . value = UINTPTR_MAX;
+	}
+
+	self -> key_values[p_slot] . key = nil;
+	self -> key_values[p_slot] . hash = 0;
+	self -> key_value_count -= 1;
+}
+
 static bool __MCArrayRehash(__MCArray *self, index_t p_by)
 {
 	uindex_t t_new_capacity_idx;
 	t_new_capacity_idx = __MCArrayGetTableSizeIndex(self);
 	if (p_by != 0)
 	{
+		uindex_t t_new_capacity_req;
 		if (p_by < 0)
-			p_by = 0;
+			t_new_capacity_req = self -> key_value_count;
+		else
+		{
+			// When growing, leave a quarter again as headroom so that a table
+			// which is churning through deletes doesn't rehash in place on
+			// every insert.
+			t_new_capacity_req = self -> key_value_count + p_by;
+			t_new_capacity_req += t_new_capacity_req / 4;
+		}
 
-		uindex_t t_new_capacity_req;
-		t_new_capacity_req = self -> key_value_count + p_by;
 		for(t_new_capacity_idx = 0;
-		    t_new_capacity_req > __kMCValueHashTableCapacities[t_new_capacity_idx];
+		    t_new_capacity_req > __MCArrayGetTableCapacityForIndex(t_new_capacity_idx);
 		    ++t_new_capacity_idx);
 	}
 
+	if (t_new_capacity_idx > kMCArrayMaxTableSizeIndex)
+		return false;
+
 	uindex_t t_old_capacity;
 	__MCArrayKeyValue *t_old_key_values;
 	t_old_capacity = __MCArrayGetTableSize(self);
 	t_old_key_values = self -> key_values;
 
-	uindex_t t_new_capacity;
+	// An ordered table is moved across in insertion order, which also drops
+	// any removed keys from the order list.
+	uindex_t *t_old_order;
+	uindex_t t_old_order_length;
+	t_old_order = nil;
+	t_old_order_length = 0;
+	if (__MCArrayIsOrdered(self) && t_old_key_values != nil)
+	{
+		t_old_order = __MCArrayGetTableOrder(self);
+		t_old_order_length = __MCArrayGetTableOrderLength(self);
+	}
+
 	__MCArrayKeyValue *t_new_key_values;
-	t_new_capacity = __kMCValueHashTableSizes[t_new_capacity_idx];
-	if (!MCMemoryNewArray(t_new_capacity, t_new_key_values))
+	if (!__MCArrayAllocateTable(__MCArrayGetTableSizeForIndex(t_new_capacity_idx), __MCArrayIsOrdered(self), t_new_key_values))
 		return false;
 
 	__MCArraySetTableSizeIndex(self, t_new_capacity_idx);
 	self -> key_values = t_new_key_values;
 
-	for(uindex_t i = 0; i < t_old_capacity; i++)
+	if (t_new_key_values != nil)
 	{
-		if (t_old_key_values[i] . value != UINTPTR_MIN && t_old_key_values[i] . value != UINTPTR_MAX)
+		uint8_t *t_control;
+		t_control = __MCArrayGetTableControl(self);
+
+		uindex_t t_moved;
+		t_moved = 0;
+		if (__MCArrayIsOrdered(self))
 		{
-			uindex_t t_target_slot;
-			__MCArrayFindKeyValueSlot(self, true, t_old_key_values[i] . key, t_target_slot);
+			uindex_t *t_order;
+			t_order = __MCArrayGetTableOrder(self);
+			for(uindex_t i = 0; i < t_old_order_length; i++)
+			{
+				if (t_old_order[i] == UINDEX_MAX)
+					continue;
+
+				const __MCArrayKeyValue& t_entry = t_old_key_values[t_old_order[i]];
+
+				uindex_t t_target_slot;
+				t_target_slot = __MCArrayFindFreeSlot(self, t_entry . hash);
+
+				t_new_key_values[t_target_slot] = t_entry;
+				t_new_key_values[t_target_slot] . position = t_moved;
+				t_control[t_target_slot] = __MCArrayHashFragment(t_entry . hash);
+				t_order[t_moved] = t_target_slot;
+				t_moved += 1;
+			}
 
-			MCAssert(t_target_slot != UINDEX_MAX);
+			__MCArrayGetTableOrderLength(self) = t_moved;
+		}
+		else
+		{
+			for(uindex_t i = 0; i < t_old_capacity; i++)
+			{
+				if (t_old_key_values[i] . value != UINTPTR_MIN && t_old_key_values[i] . value != UINTPTR_MAX)
+				{
+					// The stored hash means the key never needs to be looked at.
+					uindex_t t_target_slot;
+					t_target_slot = __MCArrayFindFreeSlot(self, t_old_key_values[i] . hash);
 
-			t_new_key_values[t_target_slot] = t_old_key_values[i];
+					t_new_key_values[t_target_slot] = t_old_key_values[i];
+					t_control[t_target_slot] = __MCArrayHashFragment(t_old_key_values[i] . hash);
+					t_moved += 1;
+				}
+			}
 		}
+
+		__MCArrayGetTableGrowthLeft(self) -= t_moved;
 	}
 
-	MCMemoryDeleteArray(t_old_key_values);
+	__MCArrayDeallocateTable(t_old_key_values);
 
 	return true;
 }
@@ -1051,6 +2943,12 @@ bool __MCArrayInitialize(void)
 void __MCArrayFinalize(void)
 {
 	MCValueRelease(kMCEmptyArray);
+
+	for(uindex_t i = 0; i < s_array_index_name_count; i++)
+		MCValueRelease(s_array_index_names[i]);
+	MCMemoryDeleteArray(s_array_index_names);
+	s_array_index_names = nil;
+	s_array_index_name_count = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1064,6 +2962,53 @@ void __MCArrayDump(MCArrayRef array)
 	else
 		t_contents = array -> contents;
 
+	if (__MCArrayIsDense(t_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+		{
+			MCValueRef t_value;
+			t_value = t_contents -> dense_values[i];
+
+			if (MCValueGetTypeCode(t_value) == kMCValueTypeCodeArray)
+			{
+				MCLog("[%u]:", i + 1);
+				__MCArrayDump((MCArrayRef)t_value);
+			}
+			else
+			{
+				MCAutoStringRef t_desc;
+				MCValueCopyDescription(t_value, &t_desc);
+				MCLog("[%u] = %@", i + 1, *t_desc);
+			}
+		}
+		return;
+	}
+
+	if (__MCArrayIsTrie(t_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+		{
+			__MCArrayKeyValue *t_entry;
+			t_entry = __MCArrayTrieNodeFetchAt(t_contents -> trie_root, 0, i);
+
+			MCValueRef t_value;
+			t_value = (MCValueRef)t_entry -> value;
+
+			if (MCValueGetTypeCode(t_value) == kMCValueTypeCodeArray)
+			{
+				MCLog("[%@]:", t_entry -> key);
+				__MCArrayDump((MCArrayRef)t_value);
+			}
+			else
+			{
+				MCAutoStringRef t_desc;
+				MCValueCopyDescription(t_value, &t_desc);
+				MCLog("[%@] = %@", t_entry -> key, *t_desc);
+			}
+		}
+		return;
+	}
+
 	uindex_t t_size;
 	t_size = __MCArrayGetTableSize(t_contents);
 
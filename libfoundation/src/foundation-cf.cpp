@@ -184,7 +184,8 @@ MC_DLLEXPORT_DEF
 bool MCProperListCreateWithCFArrayRef(CFArrayRef p_cf_array, bool p_use_lists, MCProperListRef& r_list)
 {
     MCAutoProperListRef t_list;
-    if (!MCProperListCreateMutable(&t_list))
+    if (!MCProperListCreateMutable(&t_list) ||
+        !MCProperListReserve(*t_list, CFArrayGetCount(p_cf_array)))
     {
         return false;
     }
@@ -72,6 +72,9 @@ bool MCInitialize(void)
     if (!__MCDataInitialize())
         return false;
     
+    if (!__MCFiltersInitialize())
+        return false;
+    
     if (!__MCRecordInitialize())
         return false;
     
@@ -54,6 +54,37 @@ static bool __MCDataResolveIndirect(__MCData *self);
 // Makes direct mutable data ref indirect, referencing r_new_data.
 static bool __MCDataCopyMutable(__MCData *self, __MCData*& r_new_data);
 
+// Gives a slice or external data ref its own copy of its bytes.
+static bool __MCDataOwnBytes(__MCData *self);
+
+// Gives a slice its own bytes if it is much smaller than its parent.
+static bool __MCDataUnpinParent(__MCData *self);
+
+// Ranges at least this long are copied as slices, sharing the bytes of the
+// data ref they are taken from.
+static const uindex_t kMCDataSliceThreshold = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns the bytes of a direct data ref. The parent of a slice is never a
+// slice itself.
+static inline byte_t *__MCDataGetBytes(MCDataRef self)
+{
+    if ((self -> flags & (kMCDataFlagIsSlice | kMCDataFlagIsExternal)) == 0)
+        return self -> bytes;
+    
+    if ((self -> flags & kMCDataFlagIsSlice) != 0)
+    {
+        MCDataRef t_parent;
+        t_parent = self -> parent;
+        if ((t_parent -> flags & kMCDataFlagIsExternal) != 0)
+            return t_parent -> external -> bytes + self -> offset;
+        return t_parent -> bytes + self -> offset;
+    }
+    
+    return self -> external -> bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -94,7 +125,7 @@ bool MCDataCreateWithBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCDataR
 		if (self != nil)
 			MCMemoryDeleteArray(self -> bytes);
         
-		MCMemoryDelete(self);
+		__MCValueDelete(self);
 	}
     
 	return t_success;
@@ -122,11 +153,51 @@ bool MCDataCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, MCD
         r_data = self;
     }
     else
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     
     return t_success;
 }
 
+MC_DLLEXPORT_DEF
+bool MCDataCreateWithExternalBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCDataReleaseBytesCallback p_release, void *p_context, MCDataRef& r_data)
+{
+	MCAssert(nil != p_bytes);
+	MCAssert(nil != p_release);
+
+	__MCDataExternalBytes *t_external;
+	if (!MCMemoryNew(t_external))
+		return false;
+
+	__MCData *self;
+	if (!__MCValueCreate(kMCValueTypeCodeData, self))
+	{
+		MCMemoryDelete(t_external);
+		return false;
+	}
+
+	t_external -> bytes = const_cast<byte_t *>(p_bytes);
+	t_external -> release = p_release;
+	t_external -> context = p_context;
+
+	self -> flags |= kMCDataFlagIsExternal;
+	self -> byte_count = p_byte_count;
+	self -> external = t_external;
+
+	r_data = self;
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCDataDetachExternalBytes(MCDataRef self)
+{
+	__MCAssertIsData(self);
+
+	if ((self -> flags & kMCDataFlagIsExternal) == 0)
+		return true;
+
+	return __MCDataOwnBytes(self);
+}
+
 MC_DLLEXPORT_DEF
 bool
 MCDataCreateWithData(MCDataRef& r_data, MCDataRef p_one, MCDataRef p_two)
@@ -156,8 +227,8 @@ MCDataCreateWithData(MCDataRef& r_data, MCDataRef p_one, MCDataRef p_two)
     }
     
     // Copy the bytes to the object
-    MCMemoryCopy(self->bytes, p_one->bytes, p_one->byte_count);
-    MCMemoryCopy(self->bytes + p_one->byte_count, p_two->bytes, p_two->byte_count);
+    MCMemoryCopy(self->bytes, __MCDataGetBytes(p_one), p_one->byte_count);
+    MCMemoryCopy(self->bytes + p_one->byte_count, __MCDataGetBytes(p_two), p_two->byte_count);
     
     // Set the byte count
     self->byte_count = p_one->byte_count + p_two->byte_count;
@@ -180,7 +251,9 @@ bool MCDataConvertStringToData(MCStringRef string, MCDataRef& r_data)
     if (!MCStringNativeCopy(string, t_native_copy))
         return false;
 
-    if (t_native_copy -> references != 1 || MCStringIsMutable(t_native_copy))
+    // The chars can only be taken if the string owns them.
+    if (t_native_copy -> references != 1 || MCStringIsMutable(t_native_copy) ||
+        (t_native_copy -> flags & (kMCStringFlagIsSlice | kMCStringFlagIsStatic)) != 0)
     {
         uindex_t t_native_length;
         const byte_t *t_data = (const byte_t *)MCStringGetNativeCharPtrAndLength(t_native_copy, t_native_length);
@@ -211,7 +284,7 @@ bool MCDataConvertStringToData(MCStringRef string, MCDataRef& r_data)
         t_native_copy -> char_count = 0;
     }
     else
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     
     if (t_success)
         MCValueRelease(t_native_copy);
@@ -249,7 +322,7 @@ const byte_t *MCDataGetBytePtr(MCDataRef p_data)
     if (__MCDataIsIndirect(p_data))
         p_data = p_data -> contents;
     
-    return p_data->bytes;
+    return __MCDataGetBytes(p_data);
 }
 
 MC_DLLEXPORT_DEF
@@ -260,7 +333,7 @@ byte_t MCDataGetByteAtIndex(MCDataRef p_data, uindex_t p_index)
     if (__MCDataIsIndirect(p_data))
         p_data = p_data -> contents;
     
-    return p_data->bytes[p_index];
+    return __MCDataGetBytes(p_data)[p_index];
 }
 
 MC_DLLEXPORT_DEF
@@ -278,7 +351,7 @@ bool MCDataIsEqualTo(MCDataRef p_left, MCDataRef p_right)
     if (p_left -> byte_count != p_right -> byte_count)
         return false;
     
-    return MCMemoryCompare(p_left -> bytes, p_right -> bytes, p_left -> byte_count) == 0;
+    return MCMemoryCompare(__MCDataGetBytes(p_left), __MCDataGetBytes(p_right), p_left -> byte_count) == 0;
 }
 
 // Mutable data methods
@@ -317,6 +390,11 @@ bool MCDataCopy(MCDataRef p_data, MCDataRef& r_new_data)
 
     if (!MCDataIsMutable(p_data))
     {
+        // A copy is kept, so don't let a small slice keep a much larger
+        // parent alive.
+        if (!__MCDataUnpinParent(p_data))
+            return false;
+        
         MCValueRetain(p_data);
         r_new_data = p_data;
         return true;
@@ -342,6 +420,9 @@ bool MCDataCopyAndRelease(MCDataRef p_data, MCDataRef& r_new_data)
     // If the MCData is immutable we just pass it through (as we are releasing it).
     if (!MCDataIsMutable(p_data))
     {
+        if (!__MCDataUnpinParent(p_data))
+            return false;
+        
         r_new_data = p_data;
         return true;
     }
@@ -403,7 +484,13 @@ bool MCDataMutableCopyAndRelease(MCDataRef p_data, MCDataRef& r_mutable_data)
     if (p_data -> references == 1)
     {
         if (!MCDataIsMutable(p_data))
+        {
+            // Mutable data always own their bytes.
+            if (!__MCDataOwnBytes(p_data))
+                return false;
+            
             p_data -> flags |= kMCDataFlagIsMutable;
+        }
         
         r_mutable_data = p_data;
         return true;
@@ -430,11 +517,36 @@ bool MCDataCopyRange(MCDataRef self, MCRange p_range, MCDataRef& r_new_data)
     // than create a brand new DataRef, we use one of the pre-allocated ones.
     if (p_range . length == 1)
     {
-        r_new_data = MCValueRetain(__kMCSingleBytes[self -> bytes[p_range . offset]]);
+        r_new_data = MCValueRetain(__kMCSingleBytes[__MCDataGetBytes(self)[p_range . offset]]);
+        return true;
+    }
+    
+    // Longer ranges of immutable data share its bytes, as they can't change.
+    // A slice of a slice uses the original parent.
+    if (p_range . length >= kMCDataSliceThreshold && !MCDataIsMutable(self))
+    {
+        MCDataRef t_parent;
+        t_parent = self;
+        if ((self -> flags & kMCDataFlagIsSlice) != 0)
+        {
+            t_parent = self -> parent;
+            p_range . offset += self -> offset;
+        }
+        
+        __MCData *t_slice;
+        if (!__MCValueCreate(kMCValueTypeCodeData, t_slice))
+            return false;
+        
+        t_slice -> flags |= kMCDataFlagIsSlice;
+        t_slice -> byte_count = p_range . length;
+        t_slice -> offset = p_range . offset;
+        t_slice -> parent = MCValueRetain(t_parent);
+        
+        r_new_data = t_slice;
         return true;
     }
     
-    return MCDataCreateWithBytes(self -> bytes + p_range . offset, p_range . length, r_new_data);
+    return MCDataCreateWithBytes(__MCDataGetBytes(self) + p_range . offset, p_range . length, r_new_data);
 }
 
 MC_DLLEXPORT_DEF
@@ -477,7 +589,7 @@ bool MCDataAppend(MCDataRef r_data, MCDataRef p_suffix)
         return MCDataAppend(r_data, *t_suffix_copy);
     }
     
-    return MCDataAppendBytes(r_data, p_suffix -> bytes, p_suffix -> byte_count);
+    return MCDataAppendBytes(r_data, __MCDataGetBytes(p_suffix), p_suffix -> byte_count);
 }
 
 MC_DLLEXPORT_DEF
@@ -526,7 +638,7 @@ bool MCDataPrepend(MCDataRef r_data, MCDataRef p_prefix)
         return MCDataPrepend(r_data, *t_prefix_copy);
     }
     
-    return MCDataPrependBytes(r_data, p_prefix -> bytes, p_prefix -> byte_count);
+    return MCDataPrependBytes(r_data, __MCDataGetBytes(p_prefix), p_prefix -> byte_count);
 }
 
 MC_DLLEXPORT_DEF
@@ -575,7 +687,7 @@ bool MCDataInsert(MCDataRef r_data, uindex_t p_at, MCDataRef p_new_data)
         return MCDataPrepend(r_data, *t_new_data_copy);
     }
     
-    return MCDataInsertBytes(r_data, p_at, p_new_data -> bytes, p_new_data -> byte_count);
+    return MCDataInsertBytes(r_data, p_at, __MCDataGetBytes(p_new_data), p_new_data -> byte_count);
 }
 
 MC_DLLEXPORT_DEF
@@ -636,7 +748,7 @@ bool MCDataReplace(MCDataRef r_data, MCRange p_range, MCDataRef p_new_data)
         return MCDataReplace(r_data, p_range, *t_new_data);
     }
     
-    return MCDataReplaceBytes(r_data, p_range, p_new_data -> bytes, p_new_data -> byte_count);
+    return MCDataReplaceBytes(r_data, p_range, __MCDataGetBytes(p_new_data), p_new_data -> byte_count);
 }
 
 MC_DLLEXPORT_DEF
@@ -720,7 +832,7 @@ compare_t MCDataCompareTo(MCDataRef p_left, MCDataRef p_right)
         p_right = p_right -> contents;
     
     compare_t t_result;
-    t_result = memcmp(p_left -> bytes, p_right -> bytes, MCMin(p_left -> byte_count, p_right -> byte_count));
+    t_result = memcmp(__MCDataGetBytes(p_left), __MCDataGetBytes(p_right), MCMin(p_left -> byte_count, p_right -> byte_count));
     
     if (t_result != 0)
         return t_result;
@@ -742,11 +854,11 @@ bool MCDataContains(MCDataRef p_data, MCDataRef p_needle)
         return false;
     
     const byte_t *t_bytes;
-    t_bytes = p_data -> bytes;
+    t_bytes = __MCDataGetBytes(p_data);
     
     bool t_found = false;
     for (uindex_t i = 0; i < t_byte_count - t_needle_byte_count + 1; i++)
-        if (MCMemoryCompare(t_bytes++, p_needle -> bytes, sizeof(byte_t) * t_needle_byte_count) == 0)
+        if (MCMemoryCompare(t_bytes++, __MCDataGetBytes(p_needle), sizeof(byte_t) * t_needle_byte_count) == 0)
         {
             t_found = true;
             break;
@@ -768,7 +880,7 @@ bool MCDataBeginsWith(MCDataRef p_data, MCDataRef p_needle)
     if (t_needle_byte_count > t_byte_count)
         return false;
     
-    return MCMemoryCompare(p_data -> bytes, p_needle -> bytes, sizeof(byte_t) * t_needle_byte_count) == 0;
+    return MCMemoryCompare(__MCDataGetBytes(p_data), __MCDataGetBytes(p_needle), sizeof(byte_t) * t_needle_byte_count) == 0;
 }
 
 MC_DLLEXPORT_DEF
@@ -784,7 +896,7 @@ bool MCDataEndsWith(MCDataRef p_data, MCDataRef p_needle)
     if (t_needle_byte_count > t_byte_count)
         return false;
     
-    return MCMemoryCompare(p_data -> bytes + t_byte_count - t_needle_byte_count, p_needle -> bytes, sizeof(byte_t) * t_needle_byte_count) == 0;
+    return MCMemoryCompare(__MCDataGetBytes(p_data) + t_byte_count - t_needle_byte_count, __MCDataGetBytes(p_needle), sizeof(byte_t) * t_needle_byte_count) == 0;
 }
 
 MC_DLLEXPORT_DEF
@@ -990,6 +1102,15 @@ void __MCDataDestroy(__MCData *self)
     {
         MCValueRelease(self -> contents);
     }
+    else if ((self -> flags & kMCDataFlagIsSlice) != 0)
+    {
+        MCValueRelease(self -> parent);
+    }
+    else if ((self -> flags & kMCDataFlagIsExternal) != 0)
+    {
+        self -> external -> release(self -> external -> context);
+        MCMemoryDelete(self -> external);
+    }
     else
     {
         if (self -> bytes != nil)
@@ -1011,7 +1132,7 @@ bool __MCDataIsEqualTo(__MCData *self, __MCData *p_other_data)
 
 hash_t __MCDataHash(__MCData *self)
 {
-    return MCHashBytes(self -> bytes, self -> byte_count);
+    return MCHashBytes(__MCDataGetBytes(self), self -> byte_count);
 }
 
 bool __MCDataCopyDescription(__MCData *self, MCStringRef &r_description)
@@ -1079,6 +1200,9 @@ static bool __MCDataResolveIndirect(__MCData *self)
     // copy.
     if (self -> contents -> references == 1)
     {
+        if (!__MCDataOwnBytes(t_data))
+            return false;
+        
         self -> byte_count = t_data -> byte_count;
         self -> capacity = t_data -> capacity;
         self -> flags |= t_data -> flags;
@@ -1096,7 +1220,7 @@ static bool __MCDataResolveIndirect(__MCData *self)
         if (!MCMemoryNewArray(t_data -> byte_count, self -> bytes))
             return false;
         
-        MCMemoryCopy(self -> bytes, t_data -> bytes, t_data -> byte_count);
+        MCMemoryCopy(self -> bytes, __MCDataGetBytes(t_data), t_data -> byte_count);
 
         self -> byte_count = t_data -> byte_count;
         self -> capacity = t_data -> byte_count;
@@ -1139,3 +1263,46 @@ static bool __MCDataCopyMutable(__MCData *self, __MCData*& r_new_data)
     return true;
 }
 
+static bool __MCDataOwnBytes(__MCData *self)
+{
+    if ((self -> flags & (kMCDataFlagIsSlice | kMCDataFlagIsExternal)) == 0)
+        return true;
+    
+    byte_t *t_bytes;
+    if (!MCMemoryNewArray(self -> byte_count, t_bytes))
+        return false;
+    MCMemoryCopy(t_bytes, __MCDataGetBytes(self), self -> byte_count);
+    
+    if ((self -> flags & kMCDataFlagIsSlice) != 0)
+        MCValueRelease(self -> parent);
+    else
+    {
+        self -> external -> release(self -> external -> context);
+        MCMemoryDelete(self -> external);
+    }
+    
+    self -> bytes = t_bytes;
+    self -> capacity = 0;
+    self -> flags &= ~(kMCDataFlagIsSlice | kMCDataFlagIsExternal);
+    
+    return true;
+}
+
+// Keeping all of a large data ref for the sake of a small part of it wastes
+// memory. This doesn't apply to external parents, such as mapped files, whose
+// bytes don't take up the heap.
+static bool __MCDataUnpinParent(__MCData *self)
+{
+    if ((self -> flags & kMCDataFlagIsSlice) == 0)
+        return true;
+    
+    if ((self -> parent -> flags & kMCDataFlagIsExternal) != 0 ||
+        self -> byte_count >= self -> parent -> byte_count / 16)
+        return true;
+    
+    // Shared data can't be changed.
+    if (__MCValueIsShared(self))
+        return true;
+    
+    return __MCDataOwnBytes(self);
+}
@@ -17,176 +17,289 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include <foundation.h>
 
 #include "foundation-auto.h"
+#include "foundation-filters.h"
 #include "foundation-private.h"
 
+#if defined(__SSE2__) || defined(__X86_64__)
+#include <emmintrin.h>
+#define __MCFILTERS_USE_SSE2__ 1
+#if defined(__X86_64__)
+#include <immintrin.h>
+#define __MCFILTERS_USE_SSSE3__ 1
+#endif
+#endif
+
+#if defined(__VISUALC__)
+#include <intrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
-inline uint8_t isvalid(uint8_t x)
+// The base64 encoders and decoders work a group at a time: three bytes are
+// four chars. Where the CPU allows, blocks of four groups are done at once.
+
+static const char_t kMCFiltersBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The value of each char in the base64 alphabet, and 0xff for the rest.
+static uint8_t s_filters_base64_values[256];
+
+// The number of groups in each line of encoded output.
+#define kMCFiltersBase64GroupsPerLine 18
+
+typedef void (*__MCFilters_Base64EncodeBlockFunction)(const byte_t *p_src, char_t *p_dst);
+typedef bool (*__MCFilters_Base64DecodeBlockFunction)(const char_t *p_src, byte_t *p_dst);
+
+#if defined(__MCFILTERS_USE_SSSE3__)
+// The SSSE3 functions are only used if the CPU supports it, so must be
+// compiled for it regardless of the target.
+#if defined(__VISUALC__)
+#define __MCFILTERS_SSSE3_TARGET
+#else
+#define __MCFILTERS_SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+
+// Encode 12 bytes into 16 chars. Reads 16 bytes from the source.
+__MCFILTERS_SSSE3_TARGET
+static void __MCFilters_Base64EncodeBlock_SSSE3(const byte_t *p_src, char_t *p_dst)
 {
-	return ((x >= 'A' && x <= 'Z') || (x >= 'a' && x <= 'z') ||
-	        (x >= '0' && x <= '9') || x == '+' || x == '/');
+    __m128i t_input;
+    t_input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src));
+    
+    // Spread each group of three bytes over four, then move each 6-bit value
+    // to its own byte.
+    t_input = _mm_shuffle_epi8(t_input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m128i t_high, t_low;
+    t_high = _mm_mulhi_epu16(_mm_and_si128(t_input, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    t_low = _mm_mullo_epi16(_mm_and_si128(t_input, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    __m128i t_values;
+    t_values = _mm_or_si128(t_high, t_low);
+    
+    // Map each value to the offset to add to get its char: 0-25 to 13,
+    // 26-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12.
+    __m128i t_index;
+    t_index = _mm_subs_epu8(t_values, _mm_set1_epi8(51));
+    t_index = _mm_or_si128(t_index, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), t_values), _mm_set1_epi8(13)));
+    __m128i t_offsets;
+    t_offsets = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                               '/' - 63, 'A', 0, 0),
+                                 t_index);
+    
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p_dst), _mm_add_epi8(t_values, t_offsets));
 }
 
-inline uint8_t val(uint8_t x)
+// Decode 16 chars into 12 bytes, returning false (and writing nothing) if
+// any of them isn't in the base64 alphabet. Writes 16 bytes to the
+// destination.
+__MCFILTERS_SSSE3_TARGET
+static bool __MCFilters_Base64DecodeBlock_SSSE3(const char_t *p_src, byte_t *p_dst)
 {
-	return (x >= 'A' && x <= 'Z' ? x - 'A' :
-	        (x >= 'a' && x <= 'z' ? x - 'a' + 26 :
-	         (x >= '0' && x <= '9' ? x - '0' + 52 :
-	          (x == '+' ? 62 : (x == '/' ? 63 : 0)))));
+    __m128i t_input;
+    t_input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src));
+    
+    // Classify the chars by their nibbles - a char is valid only if the bits
+    // for its low and high nibbles don't overlap.
+    __m128i t_high_nibbles, t_low_nibbles;
+    t_high_nibbles = _mm_and_si128(_mm_srli_epi32(t_input, 4), _mm_set1_epi8(0x0f));
+    t_low_nibbles = _mm_and_si128(t_input, _mm_set1_epi8(0x0f));
+    __m128i t_low_bits, t_high_bits;
+    t_low_bits = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a),
+                                  t_low_nibbles);
+    t_high_bits = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+                                   t_high_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(t_low_bits, t_high_bits), _mm_setzero_si128())) != 0)
+        return false;
+    
+    // Map each char to its value by adding an offset chosen by its high
+    // nibble ('/' shares its high nibble with '+' so is adjusted).
+    __m128i t_offsets;
+    t_offsets = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                                 _mm_add_epi8(_mm_cmpeq_epi8(t_input, _mm_set1_epi8('/')), t_high_nibbles));
+    __m128i t_values;
+    t_values = _mm_add_epi8(t_input, t_offsets);
+    
+    // Pack each four 6-bit values into three bytes.
+    __m128i t_packed;
+    t_packed = _mm_maddubs_epi16(t_values, _mm_set1_epi32(0x01400140));
+    t_packed = _mm_madd_epi16(t_packed, _mm_set1_epi32(0x00011000));
+    t_packed = _mm_shuffle_epi8(t_packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p_dst), t_packed);
+    return true;
 }
 
-bool MCFiltersBase64Decode(MCStringRef p_src, MCDataRef& r_dst)
+static bool __MCFilters_HasSSSE3(void)
+{
+#if defined(__VISUALC__)
+    int t_info[4];
+    __cpuid(t_info, 1);
+    return (t_info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+// The block functions for the CPU, if it has any.
+static __MCFilters_Base64EncodeBlockFunction s_filters_base64_encode_block = nil;
+static __MCFilters_Base64DecodeBlockFunction s_filters_base64_decode_block = nil;
+
+// Decode the next group of four chars, skipping any which aren't in the base64
+// alphabet. A pad char ('=') or nul ends the data, as does the end of the
+// source, in which case the partial group is written and false is returned.
+static inline bool __MCFilters_Base64DecodeGroup(const char_t*& x_src, const char_t *p_src_end, byte_t*& x_dst)
 {
-	MCAutoByteArray buffer;
+    uint32_t t_bits;
+    t_bits = 0;
     
-    uint32_t l;
-    MCAutoStringRefAsNativeChars t_native;
-    const char_t *s = nil;
-    byte_t *p = nil;
+    uindex_t t_count;
+    t_count = 0;
+    while (t_count < 4 && x_src != p_src_end)
+    {
+        char_t t_char;
+        t_char = *x_src++;
+        
+        uint8_t t_value;
+        t_value = s_filters_base64_values[t_char];
+        if (t_value != 0xff)
+        {
+            t_bits = (t_bits << 6) | t_value;
+            t_count += 1;
+        }
+        else if (t_char == '=' || t_char == '\0')
+            break;
+    }
+    
+    if (t_count == 4)
+    {
+        *x_dst++ = byte_t(t_bits >> 16);
+        *x_dst++ = byte_t(t_bits >> 8);
+        *x_dst++ = byte_t(t_bits);
+        return true;
+    }
+    
+    t_bits <<= 6 * (4 - t_count);
+    if (t_count >= 2)
+        *x_dst++ = byte_t(t_bits >> 16);
+    if (t_count >= 3)
+        *x_dst++ = byte_t(t_bits >> 8);
     
-    if (!t_native . Lock(p_src, s, l))
+    return false;
+}
+
+bool MCFiltersBase64Decode(MCStringRef p_src, MCDataRef& r_dst)
+{
+    uint32_t t_length;
+    MCAutoStringRefAsNativeChars t_native;
+    const char_t *t_src = nil;
+    if (!t_native . Lock(p_src, t_src, t_length))
         return false;
     
-	if (!buffer . New(l))
+    // Each four chars give at most three bytes; the extra allows for a whole
+    // block to be written at once.
+	MCAutoByteArray t_buffer;
+	if (!t_buffer . New(t_length / 4 * 3 + 16))
 		return false;
     
-	p = buffer . Bytes();
+    const char_t *t_src_end;
+    t_src_end = t_src + t_length;
     
-	uint8_t c[5];
-	c[4] = '\0';
-    
-	while (l)
-	{
-		uint16_t i = 0;
-		int16_t pad = -1;
-		uint32_t d;
-        
-		while (i < 4)
-		{
-			if (l--)
-				c[i] = *s++;
-			else
-				c[i] = '=';
-			if (c[i] && isvalid(c[i]))
-			{
-				i++;
-				continue;
-			}
-			if (c[i] && c[i] != '=')
-				continue;
-			while ((!c[i] || c[i] == '=') && i < 4)
-			{
-				pad++;
-				c[i++] = 0;
-				c[i] = '=';
-			}
-		}
-        
-		d = (val(c[0]) << 18) | (val(c[1]) << 12) | (val(c[2]) << 6) | val(c[3]);
-        
-		if (pad < 2)
-			*p++ = (d & 0xff0000) >> 16;
-		if (pad < 1)
-			*p++ = (d & 0xff00) >> 8;
-		if (pad < 0)
-			*p++ = d & 0xff;
-        
-		if (c[4] == '=')
-		{
-			*p = 0;
-			break;
-		}
-	}
+    byte_t *t_dst;
+	t_dst = t_buffer . Bytes();
     
+    do
+    {
+        if (s_filters_base64_decode_block != nil)
+            while (t_src_end - t_src >= 16 && s_filters_base64_decode_block(t_src, t_dst))
+            {
+                t_src += 16;
+                t_dst += 12;
+            }
+    }
+    while (__MCFilters_Base64DecodeGroup(t_src, t_src_end, t_dst));
     
-	buffer . Shrink(p - buffer . Bytes());
+	t_buffer . Shrink(t_dst - t_buffer . Bytes());
     
-	return buffer . CreateDataAndRelease(r_dst);
+	return t_buffer . CreateDataAndRelease(r_dst);
 }
 
 //////////
 
-inline uint8_t lav(uint8_t x)
+static inline void __MCFilters_Base64EncodeGroup(const byte_t *p_src, char_t *p_dst)
 {
-	return (x <= 25 ? x + 'A' : (x >= 26 && x <= 51 ? x + 'a' - 26 :
-	                             (x >= 52 && x <= 61 ? x + '0' - 52 :
-	                              (x == 62 ? '+' : (x == 63 ? '/' : '?')))));
+    uint32_t t_bits;
+    t_bits = (uint32_t(p_src[0]) << 16) | (uint32_t(p_src[1]) << 8) | p_src[2];
+    p_dst[0] = kMCFiltersBase64Chars[t_bits >> 18];
+    p_dst[1] = kMCFiltersBase64Chars[(t_bits >> 12) & 0x3f];
+    p_dst[2] = kMCFiltersBase64Chars[(t_bits >> 6) & 0x3f];
+    p_dst[3] = kMCFiltersBase64Chars[t_bits & 0x3f];
 }
 
 bool MCFiltersBase64Encode(MCDataRef p_src, MCStringRef& r_dst)
 {
-	MCAutoNativeCharArray buffer;
-	uint32_t size;
+	uindex_t t_size;
+	t_size = MCDataGetLength(p_src);
     
-	const char_t *s = nil;
-	char_t *p = nil;
+	const byte_t *t_src;
+	t_src = MCDataGetBytePtr(p_src);
     
-	size = MCDataGetLength(p_src);
-	s = (char_t *)MCDataGetBytePtr(p_src);
+    // Each (possibly partial) group is four chars, and each full line ends
+    // with a newline.
+    uindex_t t_group_count;
+    t_group_count = (t_size + 2) / 3;
     
-	uint32_t newsize = size * 4 / 3 + size / 54 + 5;
-	if (!buffer.New(newsize))
+	MCAutoNativeCharArray t_buffer;
+	if (!t_buffer . New(t_group_count * 4 + t_group_count / kMCFiltersBase64GroupsPerLine))
 		return false;
     
-	p = buffer.Chars();
-	char_t *linestart = p;
+    const byte_t *t_src_end;
+    t_src_end = t_src + t_size;
     
-	while (size)
-	{
-		uint8_t c[3];
-		uint8_t d;
-		int16_t i = 0;
-		int16_t pad = -1;
+    char_t *t_dst;
+	t_dst = t_buffer . Chars();
+    
+    while (t_src != t_src_end)
+    {
+        uindex_t t_line_size;
+        t_line_size = MCMin(uindex_t(t_src_end - t_src), uindex_t(kMCFiltersBase64GroupsPerLine * 3));
         
-		while (i < 3)
-		{
-			if (size)
-			{
-				c[i++] = *s++;
-				size--;
-			}
-			else
-			{
-				c[i++] = 0;
-				pad++;
-			}
-		}
+        const byte_t *t_line_end;
+        t_line_end = t_src + t_line_size;
         
-		d = c[0] >> 2;
-		*p++ = lav(d);
+        // The block functions read a little past the bytes they encode.
+        if (s_filters_base64_encode_block != nil)
+            while (t_line_end - t_src >= 12 && t_src_end - t_src >= 16)
+            {
+                s_filters_base64_encode_block(t_src, t_dst);
+                t_src += 12;
+                t_dst += 16;
+            }
         
-		if (pad < 2)
-		{
-			d = ((c[0] & 0x3) << 4) | (c[1] >> 4);
-			*p++ = lav(d);
-		}
-		else
-			*p++ = '=';
+        for(; t_line_end - t_src >= 3; t_src += 3, t_dst += 4)
+            __MCFilters_Base64EncodeGroup(t_src, t_dst);
         
-		if (pad < 1)
-		{
-			d = ((c[1] & 0xf) << 2) | (c[2] >> 6);
-			*p++ = lav(d);
-		}
-		else
-			*p++ = '=';
+        if (t_src != t_line_end)
+        {
+            byte_t t_last[3] = { 0, 0, 0 };
+            MCMemoryCopy(t_last, t_src, t_line_end - t_src);
+            __MCFilters_Base64EncodeGroup(t_last, t_dst);
+            t_dst[3] = '=';
+            if (t_line_end - t_src == 1)
+                t_dst[2] = '=';
+            t_src = t_line_end;
+            t_dst += 4;
+        }
         
-		if (pad < 0)
-		{
-			d = c[2] & 0x3f;
-			*p++ = lav(d);
-		}
-		else
-			*p++ = '=';
-		if (p - linestart == 72)
-		{
-			*p++ = '\n';
-			linestart = p;
-		}
-	}
+        // A line which ends with a partial group is still a full line.
+        if ((t_line_size + 2) / 3 == kMCFiltersBase64GroupsPerLine)
+            *t_dst++ = '\n';
+    }
     
-	buffer.Shrink(p - buffer.Chars());
-	return buffer.CreateStringAndRelease(r_dst);
+	return t_buffer . CreateStringAndRelease(r_dst);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +423,276 @@ bool MCFiltersDecompress(MCDataRef p_source, MCDataRef& r_result)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// The amount of output space made available to zlib on each step; pending
+// output grows by this much at a time until the client reads it.
+#define COMPRESSION_STREAM_CHUNK_SIZE 16384
+
+struct __MCFiltersCompressionStream
+{
+	z_stream zstream;
+	bool compress;
+	bool ended;
+	byte_t *output;
+	size_t output_offset;
+	size_t output_length;
+	size_t output_capacity;
+};
+
+static inline __MCFiltersCompressionStream *__MCFiltersCompressionStreamGet(MCStreamRef p_stream)
+{
+	return (__MCFiltersCompressionStream *)MCStreamGetExtraBytesPtr(p_stream);
+}
+
+static int __MCFiltersCompressionFormatWindowBits(MCFiltersCompressionFormat p_format)
+{
+	switch(p_format)
+	{
+		case kMCFiltersCompressionFormatGzip:
+			return MAX_WBITS + 16;
+		case kMCFiltersCompressionFormatZlib:
+			return MAX_WBITS;
+		case kMCFiltersCompressionFormatDeflate:
+		default:
+			return -MAX_WBITS;
+	}
+}
+
+// Make sure there is at least a chunk of free space after the pending output,
+// moving the pending output to the front of the buffer first.
+static bool __MCFiltersCompressionStreamEnsureOutputSpace(__MCFiltersCompressionStream *self)
+{
+	if (self -> output_offset != 0)
+	{
+		size_t t_pending;
+		t_pending = self -> output_length - self -> output_offset;
+		if (t_pending != 0)
+			MCMemoryMove(self -> output, self -> output + self -> output_offset, t_pending);
+		self -> output_length = t_pending;
+		self -> output_offset = 0;
+	}
+	
+	if (self -> output_capacity - self -> output_length >= COMPRESSION_STREAM_CHUNK_SIZE)
+		return true;
+	
+	size_t t_new_capacity;
+	t_new_capacity = MCMax(self -> output_capacity * 2, self -> output_length + COMPRESSION_STREAM_CHUNK_SIZE);
+	if (!MCMemoryReallocate(self -> output, t_new_capacity, self -> output))
+		return false;
+	self -> output_capacity = t_new_capacity;
+	return true;
+}
+
+// Run the given input through zlib, appending whatever it produces to the
+// pending output. With Z_FINISH this continues until the end of the compressed
+// stream has been written.
+static bool __MCFiltersCompressionStreamProcess(__MCFiltersCompressionStream *self, const byte_t *p_input, size_t p_amount, int p_flush)
+{
+	if (self -> ended)
+	{
+		if (p_amount == 0)
+			return true;
+		return MCErrorThrowGeneric(MCSTR("data after end of compressed stream"));
+	}
+	
+	for(;;)
+	{
+		// zlib counts input in uInt, so large buffers are fed a piece at a time.
+		uInt t_input_amount;
+		t_input_amount = (uInt)MCMin(p_amount, (size_t)(1 << 30));
+		self -> zstream . next_in = (Bytef *)p_input;
+		self -> zstream . avail_in = t_input_amount;
+		
+		bool t_last_input;
+		t_last_input = t_input_amount == p_amount;
+		
+		int t_flush;
+		t_flush = t_last_input ? p_flush : Z_NO_FLUSH;
+		
+		for(;;)
+		{
+			if (!__MCFiltersCompressionStreamEnsureOutputSpace(self))
+				return MCErrorThrowOutOfMemory();
+			
+			uInt t_space;
+			t_space = (uInt)(self -> output_capacity - self -> output_length);
+			self -> zstream . next_out = self -> output + self -> output_length;
+			self -> zstream . avail_out = t_space;
+			
+			int t_result;
+			if (self -> compress)
+				t_result = deflate(&self -> zstream, t_flush);
+			else
+				t_result = inflate(&self -> zstream, Z_NO_FLUSH);
+			
+			self -> output_length += t_space - self -> zstream . avail_out;
+			
+			if (t_result == Z_STREAM_END)
+			{
+				self -> ended = true;
+				if (self -> zstream . avail_in != 0 || !t_last_input)
+					return MCErrorThrowGeneric(MCSTR("data after end of compressed stream"));
+				return true;
+			}
+			
+			// Z_BUF_ERROR just means no progress was possible with the space
+			// and input given, which only matters if there was space left.
+			if (t_result != Z_OK && t_result != Z_BUF_ERROR)
+				return MCErrorThrowGeneric(self -> compress ? MCSTR("could not compress data") : MCSTR("invalid compressed data"));
+			
+			if (self -> zstream . avail_out != 0 && self -> zstream . avail_in == 0 && t_flush != Z_FINISH)
+				break;
+			
+			if (t_result == Z_BUF_ERROR && self -> zstream . avail_out != 0)
+				break;
+		}
+		
+		if (t_last_input)
+			break;
+		
+		p_input += t_input_amount;
+		p_amount -= t_input_amount;
+	}
+	
+	if (p_flush == Z_FINISH && !self -> ended)
+		return MCErrorThrowGeneric(MCSTR("compressed data is truncated"));
+	
+	return true;
+}
+
+static void __MCFiltersCompressionStreamDestroy(MCStreamRef p_stream)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	if (self -> compress)
+		deflateEnd(&self -> zstream);
+	else
+		inflateEnd(&self -> zstream);
+	MCMemoryDeallocate(self -> output);
+}
+
+static bool __MCFiltersCompressionStreamIsFinished(MCStreamRef p_stream, bool& r_finished)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	r_finished = self -> ended && self -> output_offset == self -> output_length;
+	return true;
+}
+
+static bool __MCFiltersCompressionStreamGetAvailableForRead(MCStreamRef p_stream, size_t& r_amount)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	r_amount = self -> output_length - self -> output_offset;
+	return true;
+}
+
+static bool __MCFiltersCompressionStreamRead(MCStreamRef p_stream, void *p_buffer, size_t p_amount)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	if (p_amount > self -> output_length - self -> output_offset)
+		return false;
+	MCMemoryCopy(p_buffer, self -> output + self -> output_offset, p_amount);
+	self -> output_offset += p_amount;
+	return true;
+}
+
+static bool __MCFiltersCompressionStreamGetAvailableForWrite(MCStreamRef p_stream, size_t& r_amount)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	r_amount = self -> ended ? 0 : SIZE_MAX;
+	return true;
+}
+
+static bool __MCFiltersCompressionStreamWrite(MCStreamRef p_stream, const void *p_buffer, size_t p_amount)
+{
+	return __MCFiltersCompressionStreamProcess(__MCFiltersCompressionStreamGet(p_stream), (const byte_t *)p_buffer, p_amount, Z_NO_FLUSH);
+}
+
+static bool __MCFiltersCompressionStreamSkip(MCStreamRef p_stream, size_t p_amount)
+{
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(p_stream);
+	if (p_amount > self -> output_length - self -> output_offset)
+		return false;
+	self -> output_offset += p_amount;
+	return true;
+}
+
+static MCStreamCallbacks kMCFiltersCompressionStreamCallbacks =
+{
+	__MCFiltersCompressionStreamDestroy,
+	__MCFiltersCompressionStreamIsFinished,
+	__MCFiltersCompressionStreamGetAvailableForRead,
+	__MCFiltersCompressionStreamRead,
+	__MCFiltersCompressionStreamGetAvailableForWrite,
+	__MCFiltersCompressionStreamWrite,
+	__MCFiltersCompressionStreamSkip,
+	nil,
+	nil,
+	nil,
+	nil,
+};
+
+static bool __MCFiltersCompressionStreamCreate(bool p_compress, MCFiltersCompressionFormat p_format, int p_level, MCStreamRef& r_stream)
+{
+	if (p_level < Z_DEFAULT_COMPRESSION || p_level > Z_BEST_COMPRESSION)
+		return MCErrorThrowGeneric(MCSTR("compression level out of range"));
+	
+	MCStreamRef t_stream;
+	if (!MCStreamCreate(&kMCFiltersCompressionStreamCallbacks, sizeof(__MCFiltersCompressionStream), t_stream))
+		return false;
+	
+	// The extra bytes start out zeroed, so destroy is safe even if zlib fails
+	// to initialize (deflateEnd and inflateEnd reject an unset stream).
+	__MCFiltersCompressionStream *self;
+	self = __MCFiltersCompressionStreamGet(t_stream);
+	self -> compress = p_compress;
+	
+	int t_result;
+	if (p_compress)
+		t_result = deflateInit2(&self -> zstream, p_level, Z_DEFLATED, __MCFiltersCompressionFormatWindowBits(p_format), 8, Z_DEFAULT_STRATEGY);
+	else
+		t_result = inflateInit2(&self -> zstream, __MCFiltersCompressionFormatWindowBits(p_format));
+	
+	if (t_result != Z_OK)
+	{
+		MCValueRelease(t_stream);
+		if (t_result == Z_MEM_ERROR)
+			return MCErrorThrowOutOfMemory();
+		return MCErrorThrowGeneric(MCSTR("could not initialize compression"));
+	}
+	
+	r_stream = t_stream;
+	return true;
+}
+
+bool MCFiltersCompressStreamCreate(MCFiltersCompressionFormat p_format, int p_level, MCStreamRef& r_stream)
+{
+	return __MCFiltersCompressionStreamCreate(true, p_format, p_level, r_stream);
+}
+
+bool MCFiltersDecompressStreamCreate(MCFiltersCompressionFormat p_format, MCStreamRef& r_stream)
+{
+	return __MCFiltersCompressionStreamCreate(false, p_format, Z_DEFAULT_COMPRESSION, r_stream);
+}
+
+bool MCFiltersIsCompressionStream(MCStreamRef p_stream)
+{
+	return MCStreamGetCallbacks(p_stream) == &kMCFiltersCompressionStreamCallbacks;
+}
+
+bool MCFiltersCompressionStreamFinish(MCStreamRef p_stream)
+{
+	if (!MCFiltersIsCompressionStream(p_stream))
+		return MCErrorThrowGeneric(MCSTR("stream is not a compression stream"));
+	
+	return __MCFiltersCompressionStreamProcess(__MCFiltersCompressionStreamGet(p_stream), nil, 0, Z_FINISH);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 static const char * const url_table[256] =
 {
     "%00", "%01", "%02", "%03", "%04", "%05", "%06", "%07", "%08", "%09",
@@ -338,52 +721,134 @@ static const char * const url_table[256] =
     "%F7", "%F8", "%F9", "%FA", "%FB", "%FC", "%FD", "%FE", "%FF"
 };
 
+// The length of each byte's entry in the url table.
+static uint8_t s_filters_url_lengths[256];
+
+static inline void __MCFilters_UrlEncodeChar(char_t p_char, char_t*& x_dst)
+{
+    MCMemoryCopy(x_dst, url_table[p_char], s_filters_url_lengths[p_char]);
+    x_dst += s_filters_url_lengths[p_char];
+}
+
+#if defined(__MCFILTERS_USE_SSE2__)
+static inline __m128i __MCFilters_InRange_SSE2(__m128i p_chars, char p_first, char p_last)
+{
+    // All the ranges are ASCII, so signed comparison rules out chars >= 128.
+    return _mm_and_si128(_mm_cmpgt_epi8(p_chars, _mm_set1_epi8(char(p_first - 1))),
+                         _mm_cmplt_epi8(p_chars, _mm_set1_epi8(char(p_last + 1))));
+}
+
+// Returns a mask of the chars in the block which are left as they are when
+// url-encoded.
+static inline __m128i __MCFilters_UrlUnchanged_SSE2(__m128i p_chars)
+{
+    __m128i t_mask;
+    t_mask = _mm_or_si128(__MCFilters_InRange_SSE2(p_chars, 'a', 'z'),
+                          __MCFilters_InRange_SSE2(p_chars, 'A', 'Z'));
+    t_mask = _mm_or_si128(t_mask, __MCFilters_InRange_SSE2(p_chars, '0', '9'));
+    t_mask = _mm_or_si128(t_mask, __MCFilters_InRange_SSE2(p_chars, '-', '.'));
+    t_mask = _mm_or_si128(t_mask, _mm_cmpeq_epi8(p_chars, _mm_set1_epi8('*')));
+    return _mm_or_si128(t_mask, _mm_cmpeq_epi8(p_chars, _mm_set1_epi8('_')));
+}
+
+// Url-encode a block of 16 chars if each stays a single char (i.e. none of
+// them needs escaping), returning false otherwise.
+static inline bool __MCFilters_UrlEncodeBlock_SSE2(const char_t *p_src, char_t *p_dst)
+{
+    __m128i t_chars, t_spaces;
+    t_chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src));
+    t_spaces = _mm_cmpeq_epi8(t_chars, _mm_set1_epi8(' '));
+    if (_mm_movemask_epi8(_mm_or_si128(t_spaces, __MCFilters_UrlUnchanged_SSE2(t_chars))) != 0xffff)
+        return false;
+    
+    if (p_dst != nil)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p_dst),
+                         _mm_add_epi8(t_chars, _mm_and_si128(t_spaces, _mm_set1_epi8('+' - ' '))));
+    return true;
+}
+#endif
+
 bool MCFiltersUrlEncode(MCStringRef p_source, MCStringRef& r_result)
 {
 	MCAutoStringRefAsUTF8String t_utf8_string;
-	const char *s;
-	uindex_t l;
-	uindex_t size;
     
     // SN-2014-11-13: [[ Bug 14015 ]] We don't want to nativise the string,
     // but rather to encode it in UTF-8 and write the bytes (a '%' will be added).
 	if (!t_utf8_string.Lock (p_source))
         return false;
     
-	s = *t_utf8_string;
-	l = t_utf8_string.Size();
-	size = l + 1;
-	size += size / 4;
+    const char_t *t_src;
+	t_src = (const char_t *)*t_utf8_string;
     
-    MCAutoNativeCharArray buffer;
-    if (!buffer . New(size))
-        return false;
+    uindex_t t_length;
+	t_length = t_utf8_string.Size();
     
-    char_t *dptr = buffer . Chars();
-    while (l--)
+    // Measure the result first, so it can be written straight into a buffer
+    // of the right size.
+    uindex_t t_size, t_offset;
+    t_size = 0;
+    t_offset = 0;
+#if defined(__MCFILTERS_USE_SSE2__)
+    for(; t_offset + 16 <= t_length; t_offset += 16)
     {
-        if (dptr - buffer . Chars() + 7 > size)
-        {
-            uint32_t newsize = size + size / 4 + 7;
-            uint32_t offset = dptr - buffer . Chars();
-            if (!buffer . Extend(newsize))
-                return false;
-            dptr = buffer . Chars() + offset;
-            size = newsize;
-        }
-        const char_t *sptr = (const char_t *)url_table[(uint8_t)*s++];
-        do
-        {
-            *dptr++ = *sptr++;
-        }
-        while (*sptr);
+        if (__MCFilters_UrlEncodeBlock_SSE2(t_src + t_offset, nil))
+            t_size += 16;
+        else
+            for(uindex_t i = 0; i < 16; i++)
+                t_size += s_filters_url_lengths[t_src[t_offset + i]];
     }
+#endif
+    for(; t_offset < t_length; t_offset++)
+        t_size += s_filters_url_lengths[t_src[t_offset]];
     
-    buffer . Shrink(dptr - buffer . Chars());
+    MCAutoNativeCharArray t_buffer;
+    if (!t_buffer . New(t_size))
+        return false;
     
-    return buffer . CreateStringAndRelease(r_result);
+    char_t *t_dst;
+    t_dst = t_buffer . Chars();
+    t_offset = 0;
+#if defined(__MCFILTERS_USE_SSE2__)
+    for(; t_offset + 16 <= t_length; t_offset += 16)
+    {
+        if (__MCFilters_UrlEncodeBlock_SSE2(t_src + t_offset, t_dst))
+            t_dst += 16;
+        else
+            for(uindex_t i = 0; i < 16; i++)
+                __MCFilters_UrlEncodeChar(t_src[t_offset + i], t_dst);
+    }
+#endif
+    for(; t_offset < t_length; t_offset++)
+        __MCFilters_UrlEncodeChar(t_src[t_offset], t_dst);
+    
+    return t_buffer . CreateStringAndRelease(r_result);
+}
+
+static inline uint8_t __MCFilters_UrlHexValue(uint8_t p_char)
+{
+    uint8_t t_char;
+    t_char = MCNativeCharUppercase(p_char);
+    if (isdigit(t_char))
+        return t_char - '0';
+    if (t_char >= 'A' && t_char <= 'F')
+        return t_char - 'A' + 10;
+    return 0;
 }
 
+#if defined(__MCFILTERS_USE_SSE2__)
+// The index of the lowest set bit of the (non-zero) mask.
+static inline uindex_t __MCFilters_LowestBit(uint32_t p_mask)
+{
+#if defined(__VISUALC__)
+    unsigned long t_index;
+    _BitScanForward(&t_index, p_mask);
+    return t_index;
+#else
+    return __builtin_ctz(p_mask);
+#endif
+}
+#endif
+
 bool MCFiltersUrlDecode(MCStringRef p_source, MCStringRef& r_result)
 {
     // SN-2014-11-13: [[ Bug 14015 ]] We don't want to use a nativised string, but
@@ -406,23 +871,45 @@ bool MCFiltersUrlDecode(MCStringRef p_source, MCStringRef& r_result)
     uint8_t *dptr = (uint8_t*)t_buffer . Bytes();
     while (sptr < eptr)
     {
+#if defined(__MCFILTERS_USE_SSE2__)
+        // Copy chars a block at a time up to the next one that changes. The
+        // output is never longer than the input, so there is room to store
+        // the whole block.
+        if (eptr - sptr >= 16)
+        {
+            __m128i t_chars;
+            t_chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sptr));
+            
+            uint32_t t_mask;
+            t_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(t_chars, _mm_set1_epi8('%')),
+                                                                 _mm_cmpeq_epi8(t_chars, _mm_set1_epi8('+'))),
+                                                    _mm_cmpeq_epi8(t_chars, _mm_set1_epi8('\r'))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dptr), t_chars);
+            if (t_mask == 0)
+            {
+                sptr += 16;
+                dptr += 16;
+                continue;
+            }
+            
+            uindex_t t_unchanged;
+            t_unchanged = __MCFilters_LowestBit(t_mask);
+            sptr += t_unchanged;
+            dptr += t_unchanged;
+        }
+#endif
+        
         if (*sptr == '%')
         {
-            uint8_t source = MCNativeCharUppercase(*++sptr);
+            // A truncated escape takes the missing digits as zero.
             uint8_t value = 0;
-            if (isdigit(source))
-                value = (source - '0') << 4;
-            else
-                if (source >= 'A' && source <= 'F')
-                    value = (source - 'A' + 10) << 4;
-            source = MCNativeCharUppercase(*++sptr);
-            if (isdigit(source))
-                value += source - '0';
-            else
-                if (source >= 'A' && source <= 'F')
-                    value += source - 'A' + 10;
+            if (sptr + 1 < eptr)
+                value = __MCFilters_UrlHexValue(sptr[1]) << 4;
+            if (sptr + 2 < eptr)
+                value += __MCFilters_UrlHexValue(sptr[2]);
             if (value != 13)
                 *dptr++ = value;
+            sptr += 2;
         }
         else
             if (*sptr == '+')
@@ -430,7 +917,7 @@ bool MCFiltersUrlDecode(MCStringRef p_source, MCStringRef& r_result)
             else
                 if (*sptr == '\r')
                 {
-                    if (*(sptr + 1) == '\n')
+                    if (sptr + 1 < eptr && *(sptr + 1) == '\n')
                         sptr++;
                     *dptr++ = '\n';
                 }
@@ -448,3 +935,149 @@ bool MCFiltersUrlDecode(MCStringRef p_source, MCStringRef& r_result)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// The value of each hex digit, and 0xff for the rest.
+static uint8_t s_filters_hex_values[256];
+
+static const char_t kMCFiltersHexDigits[] = "0123456789abcdef";
+
+#if defined(__MCFILTERS_USE_SSE2__)
+static inline __m128i __MCFilters_HexDigits_SSE2(__m128i p_nibbles)
+{
+    __m128i t_letters;
+    t_letters = _mm_cmpgt_epi8(p_nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(p_nibbles, _mm_set1_epi8('0')),
+                        _mm_and_si128(t_letters, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+// Convert 16 hex digits to their values, returning false if any of them isn't
+// a hex digit.
+static inline bool __MCFilters_HexValues_SSE2(const char_t *p_chars, __m128i& r_values)
+{
+    __m128i t_chars;
+    t_chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars));
+    
+    // A char is a digit if subtracting '0' gives at most 9, and a letter if
+    // subtracting 'a' from its lowercase form gives at most 5.
+    __m128i t_digits, t_letters, t_is_digit, t_is_letter;
+    t_digits = _mm_sub_epi8(t_chars, _mm_set1_epi8('0'));
+    t_letters = _mm_sub_epi8(_mm_or_si128(t_chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    t_is_digit = _mm_cmpeq_epi8(_mm_min_epu8(t_digits, _mm_set1_epi8(9)), t_digits);
+    t_is_letter = _mm_cmpeq_epi8(_mm_min_epu8(t_letters, _mm_set1_epi8(5)), t_letters);
+    if (_mm_movemask_epi8(_mm_or_si128(t_is_digit, t_is_letter)) != 0xffff)
+        return false;
+    
+    r_values = _mm_or_si128(_mm_and_si128(t_is_digit, t_digits),
+                            _mm_and_si128(t_is_letter, _mm_add_epi8(t_letters, _mm_set1_epi8(10))));
+    return true;
+}
+#endif
+
+void MCFiltersHexEncodeBytes(const byte_t *p_bytes, uindex_t p_byte_count, bool p_high_nibble_first, char_t *r_chars)
+{
+    uindex_t t_offset;
+    t_offset = 0;
+    
+#if defined(__MCFILTERS_USE_SSE2__)
+    for(; t_offset + 16 <= p_byte_count; t_offset += 16)
+    {
+        __m128i t_bytes, t_high, t_low;
+        t_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_bytes + t_offset));
+        t_high = __MCFilters_HexDigits_SSE2(_mm_and_si128(_mm_srli_epi16(t_bytes, 4), _mm_set1_epi8(0x0f)));
+        t_low = __MCFilters_HexDigits_SSE2(_mm_and_si128(t_bytes, _mm_set1_epi8(0x0f)));
+        
+        __m128i t_first, t_second;
+        t_first = p_high_nibble_first ? t_high : t_low;
+        t_second = p_high_nibble_first ? t_low : t_high;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_chars + t_offset * 2), _mm_unpacklo_epi8(t_first, t_second));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_chars + t_offset * 2 + 16), _mm_unpackhi_epi8(t_first, t_second));
+    }
+#endif
+    
+    for(; t_offset < p_byte_count; t_offset++)
+    {
+        byte_t t_byte;
+        t_byte = p_bytes[t_offset];
+        r_chars[t_offset * 2] = kMCFiltersHexDigits[p_high_nibble_first ? t_byte >> 4 : t_byte & 0xf];
+        r_chars[t_offset * 2 + 1] = kMCFiltersHexDigits[p_high_nibble_first ? t_byte & 0xf : t_byte >> 4];
+    }
+}
+
+bool MCFiltersHexDecodeChars(const char_t *p_chars, uindex_t p_byte_count, bool p_high_nibble_first, byte_t *r_bytes)
+{
+    uindex_t t_offset;
+    t_offset = 0;
+    
+#if defined(__MCFILTERS_USE_SSE2__)
+    for(; t_offset + 16 <= p_byte_count; t_offset += 16)
+    {
+        __m128i t_first, t_second;
+        if (!__MCFilters_HexValues_SSE2(p_chars + t_offset * 2, t_first) ||
+            !__MCFilters_HexValues_SSE2(p_chars + t_offset * 2 + 16, t_second))
+            return false;
+        
+        // Each 16-bit lane holds the values of a pair of digits, the first in
+        // the low byte.
+        if (p_high_nibble_first)
+        {
+            t_first = _mm_or_si128(_mm_slli_epi16(t_first, 4), _mm_srli_epi16(t_first, 8));
+            t_second = _mm_or_si128(_mm_slli_epi16(t_second, 4), _mm_srli_epi16(t_second, 8));
+        }
+        else
+        {
+            t_first = _mm_or_si128(t_first, _mm_srli_epi16(t_first, 4));
+            t_second = _mm_or_si128(t_second, _mm_srli_epi16(t_second, 4));
+        }
+        
+        __m128i t_mask;
+        t_mask = _mm_set1_epi16(0xff);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_bytes + t_offset),
+                         _mm_packus_epi16(_mm_and_si128(t_first, t_mask), _mm_and_si128(t_second, t_mask)));
+    }
+#endif
+    
+    for(; t_offset < p_byte_count; t_offset++)
+    {
+        uint8_t t_first, t_second;
+        t_first = s_filters_hex_values[p_chars[t_offset * 2]];
+        t_second = s_filters_hex_values[p_chars[t_offset * 2 + 1]];
+        if (t_first == 0xff || t_second == 0xff)
+            return false;
+        
+        r_bytes[t_offset] = p_high_nibble_first ? (t_first << 4) | t_second : t_first | (t_second << 4);
+    }
+    
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Choose the fastest block functions for the CPU, and compute the tables.
+bool __MCFiltersInitialize(void)
+{
+#if defined(__MCFILTERS_USE_SSSE3__)
+    if (__MCFilters_HasSSSE3())
+    {
+        s_filters_base64_encode_block = __MCFilters_Base64EncodeBlock_SSSE3;
+        s_filters_base64_decode_block = __MCFilters_Base64DecodeBlock_SSSE3;
+    }
+#endif
+    
+    MCMemoryFill(s_filters_base64_values, sizeof(s_filters_base64_values), 0xff);
+    for(uindex_t i = 0; i < 64; i++)
+        s_filters_base64_values[kMCFiltersBase64Chars[i]] = uint8_t(i);
+    
+    for(uindex_t i = 0; i < 256; i++)
+        s_filters_url_lengths[i] = uint8_t(strlen(url_table[i]));
+    
+    MCMemoryFill(s_filters_hex_values, sizeof(s_filters_hex_values), 0xff);
+    for(uindex_t i = 0; i < 16; i++)
+    {
+        s_filters_hex_values[kMCFiltersHexDigits[i]] = uint8_t(i);
+        s_filters_hex_values[MCNativeCharUppercase(kMCFiltersHexDigits[i])] = uint8_t(i);
+    }
+    
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
@@ -28,14 +28,98 @@ MC_DLLEXPORT_DEF MCNameRef kMCFalseName;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static MCNameRef *s_name_table;
-static uindex_t s_name_table_occupancy;
-static uindex_t s_name_table_capacity;
+/* NAME TABLE
+ *
+ * The name table is split into shards, chosen by the top bits of a name's
+ * hash, so that threads creating names rarely contend with each other. Each
+ * shard is a chained hash table in which the names of a caseless equivalence
+ * class are adjacent, with the representative (key) of the class first.
+ *
+ * Searching a shard for an existing name takes no lock. Instead, searchers
+ * count themselves in as readers of the shard, and a thread which unlinks a
+ * name (or replaces the shard's chains) waits for the readers which might
+ * have seen it to finish before it is freed. Adding and removing names, and
+ * resizing a shard, take the shard's lock.
+ *
+ * Names are always shared, so their reference counts are atomic. A name whose
+ * count has reached zero is being destroyed and is treated as though it has
+ * already been removed - names are only ever retained from the table if their
+ * count is not zero.
+ */
 
-////////////////////////////////////////////////////////////////////////////////
+enum
+{
+    kMCNameTableShardBits = 4,
+    kMCNameTableShardCount = 1 << kMCNameTableShardBits,
+    
+    // The initial, and minimum, number of chains in a shard.
+    kMCNameTableShardMinCapacity = 64,
+};
+
+#ifdef __32_BIT__
+static const uindex_t kMCNameHashBits = 32;
+#else
+static const uindex_t kMCNameHashBits = kMCValueFlagsNameHashBits + 4;
+#endif
+
+struct __MCNameChains
+{
+    uindex_t capacity;
+    __MCName *chains[1];
+};
+
+struct __MCNameShardState
+{
+    // The chains are replaced, rather than resized, when the shard is resized
+    // so a searcher always sees a consistent capacity.
+    __MCNameChains *chains;
+    
+    // Incremented at the start and end of a resize, so it is odd while one is
+    // in progress. Names move between chains during a resize, so a search
+    // which misses while one is happening must be retried.
+    uint32_t resizes;
+    
+    // Only the bottom bit of the epoch matters - readers are counted in the
+    // epoch which was current when they started.
+    uint32_t epoch;
+    uint32_t readers[2];
+    
+    // Non-zero while a thread is changing the shard.
+    uint32_t lock;
+    
+    // The number of names in the shard, and the number of equivalence classes
+    // they fall into (which is what determines when to resize).
+    uindex_t name_count;
+    uindex_t occupancy;
+};
+
+// Shards are padded out to a cache line so that changing one doesn't slow down
+// searches of its neighbours.
+enum
+{
+    kMCNameShardSize = 64,
+};
+
+struct __MCNameShard: public __MCNameShardState
+{
+    char padding[kMCNameShardSize - sizeof(__MCNameShardState) % kMCNameShardSize];
+};
 
-static void __MCNameGrowTable(void);
-static void __MCNameShrinkTable(void);
+static_assert(sizeof(__MCNameShard) % kMCNameShardSize == 0,
+              "Expected name table shards to fill whole cache lines");
+
+static __MCNameShard s_name_table[kMCNameTableShardCount];
+
+// The lookup counters are shared by all threads. They are only statistics, so
+// they are updated with relaxed atomics rather than under a lock.
+struct __MCNameLookupStatistics
+{
+    uint32_t lookups;
+    uint32_t probes;
+    uint32_t longest_probe;
+};
+
+static __MCNameLookupStatistics s_name_lookup_statistics;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -45,15 +129,21 @@ static void __MCNameShrinkTable(void);
  * __MCName structure.
  *
  * On 64-bit systems, in order to minimize the size of the name struct, it is
- * stored partially in the flags word (28-bits) and then the remaining 4-bits
+ * stored partially in the flags word (26-bits) and then a further 4-bits
  * split equally between the bottom two bits of the next and key ptr fields.
+ * The top two bits of the hash are discarded as the remaining bits of the
+ * flags word are needed for the interred and shared flags.
  *
  * The following 'accessor' functions hide the bit-twiddling details of this.
  */
 
 static inline hash_t __MCNameReduceHash(hash_t p_hash)
 {
+#ifdef __32_BIT__
     return p_hash;
+#else
+    return p_hash & ((1U << (kMCValueFlagsNameHashBits + 4)) - 1);
+#endif
 }
 
 static inline hash_t __MCNameGetHash(__MCName* p_name)
@@ -72,9 +162,9 @@ static inline void __MCNameSetHash(__MCName* p_name, hash_t p_hash)
 #ifdef __32_BIT__
     p_name->hash = p_hash;
 #else
-    p_name->flags = (p_name->flags & kMCValueFlagsTypeCodeMask) | (p_hash & kMCValueFlagsNameHashMask);
+    p_name->flags = (p_name->flags & ~kMCValueFlagsNameHashMask) | (p_hash & kMCValueFlagsNameHashMask);
     p_name->next = (p_name->next & ~0x3) | ((p_hash >> kMCValueFlagsNameHashBits) & 0x3);
-    p_name->key = (p_name->key & ~0x3) | ((p_hash >> (kMCValueFlagsNameHashBits + 2)));
+    p_name->key = (p_name->key & ~0x3) | ((p_hash >> (kMCValueFlagsNameHashBits + 2)) & 0x3);
 #endif
 }
 
@@ -214,6 +304,324 @@ static hash_t __MCNameIndexHash(const char_t *p_chars, uindex_t p_char_count)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static inline __MCNameShard& __MCNameGetShard(hash_t p_hash)
+{
+    return s_name_table[p_hash >> (kMCNameHashBits - kMCNameTableShardBits)];
+}
+
+static inline __MCName *& __MCNameGetChain(__MCNameChains *p_chains, hash_t p_hash)
+{
+    // The capacity is always a power-of-two, so its just a mask op.
+    return p_chains -> chains[p_hash & (p_chains -> capacity - 1)];
+}
+
+static void __MCNameShardLock(__MCNameShard& x_shard)
+{
+    // Changes to a shard are brief, so just spin.
+    while(!__MCAtomicCompareAndSwap(x_shard . lock, 0, 1))
+        continue;
+}
+
+static void __MCNameShardUnlock(__MCNameShard& x_shard)
+{
+    __MCAtomicCompareAndSwap(x_shard . lock, 1, 0);
+}
+
+// Count the calling thread in as a reader of the shard, returning the epoch it
+// was counted in.
+static inline uint32_t __MCNameShardBeginRead(__MCNameShard& x_shard)
+{
+    for(;;)
+    {
+        uint32_t t_epoch;
+        t_epoch = __MCAtomicLoad(x_shard . epoch) & 1;
+        __MCAtomicIncrement(x_shard . readers[t_epoch]);
+        
+        // If the epoch changed before we were counted, a thread synchronizing
+        // the shard might have already stopped waiting for that epoch's
+        // readers, so try again.
+        if ((__MCAtomicLoad(x_shard . epoch) & 1) == t_epoch)
+            return t_epoch;
+        
+        __MCAtomicDecrement(x_shard . readers[t_epoch]);
+    }
+}
+
+static inline void __MCNameShardEndRead(__MCNameShard& x_shard, uint32_t p_epoch)
+{
+    __MCAtomicDecrement(x_shard . readers[p_epoch]);
+}
+
+// Wait for every reader which might still be looking at something which has
+// been unlinked from the shard to finish. Readers which start afterwards can't
+// find it, so it can then be freed. The shard's lock must be held.
+static void __MCNameShardSynchronize(__MCNameShard& x_shard)
+{
+    uint32_t t_old_epoch;
+    t_old_epoch = (__MCAtomicIncrement(x_shard . epoch) - 1) & 1;
+    while(__MCAtomicLoad(x_shard . readers[t_old_epoch]) != 0)
+        continue;
+}
+
+static bool __MCNameCreateChains(uindex_t p_capacity, __MCNameChains*& r_chains)
+{
+    void *t_chains;
+    if (!MCMemoryNew(sizeof(__MCNameChains) + (p_capacity - 1) * sizeof(__MCName *), t_chains))
+        return false;
+    
+    r_chains = static_cast<__MCNameChains *>(t_chains);
+    r_chains -> capacity = p_capacity;
+    
+    return true;
+}
+
+// Move the shard's names into new chains of the given capacity. The shard's
+// lock must be held.
+static void __MCNameShardResize(__MCNameShard& x_shard, uindex_t p_new_capacity)
+{
+    // If we can't allocate the new chains, then the shard just stays as it is.
+    __MCNameChains *t_new_chains;
+    if (!__MCNameCreateChains(p_new_capacity, t_new_chains))
+        return;
+    
+    __MCAtomicIncrement(x_shard . resizes);
+    
+    // Move each equivalence class onto the front of its new chain. Readers
+    // might follow a moved name into its new chain, but as the classes are
+    // moved in order they can't be led round in a circle.
+    __MCNameChains *t_old_chains;
+    t_old_chains = x_shard . chains;
+    for(uindex_t i = 0; i < t_old_chains -> capacity; i++)
+    {
+        __MCName *t_first;
+        t_first = t_old_chains -> chains[i];
+        while(t_first != nil)
+        {
+            __MCName *t_last;
+            t_last = t_first;
+            while(__MCNameGetNext(t_last) != nil &&
+                  __MCNameGetKey(__MCNameGetNext(t_last)) == t_first)
+                t_last = __MCNameGetNext(t_last);
+            
+            __MCName *t_next;
+            t_next = __MCNameGetNext(t_last);
+            
+            __MCName *&t_chain = __MCNameGetChain(t_new_chains, __MCNameGetHash(t_first));
+            __MCNameSetNext(t_last, t_chain);
+            t_chain = t_first;
+            
+            t_first = t_next;
+        }
+    }
+    
+    __MCAtomicFence();
+    x_shard . chains = t_new_chains;
+    
+    __MCAtomicIncrement(x_shard . resizes);
+    
+    __MCNameShardSynchronize(x_shard);
+    MCMemoryDelete(t_old_chains);
+}
+
+// Add a name to the shard, as a new equivalence class if the key is nil, or
+// as a member of the key's class otherwise. The shard's lock must be held.
+static void __MCNameShardInsert(__MCNameShard& x_shard, __MCName *p_name, hash_t p_hash, __MCName *p_key)
+{
+    // Record the hash (speeds up searching and such).
+    __MCNameSetHash(p_name, p_hash);
+    
+    if (p_key == nil)
+    {
+        // To keep hashing efficient, we (try to) double the size of the
+        // shard each time occupancy reaches capacity.
+        if (x_shard . occupancy == x_shard . chains -> capacity)
+            __MCNameShardResize(x_shard, x_shard . chains -> capacity * 2);
+        
+        x_shard . occupancy += 1;
+        
+        __MCName *&t_chain = __MCNameGetChain(x_shard . chains, p_hash);
+        __MCNameSetNext(p_name, t_chain);
+        __MCNameSetKey(p_name, p_name);
+        
+        // The name must be complete before readers can reach it.
+        __MCAtomicFence();
+        t_chain = p_name;
+    }
+    else
+    {
+        __MCNameSetNext(p_name, __MCNameGetNext(p_key));
+        __MCNameSetKey(p_name, p_key);
+        
+        __MCAtomicFence();
+        __MCNameSetNext(p_key, p_name);
+    }
+    
+    x_shard . name_count += 1;
+}
+
+// Increment the name's reference count, unless it has already reached zero.
+static inline bool __MCNameRetainIfAlive(__MCName *self)
+{
+    uint32_t t_references;
+    t_references = __MCAtomicLoad(self -> references);
+    while(t_references != 0)
+    {
+        if (__MCAtomicCompareAndSwap(self -> references, t_references, t_references + 1))
+            return true;
+        t_references = __MCAtomicLoad(self -> references);
+    }
+    return false;
+}
+
+static inline void __MCNameCountLookup(uindex_t p_probes)
+{
+    __MCNameLookupStatistics& t_statistics = s_name_lookup_statistics;
+    __MCAtomicAddRelaxed(t_statistics . lookups, 1);
+    __MCAtomicAddRelaxed(t_statistics . probes, uint32_t(p_probes));
+    
+    uint32_t t_longest_probe;
+    t_longest_probe = __MCAtomicLoad(t_statistics . longest_probe);
+    while(p_probes > t_longest_probe)
+    {
+        if (__MCAtomicCompareAndSwap(t_statistics . longest_probe, t_longest_probe, uint32_t(p_probes)))
+            break;
+        t_longest_probe = __MCAtomicLoad(t_statistics . longest_probe);
+    }
+}
+
+// Search the chain for the key of the live equivalence class the string
+// belongs to.
+static __MCName *__MCNameFindKey(__MCName *p_chain, hash_t p_hash, MCStringRef p_string, uindex_t& x_probes)
+{
+	__MCName *t_key_name;
+	t_key_name = p_chain;
+	while(t_key_name != nil)
+	{
+        x_probes += 1;
+        
+		// If the string matches, then we are done - notice we compare the
+		// full hash first.
+		if (p_hash == __MCNameGetHash(t_key_name) &&
+            __MCAtomicLoad(t_key_name -> references) != 0 &&
+			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless))
+			return t_key_name;
+
+		// Otherwise skip all other members of the same equivalence class.
+		while(__MCNameGetNext(t_key_name) != nil &&
+				__MCNameGetKey(t_key_name) == __MCNameGetKey(__MCNameGetNext(t_key_name)))
+            t_key_name = __MCNameGetNext(t_key_name);
+
+        // Next name must be the next one.
+        t_key_name = __MCNameGetNext(t_key_name);
+	}
+    
+    return nil;
+}
+
+// Search the key's equivalence class for a live name with the same string.
+static __MCName *__MCNameFindInClass(__MCName *p_key_name, MCStringRef p_string)
+{
+	for(__MCName *t_name = p_key_name; t_name != nil && __MCNameGetKey(t_name) == p_key_name; t_name = __MCNameGetNext(t_name))
+		if (__MCAtomicLoad(t_name -> references) != 0 &&
+            MCStringIsEqualTo(p_string, t_name -> string, kMCStringOptionCompareExact))
+			return t_name;
+    
+    return nil;
+}
+
+// Search the chain for the live name of the given index. As an index as a
+// string consists of folded chars, it must be the key of its class.
+static __MCName *__MCNameFindIndex(__MCName *p_chain, hash_t p_hash, const char_t *p_chars, uindex_t p_char_count, uindex_t& x_probes)
+{
+    for(__MCName *t_name = p_chain; t_name != nil; t_name = __MCNameGetNext(t_name))
+    {
+        x_probes += 1;
+        
+        if (p_hash == __MCNameGetHash(t_name) &&
+            __MCNameGetKey(t_name) == t_name &&
+            __MCAtomicLoad(t_name -> references) != 0 &&
+            MCStringIsEqualToNativeChars(t_name -> string, p_chars, p_char_count, kMCStringOptionCompareExact))
+            return t_name;
+    }
+    
+    return nil;
+}
+
+// Search the shard, without taking its lock, for the name with the given
+// string. If 'exact' is true the name must match exactly and is returned
+// retained, otherwise the key of the string's equivalence class is returned.
+static __MCName *__MCNameShardSearch(__MCNameShard& x_shard, hash_t p_hash, MCStringRef p_string, bool p_exact)
+{
+    uint32_t t_epoch;
+    t_epoch = __MCNameShardBeginRead(x_shard);
+    
+    __MCName *t_name;
+    uindex_t t_probes;
+    t_probes = 0;
+    for(;;)
+    {
+        uint32_t t_resizes;
+        t_resizes = __MCAtomicLoad(x_shard . resizes);
+        
+        t_name = __MCNameFindKey(__MCNameGetChain(x_shard . chains, p_hash), p_hash, p_string, t_probes);
+        if (t_name != nil && p_exact)
+        {
+            t_name = __MCNameFindInClass(t_name, p_string);
+            if (t_name != nil && !__MCNameRetainIfAlive(t_name))
+                t_name = nil;
+        }
+        
+        if (t_name != nil ||
+            ((t_resizes & 1) == 0 && __MCAtomicLoad(x_shard . resizes) == t_resizes))
+            break;
+    }
+    
+    __MCNameShardEndRead(x_shard, t_epoch);
+    
+    __MCNameCountLookup(t_probes);
+    
+    return t_name;
+}
+
+// As __MCNameShardSearch, but for the name of an index.
+static __MCName *__MCNameShardSearchIndex(__MCNameShard& x_shard, hash_t p_hash, const char_t *p_chars, uindex_t p_char_count, bool p_retain)
+{
+    uint32_t t_epoch;
+    t_epoch = __MCNameShardBeginRead(x_shard);
+    
+    __MCName *t_name;
+    uindex_t t_probes;
+    t_probes = 0;
+    for(;;)
+    {
+        uint32_t t_resizes;
+        t_resizes = __MCAtomicLoad(x_shard . resizes);
+        
+        t_name = __MCNameFindIndex(__MCNameGetChain(x_shard . chains, p_hash), p_hash, p_chars, p_char_count, t_probes);
+        if (t_name != nil && p_retain && !__MCNameRetainIfAlive(t_name))
+            t_name = nil;
+        
+        if (t_name != nil ||
+            ((t_resizes & 1) == 0 && __MCAtomicLoad(x_shard . resizes) == t_resizes))
+            break;
+    }
+    
+    __MCNameShardEndRead(x_shard, t_epoch);
+    
+    __MCNameCountLookup(t_probes);
+    
+    return t_name;
+}
+
+// Discard a name which was created but never added to the table.
+static void __MCNameDiscard(__MCName *self)
+{
+    MCValueRelease(self -> string);
+    __MCValueDelete(self);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MC_DLLEXPORT_DEF
 MCNameRef MCNAME(const char *p_string)
 {
@@ -247,42 +655,17 @@ bool MCNameCreate(MCStringRef p_string, MCNameRef& r_name)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
 
-	// Calculate the index of the chain in the name table where this might be
-	// found. The capacity is always a power-of-two, so its just a mask op.
-	uindex_t t_index;
-	t_index = t_hash & (s_name_table_capacity - 1);
-
-	// Search for the first representation of the would-be name's equivalence
-	// class.
-	__MCName *t_key_name;
-	t_key_name = s_name_table[t_index];
-	while(t_key_name != nil)
-	{
-		// If the string matches, then we are done - notice we compare the
-		// full hash first.
-		if (t_hash == __MCNameGetHash(t_key_name) &&
-			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless))
-			break;
-
-		// Otherwise skip all other members of the same equivalence class.
-		while(__MCNameGetNext(t_key_name) != nil &&
-				__MCNameGetKey(t_key_name) == __MCNameGetKey(__MCNameGetNext(t_key_name)))
-            t_key_name = __MCNameGetNext(t_key_name);
-
-        // Next name must be the next one.
-        t_key_name = __MCNameGetNext(t_key_name);
-	}
-
-	// Now search within the equivalence class for one with the same string and
-	// return immediately if we find a match.
+	__MCNameShard& t_shard = __MCNameGetShard(t_hash);
+    
+    // Most names already exist, so first search for an exact match without
+    // locking the shard.
 	__MCName *t_name;
-	for(t_name = t_key_name; t_name != nil && __MCNameGetKey(t_name) == t_key_name; t_name = __MCNameGetNext(t_name))
-		if (MCStringIsEqualTo(p_string, t_name -> string, kMCStringOptionCompareExact))
-		{
-			t_name -> references += 1;
-			r_name = t_name;
-			return true;
-		}
+    t_name = __MCNameShardSearch(t_shard, t_hash, p_string, true);
+    if (t_name != nil)
+    {
+        r_name = t_name;
+        return true;
+    }
 
 	// We haven't found an exact match, so we create a new name...
 	bool t_success;
@@ -295,54 +678,61 @@ bool MCNameCreate(MCStringRef p_string, MCNameRef& r_name)
 	// Copy the string (as immutable).
 	if (t_success)
 		t_success = MCStringCopy(p_string, t_name -> string);
+    
+    // Names can be used from any thread.
+    if (t_success)
+    {
+        t_success = __MCValueMarkShared((__MCValue *)t_name -> string);
+    }
 
-	// Now add the name to the table and fill in the rest of the fields.
-	if (t_success)
-	{
-		// If there is no existing equivalence class, we chain at the start,
-		// otherwise we insert the name after the representative.
-		if (t_key_name == nil)
-		{
-			// To keep hashin efficient, we (try to) double the size of the
-			// table each time occupancy reaches capacity.
-			if (s_name_table_occupancy == s_name_table_capacity)
-			{
-				__MCNameGrowTable();
-				t_index = t_hash & (s_name_table_capacity - 1);
-			}
-
-			// Increase occupancy.
-			s_name_table_occupancy += 1;
-
-            __MCNameSetNext(t_name, s_name_table[t_index]);
-            __MCNameSetKey(t_name, t_name);
-			s_name_table[t_index] = t_name;
-		}
-		else
-		{
-            __MCNameSetNext(t_name, __MCNameGetNext(t_key_name));
-            __MCNameSetKey(t_name, t_key_name);
-            __MCNameSetNext(t_key_name, t_name);
-
-			// Increment the reference count of the representative as we need
-			// it to 'hang around' for the entire lifetime of all others in the
-			// equivalence class to give a search handle.
-			t_key_name -> references += 1;
-		}
-
-		// Record the hash (speeds up searching and such).
-        __MCNameSetHash(t_name, t_hash);
-
-		// Return the new name.
-		r_name = t_name;
-	}
-	else
-	{
-		MCValueRelease(t_name -> string);
-		MCMemoryDelete(t_name);
-	}
+    if (!t_success)
+    {
+        if (t_name != nil)
+            __MCNameDiscard(t_name);
+        return false;
+    }
+    
+    t_name -> flags |= kMCValueFlagIsShared;
+    
+    __MCNameShardLock(t_shard);
+    
+    // Another thread might have added the name since we searched, so search
+    // again now that nothing else can change the shard.
+    uindex_t t_probes;
+    t_probes = 0;
+    
+	__MCName *t_key_name;
+    t_key_name = __MCNameFindKey(__MCNameGetChain(t_shard . chains, t_hash), t_hash, p_string, t_probes);
+    
+    __MCName *t_existing_name;
+    t_existing_name = nil;
+    if (t_key_name != nil)
+        t_existing_name = __MCNameFindInClass(t_key_name, p_string);
+    
+    if (t_existing_name != nil &&
+        __MCNameRetainIfAlive(t_existing_name))
+    {
+        __MCNameShardUnlock(t_shard);
+        __MCNameDiscard(t_name);
+        r_name = t_existing_name;
+        return true;
+    }
+    
+    // If there is no existing equivalence class, the name becomes the key of a
+    // new one. Otherwise we need a reference to the key as it must 'hang
+    // around' for the entire lifetime of all others in the equivalence class
+    // to give a search handle - if it is being destroyed then its class is on
+    // the way out too, so we start a new one.
+    if (t_key_name != nil &&
+        !__MCNameRetainIfAlive(t_key_name))
+        t_key_name = nil;
+    
+    __MCNameShardInsert(t_shard, t_name, t_hash, t_key_name);
+    
+    __MCNameShardUnlock(t_shard);
 
-	return t_success;
+	r_name = t_name;
+	return true;
 }
 
 MC_DLLEXPORT_DEF
@@ -359,30 +749,14 @@ bool MCNameCreateWithIndex(index_t p_index, MCNameRef& r_name)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
-    // Calculate the index of the chain in the name table where this might be
-    // found. The capacity is always a power-of-two, so its just a mask op.
-    uindex_t t_index;
-    t_index = t_hash & (s_name_table_capacity - 1);
+    __MCNameShard& t_shard = __MCNameGetShard(t_hash);
     
-    // Search for the first representation of the would-be name's equivalence
-    // class.
-    __MCName *t_key_name;
-    t_key_name = s_name_table[t_index];
-    while(t_key_name != nil)
+    __MCName *t_name;
+    t_name = __MCNameShardSearchIndex(t_shard, t_hash, t_chars, t_char_count, true);
+    if (t_name != nil)
     {
-        // If the string matches, then we are done - notice we compare the
-        // full hash first.
-        if (t_hash == __MCNameGetHash(t_key_name) &&
-            __MCNameGetKey(t_key_name) == t_key_name &&
-            MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact))
-        {
-            t_key_name -> references += 1;
-            r_name = t_key_name;
-            return true;
-        }
-        
-        // Next name must be the next one.
-        t_key_name = __MCNameGetNext(t_key_name);
+        r_name = t_name;
+        return true;
     }
     
     // We haven't found an exact match, so we create a new name...
@@ -390,7 +764,6 @@ bool MCNameCreateWithIndex(index_t p_index, MCNameRef& r_name)
     t_success = true;
     
     // Allocate a name record.
-    __MCName *t_name;
     if (t_success)
         t_success = __MCValueCreate(kMCValueTypeCodeName, t_name);
     
@@ -398,37 +771,40 @@ bool MCNameCreateWithIndex(index_t p_index, MCNameRef& r_name)
     if (t_success)
         t_success = MCStringCreateWithNativeChars(t_chars, t_char_count, t_name -> string);
     
-    // Now add the name to the table and fill in the rest of the fields.
     if (t_success)
+        t_success = __MCValueMarkShared((__MCValue *)t_name -> string);
+    
+    if (!t_success)
     {
-        // To keep hashin efficient, we (try to) double the size of the
-        // table each time occupancy reaches capacity.
-        if (s_name_table_occupancy == s_name_table_capacity)
-        {
-            __MCNameGrowTable();
-            t_index = t_hash & (s_name_table_capacity - 1);
-        }
-        
-        // Increase occupancy.
-        s_name_table_occupancy += 1;
-        
-        __MCNameSetNext(t_name, s_name_table[t_index]);
-        __MCNameSetKey(t_name, t_name);
-        s_name_table[t_index] = t_name;
-
-        // Record the hash (speeds up searching and such).
-        __MCNameSetHash(t_name, t_hash);
-        
-        // Return the new name.
-        r_name = t_name;
+        if (t_name != nil)
+            __MCNameDiscard(t_name);
+        return false;
     }
-    else
+    
+    t_name -> flags |= kMCValueFlagIsShared;
+    
+    __MCNameShardLock(t_shard);
+    
+    uindex_t t_probes;
+    t_probes = 0;
+    
+    __MCName *t_existing_name;
+    t_existing_name = __MCNameFindIndex(__MCNameGetChain(t_shard . chains, t_hash), t_hash, t_chars, t_char_count, t_probes);
+    if (t_existing_name != nil &&
+        __MCNameRetainIfAlive(t_existing_name))
     {
-        MCValueRelease(t_name -> string);
-        MCMemoryDelete(t_name);
+        __MCNameShardUnlock(t_shard);
+        __MCNameDiscard(t_name);
+        r_name = t_existing_name;
+        return true;
     }
     
-    return t_success;
+    __MCNameShardInsert(t_shard, t_name, t_hash, nil);
+    
+    __MCNameShardUnlock(t_shard);
+    
+    r_name = t_name;
+    return true;
 }
 
 MC_DLLEXPORT_DEF
@@ -466,6 +842,94 @@ bool MCNameCreateAndRelease(MCStringRef p_string, MCNameRef& r_name)
 	return false;
 }
 
+// The static storage for a name holds the name and its string.
+struct __MCNameStatic
+{
+    __MCName name;
+    __MCString string;
+};
+
+static_assert(sizeof(__MCNameStatic) <= sizeof(MCNameStaticStorage),
+              "MCNameStaticStorage is too small");
+
+MC_DLLEXPORT_DEF
+void MCNameCreateStatic(const MCNameStaticInfo *p_names, MCNameStaticStorage *p_storage, uindex_t p_count)
+{
+    for(uindex_t i = 0; i < p_count; i++)
+    {
+        const MCNameStaticInfo& t_info = p_names[i];
+        
+        if (t_info . length == 0 && kMCEmptyName != nil)
+        {
+            *t_info . name_var = MCValueRetain(kMCEmptyName);
+            continue;
+        }
+        
+        __MCNameStatic *t_static;
+        t_static = reinterpret_cast<__MCNameStatic *>(&p_storage[i]);
+        
+        // The string is referenced by the name, and the extra reference
+        // means it is never destroyed.
+        __MCStringInitializeStatic(&t_static -> string, (const char_t *)t_info . cstring, t_info . length);
+        t_static -> string . references = 2;
+        
+        MCStringRef t_string;
+        t_string = &t_static -> string;
+        
+        MCAssert(t_info . hash == MCStringHash(t_string, kMCStringOptionCompareCaseless));
+        
+        // The caseless hash is the one which was computed in advance.
+        t_static -> string . caseless_hash = t_info . hash;
+        t_static -> string . flags |= kMCStringFlagHasCaselessHash;
+        /* UNCHECKED */ __MCValueMarkShared(&t_static -> string);
+        
+        // The table's reference to the name is never released, so it lives
+        // for as long as the table.
+        __MCName *t_name;
+        t_name = &t_static -> name;
+        t_name -> references = 1;
+        t_name -> flags = (kMCValueTypeCodeName << 28) | kMCValueFlagIsShared;
+        t_name -> string = t_string;
+        
+        hash_t t_hash;
+        t_hash = __MCNameReduceHash(t_info . hash);
+        
+        __MCNameShard& t_shard = __MCNameGetShard(t_hash);
+        
+        __MCNameShardLock(t_shard);
+        
+        uindex_t t_probes;
+        t_probes = 0;
+        
+        __MCName *t_key_name;
+        t_key_name = __MCNameFindKey(__MCNameGetChain(t_shard . chains, t_hash), t_hash, t_string, t_probes);
+        
+        __MCName *t_existing_name;
+        t_existing_name = nil;
+        if (t_key_name != nil)
+            t_existing_name = __MCNameFindInClass(t_key_name, t_string);
+        
+        // If the name already exists, then the storage goes unused.
+        if (t_existing_name != nil &&
+            __MCNameRetainIfAlive(t_existing_name))
+        {
+            __MCNameShardUnlock(t_shard);
+            *t_info . name_var = t_existing_name;
+            continue;
+        }
+        
+        if (t_key_name != nil &&
+            !__MCNameRetainIfAlive(t_key_name))
+            t_key_name = nil;
+        
+        __MCNameShardInsert(t_shard, t_name, t_hash, t_key_name);
+        
+        __MCNameShardUnlock(t_shard);
+        
+        *t_info . name_var = MCValueRetain(t_name);
+    }
+}
+
 MC_DLLEXPORT_DEF
 MCNameRef MCNameLookupCaseless(MCStringRef p_string)
 {
@@ -476,32 +940,8 @@ MCNameRef MCNameLookupCaseless(MCStringRef p_string)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
-	// Calculate the index of the chain in the name table where this name might
-	// be found. The capacity is always a power-of-two, so its just a mask op.
-	uindex_t t_index;
-	t_index = t_hash & (s_name_table_capacity - 1);
-
-	// Search for the first representative of the would-be name's equivalence class.
-	__MCName *t_key_name;
-	t_key_name = s_name_table[t_index];
-	while(t_key_name != nil)
-	{
-		// If the string matches, then we are done - notice we compare the full
-		// hash first.
-		if (t_hash == __MCNameGetHash(t_key_name) &&
-			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless))
-			break;
-
-        // Otherwise skip all other members of the same equivalence class.
-        while(__MCNameGetNext(t_key_name) != nil &&
-              __MCNameGetKey(t_key_name) == __MCNameGetKey(__MCNameGetNext(t_key_name)))
-            t_key_name = __MCNameGetNext(t_key_name);
-
-        // Next name must be the next one
-        t_key_name = __MCNameGetNext(t_key_name);
-	}
-
-	return t_key_name;
+	// Search for the representative of the would-be name's equivalence class.
+	return __MCNameShardSearch(__MCNameGetShard(t_hash), t_hash, p_string, false);
 }
 
 MCNameRef MCNameLookupIndex(index_t p_index)
@@ -517,29 +957,7 @@ MCNameRef MCNameLookupIndex(index_t p_index)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
-    // Calculate the index of the chain in the name table where this name might
-    // be found. The capacity is always a power-of-two, so its just a mask op.
-    uindex_t t_index;
-    t_index = t_hash & (s_name_table_capacity - 1);
-    
-    // Search for the first representative of the would-be name's equivalence class.
-    __MCName *t_key_name;
-    t_key_name = s_name_table[t_index];
-    while(t_key_name != nil)
-    {
-        // If the string matches, then we are done - notice we compare the full
-        // hash first. As an index as a string consists of folded chars, we can
-        // use exact comparison.
-        if (t_hash == __MCNameGetHash(t_key_name) &&
-            __MCNameGetKey(t_key_name) == t_key_name &&
-            MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact))
-            break;
-        
-        // Next name must be the next one
-        t_key_name = __MCNameGetNext(t_key_name);
-    }
-    
-    return t_key_name;
+    return __MCNameShardSearchIndex(__MCNameGetShard(t_hash), t_hash, t_chars, t_char_count, false);
 }
 
 MC_DLLEXPORT_DEF
@@ -594,36 +1012,51 @@ bool MCNameIsEqualTo(MCNameRef self, MCNameRef p_other_name, MCStringOptions p_o
 
 void __MCNameDestroy(__MCName *self)
 {
-	// Compute the index in the table
-	uindex_t t_index;
-	t_index = __MCNameGetHash(self) & (s_name_table_capacity - 1);
-
+    __MCNameShard& t_shard = __MCNameGetShard(__MCNameGetHash(self));
+    
+    __MCNameShardLock(t_shard);
+    
 	// Find the previous link in the chain
+    __MCName *&t_chain = __MCNameGetChain(t_shard . chains, __MCNameGetHash(self));
 	__MCName *t_previous;
 	t_previous = nil;
-	for(__MCName *t_name = s_name_table[t_index]; t_name != self; t_name = __MCNameGetNext(t_name))
+	for(__MCName *t_name = t_chain; t_name != self; t_name = __MCNameGetNext(t_name))
 		t_previous = t_name;
 
-	// Update the previous name's next field
+	// Update the previous name's next field. Readers which have already
+	// reached this name can still follow its next field.
 	if (t_previous == nil)
-		s_name_table[t_index] = __MCNameGetNext(self);
+		t_chain = __MCNameGetNext(self);
 	else
         __MCNameSetNext(t_previous, __MCNameGetNext(self));
+    
+    t_shard . name_count -= 1;
 
-	// If this name is not the key then remove our reference to it. Otherwise
-	// adjust occupancy appropriately.
-	if (__MCNameGetKey(self) != self)
-		MCValueRelease(__MCNameGetKey(self));
-	else
+	// If this name is the key then adjust occupancy appropriately.
+    __MCName *t_key_name;
+    t_key_name = __MCNameGetKey(self);
+	if (t_key_name == self)
 	{
-		// Reduce occupancy of the table
-		s_name_table_occupancy -= 1;
-
-		// If the table is too sparse, reduce its size (current heuristic has the
-		// threshold at 33%).
-		if (s_name_table_capacity > 1024 && s_name_table_occupancy * 16 / s_name_table_capacity < 5)
-			__MCNameShrinkTable();
+		// Reduce occupancy of the shard
+		t_shard . occupancy -= 1;
+
+		// If the shard is too sparse, reduce its size (current heuristic has
+		// the threshold at 33%).
+        uindex_t t_capacity;
+        t_capacity = t_shard . chains -> capacity;
+		if (t_capacity > kMCNameTableShardMinCapacity && t_shard . occupancy * 16 / t_capacity < 5)
+			__MCNameShardResize(t_shard, t_capacity / 2);
 	}
+    
+    // The name can't be freed until nothing can be looking at it.
+    __MCNameShardSynchronize(t_shard);
+    
+    __MCNameShardUnlock(t_shard);
+
+	// If this name is not the key then remove our reference to it (this might
+	// destroy the key, so must be done without the shard locked).
+	if (t_key_name != self)
+		MCValueRelease(t_key_name);
 
 	// Delete the resources
 	MCValueRelease(self -> string);
@@ -646,89 +1079,39 @@ bool __MCNameIsEqualTo(__MCName *self, __MCName *p_other_self)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static void __MCNameRelocateTableEntries(uindex_t p_start, uindex_t p_finish, uindex_t p_new_capacity)
-{
-	// Loop through the entries, moving them as necessary. As the hash-table
-	// grows by powers of two, an entry either stays put or moves to outside
-	// the range of consideration.
-	for(uindex_t t_old_index = p_start; t_old_index < p_finish; t_old_index++)
-	{
-		// The last name in the chain we previously processed which might
-		// get its 'next' field updated.
-		MCNameRef t_previous;
-		t_previous = nil;
-
-		// The first name in the current chain being processed.
-		MCNameRef t_first;
-		t_first = s_name_table[t_old_index];
-		while(t_first != nil)
-		{
-			// Compute the new index.
-			uindex_t t_new_index;
-			t_new_index = __MCNameGetHash(t_first) & (p_new_capacity - 1);
-
-			// Search for the last name to relocate.
-			MCNameRef t_last;
-			for(t_last = t_first; __MCNameGetNext(t_last) != nil; t_last = __MCNameGetNext(t_last))
-				if ((__MCNameGetHash(__MCNameGetNext(t_last)) & (p_new_capacity - 1)) != t_new_index)
-					break;
-
-			// Record the next name to process after this chain.
-			MCNameRef t_next;
-			t_next = __MCNameGetNext(t_last);
-
-			// If the new index is different from the old, then we need to move
-			// the names from first->last.
-			if (t_new_index != t_old_index)
-			{
-				// Remove the link from the previous name, or the table at the
-				// old index.
-				if (t_previous != nil)
-                    __MCNameSetNext(t_previous, __MCNameGetNext(t_last));
-				else
-					s_name_table[t_old_index] = __MCNameGetNext(t_last);
-
-				// Push the chain of names onto the front of the table at the
-				// new index.
-				__MCNameSetNext(t_last, s_name_table[t_new_index]);
-				s_name_table[t_new_index] = t_first;
-			}
-			else
-				t_previous = t_last;
-
-			// Move to the next chain.
-			t_first = t_next;
-		}
-	}
-}
-
-static void __MCNameGrowTable(void)
-{
-	// First attempt to double the table size.
-	if (!MCMemoryResizeArray(s_name_table_capacity * 2, s_name_table, s_name_table_capacity))
-		return;
-
-	// Now relocate any entries from the used half that need to be moved to the
-	// upper half (another bit has become available to determine spread).
-	__MCNameRelocateTableEntries(0, s_name_table_capacity / 2, s_name_table_capacity);
-}
-
-static void __MCNameShrinkTable(void)
+MC_DLLEXPORT_DEF
+void MCNameTableGetStatistics(MCNameTableStatistics& r_statistics)
 {
-	// First relocate any entries from the upper half of the table to the lower
-	// half (a bit has been removed from that which determines spread).
-	__MCNameRelocateTableEntries(s_name_table_capacity / 2, s_name_table_capacity, s_name_table_capacity / 2);
-
-	// Now resize the array.
-	MCMemoryResizeArray(s_name_table_capacity / 2, s_name_table, s_name_table_capacity);
+    MCMemoryClear(r_statistics);
+    
+    for(uindex_t i = 0; i < kMCNameTableShardCount; i++)
+    {
+        __MCNameShard& t_shard = s_name_table[i];
+        __MCNameShardLock(t_shard);
+        r_statistics . names += t_shard . name_count;
+        r_statistics . classes += t_shard . occupancy;
+        r_statistics . capacity += t_shard . chains -> capacity;
+        __MCNameShardUnlock(t_shard);
+    }
+    
+    __MCNameLookupStatistics& t_lookups = s_name_lookup_statistics;
+    r_statistics . lookups = __MCAtomicLoad(t_lookups . lookups);
+    r_statistics . probes = __MCAtomicLoad(t_lookups . probes);
+    r_statistics . longest_probe = __MCAtomicLoad(t_lookups . longest_probe);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool __MCNameInitialize(void)
 {
-	if (!MCMemoryNewArray(1024, s_name_table, s_name_table_capacity))
-		return false;
+    for(uindex_t i = 0; i < kMCNameTableShardCount; i++)
+    {
+        __MCNameShard& t_shard = s_name_table[i];
+        if (!__MCNameCreateChains(kMCNameTableShardMinCapacity, t_shard . chains))
+            return false;
+        t_shard . name_count = 0;
+        t_shard . occupancy = 0;
+    }
 
 	if (!MCNameCreate(kMCEmptyString, kMCEmptyName))
 		return false;
@@ -739,8 +1122,6 @@ bool __MCNameInitialize(void)
 	if (!MCNameCreate(kMCFalseString, kMCFalseName))
 		return false;
 
-	s_name_table_occupancy = 0;
-
 	return true;
 }
 
@@ -755,10 +1136,14 @@ void __MCNameFinalize(void)
     MCValueRelease(kMCFalseName);
     kMCFalseName = nil;
 
-	MCMemoryDeleteArray(s_name_table);
-	s_name_table = nil;
-	s_name_table_capacity = 0;
-	s_name_table_occupancy = 0;
+    for(uindex_t i = 0; i < kMCNameTableShardCount; i++)
+    {
+        __MCNameShard& t_shard = s_name_table[i];
+        MCMemoryDelete(t_shard . chains);
+        t_shard . chains = nil;
+        t_shard . name_count = 0;
+        t_shard . occupancy = 0;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -775,13 +1160,14 @@ void MCNameDumpTable(void)
 	t_singleton_count = 0;
 	t_variants_count = 0;
 
-	for(uint32_t i = 0; i < s_name_table_capacity; i++)
+    for(uint32_t s = 0; s < kMCNameTableShardCount; s++)
+	for(uint32_t i = 0; i < s_name_table[s] . chains -> capacity; i++)
 	{
-		if (s_name_table[i] == nil)
+		if (s_name_table[s] . chains -> chains[i] == nil)
 			continue;
 
 		MCNameRef t_name;
-		t_name = s_name_table[i];
+		t_name = s_name_table[s] . chains -> chains[i];
 		while(t_name != nil)
 		{
 			if (t_name -> references == 1)
@@ -806,4 +1192,3 @@ void MCNameDumpTable(void)
 	fclose(t_output);
 }
 #endif
-
@@ -279,7 +279,11 @@ static bool __MCNumberParseNativeString(const char *p_string, uindex_t p_length,
         errno = 0;
         
         real64_t t_real;
-        t_real = strtod(p_string, &t_end);
+        if (p_full_string &&
+            __MCTypeConvertParseShortDecimal(p_string, p_length, t_real))
+            t_end = const_cast<char *>(p_string + p_length);
+        else
+            t_real = strtod(p_string, &t_end);
         
         // SN-2014-10-06: [[ Bug 13594 ]] check that no error was encountered
         t_success = (errno != ERANGE) && (p_full_string ? (t_end - p_string == (ptrdiff_t)p_length) : (t_end != t_string));
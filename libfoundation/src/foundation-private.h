@@ -39,14 +39,18 @@ extern const char *__MCSysCharset;
 
 enum
 {
+    // If set, then this value may be referenced from more than one thread and
+    // its reference count must be manipulated atomically.
+    kMCValueFlagIsShared = 1 << 26,
+    
 	// If set, then this value is in the unique table.
 	kMCValueFlagIsInterred = 1 << 27,
     
     // The mask for the typecode bits.
     kMCValueFlagsTypeCodeMask = 0xf0000000,
     
-    // Names store the hash value in the flags word.
-    kMCValueFlagsNameHashBits = 28,
+    // Names store (part of) the hash value in the flags word.
+    kMCValueFlagsNameHashBits = 26,
     kMCValueFlagsNameHashMask = (1 << kMCValueFlagsNameHashBits) - 1,
 };
 
@@ -176,7 +180,22 @@ enum
     // If set, the string has been converted to a number
     kMCStringFlagHasNumber = 1 << 6,
     // If set, indicates that the string can be losslessly nativized
-    kMCStringFlagCanBeNative = 1 << 7
+    kMCStringFlagCanBeNative = 1 << 7,
+    // If set, the native chars are constant and not owned by the string
+    kMCStringFlagIsStatic = 1 << 8,
+    // If set, the string is immutable and its exact hash has been computed
+    kMCStringFlagHasHash = 1 << 9,
+    // If set, the string is immutable and its caseless hash has been computed
+    kMCStringFlagHasCaselessHash = 1 << 10,
+    // If set, the string is immutable, not native and its chars are still
+    // the UTF-8 it was created from (see __MCStringDecodeUTF8)
+    kMCStringFlagIsUTF8 = 1 << 11,
+    // If set, the string is mutable and the free space in its buffer is a gap
+    // in its chars (see __MCStringMoveGap)
+    kMCStringFlagHasGap = 1 << 12,
+    // If set, the string is immutable and its chars are those of a range of
+    // its parent string (see __MCStringCreateSlice)
+    kMCStringFlagIsSlice = 1 << 13
 };
 
 enum
@@ -263,10 +282,29 @@ struct __MCString: public __MCValue
             {
                 unichar_t *chars;
                 char_t *native_chars;
+                // If the string is UTF-8, capacity is the number of bytes.
+                byte_t *utf8_bytes;
+            };
+            union
+            {
+                double numeric_value;
+                // If the string is a slice, the string whose chars it uses.
+                MCStringRef parent;
             };
-            double numeric_value;
             uindex_t capacity;
-            /* The padding is here to ensure the size of the struct is 32-bytes
+            union
+            {
+                // If the string is immutable, its cached hashes.
+                struct
+                {
+                    hash_t hash;
+                    hash_t caseless_hash;
+                };
+                // If the string is mutable and has a gap, the number of chars
+                // before it.
+                uindex_t gap_offset;
+            };
+            /* The padding is here to ensure the size of the struct is 40-bytes
              * on all platforms. This ensures consistency between Win and UNIX
              * ABIs which have slightly different rules concerning double
              * alignment. */
@@ -278,8 +316,27 @@ struct __MCString: public __MCValue
             {
                 unichar_t *chars;
                 char_t *native_chars;
+                // If the string is UTF-8, capacity is the number of bytes.
+                byte_t *utf8_bytes;
+            };
+            union
+            {
+                double numeric_value;
+                // If the string is a slice, the string whose chars it uses.
+                MCStringRef parent;
+            };
+            union
+            {
+                // If the string is immutable, its cached hashes.
+                struct
+                {
+                    hash_t hash;
+                    hash_t caseless_hash;
+                };
+                // If the string is mutable and has a gap, the number of chars
+                // before it.
+                uindex_t gap_offset;
             };
-            double numeric_value;
 #endif
         };
     };
@@ -293,6 +350,21 @@ enum
     kMCDataFlagIsMutable = 1 << 0,
     // The data are indirect (i.e. contents is within another immutable data ref).
     kMCDataFlagIsIndirect = 1 << 1,
+    // The data are immutable and their bytes are a range of those of their
+    // parent data ref.
+    kMCDataFlagIsSlice = 1 << 2,
+    // The data are immutable and their bytes are owned by someone else, who is
+    // told when they are no longer needed (see MCDataCreateWithExternalBytes).
+    kMCDataFlagIsExternal = 1 << 3,
+};
+
+// The bytes of a data ref created with external bytes, and how to release
+// them.
+struct __MCDataExternalBytes
+{
+    byte_t *bytes;
+    MCDataReleaseBytesCallback release;
+    void *context;
 };
 
 // AL-2014-11-12: [[ Bug 13987 ]] Implement copy on write for MCDataRef
@@ -304,8 +376,23 @@ struct __MCData: public __MCValue
         struct
         {
             uindex_t byte_count;
-            uindex_t capacity;
-            byte_t *bytes;
+            union
+            {
+                uindex_t capacity;
+                // If the data are a slice, the offset of their bytes in those
+                // of their parent.
+                uindex_t offset;
+            };
+            // The bytes of slices and external data are found through the
+            // other fields (see __MCDataGetBytes).
+            union
+            {
+                byte_t *bytes;
+                // If the data are a slice, the data ref whose bytes they use.
+                MCDataRef parent;
+                // If the data are external, their bytes.
+                __MCDataExternalBytes *external;
+            };
         };
     };
 };
@@ -337,12 +424,31 @@ enum
 	// If set then the array is indirect (i.e. contents is within another
 	// immutable array).
 	kMCArrayFlagIsIndirect = 1 << 7,
+	// If set then the keys of the array are exactly 1 to key_value_count, and
+	// the values are stored in order in dense_values. In this case the
+	// capacity index is the log2 of the capacity of dense_values.
+	kMCArrayFlagIsDense = 1 << 8,
+	// If set then the key-values are stored in a persistent hash array mapped
+	// trie rooted at trie_root, whose nodes can be shared between arrays.
+	kMCArrayFlagIsTrie = 1 << 9,
+	// If set then iteration visits the keys in the order they were first
+	// stored. An ordered key-value table has a list of the slots in insertion
+	// order after its control bytes. Ordered arrays never use a trie.
+	kMCArrayFlagIsOrdered = 1 << 10,
 };
 
+struct __MCArrayTrieNode;
+
 struct __MCArrayKeyValue
 {
 	MCNameRef key;
 	uintptr_t value;
+	// The (caseless) hash of the key, kept so that rehashing and probing
+	// don't have to go back to the name.
+	hash_t hash;
+	// The index of the slot in the insertion order list, if the array is
+	// ordered.
+	uindex_t position;
 };
 
 struct __MCArray: public __MCValue
@@ -352,7 +458,12 @@ struct __MCArray: public __MCValue
 		MCArrayRef contents;
 		struct
 		{
-			__MCArrayKeyValue *key_values;
+			union
+			{
+				__MCArrayKeyValue *key_values;
+				MCValueRef *dense_values;
+				__MCArrayTrieNode *trie_root;
+			};
 			uindex_t key_value_count;
 		};
 	};
@@ -404,6 +515,8 @@ struct __MCProperList: public __MCValue
         {
             MCValueRef *list;
             uindex_t length;
+            // The number of elements there is room for in the list's buffer.
+            uindex_t capacity;
         };
 	};
 };
@@ -493,6 +606,11 @@ bool __MCValueCreate(MCValueTypeCode type_code, size_t size, __MCValue*& r_value
 
 void __MCValueDestroy(__MCValue *value);
 
+// Free a value which was created but never handed out, without destroying
+// its contents. Values must be freed with this rather than MCMemoryDelete, as
+// they might be in a pool. The value may be nil.
+void __MCValueDelete(__MCValue *value);
+
 bool __MCValueImmutableCopy(__MCValue *value, bool release, __MCValue*& r_new_value);
 
 inline MCValueTypeCode __MCValueGetTypeCode(__MCValue *self)
@@ -500,6 +618,11 @@ inline MCValueTypeCode __MCValueGetTypeCode(__MCValue *self)
 	return (self -> flags >> 28);
 }
 
+inline bool __MCValueIsShared(__MCValue *self)
+{
+    return (self -> flags & kMCValueFlagIsShared) != 0;
+}
+
 template<class T> inline bool __MCValueCreate(MCValueTypeCode p_type_code, T*& r_value)
 {
 	__MCValue *t_value;
@@ -532,6 +655,7 @@ void __MCLocaleFinalize();
 
 bool __MCValueInitialize(void);
 void __MCValueFinalize(void);
+bool __MCValueMarkShared(__MCValue *value);
 
 bool __MCStringInitialize(void);
 void __MCStringFinalize(void);
@@ -540,6 +664,8 @@ hash_t __MCStringHash(__MCString *string);
 bool __MCStringIsEqualTo(__MCString *string, __MCString *other_string);
 bool __MCStringCopyDescription(__MCString *string, MCStringRef& r_string);
 bool __MCStringImmutableCopy(__MCString *string, bool release, __MCString*& r_immutable_value);
+void __MCStringInitializeStatic(__MCString *string, const char_t *chars, uindex_t char_count);
+bool __MCStringPrepareToShare(__MCString *string);
 
 bool __MCNameInitialize(void);
 void __MCNameFinalize(void);
@@ -553,6 +679,10 @@ hash_t __MCNumberHash(__MCNumber *number);
 bool __MCNumberIsEqualTo(__MCNumber *number, __MCNumber *other_number);
 bool __MCNumberCopyDescription(__MCNumber *number, MCStringRef& r_string);
 
+// Converts chars which are exactly a short plain decimal, returning false if
+// strtod() is needed instead.
+bool __MCTypeConvertParseShortDecimal(const char *chars, uindex_t char_count, real64_t& r_value);
+
 bool __MCArrayInitialize(void);
 void __MCArrayFinalize(void);
 void __MCArrayDestroy(__MCArray *array);
@@ -560,6 +690,7 @@ hash_t __MCArrayHash(__MCArray *array);
 bool __MCArrayIsEqualTo(__MCArray *array, __MCArray *other_array);
 bool __MCArrayCopyDescription(__MCArray *array, MCStringRef& r_string);
 bool __MCArrayImmutableCopy(__MCArray *array, bool release, __MCArray*& r_immutable_value);
+bool __MCArrayMakeSparse(__MCArray *array);
 
 bool __MCListInitialize(void);
 void __MCListFinalize(void);
@@ -585,6 +716,8 @@ bool __MCDataIsEqualTo(__MCData *self, __MCData *p_other_data);
 bool __MCDataCopyDescription(__MCData *self, MCStringRef &r_description);
 bool __MCDataImmutableCopy(__MCData *self, bool p_release, __MCData *&r_immutable_value);
 
+bool __MCFiltersInitialize(void);
+
 bool __MCProperListInitialize(void);
 void __MCProperListFinalize(void);
 void __MCProperListDestroy(__MCProperList *list);
@@ -678,6 +811,89 @@ bool MCUnicodeCharMapToNative(unichar_t uchar, char_t& r_nchar);
 char_t MCUnicodeCharMapToNativeLossy(unichar_t nchar);
 unichar_t MCUnicodeCharMapFromNative(char_t nchar);
 
+////////////////////////////////////////////////////////////////////////////////
+// ATOMIC OPERATIONS
+//
+
+// Atomically increment / decrement the given counter, returning the new value.
+// These are used for the reference counts of shared values - unshared values
+// (the vast majority) use plain arithmetic - and by the name table.
+//
+// Compare-and-swap sets the value to 'new' only if it is currently 'old',
+// returning whether it did. Load reads the value, ordered with respect to the
+// other atomic operations. Fence orders all memory accesses either side of it.
+//
+// AddRelaxed adds to a counter without ordering any other memory accesses, so
+// is only suitable for counters which nothing else depends on (statistics).
+#if defined(__VISUALC__)
+extern "C" long __cdecl _InterlockedIncrement(long volatile *);
+extern "C" long __cdecl _InterlockedDecrement(long volatile *);
+extern "C" long __cdecl _InterlockedCompareExchange(long volatile *, long, long);
+extern "C" long __cdecl _InterlockedExchangeAdd(long volatile *, long);
+extern "C" void __cdecl _mm_mfence(void);
+#pragma intrinsic(_InterlockedIncrement, _InterlockedDecrement, _InterlockedCompareExchange, _InterlockedExchangeAdd, _mm_mfence)
+
+inline uint32_t __MCAtomicIncrement(uint32_t& x_counter)
+{
+    return uint32_t(_InterlockedIncrement(reinterpret_cast<long volatile *>(&x_counter)));
+}
+
+inline uint32_t __MCAtomicDecrement(uint32_t& x_counter)
+{
+    return uint32_t(_InterlockedDecrement(reinterpret_cast<long volatile *>(&x_counter)));
+}
+
+inline bool __MCAtomicCompareAndSwap(uint32_t& x_value, uint32_t p_old, uint32_t p_new)
+{
+    return uint32_t(_InterlockedCompareExchange(reinterpret_cast<long volatile *>(&x_value), long(p_new), long(p_old))) == p_old;
+}
+
+inline uint32_t __MCAtomicLoad(uint32_t& x_value)
+{
+    return uint32_t(_InterlockedCompareExchange(reinterpret_cast<long volatile *>(&x_value), 0, 0));
+}
+
+inline void __MCAtomicAddRelaxed(uint32_t& x_counter, uint32_t p_amount)
+{
+    _InterlockedExchangeAdd(reinterpret_cast<long volatile *>(&x_counter), long(p_amount));
+}
+
+inline void __MCAtomicFence(void)
+{
+    _mm_mfence();
+}
+#else
+inline uint32_t __MCAtomicIncrement(uint32_t& x_counter)
+{
+    return __sync_add_and_fetch(&x_counter, 1);
+}
+
+inline uint32_t __MCAtomicDecrement(uint32_t& x_counter)
+{
+    return __sync_sub_and_fetch(&x_counter, 1);
+}
+
+inline bool __MCAtomicCompareAndSwap(uint32_t& x_value, uint32_t p_old, uint32_t p_new)
+{
+    return __sync_bool_compare_and_swap(&x_value, p_old, p_new);
+}
+
+inline uint32_t __MCAtomicLoad(uint32_t& x_value)
+{
+    return __atomic_load_n(&x_value, __ATOMIC_SEQ_CST);
+}
+
+inline void __MCAtomicAddRelaxed(uint32_t& x_counter, uint32_t p_amount)
+{
+    __atomic_fetch_add(&x_counter, p_amount, __ATOMIC_RELAXED);
+}
+
+inline void __MCAtomicFence(void)
+{
+    __sync_synchronize();
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // INTERNAL MCVALUE TYPE ASSERTIONS
 //
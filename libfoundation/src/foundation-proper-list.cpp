@@ -42,6 +42,9 @@ static bool __MCProperListResolveIndirect(__MCProperList *self);
 
 static bool __MCProperListExpandAt(MCProperListRef self, uindex_t p_at, uindex_t p_count);
 
+// Resizes the list's buffer to have room for the given number of elements.
+static bool __MCProperListSetCapacity(MCProperListRef self, uindex_t p_capacity);
+
 static bool __MCProperListShrinkAt(MCProperListRef self, uindex_t p_at, uindex_t p_count);
 
 static void __MCProperListClampRange(MCProperListRef self, MCRange& x_range);
@@ -76,7 +79,8 @@ bool MCProperListCreateWithForeignValues(MCTypeInfoRef p_typeinfo, const void *p
     MCAssert(p_values != nullptr || p_value_count == 0);
 
     MCAutoProperListRef t_list;
-    if (!MCProperListCreateMutable(&t_list))
+    if (!MCProperListCreateMutable(&t_list) ||
+        !MCProperListReserve(*t_list, p_value_count))
     {
         return false;
     }
@@ -194,6 +198,7 @@ MCProperListCreateAndRelease(MCValueRef *p_values,
 
 	t_list -> list = p_values;
 	t_list -> length = p_length;
+	t_list -> capacity = p_length;
 
 	r_list = t_list;
 	return true;
@@ -252,6 +257,11 @@ bool MCProperListCopyAndRelease(MCProperListRef self, MCProperListRef& r_new_lis
 	if (!__MCProperListMakeContentsImmutable(self))
 		return false;
 
+	// The list is unlikely to grow again, so give back any unused room.
+	if (self -> capacity > self -> length &&
+		!__MCProperListSetCapacity(self, self -> length))
+		return false;
+
 	// If we have a reference count of one 'self' becomes the immutable copy.
 	if (self -> references == 1)
 	{
@@ -323,6 +333,21 @@ bool MCProperListMutableCopyAndRelease(MCProperListRef self, MCProperListRef& r_
 
 ////////////////////////////////////////////////////////////////////////////////
 
+MC_DLLEXPORT_DEF
+bool MCProperListReserve(MCProperListRef self, uindex_t p_capacity)
+{
+    MCAssert(MCProperListIsMutable(self));
+    
+    if (__MCProperListIsIndirect(self))
+        if (!__MCProperListResolveIndirect(self))
+            return false;
+    
+    if (p_capacity <= self -> capacity)
+        return true;
+    
+    return __MCProperListSetCapacity(self, p_capacity);
+}
+
 MC_DLLEXPORT_DEF
 bool MCProperListIsMutable(MCProperListRef self)
 {
@@ -1142,17 +1167,44 @@ static void __MCProperListClampRange(MCProperListRef self, MCRange& x_range)
 	x_range . length = t_right - t_left;
 }
 
+static bool __MCProperListSetCapacity(MCProperListRef self, uindex_t p_capacity)
+{
+    MCAssert(p_capacity >= self -> length);
+    
+    uindex_t t_capacity;
+    t_capacity = self -> capacity;
+    if (!MCMemoryResizeArray(p_capacity, self -> list, t_capacity))
+        return false;
+    
+    self -> capacity = t_capacity;
+    return true;
+}
+
 static bool __MCProperListExpandAt(MCProperListRef self, uindex_t p_at, uindex_t p_count)
 {
     MCAssert(!MCProperListIsIndirect(self));
     
-    uindex_t t_old_length;
-    t_old_length = self -> length;
+    if (p_count > UINDEX_MAX - self -> length)
+        return MCErrorThrowOutOfMemory();
     
-    if (!MCMemoryResizeArray(self -> length + p_count, self -> list, self -> length))
-        return false;
+    uindex_t t_new_length;
+    t_new_length = self -> length + p_count;
+    
+    // Grow the buffer by half as much again as is needed, so that building a
+    // list an element at a time doesn't reallocate it on every insertion.
+    if (t_new_length > self -> capacity)
+    {
+        uindex_t t_new_capacity;
+        t_new_capacity = t_new_length + MCMin(t_new_length / 2, UINDEX_MAX - t_new_length);
+        if (t_new_capacity < 4)
+            t_new_capacity = 4;
+        
+        if (!__MCProperListSetCapacity(self, t_new_capacity))
+            return false;
+    }
     
-    MCMemoryMove(self -> list + p_at + p_count, self -> list + p_at, (t_old_length - p_at) * sizeof(MCValueRef));
+    MCMemoryMove(self -> list + p_at + p_count, self -> list + p_at, (self -> length - p_at) * sizeof(MCValueRef));
+    self -> length = t_new_length;
     
     return true;
 }
@@ -1162,8 +1214,12 @@ static bool __MCProperListShrinkAt(MCProperListRef self, uindex_t p_at, uindex_t
     MCAssert(!MCProperListIsIndirect(self));
     
     MCMemoryMove(self -> list + p_at, self -> list + p_at + p_count, (self -> length - (p_at + p_count)) * sizeof(MCValueRef));
+    self -> length -= p_count;
     
-    if (!MCMemoryResizeArray(self -> length - p_count, self -> list, self -> length))
+    // Give back half of the buffer once less than a quarter of it is used;
+    // shrinking by less would make alternate pushes and pops reallocate.
+    if (self -> length < self -> capacity / 4 &&
+        !__MCProperListSetCapacity(self, self -> capacity / 2))
         return false;
     
     return true;
@@ -1216,6 +1272,7 @@ static bool __MCProperListMakeIndirect(__MCProperList *self)
 
 	// Fill in our new list.
 	t_list -> length = self -> length;
+	t_list -> capacity = self -> capacity;
 	t_list -> list = self -> list;
 
 	// 'self' now becomes indirect with a reference to the new list.
@@ -1238,10 +1295,12 @@ static bool __MCProperListResolveIndirect(__MCProperList *self)
 	if (self -> contents -> references == 1)
 	{
 		self -> length = t_contents -> length;
+		self -> capacity = t_contents -> capacity;
 		self -> list = t_contents -> list;
 
 		t_contents -> list = nil;
 		t_contents -> length = 0;
+		t_contents -> capacity = 0;
 	}
 	else
 	{
@@ -1252,6 +1311,7 @@ static bool __MCProperListResolveIndirect(__MCProperList *self)
 			return false;
 
 		self -> length = t_contents -> length;
+		self -> capacity = t_size;
 
 		for(uindex_t i = 0; i < t_size; i++)
             self -> list[i] = MCValueRetain(t_contents -> list[i]);
@@ -76,7 +76,7 @@ bool MCRecordCreate(MCTypeInfoRef p_typeinfo, const MCValueRef *p_values, uindex
     else
     {
         MCMemoryDeleteArray(self -> fields);
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     }
     
     return t_success;
@@ -118,7 +118,7 @@ bool MCRecordCreateMutable(MCTypeInfoRef p_typeinfo, MCRecordRef& r_record)
     else
     {
         MCMemoryDeleteArray(self -> fields);
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     }
     
     return t_success;
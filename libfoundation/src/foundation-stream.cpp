@@ -406,6 +406,16 @@ bool MCStreamWrite(MCStreamRef self, const void *p_buffer, size_t p_amount)
 	return __MCStreamCallbacks(self) -> write(self, p_buffer, p_amount);
 }
 
+MC_DLLEXPORT_DEF
+bool MCStreamIsFinished(MCStreamRef self, bool& r_finished)
+{
+	__MCAssertIsStream(self);
+
+	if (__MCStreamCallbacks(self) -> is_finished == nil)
+		return false;
+	return __MCStreamCallbacks(self) -> is_finished(self, r_finished);
+}
+
 MC_DLLEXPORT_DEF
 bool MCStreamSkip(MCStreamRef self, size_t p_amount)
 {
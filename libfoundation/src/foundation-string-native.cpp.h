@@ -21,6 +21,22 @@
 
 #include "foundation-private.h"
 
+#if defined(__SSE2__) || defined(__X86_64__)
+#include <emmintrin.h>
+#define __MCNATIVECHARS_USE_SSE2__ 1
+#if defined(__X86_64__)
+#include <immintrin.h>
+#define __MCNATIVECHARS_USE_AVX2__ 1
+#endif
+#elif defined(__ARM64__)
+#include <arm_neon.h>
+#define __MCNATIVECHARS_USE_NEON__ 1
+#endif
+
+#if defined(__VISUALC__)
+#include <intrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // This file contains low-level native string operations and is designed to be
@@ -458,6 +474,545 @@ __MCNativeStr_Hash(const char_t *p_chars,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Searching for (and counting) a single char is done a block of chars at a
+// time, using SSE2 (or AVX2 if the CPU has it) on x86 and NEON on ARM64. Each
+// block is compared against a pair of chars at once - for an exact search
+// they are both the needle, and for a caseless search they are the chars which
+// fold to it.
+//
+// The comparison of a block gives a mask with the bits for the matching chars
+// set, which is then dealt with by common code. NEON has no movemask, so its
+// masks have four bits per char (with only the top one of each kept).
+
+// The scan functions have the same semantics as the CharScan operation
+// described below, but find either of the two needle chars.
+typedef size_t (*__MCNativeChars_ScanFunction)(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset);
+
+static inline uindex_t __MCNativeChars_PopCount(uint64_t p_mask)
+{
+#if defined(__VISUALC__)
+    p_mask = p_mask - ((p_mask >> 1) & 0x5555555555555555ULL);
+    p_mask = (p_mask & 0x3333333333333333ULL) + ((p_mask >> 2) & 0x3333333333333333ULL);
+    p_mask = (p_mask + (p_mask >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return uindex_t((p_mask * 0x0101010101010101ULL) >> 56);
+#else
+    return __builtin_popcountll(p_mask);
+#endif
+}
+
+// The index of the lowest set bit of the (non-zero) mask.
+static inline uindex_t __MCNativeChars_LowestBit(uint64_t p_mask)
+{
+#if defined(__VISUALC__)
+    unsigned long t_index;
+    if (_BitScanForward(&t_index, uint32_t(p_mask)))
+        return t_index;
+    _BitScanForward(&t_index, uint32_t(p_mask >> 32));
+    return t_index + 32;
+#else
+    return __builtin_ctzll(p_mask);
+#endif
+}
+
+// The index of the highest set bit of the (non-zero) mask.
+static inline uindex_t __MCNativeChars_HighestBit(uint64_t p_mask)
+{
+#if defined(__VISUALC__)
+    unsigned long t_index;
+    if (_BitScanReverse(&t_index, uint32_t(p_mask >> 32)))
+        return t_index + 32;
+    _BitScanReverse(&t_index, uint32_t(p_mask));
+    return t_index;
+#else
+    return 63 - __builtin_clzll(p_mask);
+#endif
+}
+
+// Account for the (non-zero) match mask of the block of chars at offset when
+// scanning forward. Returns true if max_count chars have now been found.
+static inline bool __MCNativeChars_ForwardMask(uint64_t p_mask,
+                                               uindex_t p_bits_per_char,
+                                               size_t p_offset,
+                                               size_t p_max_count,
+                                               size_t& x_count,
+                                               size_t& x_last_offset)
+{
+    size_t t_count;
+    t_count = __MCNativeChars_PopCount(p_mask);
+    
+    if (p_max_count != 0 && x_count + t_count >= p_max_count)
+    {
+        // Clear the matches before the one which makes up the count.
+        for(size_t i = x_count + 1; i < p_max_count; i++)
+            p_mask &= p_mask - 1;
+        
+        x_count = p_max_count;
+        x_last_offset = p_offset + __MCNativeChars_LowestBit(p_mask) / p_bits_per_char;
+        return true;
+    }
+    
+    x_count += t_count;
+    x_last_offset = p_offset + __MCNativeChars_HighestBit(p_mask) / p_bits_per_char;
+    return false;
+}
+
+// As __MCNativeChars_ForwardMask, but when scanning backward.
+static inline bool __MCNativeChars_ReverseMask(uint64_t p_mask,
+                                               uindex_t p_bits_per_char,
+                                               size_t p_offset,
+                                               size_t p_max_count,
+                                               size_t& x_count,
+                                               size_t& x_last_offset)
+{
+    size_t t_count;
+    t_count = __MCNativeChars_PopCount(p_mask);
+    
+    if (p_max_count != 0 && x_count + t_count >= p_max_count)
+    {
+        for(size_t i = x_count + 1; i < p_max_count; i++)
+            p_mask &= ~(uint64_t(1) << __MCNativeChars_HighestBit(p_mask));
+        
+        x_count = p_max_count;
+        x_last_offset = p_offset + __MCNativeChars_HighestBit(p_mask) / p_bits_per_char;
+        return true;
+    }
+    
+    x_count += t_count;
+    x_last_offset = p_offset + __MCNativeChars_LowestBit(p_mask) / p_bits_per_char;
+    return false;
+}
+
+// Scan the chars from offset to the end of the chars, one at a time.
+static inline void __MCNativeChars_ForwardTail(const char_t *p_chars,
+                                               size_t p_offset,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t& x_count,
+                                               size_t& x_last_offset)
+{
+    for(; p_offset < p_length; p_offset++)
+        if (p_chars[p_offset] == p_needles[0] || p_chars[p_offset] == p_needles[1])
+        {
+            x_last_offset = p_offset;
+            x_count += 1;
+            if (x_count == p_max_count)
+                break;
+        }
+}
+
+// Scan the chars from end back to the start of the chars, one at a time.
+static inline void __MCNativeChars_ReverseTail(const char_t *p_chars,
+                                               size_t p_end,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t& x_count,
+                                               size_t& x_last_offset)
+{
+    for(; p_end > 0; p_end--)
+        if (p_chars[p_end - 1] == p_needles[0] || p_chars[p_end - 1] == p_needles[1])
+        {
+            x_last_offset = p_end - 1;
+            x_count += 1;
+            if (x_count == p_max_count)
+                break;
+        }
+}
+
+// The scalar scans are only needed where there is no vector unit to use.
+#if !defined(__MCNATIVECHARS_USE_SSE2__) && !defined(__MCNATIVECHARS_USE_NEON__)
+static size_t __MCNativeChars_ScanForward_Scalar(const char_t *p_chars,
+                                                 size_t p_length,
+                                                 const char_t p_needles[2],
+                                                 size_t p_max_count,
+                                                 size_t *r_offset)
+{
+    size_t t_count, t_last_offset;
+    t_count = 0;
+    t_last_offset = 0;
+    __MCNativeChars_ForwardTail(p_chars, 0, p_length, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+
+static size_t __MCNativeChars_ScanReverse_Scalar(const char_t *p_chars,
+                                                 size_t p_length,
+                                                 const char_t p_needles[2],
+                                                 size_t p_max_count,
+                                                 size_t *r_offset)
+{
+    size_t t_count, t_last_offset;
+    t_count = 0;
+    t_last_offset = 0;
+    __MCNativeChars_ReverseTail(p_chars, p_length, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+#endif
+
+#if defined(__MCNATIVECHARS_USE_SSE2__)
+static inline uint32_t __MCNativeChars_MatchSSE2(const char_t *p_chars, __m128i p_first, __m128i p_second)
+{
+    __m128i t_chars;
+    t_chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(t_chars, p_first),
+                                          _mm_cmpeq_epi8(t_chars, p_second)));
+}
+
+static size_t __MCNativeChars_ScanForward_SSE2(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    __m128i t_first, t_second;
+    t_first = _mm_set1_epi8(char(p_needles[0]));
+    t_second = _mm_set1_epi8(char(p_needles[1]));
+    
+    size_t t_count, t_last_offset, t_offset;
+    t_count = 0;
+    t_last_offset = 0;
+    t_offset = 0;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_offset + 16 <= p_length; t_offset += 16)
+    {
+        uint32_t t_mask;
+        t_mask = __MCNativeChars_MatchSSE2(p_chars + t_offset, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ForwardMask(t_mask, 1, t_offset, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ForwardTail(p_chars, t_offset, p_length, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+
+static size_t __MCNativeChars_ScanReverse_SSE2(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    __m128i t_first, t_second;
+    t_first = _mm_set1_epi8(char(p_needles[0]));
+    t_second = _mm_set1_epi8(char(p_needles[1]));
+    
+    size_t t_count, t_last_offset, t_end;
+    t_count = 0;
+    t_last_offset = 0;
+    t_end = p_length;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_end >= 16; t_end -= 16)
+    {
+        uint32_t t_mask;
+        t_mask = __MCNativeChars_MatchSSE2(p_chars + t_end - 16, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ReverseMask(t_mask, 1, t_end - 16, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ReverseTail(p_chars, t_end, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+#endif
+
+#if defined(__MCNATIVECHARS_USE_AVX2__)
+// The AVX2 functions are only used if the CPU supports it, so must be compiled
+// for it regardless of the target.
+#if defined(__VISUALC__)
+#define __MCNATIVECHARS_AVX2_TARGET
+#else
+#define __MCNATIVECHARS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+__MCNATIVECHARS_AVX2_TARGET
+static inline uint32_t __MCNativeChars_MatchAVX2(const char_t *p_chars, __m256i p_first, __m256i p_second)
+{
+    __m256i t_chars;
+    t_chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p_chars));
+    return uint32_t(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(t_chars, p_first),
+                                                         _mm256_cmpeq_epi8(t_chars, p_second))));
+}
+
+__MCNATIVECHARS_AVX2_TARGET
+static size_t __MCNativeChars_ScanForward_AVX2(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    __m256i t_first, t_second;
+    t_first = _mm256_set1_epi8(char(p_needles[0]));
+    t_second = _mm256_set1_epi8(char(p_needles[1]));
+    
+    size_t t_count, t_last_offset, t_offset;
+    t_count = 0;
+    t_last_offset = 0;
+    t_offset = 0;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_offset + 32 <= p_length; t_offset += 32)
+    {
+        uint32_t t_mask;
+        t_mask = __MCNativeChars_MatchAVX2(p_chars + t_offset, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ForwardMask(t_mask, 1, t_offset, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ForwardTail(p_chars, t_offset, p_length, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+
+__MCNATIVECHARS_AVX2_TARGET
+static size_t __MCNativeChars_ScanReverse_AVX2(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    __m256i t_first, t_second;
+    t_first = _mm256_set1_epi8(char(p_needles[0]));
+    t_second = _mm256_set1_epi8(char(p_needles[1]));
+    
+    size_t t_count, t_last_offset, t_end;
+    t_count = 0;
+    t_last_offset = 0;
+    t_end = p_length;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_end >= 32; t_end -= 32)
+    {
+        uint32_t t_mask;
+        t_mask = __MCNativeChars_MatchAVX2(p_chars + t_end - 32, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ReverseMask(t_mask, 1, t_end - 32, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ReverseTail(p_chars, t_end, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+
+static bool __MCNativeChars_HasAVX2(void)
+{
+#if defined(__VISUALC__)
+    int t_info[4];
+    __cpuid(t_info, 0);
+    if (t_info[0] < 7)
+        return false;
+    
+    // The OS must save the AVX state (OSXSAVE and AVX, then XCR0).
+    __cpuid(t_info, 1);
+    if ((t_info[2] & (1 << 27)) == 0 || (t_info[2] & (1 << 28)) == 0)
+        return false;
+    if ((_xgetbv(0) & 6) != 6)
+        return false;
+    
+    __cpuidex(t_info, 7, 0);
+    return (t_info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(__MCNATIVECHARS_USE_NEON__)
+static inline uint64_t __MCNativeChars_MatchNEON(const char_t *p_chars, uint8x16_t p_first, uint8x16_t p_second)
+{
+    uint8x16_t t_chars, t_lanes;
+    t_chars = vld1q_u8(p_chars);
+    t_lanes = vorrq_u8(vceqq_u8(t_chars, p_first), vceqq_u8(t_chars, p_second));
+    
+    // Narrow each (all-ones or all-zeros) lane to four bits.
+    uint8x8_t t_narrowed;
+    t_narrowed = vshrn_n_u16(vreinterpretq_u16_u8(t_lanes), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(t_narrowed), 0) & 0x8888888888888888ULL;
+}
+
+static size_t __MCNativeChars_ScanForward_NEON(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    uint8x16_t t_first, t_second;
+    t_first = vdupq_n_u8(p_needles[0]);
+    t_second = vdupq_n_u8(p_needles[1]);
+    
+    size_t t_count, t_last_offset, t_offset;
+    t_count = 0;
+    t_last_offset = 0;
+    t_offset = 0;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_offset + 16 <= p_length; t_offset += 16)
+    {
+        uint64_t t_mask;
+        t_mask = __MCNativeChars_MatchNEON(p_chars + t_offset, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ForwardMask(t_mask, 4, t_offset, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ForwardTail(p_chars, t_offset, p_length, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+
+static size_t __MCNativeChars_ScanReverse_NEON(const char_t *p_chars,
+                                               size_t p_length,
+                                               const char_t p_needles[2],
+                                               size_t p_max_count,
+                                               size_t *r_offset)
+{
+    uint8x16_t t_first, t_second;
+    t_first = vdupq_n_u8(p_needles[0]);
+    t_second = vdupq_n_u8(p_needles[1]);
+    
+    size_t t_count, t_last_offset, t_end;
+    t_count = 0;
+    t_last_offset = 0;
+    t_end = p_length;
+    
+    bool t_done;
+    t_done = false;
+    for(; !t_done && t_end >= 16; t_end -= 16)
+    {
+        uint64_t t_mask;
+        t_mask = __MCNativeChars_MatchNEON(p_chars + t_end - 16, t_first, t_second);
+        if (t_mask != 0)
+            t_done = __MCNativeChars_ReverseMask(t_mask, 4, t_end - 16, p_max_count, t_count, t_last_offset);
+    }
+    
+    if (!t_done)
+        __MCNativeChars_ReverseTail(p_chars, t_end, p_needles, p_max_count, t_count, t_last_offset);
+    
+    if (t_count > 0 && r_offset != nil)
+        *r_offset = t_last_offset;
+    
+    return t_count;
+}
+#endif
+
+#if defined(__MCNATIVECHARS_USE_SSE2__)
+static __MCNativeChars_ScanFunction s_native_chars_scan_forward = __MCNativeChars_ScanForward_SSE2;
+static __MCNativeChars_ScanFunction s_native_chars_scan_reverse = __MCNativeChars_ScanReverse_SSE2;
+#elif defined(__MCNATIVECHARS_USE_NEON__)
+static __MCNativeChars_ScanFunction s_native_chars_scan_forward = __MCNativeChars_ScanForward_NEON;
+static __MCNativeChars_ScanFunction s_native_chars_scan_reverse = __MCNativeChars_ScanReverse_NEON;
+#else
+static __MCNativeChars_ScanFunction s_native_chars_scan_forward = __MCNativeChars_ScanForward_Scalar;
+static __MCNativeChars_ScanFunction s_native_chars_scan_reverse = __MCNativeChars_ScanReverse_Scalar;
+#endif
+
+// For each char, the two chars which are equal to it when folded - i.e. the
+// char itself and the chars which fold to it. If there are more than two,
+// the char is marked as not having any, and must be searched for one at a
+// time.
+static char_t s_native_chars_fold_pairs[256][2];
+static bool s_native_chars_has_fold_pair[256];
+
+// Choose the fastest scan functions for the CPU, and compute the fold pairs.
+static void __MCNativeChars_Initialize(void)
+{
+#if defined(__MCNATIVECHARS_USE_AVX2__)
+    if (__MCNativeChars_HasAVX2())
+    {
+        s_native_chars_scan_forward = __MCNativeChars_ScanForward_AVX2;
+        s_native_chars_scan_reverse = __MCNativeChars_ScanReverse_AVX2;
+    }
+#endif
+    
+    uindex_t t_counts[256];
+    for(uindex_t i = 0; i < 256; i++)
+    {
+        s_native_chars_fold_pairs[i][0] = s_native_chars_fold_pairs[i][1] = char_t(i);
+        t_counts[i] = 1;
+    }
+    
+    for(uindex_t i = 0; i < 256; i++)
+    {
+        char_t t_folded;
+        t_folded = __MCNativeChar_Fold(char_t(i));
+        if (t_folded == i)
+            continue;
+        
+        if (t_counts[t_folded] < 2)
+            s_native_chars_fold_pairs[t_folded][1] = char_t(i);
+        t_counts[t_folded] += 1;
+    }
+    
+    for(uindex_t i = 0; i < 256; i++)
+        s_native_chars_has_fold_pair[i] = t_counts[i] <= 2;
+}
+
+// Get the pair of chars which match the given char using the given char
+// comparison method. Returns false if there isn't one, in which case the
+// chars have to be compared one at a time.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static inline bool __MCNativeChars_GetPair(char_t p_char, char_t r_pair[2])
+{
+    if (CharEqual == __MCNativeChar_Equal_Unfolded)
+    {
+        r_pair[0] = r_pair[1] = p_char;
+        return true;
+    }
+    
+    // A prefolded char is equal to any char which folds to it, whereas an
+    // unfolded one is equal to any char which folds to the same char as it
+    // does.
+    char_t t_folded;
+    t_folded = CharEqual == __MCNativeChar_Equal_Prefolded ? p_char : __MCNativeChar_Fold(p_char);
+    if (!s_native_chars_has_fold_pair[t_folded] ||
+        __MCNativeChar_Fold(t_folded) != t_folded)
+        return false;
+    
+    r_pair[0] = s_native_chars_fold_pairs[t_folded][0];
+    r_pair[1] = s_native_chars_fold_pairs[t_folded][1];
+    
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // Most delimiter based string operations depend on a single 'scanning'
 // operation:
 //
@@ -481,6 +1036,14 @@ struct __MCNativeStr_Forward
                                   size_t p_max_count,
                                   size_t *r_offset)
     {
+        char_t t_pair[2];
+        if (__MCNativeChars_GetPair<CharEqual>(p_needle_char, t_pair))
+            return s_native_chars_scan_forward(p_haystack_chars,
+                                               p_haystack_length,
+                                               t_pair,
+                                               p_max_count,
+                                               r_offset);
+        
         size_t t_count;
         t_count = 0;
         
@@ -527,9 +1090,28 @@ struct __MCNativeStr_Forward
         size_t t_char_offset;
         t_char_offset = 0;
         
+        // If the needle's first char can be searched for quickly, then skip
+        // straight to each occurrence of it.
+        char_t t_pair[2];
+        bool t_has_pair;
+        t_has_pair = __MCNativeChars_GetPair<CharEqual>(p_needle_chars[0], t_pair);
+        
         size_t t_offset = 0;
         while(t_char_offset <= p_haystack_length)
         {
+            if (t_has_pair)
+            {
+                size_t t_skip;
+                if (s_native_chars_scan_forward(p_haystack_chars + t_char_offset,
+                                                p_haystack_length - t_char_offset + 1,
+                                                t_pair,
+                                                1,
+                                                &t_skip) == 0)
+                    break;
+                
+                t_char_offset += t_skip;
+            }
+            
             if (__MCNativeStr_Equal<CharEqual>(p_haystack_chars + t_char_offset,
                                                p_needle_length,
                                                p_needle_chars,
@@ -564,6 +1146,14 @@ struct __MCNativeStr_Reverse
                                   size_t p_max_count,
                                   size_t *r_offset)
     {
+        char_t t_pair[2];
+        if (__MCNativeChars_GetPair<CharEqual>(p_needle_char, t_pair))
+            return s_native_chars_scan_reverse(p_haystack_chars,
+                                               p_haystack_length,
+                                               t_pair,
+                                               p_max_count,
+                                               r_offset);
+        
         size_t t_count;
         t_count = 0;
         
@@ -610,9 +1200,26 @@ struct __MCNativeStr_Reverse
         size_t t_char_offset;
         t_char_offset = p_haystack_length;
         
+        char_t t_pair[2];
+        bool t_has_pair;
+        t_has_pair = __MCNativeChars_GetPair<CharEqual>(p_needle_chars[0], t_pair);
+        
         size_t t_offset = 0;
         while(t_char_offset > 0)
         {
+            if (t_has_pair)
+            {
+                size_t t_found;
+                if (s_native_chars_scan_reverse(p_haystack_chars,
+                                                t_char_offset,
+                                                t_pair,
+                                                1,
+                                                &t_found) == 0)
+                    break;
+                
+                t_char_offset = t_found + 1;
+            }
+            
             if (__MCNativeStr_Equal<CharEqual>(p_haystack_chars + t_char_offset - 1,
                                                p_needle_length,
                                                p_needle_chars,
@@ -621,7 +1228,8 @@ struct __MCNativeStr_Reverse
                 t_offset = t_char_offset;
                 t_count += 1;
                 
-                if (t_count == p_max_count)
+                if (t_count == p_max_count ||
+                    t_char_offset < p_needle_length)
                     break;
                 
                 t_char_offset -= p_needle_length;
@@ -984,15 +1592,38 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     size_t t_offset = 0;
     t_offset = 0;
     
+    // If the delimiter can be searched for quickly, the delimiters are
+    // skipped and counted a block at a time.
+    char_t t_delimiters[2];
+    bool t_has_pair;
+    t_has_pair = __MCNativeChars_GetPair<DelimiterCharEqual>(p_delimiter_char, t_delimiters);
+    
     size_t t_end_before;
     t_end_before = 0;
-    for(; p_skip > 0 && t_offset < p_haystack_length; t_offset++)
+    if (t_has_pair)
+    {
+        if (p_skip > 0)
+        {
+            size_t t_found;
+            t_found = s_native_chars_scan_forward(p_haystack_chars,
+                                                  p_haystack_length,
+                                                  t_delimiters,
+                                                  p_skip,
+                                                  &t_end_before);
+            t_index += t_found;
+            t_offset = t_found == p_skip ? t_end_before + 1 : p_haystack_length;
+        }
+    }
+    else
     {
-        if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
+        for(; p_skip > 0 && t_offset < p_haystack_length; t_offset++)
         {
-            p_skip -= 1;
-            t_index += 1;
-            t_end_before = t_offset;
+            if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
+            {
+                p_skip -= 1;
+                t_index += 1;
+                t_end_before = t_offset;
+            }
         }
     }
     
@@ -1007,12 +1638,30 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     
     t_start_found += t_offset;
     
-    for(; t_offset < t_start_found; t_offset++)
+    if (t_has_pair)
     {
-        if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
+        size_t t_last_offset;
+        size_t t_found;
+        t_found = s_native_chars_scan_forward(p_haystack_chars + t_offset,
+                                              t_start_found - t_offset,
+                                              t_delimiters,
+                                              0,
+                                              &t_last_offset);
+        if (t_found > 0)
         {
-            t_index += 1;
-            t_end_before = t_offset;
+            t_index += t_found;
+            t_end_before = t_offset + t_last_offset;
+        }
+    }
+    else
+    {
+        for(; t_offset < t_start_found; t_offset++)
+        {
+            if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
+            {
+                t_index += 1;
+                t_end_before = t_offset;
+            }
         }
     }
     
@@ -1026,9 +1675,25 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     
     if (r_after_offset != nil)
     {
-        for(t_offset = t_start_found + p_needle_length; t_offset < p_haystack_length; t_offset++)
-            if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
-                break;
+        t_offset = t_start_found + p_needle_length;
+        if (t_has_pair)
+        {
+            size_t t_next_offset;
+            if (s_native_chars_scan_forward(p_haystack_chars + t_offset,
+                                            p_haystack_length - t_offset,
+                                            t_delimiters,
+                                            1,
+                                            &t_next_offset) == 1)
+                t_offset += t_next_offset;
+            else
+                t_offset = p_haystack_length;
+        }
+        else
+        {
+            for(; t_offset < p_haystack_length; t_offset++)
+                if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
+                    break;
+        }
         
         *r_after_offset = t_offset;
     }
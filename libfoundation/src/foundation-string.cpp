@@ -21,6 +21,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "foundation-private.h"
 #include "foundation-bidi.h"
 #include "foundation-chunk.h"
+#include "foundation-text.h"
 
 #ifdef __LINUX__
 #include <errno.h>
@@ -81,14 +82,85 @@ static bool MCStringSplitByDelimiterNative(MCStringRef self, MCStringRef p_elem_
 // Check the string and set CanBeNative, Basic and Trivial flags accordingly
 static void __MCStringCheck(MCStringRef self);
 
+// Returns true if the bytes are valid UTF-8 containing a char which can't be
+// native, setting r_char_count to the number of UTF-16 chars they decode to.
+static bool __MCStringScanUTF8(const byte_t *bytes, uindex_t byte_count, uindex_t& r_char_count);
+
+// Creates an immutable string which keeps the given (scanned) UTF-8 bytes.
+static bool __MCStringCreateWithUTF8Bytes(const byte_t *bytes, uindex_t byte_count, uindex_t char_count, MCStringRef& r_string);
+
+// Replaces the UTF-8 bytes of the string with the equivalent unicode chars.
+static bool __MCStringDecodeUTF8(MCStringRef self);
+
+// Creates a filter over the chars of a direct string. For a UTF-8 string it
+// reads the bytes, so the string doesn't need to be decoded.
+static MCTextFilter *__MCStringCreateTextFilter(MCStringRef self, MCStringOptions options);
+
+// Moves the gap in a mutable string's chars to before the char at 'at', or
+// closes it if 'at' is the length of the string.
+static void __MCStringMoveGap(MCStringRef self, uindex_t at);
+
+// Substrings at least this long share the chars of the string they are taken
+// from, rather than copying them.
+static const uindex_t kMCStringSliceThreshold = 16;
+
+// Creates an immutable string whose chars are the given range of those of the
+// (immutable, direct) string.
+static bool __MCStringCreateSlice(MCStringRef self, MCRange range, MCStringRef& r_slice);
+
+// Gives a slice its own chars, releasing its parent.
+static bool __MCStringUnslice(MCStringRef self);
+
+// Frees (or for a slice, releases) the chars of a direct string.
+static void __MCStringDiscardChars(MCStringRef self);
+
+// Ensures the chars of a direct string are NUL-terminated.
+static bool __MCStringEnsureTerminated(MCStringRef self);
+
+// Gives a slice its own chars if its parent is much larger than it.
+static bool __MCStringUnpinParent(MCStringRef self);
+
 ////////////////////////////////////////////////////////////////////////////////
 
+// Ensures the chars of a direct string can be accessed as a single run of
+// native or unicode chars, by decoding them if they are UTF-8 or closing the
+// gap in them if there is one. Only decoding can fail.
+static inline bool __MCStringResolveChars(MCStringRef self)
+{
+    if ((self -> flags & (kMCStringFlagIsUTF8 | kMCStringFlagHasGap)) == 0)
+        return true;
+    
+    if ((self -> flags & kMCStringFlagIsUTF8) != 0)
+        return __MCStringDecodeUTF8(self);
+    
+    __MCStringMoveGap(self, self -> char_count);
+    return true;
+}
+
 // AL-2015-02-06: [[ Bug 14504 ]] Add wrappers for string flag and length checking,
 // for internal use when a string is known to be direct.
 static bool __MCStringIsNative(MCStringRef self)
 {
     MCAssert(!__MCStringIsIndirect(self));
     
+    // Anything which needs to know which kind of chars a string has is about
+    // to access them. The functions which ask have no way to report failure,
+    // and the string's value can't change, so if there isn't the memory to
+    // decode UTF-8 it is fatal. Hashing and comparing don't come here for
+    // UTF-8 strings, as they read the bytes directly.
+    if (!__MCStringResolveChars(self))
+        abort();
+    
+    return (self -> flags & kMCStringFlagIsNotNative) == 0;
+}
+
+// Returns true if the string's chars are native, without making them
+// contiguous. This is for functions which don't access the chars, or which
+// take care of the gap in them.
+static bool __MCStringHasNativeChars(MCStringRef self)
+{
+    MCAssert(!__MCStringIsIndirect(self));
+    
     return (self -> flags & kMCStringFlagIsNotNative) == 0;
 }
 
@@ -337,8 +409,16 @@ bool MCStringCreateWithBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCStr
             
         case kMCStringEncodingUTF8:
         {
-            unichar_t *t_chars;
             uindex_t t_char_count;
+            
+            // Text which is mostly ASCII is smaller as UTF-8 than as unicode
+            // chars, so it is kept as it is until its chars are needed. This
+            // also means it can be converted back to UTF-8 without encoding.
+            if (__MCStringScanUTF8(p_bytes, p_byte_count, t_char_count) &&
+                p_byte_count <= t_char_count * sizeof(unichar_t))
+                return __MCStringCreateWithUTF8Bytes(p_bytes, p_byte_count, t_char_count, r_string);
+            
+            unichar_t *t_chars;
             t_char_count = MCUnicodeCharsMapFromUTF8(p_bytes, p_byte_count, nil, 0);
             if (!MCMemoryNewArray(t_char_count, t_chars))
                 return false;
@@ -466,7 +546,7 @@ bool MCStringCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, M
         r_string = t_string;
     }
     else
-        MCMemoryDelete(t_string);
+        __MCValueDelete(t_string);
     
     return t_success;
 }
@@ -537,7 +617,7 @@ bool MCStringCreateWithChars(const unichar_t *p_chars, uindex_t p_char_count, MC
 		if (self != nil)
             MCMemoryDeleteArray(self -> chars);
 
-		MCMemoryDelete(self);
+		__MCValueDelete(self);
 	}
 
 	return t_success;
@@ -595,7 +675,7 @@ bool MCStringCreateUnicodeWithChars(const unichar_t *p_chars, uindex_t p_char_co
         if (self != nil)
             MCMemoryDeleteArray(self -> chars);
         
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     }
     
     return t_success;
@@ -655,7 +735,7 @@ bool MCStringCreateWithNativeChars(const char_t *p_chars, uindex_t p_char_count,
 	{
 		if (self != nil)
 			MCMemoryDeleteArray(self -> native_chars);
-		MCMemoryDelete(self);
+		__MCValueDelete(self);
 	}
 
     if (t_success)
@@ -709,7 +789,7 @@ bool MCStringCreateWithNativeCharBufferAndRelease(char_t* p_chars, uindex_t p_ch
         r_string = self;
     }
     else
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     
     return t_success;
 }
@@ -881,7 +961,7 @@ bool MCStringCreateUnicodeStringFromData(MCDataRef p_data, bool p_is_external_re
         if (self != nil)
             MCMemoryDeleteArray(self -> chars);
         
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
     }
     
     return t_success;
@@ -1324,6 +1404,11 @@ bool MCStringCopy(MCStringRef self, MCStringRef& r_new_string)
 	// If the string is immutable we can just bump the reference count.
 	if (!MCStringIsMutable(self))
 	{
+        // A copy is kept, so don't let a small slice keep a much larger
+        // parent alive.
+        if (!__MCStringUnpinParent(self))
+            return false;
+        
 		r_new_string = self;
 		MCValueRetain(self);
 		return true;
@@ -1350,6 +1435,9 @@ bool MCStringCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
 	// If the string is immutable we just pass it through (as we are releasing the string).
 	if (!MCStringIsMutable(self))
 	{
+        if (!__MCStringUnpinParent(self))
+            return false;
+        
 		r_new_string = self;
 		return true;
 	}
@@ -1415,7 +1503,13 @@ bool MCStringMutableCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
 	{
 		if (!MCStringIsMutable(self))
         {
+            // Mutable strings are never UTF-8, and have their own chars.
+            if (!__MCStringResolveChars(self) ||
+                !__MCStringUnslice(self))
+                return false;
+            
 			self -> flags |= kMCStringFlagIsMutable;
+            self -> flags &= ~(kMCStringFlagHasHash | kMCStringFlagHasCaselessHash);
             //self -> capacity = self -> char_count;
         }
         
@@ -1446,7 +1540,18 @@ bool MCStringCopySubstring(MCStringRef self, MCRange p_range, MCStringRef& r_sub
 
 	__MCStringClampRange(self, p_range);
 	
-    if (__MCStringIsNative(self))
+    bool t_is_native;
+    t_is_native = __MCStringIsNative(self);
+    
+    // Long enough substrings of immutable strings share their chars. Shared
+    // strings can't be changed to give their chars to a parent, so they are
+    // never sliced.
+    if (p_range . length >= kMCStringSliceThreshold &&
+        !MCStringIsMutable(self) &&
+        !__MCValueIsShared(self))
+        return __MCStringCreateSlice(self, p_range, r_substring);
+    
+    if (t_is_native)
         return MCStringCreateWithNativeChars(self -> native_chars + p_range . offset, p_range . length, r_substring);
     
 	return MCStringCreateWithChars(self -> chars + p_range . offset, p_range . length, r_substring);
@@ -1624,7 +1729,8 @@ const unichar_t *MCStringGetCharPtr(MCStringRef self)
 		if (!__MCStringResolveIndirect(self))
 			return nil;
     
-	if (!__MCStringUnnativize(self))
+	if (!__MCStringUnnativize(self) ||
+	    !__MCStringEnsureTerminated(self))
 	{
 		return nil;
 	}
@@ -1644,6 +1750,9 @@ const char_t *MCStringGetNativeCharPtr(MCStringRef self)
 			if (!__MCStringResolveIndirect(self))
 				return nil;
         
+        if (!__MCStringEnsureTerminated(self))
+            return nil;
+        
         return self -> native_chars;
     }
     
@@ -1655,7 +1764,8 @@ const char_t *MCStringGetNativeCharPtrAndLength(MCStringRef self, uindex_t& r_ch
 {
 	__MCAssertIsString(self);
 
-	if (__MCStringNativize(self, r_char_count))
+	if (__MCStringNativize(self, r_char_count) &&
+	    __MCStringEnsureTerminated(self))
 	{
 		return self->native_chars;
 	}
@@ -1676,6 +1786,10 @@ unichar_t MCStringGetCharAtIndex(MCStringRef self, uindex_t p_index)
     /* Allow trailing null character */
     MCAssert(p_index <= MCStringGetLength(self));
 
+    // A slice's chars aren't necessarily followed by a NUL.
+    if (p_index == self -> char_count)
+        return 0;
+    
     if (__MCStringIsNative(self))
         return MCUnicodeCharMapFromNative(self -> native_chars[p_index]);
     
@@ -1693,6 +1807,9 @@ char_t MCStringGetNativeCharAtIndex(MCStringRef self, uindex_t p_index)
     /* Allow trailing null character */
     MCAssert(p_index <= __MCStringGetLength(self));
 
+    if (p_index == self -> char_count)
+        return 0;
+    
     if (__MCStringIsNative(self))
         return self -> native_chars[p_index];
     
@@ -2053,7 +2170,7 @@ bool MCStringMapGraphemeIndices(MCStringRef self, MCRange p_grapheme_range, MCRa
         self = self -> string;
     
     // Quick-n-dirty workaround
-    if (__MCStringIsNative(self) || __MCStringIsTrivial(self))
+    if (__MCStringHasNativeChars(self) || __MCStringIsTrivial(self))
     {
         __MCStringClampRange(self, p_grapheme_range);
         r_cu_range = p_grapheme_range;
@@ -2785,6 +2902,19 @@ bool MCStringConvertToUTF8(MCStringRef p_string, char*& r_utf8string, uindex_t&
 {
 	__MCAssertIsString(p_string);
 
+    // A string which is still UTF-8 only needs its bytes copied.
+    MCStringRef t_direct;
+    t_direct = __MCStringIsIndirect(p_string) ? p_string -> string : p_string;
+    if ((t_direct -> flags & kMCStringFlagIsUTF8) != 0)
+    {
+        if (!MCMemoryNewArray(t_direct -> capacity + 1, r_utf8string))
+            return false;
+        
+        MCMemoryCopy(r_utf8string, t_direct -> utf8_bytes, t_direct -> capacity);
+        r_utf8_chars = t_direct -> capacity;
+        return true;
+    }
+
 	// Allocate an array of chars one byte bigger than needed. As the allocated array
 	// is filled with zeros, this will naturally NUL terminate the string.
     uindex_t t_length;
@@ -2932,6 +3062,30 @@ bool MCStringConvertToBSTR(MCStringRef p_string, BSTR& r_bstr)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Immutable strings cache their exact and caseless hashes, as the same string
+// is often hashed many times (e.g. when it is used as a key). Returns the flag
+// which marks the given hash as cached, or 0 if it isn't one that is cached.
+static inline uint32_t __MCStringHashFlagForOptions(MCStringOptions p_options)
+{
+    if (p_options == kMCStringOptionCompareExact)
+        return kMCStringFlagHasHash;
+    if (p_options == kMCStringOptionCompareCaseless)
+        return kMCStringFlagHasCaselessHash;
+    return 0;
+}
+
+// Fetch the cached hash of the (direct) string, if there is one.
+static inline bool __MCStringFetchCachedHash(MCStringRef self, MCStringOptions p_options, hash_t& r_hash)
+{
+    uint32_t t_flag;
+    t_flag = __MCStringHashFlagForOptions(p_options);
+    if (t_flag == 0 || (self -> flags & t_flag) == 0)
+        return false;
+    
+    r_hash = t_flag == kMCStringFlagHasHash ? self -> hash : self -> caseless_hash;
+    return true;
+}
+
 MC_DLLEXPORT_DEF
 hash_t MCStringHash(MCStringRef self, MCStringOptions p_options)
 {
@@ -2940,12 +3094,46 @@ hash_t MCStringHash(MCStringRef self, MCStringOptions p_options)
     if (__MCStringIsIndirect(self))
         self = self -> string;
     
-    if (__MCStringIsNative(self))
-        return __MCNativeOp_Hash(self -> native_chars,
-                                 self -> char_count,
-                                 p_options);
+    hash_t t_hash;
+    if (__MCStringFetchCachedHash(self, p_options, t_hash))
+        return t_hash;
+    
+    if ((self -> flags & kMCStringFlagIsUTF8) != 0)
+    {
+        MCAutoPointer<MCTextFilter> t_filter =
+                __MCStringCreateTextFilter(self, p_options);
+        
+        MCHashCharsContext t_context;
+        while (t_filter -> HasData())
+        {
+            t_context . consume(t_filter -> GetNextCodepoint());
+            t_filter -> AdvanceCursor();
+        }
+        t_hash = t_context;
+    }
+    else if (__MCStringIsNative(self))
+        t_hash = __MCNativeOp_Hash(self -> native_chars,
+                                   self -> char_count,
+                                   p_options);
+    else
+        t_hash = MCUnicodeHash(self -> chars, self -> char_count, (MCUnicodeCompareOption)p_options);
+    
+    // Shared strings may be read concurrently, so their hashes are cached
+    // when they are shared rather than here.
+    uint32_t t_flag;
+    t_flag = __MCStringHashFlagForOptions(p_options);
+    if (t_flag != 0 &&
+        !MCStringIsMutable(self) &&
+        !__MCValueIsShared(self))
+    {
+        if (t_flag == kMCStringFlagHasHash)
+            self -> hash = t_hash;
+        else
+            self -> caseless_hash = t_hash;
+        self -> flags |= t_flag;
+    }
     
-	return MCUnicodeHash(self -> chars, self -> char_count, (MCUnicodeCompareOption)p_options);
+    return t_hash;
 }
 
 MC_DLLEXPORT_DEF
@@ -2965,6 +3153,42 @@ bool MCStringIsEqualTo(MCStringRef self, MCStringRef p_other, MCStringOptions p_
     
     if (__MCStringIsEmpty(self) != __MCStringIsEmpty(p_other))
         return false;
+    
+    // Equal strings have equal hashes, so if both are known they can be used
+    // to reject unequal strings without comparing chars.
+    hash_t t_self_hash, t_other_hash;
+    if (__MCStringFetchCachedHash(self, p_options, t_self_hash) &&
+        __MCStringFetchCachedHash(p_other, p_options, t_other_hash) &&
+        t_self_hash != t_other_hash)
+        return false;
+    
+    // UTF-8 strings only have the shortest encoding of each char, so they have
+    // exactly the same chars if they have the same bytes.
+    if (p_options == kMCStringOptionCompareExact &&
+        (self -> flags & p_other -> flags & kMCStringFlagIsUTF8) != 0)
+        return self -> capacity == p_other -> capacity &&
+                MCMemoryCompare(self -> utf8_bytes, p_other -> utf8_bytes, self -> capacity) == 0;
+    
+    // Otherwise a UTF-8 string is compared by reading its bytes, as decoding
+    // it would undo the memory saved by keeping it as UTF-8.
+    if (((self -> flags | p_other -> flags) & kMCStringFlagIsUTF8) != 0)
+    {
+        MCAutoPointer<MCTextFilter> t_self_filter =
+                __MCStringCreateTextFilter(self, p_options);
+        MCAutoPointer<MCTextFilter> t_other_filter =
+                __MCStringCreateTextFilter(p_other, p_options);
+        
+        while (t_self_filter -> HasData() && t_other_filter -> HasData())
+        {
+            if (t_self_filter -> GetNextCodepoint() != t_other_filter -> GetNextCodepoint())
+                return false;
+            
+            t_self_filter -> AdvanceCursor();
+            t_other_filter -> AdvanceCursor();
+        }
+        
+        return !t_self_filter -> HasData() && !t_other_filter -> HasData();
+    }
 
     bool self_native, other_native;
     self_native = __MCStringIsNative(self);
@@ -4612,7 +4836,7 @@ bool MCStringPrependNativeChars(MCStringRef self, const char_t *p_chars, uindex_
 	if (!__MCStringExpandAt(self, 0, p_char_count))
 		return false;
 	
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         MCMemoryCopy(self -> native_chars, p_chars, p_char_count);
         __MCStringChanged(self, true, true, true);
@@ -4645,7 +4869,7 @@ bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p
         return false;
     
     // If we are native, attempt a native copy of the input chars.
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         bool t_not_native;
         t_not_native = false;
@@ -4660,7 +4884,6 @@ bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p
         
         if (!t_not_native)
         {
-            self -> native_chars[self -> char_count] = '\0';
             __MCStringChanged(self, true, true, true);
             return true;
         }
@@ -4768,7 +4991,7 @@ bool MCStringInsertNativeChars(MCStringRef self, uindex_t p_at, const char_t *p_
 	if (!__MCStringExpandAt(self, p_at, p_char_count))
 		return false;
 	
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         MCMemoryCopy(self -> native_chars + p_at, p_chars, p_char_count);
         __MCStringChanged(self, true, true, true);
@@ -4802,7 +5025,7 @@ bool MCStringInsertChars(MCStringRef self, uindex_t p_at, const unichar_t *p_cha
 	if (!__MCStringExpandAt(self, p_at, p_char_count))
 		return false;
 	
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         bool t_not_native;
         t_not_native = false;
@@ -4815,7 +5038,6 @@ bool MCStringInsertChars(MCStringRef self, uindex_t p_at, const unichar_t *p_cha
         
         if (!t_not_native)
         {
-            self -> native_chars[self -> char_count] = '\0';
             __MCStringChanged(self, true, true, true);
             return true;
         }
@@ -4879,7 +5101,7 @@ bool MCStringRemove(MCStringRef self, MCRange p_range)
 	// NUL.
 	__MCStringShrinkAt(self, p_range . offset, p_range . length);
 	
-    if (!__MCStringIsNative(self))
+    if (!__MCStringHasNativeChars(self))
         __MCStringChanged(self, false, false);
     else
         __MCStringChanged(self, true, true, true);
@@ -4944,7 +5166,7 @@ bool MCStringReplaceNativeChars(MCStringRef self, MCRange p_range, const char_t
         __MCStringShrinkAt(self, p_range . offset + (p_range . length - (self -> char_count - t_new_char_count)), (self -> char_count - t_new_char_count));
     }
     
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         // Copy across the replacement chars.
         MCMemoryCopy(self -> native_chars + p_range . offset, p_chars, p_char_count);
@@ -4992,7 +5214,7 @@ bool MCStringReplaceChars(MCStringRef self, MCRange p_range, const unichar_t *p_
         __MCStringShrinkAt(self, p_range . offset + (p_range . length + t_change), -t_change);
     }
     
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
     {
         bool t_not_native;
         t_not_native = false;
@@ -5005,7 +5227,6 @@ bool MCStringReplaceChars(MCStringRef self, MCRange p_range, const unichar_t *p_
         
         if (!t_not_native)
         {
-            self -> native_chars[self -> char_count] = '\0';
             __MCStringChanged(self, true, true, true);
             return true;
         }
@@ -5236,7 +5457,7 @@ bool MCStringSplitNative(MCStringRef self, MCStringRef p_elem_del, MCStringRef p
             split_find_end_of_element_native(t_sptr, t_eptr, p_elem_del -> native_chars, p_elem_del -> char_count, t_element_end, p_options);
             
             MCAutoStringRef t_string;
-            if (!MCStringCreateWithNativeChars(t_sptr, t_element_end - t_sptr, &t_string))
+            if (!MCStringCopySubstring(self, MCRangeMake(t_sptr - self -> native_chars, t_element_end - t_sptr), &t_string))
                 return false;
             
             if (!MCArrayStoreValueAtIndex(*t_array, t_index, *t_string))
@@ -5270,7 +5491,7 @@ bool MCStringSplitNative(MCStringRef self, MCStringRef p_elem_del, MCStringRef p
 				t_key_end += p_key_del -> char_count;
 
 			MCAutoStringRef t_string;
-			if (!MCStringCreateWithNativeChars(t_key_end, t_element_end - t_key_end, &t_string))
+			if (!MCStringCopySubstring(self, MCRangeMake(t_key_end - self -> native_chars, t_element_end - t_key_end), &t_string))
 				return false;
             
 			if (!MCArrayStoreValue(*t_array, true, *t_name, *t_string))
@@ -5298,7 +5519,29 @@ bool MCStringFindAndReplaceChar(MCStringRef self, char_t p_pattern, char_t p_rep
 		if (!__MCStringResolveIndirect(self))
 			return false;
 	
+	// Find each occurrence of the pattern a block of chars at a time, if it
+	// can be searched for quickly.
+	char_t t_pair[2];
+	bool t_has_pair;
 	if (p_options == kMCStringOptionCompareExact || p_options == kMCStringOptionCompareNonliteral)
+		t_has_pair = __MCNativeChars_GetPair<__MCNativeChar_Equal_Unfolded>(p_pattern, t_pair);
+	else
+		t_has_pair = __MCNativeChars_GetPair<__MCNativeChar_Equal_Folded>(p_pattern, t_pair);
+	
+	if (t_has_pair)
+	{
+		size_t t_offset;
+		t_offset = 0;
+		
+		size_t t_found;
+		while(t_offset < self -> char_count &&
+			  s_native_chars_scan_forward(self -> native_chars + t_offset, self -> char_count - t_offset, t_pair, 1, &t_found) == 1)
+		{
+			self -> native_chars[t_offset + t_found] = p_replacement;
+			t_offset += t_found + 1;
+		}
+	}
+	else if (p_options == kMCStringOptionCompareExact || p_options == kMCStringOptionCompareNonliteral)
 	{
 		// Simplest case, just substitute pattern for replacement.
 		for(uindex_t i = 0; i < self -> char_count; i++)
@@ -5697,7 +5940,7 @@ MCStringSplitByDelimiterNative(MCStringRef self, MCStringRef p_elem_del, MCStrin
         split_find_end_of_element_native(t_sptr, t_eptr, p_elem_del -> native_chars, p_elem_del -> char_count, t_element_end, p_options);
         
         MCAutoStringRef t_string;
-        if (!MCStringCreateWithNativeChars(t_sptr, t_element_end - t_sptr, &t_string))
+        if (!MCStringCopySubstring(self, MCRangeMake(t_sptr - self -> native_chars, t_element_end - t_sptr), &t_string))
         {
             return false;
         }
@@ -5912,13 +6155,324 @@ void __MCStringDestroy(__MCString *self)
     {
         MCValueRelease(self -> string);
     }
+    else if ((self -> flags & kMCStringFlagIsUTF8) != 0)
+    {
+        MCMemoryDeleteArray(self -> utf8_bytes);
+    }
     else
+        __MCStringDiscardChars(self);
+}
+
+// Make an immutable native string, in storage which is never freed, from
+// constant chars which it doesn't copy.
+void __MCStringInitializeStatic(__MCString *self, const char_t *p_chars, uindex_t p_char_count)
+{
+    self -> references = 1;
+    self -> flags = (kMCValueTypeCodeString << 28) | kMCStringFlagIsStatic;
+    self -> char_count = p_char_count;
+    self -> capacity = 0;
+    self -> native_chars = const_cast<char_t *>(p_chars);
+    self -> numeric_value = 0;
+}
+
+static bool __MCStringScanUTF8(const byte_t *p_bytes, uindex_t p_byte_count, uindex_t& r_char_count)
+{
+    uindex_t t_char_count;
+    t_char_count = 0;
+    
+    bool t_can_be_native;
+    t_can_be_native = true;
+    
+    uindex_t i;
+    i = 0;
+    while(i < p_byte_count)
     {
-        if (__MCStringIsNative(self))
-            MCMemoryDeleteArray(self -> native_chars);
+        byte_t t_lead;
+        t_lead = p_bytes[i];
+        
+        if (t_lead < 0x80)
+        {
+            t_char_count += 1;
+            i += 1;
+            continue;
+        }
+        
+        // Only the shortest encoding of each codepoint is accepted, and
+        // surrogates aren't codepoints, so that decoding and encoding again
+        // gives back the same bytes.
+        uindex_t t_length;
+        byte_t t_min, t_max;
+        if (t_lead >= 0xC2 && t_lead <= 0xDF)
+            t_length = 2, t_min = 0x80, t_max = 0xBF;
+        else if (t_lead == 0xE0)
+            t_length = 3, t_min = 0xA0, t_max = 0xBF;
+        else if (t_lead == 0xED)
+            t_length = 3, t_min = 0x80, t_max = 0x9F;
+        else if (t_lead >= 0xE1 && t_lead <= 0xEF)
+            t_length = 3, t_min = 0x80, t_max = 0xBF;
+        else if (t_lead == 0xF0)
+            t_length = 4, t_min = 0x90, t_max = 0xBF;
+        else if (t_lead >= 0xF1 && t_lead <= 0xF3)
+            t_length = 4, t_min = 0x80, t_max = 0xBF;
+        else if (t_lead == 0xF4)
+            t_length = 4, t_min = 0x80, t_max = 0x8F;
         else
-            MCMemoryDeleteArray(self -> chars);
+            return false;
+        
+        if (p_byte_count - i < t_length ||
+            p_bytes[i + 1] < t_min || p_bytes[i + 1] > t_max)
+            return false;
+        
+        codepoint_t t_codepoint;
+        t_codepoint = t_lead & (0x7F >> t_length);
+        for(uindex_t j = 1; j < t_length; j++)
+        {
+            if ((p_bytes[i + j] & 0xC0) != 0x80)
+                return false;
+            t_codepoint = (t_codepoint << 6) | (p_bytes[i + j] & 0x3F);
+        }
+        
+        if (t_codepoint >= 0x10000)
+        {
+            t_char_count += 2;
+            t_can_be_native = false;
+        }
+        else
+        {
+            t_char_count += 1;
+            
+            char_t t_native;
+            if (t_can_be_native &&
+                !MCUnicodeCharMapToNative(unichar_t(t_codepoint), t_native))
+                t_can_be_native = false;
+        }
+        
+        i += t_length;
+    }
+    
+    // Text which can be native is kept as native chars instead.
+    if (t_can_be_native)
+        return false;
+    
+    r_char_count = t_char_count;
+    return true;
+}
+
+static bool __MCStringCreateWithUTF8Bytes(const byte_t *p_bytes, uindex_t p_byte_count, uindex_t p_char_count, MCStringRef& r_string)
+{
+    __MCString *self;
+    if (!__MCValueCreate(kMCValueTypeCodeString, self))
+        return false;
+    
+    if (!MCMemoryNewArray(p_byte_count + 1, self -> utf8_bytes))
+    {
+        __MCValueDelete(self);
+        return false;
+    }
+    
+    MCMemoryCopy(self -> utf8_bytes, p_bytes, p_byte_count);
+    self -> char_count = p_char_count;
+    self -> capacity = p_byte_count;
+    self -> flags |= kMCStringFlagIsNotNative | kMCStringFlagIsUTF8;
+    
+    r_string = self;
+    return true;
+}
+
+// This is done in place, as unnativizing is, since the string's value doesn't
+// change. If the unicode chars can't be allocated then the string is left as
+// UTF-8.
+static bool __MCStringDecodeUTF8(MCStringRef self)
+{
+    unichar_t *t_chars;
+    if (!MCMemoryNewArray(self -> char_count + 1, t_chars))
+        return false;
+    
+    MCUnicodeCharsMapFromUTF8(self -> utf8_bytes, self -> capacity, t_chars, self -> char_count);
+    
+    MCMemoryDeleteArray(self -> utf8_bytes);
+    self -> chars = t_chars;
+    self -> capacity = 0;
+    self -> flags &= ~kMCStringFlagIsUTF8;
+    
+    return true;
+}
+
+static MCTextFilter *__MCStringCreateTextFilter(MCStringRef self, MCStringOptions p_options)
+{
+    if ((self -> flags & kMCStringFlagIsUTF8) != 0)
+        return MCTextFilterCreate(self -> utf8_bytes, self -> capacity, kMCStringEncodingUTF8, p_options);
+    
+    if (__MCStringIsNative(self))
+        return MCTextFilterCreate(self -> native_chars, self -> char_count, kMCStringEncodingNative, p_options);
+    
+    return MCTextFilterCreate(self -> chars, self -> char_count, kMCStringEncodingUTF16, p_options);
+}
+
+// A slice can't point into the chars of the string it was taken from, as that
+// string may replace them (when it is unnativized, for example). So the first
+// time a string is sliced its chars are moved to a hidden parent string which
+// never changes, and the string becomes a slice of all of them.
+static bool __MCStringCreateSlice(MCStringRef self, MCRange p_range, MCStringRef& r_slice)
+{
+    MCAssert(!MCStringIsMutable(self));
+    MCAssert((self -> flags & kMCStringFlagIsUTF8) == 0);
+    
+    if ((self -> flags & kMCStringFlagIsSlice) == 0)
+    {
+        __MCString *t_parent;
+        if (!__MCValueCreate(kMCValueTypeCodeString, t_parent))
+            return false;
+        
+        t_parent -> flags |= self -> flags & (kMCStringFlagIsNotNative | kMCStringFlagCanBeNative | kMCStringFlagIsStatic | kMCStringFlagIsChecked | kMCStringFlagIsBasic | kMCStringFlagIsTrivial);
+        t_parent -> char_count = self -> char_count;
+        if (__MCStringHasNativeChars(self))
+            t_parent -> native_chars = self -> native_chars;
+        else
+            t_parent -> chars = self -> chars;
+        
+        // The numeric value is lost, as its field now holds the parent.
+        self -> parent = t_parent;
+        self -> flags &= ~(kMCStringFlagHasNumber | kMCStringFlagIsStatic);
+        self -> flags |= kMCStringFlagIsSlice;
     }
+    
+    __MCString *t_slice;
+    if (!__MCValueCreate(kMCValueTypeCodeString, t_slice))
+        return false;
+    
+    t_slice -> flags |= kMCStringFlagIsSlice | (self -> flags & (kMCStringFlagIsNotNative | kMCStringFlagCanBeNative));
+    t_slice -> char_count = p_range . length;
+    if (__MCStringHasNativeChars(self))
+        t_slice -> native_chars = self -> native_chars + p_range . offset;
+    else
+        t_slice -> chars = self -> chars + p_range . offset;
+    t_slice -> parent = MCValueRetain(self -> parent);
+    
+    r_slice = t_slice;
+    return true;
+}
+
+// Frees the chars of a direct string, or lets go of its parent's if it is a
+// slice, so that they can be replaced.
+static void __MCStringDiscardChars(MCStringRef self)
+{
+    if ((self -> flags & kMCStringFlagIsSlice) != 0)
+    {
+        MCValueRelease(self -> parent);
+        self -> numeric_value = 0;
+    }
+    else if (__MCStringHasNativeChars(self))
+    {
+        if ((self -> flags & kMCStringFlagIsStatic) == 0)
+            MCMemoryDeleteArray(self -> native_chars);
+    }
+    else
+        MCMemoryDeleteArray(self -> chars);
+    
+    self -> flags &= ~(kMCStringFlagIsSlice | kMCStringFlagIsStatic);
+}
+
+// Gives a slice its own copy of its chars. If it is the only thing left using
+// all of its parent's chars, it takes them instead.
+static bool __MCStringUnslice(MCStringRef self)
+{
+    if ((self -> flags & kMCStringFlagIsSlice) == 0)
+        return true;
+    
+    MCStringRef t_parent;
+    t_parent = self -> parent;
+    
+    if (t_parent -> references == 1 &&
+        (t_parent -> flags & kMCStringFlagIsStatic) == 0 &&
+        t_parent -> char_count == self -> char_count)
+    {
+        t_parent -> char_count = 0;
+        t_parent -> chars = nil;
+        t_parent -> native_chars = nil;
+    }
+    else if (__MCStringHasNativeChars(self))
+    {
+        char_t *t_native_chars;
+        if (!MCMemoryNewArray(self -> char_count + 1, t_native_chars))
+            return false;
+        MCMemoryCopy(t_native_chars, self -> native_chars, self -> char_count);
+        self -> native_chars = t_native_chars;
+    }
+    else
+    {
+        unichar_t *t_chars;
+        if (!MCMemoryNewArray(self -> char_count + 1, t_chars))
+            return false;
+        MCMemoryCopy(t_chars, self -> chars, self -> char_count * sizeof(unichar_t));
+        self -> chars = t_chars;
+    }
+    
+    MCValueRelease(t_parent);
+    self -> numeric_value = 0;
+    self -> flags &= ~kMCStringFlagIsSlice;
+    
+    return true;
+}
+
+// Ensures the chars of a direct string are followed by a NUL, which isn't so
+// for a slice which ends before its parent does.
+static bool __MCStringEnsureTerminated(MCStringRef self)
+{
+    if ((self -> flags & kMCStringFlagIsSlice) == 0)
+        return true;
+    
+    MCStringRef t_parent;
+    t_parent = self -> parent;
+    
+    if (__MCStringHasNativeChars(self))
+    {
+        if (self -> native_chars + self -> char_count == t_parent -> native_chars + t_parent -> char_count)
+            return true;
+    }
+    else if (self -> chars + self -> char_count == t_parent -> chars + t_parent -> char_count)
+        return true;
+    
+    return __MCStringUnslice(self);
+}
+
+// Gives a slice its own chars if it is much smaller than its parent. This is
+// done when a slice is copied, as that is when it is being kept, and keeping
+// all of a large string for the sake of a small part of it wastes memory.
+static bool __MCStringUnpinParent(MCStringRef self)
+{
+    if ((self -> flags & kMCStringFlagIsSlice) == 0)
+        return true;
+    
+    if (self -> char_count >= self -> parent -> char_count / 16)
+        return true;
+    
+    // Shared strings can't be changed.
+    if (__MCValueIsShared(self))
+        return true;
+    
+    return __MCStringUnslice(self);
+}
+
+// Shared strings may be read on several threads at once, so nothing which
+// would otherwise be done to them lazily, in place, when they are read can be
+// left until then. So UTF-8 is decoded, a slice is given its own chars (it
+// would otherwise do so, releasing its parent, to be NUL-terminated), and the
+// char flags and hashes are computed. Converting between native and unicode
+// chars is refused for shared strings instead.
+bool __MCStringPrepareToShare(__MCString *self)
+{
+    MCAssert(!MCStringIsMutable(self));
+    
+    if (!__MCStringResolveChars(self) ||
+        !__MCStringUnslice(self))
+        return false;
+    
+    __MCStringCheck(self);
+    MCStringHash(self, kMCStringOptionCompareExact);
+    MCStringHash(self, kMCStringOptionCompareCaseless);
+    
+    return true;
 }
 
 bool __MCStringCopyDescription(__MCString *self, MCStringRef& r_desc)
@@ -5976,6 +6530,69 @@ static uindex_t __MCStringGetCapacity(MCStringRef self)
 	return 0;*/
 }
 
+// Mutable strings at least this long keep the free space in their buffer as
+// a gap where they were last changed, rather than at the end. A run of
+// changes near one another then only moves the chars between them, rather
+// than all the chars after them.
+static const uindex_t kMCStringGapThreshold = 4096;
+
+// Records that the gap in the chars is before the char at 'at' (with the
+// chars already either side of it). The implicit NUL follows the last char,
+// which is at the end of the buffer if there is a gap.
+static void __MCStringSetGap(MCStringRef self, uindex_t p_at)
+{
+    uindex_t t_nul;
+    if (p_at == self -> char_count)
+    {
+        self -> flags &= ~kMCStringFlagHasGap;
+        t_nul = self -> char_count;
+    }
+    else
+    {
+        self -> flags |= kMCStringFlagHasGap;
+        self -> gap_offset = p_at;
+        t_nul = self -> capacity;
+    }
+    
+    if (__MCStringHasNativeChars(self))
+        self -> native_chars[t_nul] = '\0';
+    else
+        self -> chars[t_nul] = 0;
+}
+
+static void __MCStringMoveGap(MCStringRef self, uindex_t p_at)
+{
+    MCAssert(!__MCStringIsIndirect(self));
+    MCAssert(p_at <= self -> char_count);
+    
+    size_t t_char_size;
+    t_char_size = __MCStringHasNativeChars(self) ? sizeof(char_t) : sizeof(unichar_t);
+    
+    byte_t *t_chars;
+    t_chars = (byte_t *)self -> native_chars;
+    
+    // If there is no gap, then the free space is after the chars.
+    uindex_t t_gap_offset, t_gap_length;
+    if ((self -> flags & kMCStringFlagHasGap) != 0)
+        t_gap_offset = self -> gap_offset;
+    else
+        t_gap_offset = self -> char_count;
+    t_gap_length = self -> capacity - self -> char_count;
+    
+    // Move the chars between the old and new places to the other side of the
+    // gap.
+    if (p_at < t_gap_offset)
+        MCMemoryMove(t_chars + (p_at + t_gap_length) * t_char_size,
+                     t_chars + p_at * t_char_size,
+                     (t_gap_offset - p_at) * t_char_size);
+    else if (p_at > t_gap_offset)
+        MCMemoryMove(t_chars + t_gap_offset * t_char_size,
+                     t_chars + (t_gap_offset + t_gap_length) * t_char_size,
+                     (p_at - t_gap_offset) * t_char_size);
+    
+    __MCStringSetGap(self, p_at);
+}
+
 static bool __MCStringExpandAt(MCStringRef self, uindex_t p_at, uindex_t p_count)
 {
     MCAssert(!__MCStringIsIndirect(self));
@@ -5996,71 +6613,81 @@ static bool __MCStringExpandAt(MCStringRef self, uindex_t p_at, uindex_t p_count
 	 * size_t.  The maximum capacity (i.e. number of chars) depends on whether it's a
 	 * Unicode (multibyte) or native (unibyte) string representation. */
 	size_t t_capacity_limit =
-		SIZE_MAX / (__MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t));
+		SIZE_MAX / (__MCStringHasNativeChars(self) ? sizeof(char_t) : sizeof(unichar_t));
 	if (t_capacity_limit == p_count || t_capacity_limit - p_count - 1 < self->char_count)
 	{
 		return MCErrorThrowOutOfMemory();
 	}
 
 	// The capacity field stores the total number of chars that could fit not
-	// including the implicit NUL, so if we fit, we can fast-track.
-	if (t_capacity != 0 && self -> char_count + p_count <= t_capacity)
+	// including the implicit NUL, so if we don't fit, we need to reallocate
+	// first.
+	if (t_capacity == 0 || self -> char_count + p_count > t_capacity)
 	{
-		// Shift up the chars above - including the implicit NUL.
-        if (__MCStringIsNative(self))
-            MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
-        else
-            MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
-
-		// Increase the char_count.
-		self -> char_count += p_count;
+		// Base capacity - current length + inserted length + implicit NUL.
+		uindex_t t_new_capacity;
+		t_new_capacity = self -> char_count + p_count + 1;
 		
-		// Rewrite the capacity.
-		//*(__MCStringGetCapacityPtr(self)) = t_capacity;
-
-		// We succeeded.
+		// Long strings get half as much space again, so that building one up
+		// a piece at a time doesn't reallocate (and copy) it every time.
+		size_t t_growth_limit;
+		t_growth_limit = MCMin(t_capacity_limit, size_t(INDEX_MAX)) - t_new_capacity;
+		if (t_new_capacity >= kMCStringGapThreshold &&
+			t_new_capacity / 2 + 64 <= t_growth_limit)
+			t_new_capacity += t_new_capacity / 2;
+		
+		// Capacity rounded up to a suitable boundary.
+		t_new_capacity = (t_new_capacity + 63) & ~63;
+		
+		if (__MCStringHasNativeChars(self))
+		{
+			if (!MCMemoryReallocate(self -> native_chars, t_new_capacity, self -> native_chars))
+				return false;
+		}
+		else
+		{
+			if (!MCMemoryReallocate(self -> chars, t_new_capacity * sizeof(unichar_t), self -> chars))
+				return false;
+		}
+		
+		// If there is a gap, the chars after it (and the implicit NUL) move to
+		// the end of the new buffer.
+		if ((self -> flags & kMCStringFlagHasGap) != 0)
+		{
+			size_t t_char_size;
+			t_char_size = __MCStringHasNativeChars(self) ? sizeof(char_t) : sizeof(unichar_t);
+			
+			uindex_t t_after_count;
+			t_after_count = self -> char_count - self -> gap_offset + 1;
+			MCMemoryMove((byte_t *)self -> native_chars + (t_new_capacity - t_after_count) * t_char_size,
+						 (byte_t *)self -> native_chars + (t_capacity + 1 - t_after_count) * t_char_size,
+						 t_after_count * t_char_size);
+		}
+		
+		// Update the capacity - shaving off room for the implicit NUL.
+		self -> capacity = t_new_capacity - 1;
+	}
+	
+	// Long strings make room by moving the gap to 'at', and then taking the
+	// start of it.
+	if ((self -> flags & kMCStringFlagHasGap) != 0 ||
+		self -> char_count >= kMCStringGapThreshold)
+	{
+		__MCStringMoveGap(self, p_at);
+		self -> char_count += p_count;
+		__MCStringSetGap(self, p_at + p_count);
 		return true;
 	}
 
-	// If we get here then we need to reallocate first.
-
-	// Base capacity - current length + inserted length + implicit NUL.
-	uindex_t t_new_capacity;
-	t_new_capacity = self -> char_count + p_count + 1;
-
-	// Capacity rounded up to nearest aligned boundary and then space for
-	// the capacity field.
-	//t_new_capacity = ((t_new_capacity + sizeof(uindex_t) - 1) & (~(sizeof(uindex_t) - 1))) + sizeof(uindex_t);
-
-	// Capacity rounded up to a suitable boundary (at some point this should
-	// be a function of the string's size).
-	t_new_capacity = (t_new_capacity + 63) & ~63;
-
-	// Reallocate and shift up the chars above - including the implicit NUL.
-    if (__MCStringIsNative(self))
-    {
-        if (!MCMemoryReallocate(self -> native_chars, t_new_capacity, self -> native_chars))
-            return false;
-        
-    	MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
-    }
-    else
-    {
-        if (!MCMemoryReallocate(self -> chars, t_new_capacity * sizeof(unichar_t), self -> chars))
-            return false;
-        
-        MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
-    }
+	// Otherwise shift up the chars above - including the implicit NUL.
+	if (__MCStringHasNativeChars(self))
+		MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
+	else
+		MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
 
 	// Increase the char_count.
 	self -> char_count += p_count;
 
-	// Update the capacity - notice that we shave off the capacity field itself
-	// since it represents the char capacity rather than the size of the alloc'd
-	// block. We also shave off room for the implicit NUL.
-	self -> capacity = t_new_capacity - 1;
-	//*(__MCStringGetCapacityPtr(self)) = t_new_capacity - 1 - sizeof(uindex_t);
-
 	// We succeeded.
 	return true;
 }
@@ -6069,9 +6696,20 @@ static void __MCStringShrinkAt(MCStringRef self, uindex_t p_at, uindex_t p_count
 {
     MCAssert(!__MCStringIsIndirect(self));
     
+    // Long strings move the gap to after the chars being removed, and then
+    // add them to it.
+    if ((self -> flags & kMCStringFlagHasGap) != 0 ||
+        (self -> char_count >= kMCStringGapThreshold && self -> capacity >= self -> char_count))
+    {
+        __MCStringMoveGap(self, p_at + p_count);
+        self -> char_count -= p_count;
+        __MCStringSetGap(self, p_at);
+        return;
+    }
+    
 	// Shift the chars above 'at' down to remove 'count', remembering to include
 	// the implicit NUL.
-    if (__MCStringIsNative(self))
+    if (__MCStringHasNativeChars(self))
         MCMemoryMove(self -> native_chars + p_at, self -> native_chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1));
     else
         MCMemoryMove(self -> chars + p_at, self -> chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1) * sizeof(strchar_t));
@@ -6097,6 +6735,10 @@ static bool __MCStringNativize(MCStringRef self, uindex_t & r_char_count)
 		return true;
 	}
     
+	// Shared strings may be being read on other threads.
+	if (__MCValueIsShared(self))
+		return false;
+    
 	if (__MCStringIsIndirect(self) &&
 	    !__MCStringResolveIndirect(self))
 	{
@@ -6122,7 +6764,7 @@ static bool __MCStringNativize(MCStringRef self, uindex_t & r_char_count)
     if (!t_not_native)
     {
 		uindex_t t_ignored;
-        MCMemoryDeleteArray(self -> chars);
+        __MCStringDiscardChars(self);
 		chars.Take(self -> native_chars, t_ignored);
         __MCStringChanged(self, true, true, true);
         self -> flags &= ~kMCStringFlagIsNotNative;
@@ -6171,7 +6813,7 @@ static bool __MCStringNativize(MCStringRef self, uindex_t & r_char_count)
     }
     
     uindex_t t_ignored;
-    MCMemoryDeleteArray(self -> chars);
+    __MCStringDiscardChars(self);
 	chars.Take(self -> native_chars, t_ignored);
 	self -> native_chars[t_char_range.length] = '\0';
     
@@ -6187,6 +6829,10 @@ static bool __MCStringUnnativize(MCStringRef self)
 {    
     if (!MCStringIsNative(self))
 		return true;
+    
+	// Shared strings may be being read on other threads.
+	if (__MCValueIsShared(self))
+		return false;
 
 	if (__MCStringIsIndirect(self) &&
 	    !__MCStringResolveIndirect(self))
@@ -6205,7 +6851,7 @@ static bool __MCStringUnnativize(MCStringRef self)
 	}
     
 	MCStrCharsMapFromNative(chars, self -> native_chars, t_char_count);
-	MCMemoryDeleteArray(self -> native_chars);
+    __MCStringDiscardChars(self);
 	self -> chars = chars;
 	self -> char_count = t_char_count;
 	// Set the NUL char.
@@ -6263,6 +6909,7 @@ static void __MCStringChanged(MCStringRef self, uindex_t basic, uindex_t trivial
 
     self -> flags &= ~kMCStringFlagIsChecked;
     self -> flags &= ~kMCStringFlagHasNumber;
+    self -> flags &= ~(kMCStringFlagHasHash | kMCStringFlagHasCaselessHash);
     
     __MCStringSetFlags(self, basic, trivial, native);
 }
@@ -6427,6 +7074,8 @@ MC_DLLEXPORT_DEF MCStringRef kMCNulString;
 
 bool __MCStringInitialize(void)
 {
+    __MCNativeChars_Initialize();
+    
 #if defined(__LINUX__)
     if (!__MCStringInitializeIconv())
         return false;
@@ -6990,6 +7639,14 @@ bool MCStringSetNumericValue(MCStringRef self, double p_value)
     if (MCStringIsMutable(self))
         return false;
     
+    // Shared strings may be read concurrently, so don't cache anything in them.
+    if (__MCValueIsShared(self))
+        return false;
+    
+    // A slice's numeric value field holds its parent.
+    if ((self -> flags & kMCStringFlagIsSlice) != 0)
+        return false;
+    
     self -> numeric_value = p_value;
     self -> flags |= kMCStringFlagHasNumber;
     
@@ -7128,6 +7785,14 @@ static void __MCStringCheck(MCStringRef self)
     if (__MCStringCanBeNative(self))
         return;
     
+    // The check is only an optimization, so skip it if the chars can't be
+    // decoded.
+    if (!__MCStringResolveChars(self))
+    {
+        MCErrorReset();
+        return;
+    }
+    
     bool t_can_be_native;
     t_can_be_native = true;
     
@@ -7140,7 +7805,10 @@ static void __MCStringCheck(MCStringRef self)
             break;
         }
         
-        if (!MCUnicodeIsGraphemeClusterBoundary(self -> chars[i], self -> chars[i + 1]))
+        // A slice's chars aren't necessarily followed by a NUL.
+        unichar_t t_next_char;
+        t_next_char = i + 1 < self -> char_count ? self -> chars[i + 1] : 0;
+        if (!MCUnicodeIsGraphemeClusterBoundary(self -> chars[i], t_next_char))
         {
             __MCStringSetFlags(self, kMCStringFlagNoChange, false, false);
             t_can_be_native = false;
@@ -7250,13 +7918,23 @@ static bool __MCStringResolveIndirect(__MCString *self)
 	MCStringRef t_string;
 	t_string = self -> string;
     
+    // Mutable strings are never UTF-8.
+    if (!__MCStringResolveChars(t_string))
+    {
+        return false;
+    }
+    
 	// If the string only has a single reference, then re-absorb; otherwise
 	// copy.
 	if (self -> string -> references == 1)
 	{
+        if (!__MCStringUnslice(t_string))
+            return false;
+        
         self -> char_count = t_string -> char_count;
         self -> capacity = t_string -> capacity;
-        self -> flags |= t_string -> flags;
+        // Mutable strings don't have cached hashes.
+        self -> flags |= t_string -> flags & ~(kMCStringFlagHasHash | kMCStringFlagHasCaselessHash);
         
         if (__MCStringIsNative(t_string))
             self -> native_chars = t_string -> native_chars;
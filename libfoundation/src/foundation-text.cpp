@@ -201,6 +201,113 @@ MCTextFilter_DecodeNative::~MCTextFilter_DecodeNative()
     ;
 }
 
+codepoint_t MCTextFilter_DecodeUTF8::Decode(uindex_t& r_length) const
+{
+    // Going backwards, the sequence starts at the last byte which isn't a
+    // continuation byte.
+    uindex_t t_start, t_end;
+    if (!m_Reverse)
+    {
+        t_start = m_ReadIndex;
+        t_end = m_DataLength;
+    }
+    else
+    {
+        t_end = m_DataLength - m_ReadIndex;
+        t_start = t_end - 1;
+        while (t_start > 0 && t_end - t_start < 4 && (m_Data[t_start] & 0xC0) == 0x80)
+            t_start--;
+    }
+    
+    byte_t t_lead = m_Data[t_start];
+    
+    uindex_t t_length;
+    codepoint_t t_codepoint;
+    if (t_lead < 0x80)
+        t_length = 1, t_codepoint = t_lead;
+    else if (t_lead >= 0xC0 && t_lead < 0xE0)
+        t_length = 2, t_codepoint = t_lead & 0x1F;
+    else if (t_lead >= 0xE0 && t_lead < 0xF0)
+        t_length = 3, t_codepoint = t_lead & 0x0F;
+    else if (t_lead >= 0xF0 && t_lead < 0xF8)
+        t_length = 4, t_codepoint = t_lead & 0x07;
+    else
+        t_length = 0, t_codepoint = 0;
+    
+    // Bytes which aren't a complete sequence are taken one at a time, each
+    // as a replacement char.
+    bool t_valid = t_length != 0 && t_length <= t_end - t_start;
+    for (uindex_t i = 1; t_valid && i < t_length; i++)
+    {
+        if ((m_Data[t_start + i] & 0xC0) != 0x80)
+            t_valid = false;
+        t_codepoint = (t_codepoint << 6) | (m_Data[t_start + i] & 0x3F);
+    }
+    
+    if (m_Reverse && t_start + t_length != t_end)
+        t_valid = false;
+    
+    if (!t_valid)
+    {
+        r_length = 1;
+        return 0xFFFD;
+    }
+    
+    r_length = t_length;
+    return t_codepoint;
+}
+
+codepoint_t MCTextFilter_DecodeUTF8::GetNextCodepoint()
+{
+    // Don't read beyond the end of the input if no data remains
+    if (m_ReadIndex >= m_DataLength)
+        return 0;
+    
+    uindex_t t_length;
+    return Decode(t_length);
+}
+
+bool MCTextFilter_DecodeUTF8::AdvanceCursor()
+{
+    if (m_ReadIndex >= m_DataLength)
+        return false;
+    
+    uindex_t t_length;
+    if (Decode(t_length) >= 0x10000)
+        m_UnitIndex += 2;
+    else
+        m_UnitIndex += 1;
+    m_ReadIndex += t_length;
+    
+    return m_ReadIndex < m_DataLength;
+}
+
+bool MCTextFilter_DecodeUTF8::HasData() const
+{
+    return m_ReadIndex < m_DataLength;
+}
+
+void MCTextFilter_DecodeUTF8::MarkText()
+{
+    m_AcceptedUnitIndex = m_UnitIndex;
+}
+
+uindex_t MCTextFilter_DecodeUTF8::GetMarkedLength() const
+{
+    return m_AcceptedUnitIndex + 1;
+}
+
+MCTextFilter_DecodeUTF8::MCTextFilter_DecodeUTF8(const byte_t *p_text, uindex_t p_length, bool p_from_end)
+: m_Data(p_text), m_DataLength(p_length), m_ReadIndex(0), m_AcceptedUnitIndex(-1), m_UnitIndex(0), m_Reverse(p_from_end)
+{
+    ;
+}
+
+MCTextFilter_DecodeUTF8::~MCTextFilter_DecodeUTF8()
+{
+    ;
+}
+
 codepoint_t MCTextFilter_SimpleCaseFold::GetNextCodepoint()
 {
     // Get a codepoint from the preceding filter
@@ -475,6 +582,8 @@ MCTextFilter* MCTextFilterCreate(const void *p_data, uindex_t p_length, MCString
     // Choose the decoder based on the encoding
     if (p_encoding == kMCStringEncodingUTF16)
         t_chain = new (nothrow) MCTextFilter_DecodeUTF16(reinterpret_cast<const unichar_t*>(p_data), p_length, p_from_end);
+    else if (p_encoding == kMCStringEncodingUTF8)
+        t_chain = new (nothrow) MCTextFilter_DecodeUTF8(reinterpret_cast<const byte_t*>(p_data), p_length, p_from_end);
     else
         t_chain = new (nothrow) MCTextFilter_DecodeNative(reinterpret_cast<const char_t*>(p_data), p_length, p_from_end);
     
@@ -487,7 +596,7 @@ MCTextFilter* MCTextFilterCreate(const void *p_data, uindex_t p_length, MCString
         t_chain = t_filter;
     }
     
-    if (p_encoding == kMCStringEncodingUTF16 && (p_options == kMCStringOptionCompareCaseless || p_options == kMCStringOptionCompareNonliteral))
+    if ((p_encoding == kMCStringEncodingUTF16 || p_encoding == kMCStringEncodingUTF8) && (p_options == kMCStringOptionCompareCaseless || p_options == kMCStringOptionCompareNonliteral))
     {
         MCTextFilter *t_filter;
         t_filter = new (nothrow) MCTextFilter_NormalizeNFC(p_from_end);
@@ -18,8 +18,30 @@
 #include "foundation-private.h"
 #include "foundation-auto.h"
 
+#include <float.h>
+
 #define R8L 384
 
+/* The powers of ten which are exactly representable as doubles. */
+static const real64_t kMCTypeConvertPowersOfTen[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* The largest number of decimal places which fixed-point formatting will
+ * handle without falling back to snprintf(). */
+#define kMCTypeConvertFixedMaxPrecision 20
+
+static const uint64_t kMCTypeConvertPowersOfFive[] =
+{
+	1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL,
+	390625ULL, 1953125ULL, 9765625ULL, 48828125ULL, 244140625ULL,
+	1220703125ULL, 6103515625ULL, 30517578125ULL, 152587890625ULL,
+	762939453125ULL, 3814697265625ULL, 19073486328125ULL,
+	95367431640625ULL,
+};
+
 static MCSpan<const char>::const_iterator
 skip_spaces(MCSpan<const char>::const_iterator p_start,
             MCSpan<const char>::const_iterator p_end)
@@ -199,6 +221,21 @@ static real64_t MCU_strtor8(MCSpan<const char> p_chars,
 	char t_buff[R8L + 1];
 	if (p_chars.size() > R8L)
 		return 0;
+	/* Most numbers are plain decimals which can be converted exactly without
+	 * needing strtod(). */
+	{
+		size_t t_length = p_chars.size();
+		while (t_length > 0 && isspace(uint8_t(p_chars[t_length - 1])))
+			t_length -= 1;
+
+		real64_t t_value;
+		if (__MCTypeConvertParseShortDecimal(p_chars.data(), t_length, t_value))
+		{
+			r_done = true;
+			return t_value;
+		}
+	}
+
 	memcpy(t_buff, p_chars.data(), p_chars.size());
 	t_buff[p_chars.size()] = '\0';
 
@@ -215,6 +252,225 @@ static real64_t MCU_strtor8(MCSpan<const char> p_chars,
 	return t_value;
 }
 
+/* Exact conversion of short decimals.
+ *
+ * If the significant digits of a decimal form an integer no bigger than
+ * 2^53, and its exponent is at most 22 in magnitude, then both the integer
+ * and the power of ten are exact doubles.  A single multiplication or
+ * division then gives the correctly rounded result (Clinger's fast path).
+ * This covers nearly all the numbers scripts deal with, and doesn't depend
+ * on the locale; anything else is left to strtod().
+ *
+ * This relies on doubles being evaluated at double precision - with x87
+ * extended precision the result could be rounded twice. */
+bool __MCTypeConvertParseShortDecimal(const char *p_chars, uindex_t p_char_count, real64_t& r_value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+	const char *t_ptr = p_chars;
+	const char *t_end = p_chars + p_char_count;
+
+	bool t_negative = false;
+	if (t_ptr != t_end && (*t_ptr == '-' || *t_ptr == '+'))
+	{
+		t_negative = *t_ptr == '-';
+		++t_ptr;
+	}
+
+	/* Accumulate at most 19 significant digits, so the mantissa can't
+	 * overflow, tracking the decimal exponent they have been scaled by. */
+	uint64_t t_mantissa = 0;
+	int t_significant_digits = 0;
+	int t_exponent = 0;
+	bool t_has_digits = false;
+	bool t_in_fraction = false;
+	for(; t_ptr != t_end; ++t_ptr)
+	{
+		if (*t_ptr == '.' && !t_in_fraction)
+		{
+			t_in_fraction = true;
+			continue;
+		}
+
+		if (!isdigit(uint8_t(*t_ptr)))
+			break;
+
+		t_has_digits = true;
+		if (t_in_fraction)
+			t_exponent -= 1;
+
+		if (t_mantissa == 0 && *t_ptr == '0')
+			continue;
+
+		if (++t_significant_digits > 19)
+			return false;
+
+		t_mantissa = t_mantissa * 10 + uint64_t(*t_ptr - '0');
+	}
+
+	if (!t_has_digits)
+		return false;
+
+	if (t_ptr != t_end && (*t_ptr == 'e' || *t_ptr == 'E'))
+	{
+		++t_ptr;
+
+		bool t_negative_exponent = false;
+		if (t_ptr != t_end && (*t_ptr == '-' || *t_ptr == '+'))
+		{
+			t_negative_exponent = *t_ptr == '-';
+			++t_ptr;
+		}
+
+		if (t_ptr == t_end || !isdigit(uint8_t(*t_ptr)))
+			return false;
+
+		int t_explicit_exponent = 0;
+		for(; t_ptr != t_end && isdigit(uint8_t(*t_ptr)); ++t_ptr)
+		{
+			if (t_explicit_exponent > 1000)
+				return false;
+			t_explicit_exponent = t_explicit_exponent * 10 + (*t_ptr - '0');
+		}
+
+		t_exponent += t_negative_exponent ? -t_explicit_exponent : t_explicit_exponent;
+	}
+
+	if (t_ptr != t_end)
+		return false;
+
+	if (t_mantissa > (uint64_t(1) << 53) ||
+		t_exponent < -22 || t_exponent > 22)
+		return false;
+
+	real64_t t_value = real64_t(t_mantissa);
+	if (t_exponent < 0)
+		t_value /= kMCTypeConvertPowersOfTen[-t_exponent];
+	else
+		t_value *= kMCTypeConvertPowersOfTen[t_exponent];
+
+	r_value = t_negative ? -t_value : t_value;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* Exactly rounded fixed-point formatting.
+ *
+ * A finite double is m * 2^e for some 53-bit integer m.  Scaling it by 10^p,
+ * where p is the number of decimal places wanted, gives m * 5^p * 2^(e + p).
+ * For p <= 20, m * 5^p fits into 128 bits, so the scaled value can be
+ * rounded to an integer exactly with a shift, rounding halves to even as
+ * printf() does.  The digits of that integer are the digits of the result.
+ *
+ * This returns false if the value is too large, or the compiler has no
+ * 128-bit integers. */
+static bool __MCTypeConvertRealToFixedDigits(real64_t p_real, uindex_t p_precision, uint64_t& r_digits)
+{
+#if defined(__SIZEOF_INT128__)
+	typedef unsigned __int128 uint128_t;
+
+	if (p_precision > kMCTypeConvertFixedMaxPrecision)
+		return false;
+
+	/* Keep the scaled value well within 64 bits; this also rules out
+	 * infinities and NaNs. */
+	real64_t t_magnitude = fabs(p_real);
+	if (!(t_magnitude < 1e18 / kMCTypeConvertPowersOfTen[p_precision]))
+		return false;
+
+	uint64_t t_bits;
+	MCMemoryCopy(&t_bits, &t_magnitude, sizeof(t_bits));
+
+	int t_exponent = int(t_bits >> 52);
+	uint64_t t_mantissa = t_bits & ((uint64_t(1) << 52) - 1);
+	if (t_exponent == 0)
+		t_exponent = 1;
+	else
+		t_mantissa |= uint64_t(1) << 52;
+	t_exponent -= 1075;
+
+	uint128_t t_scaled = uint128_t(t_mantissa) * kMCTypeConvertPowersOfFive[p_precision];
+
+	int t_shift = t_exponent + int(p_precision);
+	if (t_shift >= 0)
+	{
+		r_digits = uint64_t(t_scaled << t_shift);
+		return true;
+	}
+
+	t_shift = -t_shift;
+	if (t_shift >= 128)
+	{
+		r_digits = 0;
+		return true;
+	}
+
+	uint128_t t_quotient = t_scaled >> t_shift;
+	uint128_t t_remainder = t_scaled - (t_quotient << t_shift);
+	uint128_t t_half = uint128_t(1) << (t_shift - 1);
+	if (t_remainder > t_half ||
+		(t_remainder == t_half && (t_quotient & 1) != 0))
+		t_quotient += 1;
+
+	r_digits = uint64_t(t_quotient);
+	return true;
+#else
+	return false;
+#endif
+}
+
+MC_DLLEXPORT_DEF
+bool MCTypeConvertRealToFixedChars(real64_t p_real, uindex_t p_width, uindex_t p_precision, char *r_chars, uindex_t p_max_chars, uindex_t& r_length)
+{
+	uint64_t t_digits;
+	if (!__MCTypeConvertRealToFixedDigits(p_real, p_precision, t_digits))
+	{
+		int t_length = snprintf(r_chars, p_max_chars, "%0*.*f", int(p_width), int(p_precision), p_real);
+		if (t_length < 0 || uindex_t(t_length) >= p_max_chars)
+			return false;
+
+		r_length = uindex_t(t_length);
+		return true;
+	}
+
+	/* Generate the digits backwards, making sure there is at least one
+	 * before the decimal point. */
+	char t_reversed[kMCTypeConvertFixedMaxPrecision + 4];
+	uindex_t t_digit_count = 0;
+	do
+	{
+		t_reversed[t_digit_count++] = char('0' + t_digits % 10);
+		t_digits /= 10;
+	}
+	while (t_digits != 0 || t_digit_count <= p_precision);
+
+	/* Like printf(), negative zero keeps its sign, and the zero padding goes
+	 * between the sign and the digits. */
+	bool t_negative = p_real < 0 || (p_real == 0 && 1 / p_real < 0);
+
+	uindex_t t_length = t_digit_count + (t_negative ? 1 : 0) + (p_precision != 0 ? 1 : 0);
+	uindex_t t_padding = p_width > t_length ? p_width - t_length : 0;
+	if (t_length + t_padding >= p_max_chars)
+		return false;
+
+	char *t_chars = r_chars;
+	if (t_negative)
+		*t_chars++ = '-';
+	for(uindex_t i = 0; i < t_padding; i++)
+		*t_chars++ = '0';
+	for(uindex_t i = t_digit_count; i > 0; i--)
+	{
+		if (i == p_precision)
+			*t_chars++ = '.';
+		*t_chars++ = t_reversed[i - 1];
+	}
+	*t_chars = '\0';
+
+	r_length = uindex_t(t_chars - r_chars);
+	return true;
+}
+
 MC_DLLEXPORT_DEF
 bool MCTypeConvertStringToLongInteger(MCStringRef p_string, integer_t& r_converted)
 {
@@ -698,7 +698,7 @@ bool MCRecordTypeInfoCreate(const MCRecordTypeFieldInfo *p_fields, index_t p_fie
     
     if (!MCMemoryNewArray(p_field_count, self -> record . fields))
     {
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
         return false;
     }
     
@@ -786,7 +786,7 @@ static bool MCCommonHandlerTypeInfoCreate(bool p_is_foreign, const MCHandlerType
 
     if (!MCMemoryNewArray(p_field_count, self -> handler . fields))
     {
-        MCMemoryDelete(self);
+        __MCValueDelete(self);
         return false;
     }
     
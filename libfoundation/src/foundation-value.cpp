@@ -21,6 +21,14 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #  include <valgrind/memcheck.h>
 #endif /* HAVE_VALGRIND */
 
+#if defined(__WINDOWS__)
+#  include <windows.h>
+#  include <malloc.h>
+#else
+#  include <pthread.h>
+#  include <stdlib.h>
+#endif
+
 #include "foundation-private.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,7 +139,10 @@ MCValueRef MCValueRetain(MCValueRef p_value)
     __MCAssertIsValue(self);
     
 	MCAssert(self -> references != UINT32_MAX);
-	self -> references += 1;
+	if (!__MCValueIsShared(self))
+		self -> references += 1;
+	else
+		__MCAtomicIncrement(self -> references);
 
 	return self;
 }
@@ -146,16 +157,33 @@ void MCValueRelease(MCValueRef p_value)
     
     __MCAssertIsValue(self);
         
-    uint32_t t_new_references;
-    t_new_references = self -> references - 1;
-    if (t_new_references == 0)
+    if (!__MCValueIsShared(self))
     {
-        __MCValueDestroy(self);
+        uint32_t t_new_references;
+        t_new_references = self -> references - 1;
+        if (t_new_references == 0)
+        {
+            __MCValueDestroy(self);
+            return;
+        }
+        
+        self -> references = t_new_references;
         return;
     }
     
-    self -> references = t_new_references;
-    return;
+    // Shared values might be released concurrently so the decrement must be
+    // atomic. Only the thread which takes the count to zero can destroy the
+    // value; it restores the count to 1 so that the value still looks valid
+    // while its destructor runs (as it does for unshared values). Names are
+    // the exception - other threads can find them in the name table until
+    // they have been removed from it, and only retain those whose count is
+    // not zero.
+    if (__MCAtomicDecrement(self -> references) == 0)
+    {
+        if (__MCValueGetTypeCode(self) != kMCValueTypeCodeName)
+            self -> references = 1;
+        __MCValueDestroy(self);
+    }
 }
 
 MC_DLLEXPORT_DEF
@@ -515,6 +543,136 @@ bool MCValueInterAndRelease(MCValueRef p_value, MCValueRef& r_unique_value)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Mark the given value, and all values it references, as shared. Only
+// immutable values of the core data types can be shared - if anything else
+// is encountered, false is returned. Any values which were marked before the
+// failure remain shared; this is harmless as it only means their reference
+// counts will be manipulated atomically.
+bool __MCValueMarkShared(__MCValue *self)
+{
+    // If the value is already shared then everything it references is too.
+    if (__MCValueIsShared(self))
+        return true;
+    
+    switch(__MCValueGetTypeCode(self))
+    {
+    case kMCValueTypeCodeNull:
+    case kMCValueTypeCodeBoolean:
+    case kMCValueTypeCodeNumber:
+    case kMCValueTypeCodeSet:
+        break;
+            
+    case kMCValueTypeCodeName:
+    {
+        // Names hold a reference to the representative of their caseless
+        // equivalence class, as well as their string.
+        __MCValue *t_key;
+        t_key = (__MCValue *)MCNameGetCaselessSearchKey((MCNameRef)self);
+        if (t_key != self &&
+            !__MCValueMarkShared(t_key))
+            return false;
+        if (!__MCValueMarkShared((__MCValue *)MCNameGetString((MCNameRef)self)))
+            return false;
+    }
+    break;
+            
+    case kMCValueTypeCodeString:
+        if (MCStringIsMutable((MCStringRef)self))
+            return false;
+        
+        // Make sure anything which would be done to the string lazily when
+        // it is read is done now, rather than on whichever thread happens to
+        // need it first.
+        if (!__MCStringPrepareToShare((MCStringRef)self))
+            return false;
+        break;
+            
+    case kMCValueTypeCodeData:
+        if (MCDataIsMutable((MCDataRef)self))
+            return false;
+        
+        // A slice holds a reference to the data whose bytes it uses.
+        if ((self -> flags & kMCDataFlagIsSlice) != 0 &&
+            !__MCValueMarkShared(((MCDataRef)self) -> parent))
+            return false;
+        break;
+            
+    case kMCValueTypeCodeArray:
+    {
+        if (MCArrayIsMutable((MCArrayRef)self))
+            return false;
+        
+        // Iterating a dense array uses the (unsynchronized) index name cache,
+        // and trie nodes have unsynchronized reference counts, so shared
+        // arrays always use the key-value table.
+        if (!__MCArrayMakeSparse((__MCArray *)self))
+            return false;
+        
+        uintptr_t t_iterator;
+        t_iterator = 0;
+        MCNameRef t_key;
+        MCValueRef t_value;
+        while(MCArrayIterate((MCArrayRef)self, t_iterator, t_key, t_value))
+            if (!__MCValueMarkShared((__MCValue *)t_key) ||
+                !__MCValueMarkShared((__MCValue *)t_value))
+                return false;
+    }
+    break;
+            
+    case kMCValueTypeCodeProperList:
+    {
+        if (MCProperListIsMutable((MCProperListRef)self))
+            return false;
+        
+        for(uindex_t i = 0; i < MCProperListGetLength((MCProperListRef)self); i++)
+            if (!__MCValueMarkShared((__MCValue *)MCProperListFetchElementAtIndex((MCProperListRef)self, i)))
+                return false;
+    }
+    break;
+            
+    default:
+        return false;
+    }
+    
+    self -> flags |= kMCValueFlagIsShared;
+    
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCValueShare(MCValueRef p_value, MCValueRef& r_shared_value)
+{
+	MCAssert(p_value != nil);
+    __MCAssertIsValue(p_value);
+    
+    MCValueRef t_value;
+    if (!MCValueCopy(p_value, t_value))
+        return false;
+    
+    if (!__MCValueMarkShared((__MCValue *)t_value))
+    {
+        MCValueRelease(t_value);
+        return false;
+    }
+    
+    r_shared_value = t_value;
+    
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCValueIsShared(MCValueRef p_value)
+{
+	__MCValue *self = (__MCValue *)p_value;
+    
+	MCAssert(self != nil);
+    __MCAssertIsValue(self);
+    
+    return __MCValueIsShared(self);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // This is the layout of a valueref which is on the free-list.
 struct __MCFreedValue: public __MCValue
 {
@@ -522,70 +680,537 @@ struct __MCFreedValue: public __MCValue
 };
 
 // MW-2014-03-21: [[ Faster ]] Memory allocation is relatively slow, therefore
-//   we use a per-typecode pool of previously used __MCValue's. This saves a
-//   a per-value malloc, particularly for types which are short-lived (such
-//   as numbers).
-struct MCValuePool
+//   we use pools of previously used __MCValue's. This saves a per-value malloc,
+//   particularly for types which are short-lived (such as numbers).
+//
+// Values are pooled by size class (multiples of 8 bytes) rather than by
+// typecode so that types of the same size share a pool. The values of a size
+// class are carved out of slabs - blocks of memory aligned to their own size,
+// so that the slab a value is in can be found from its address.
+//
+// Each thread has its own cache of slabs, found through the platform's
+// thread-specific storage (thread_local can't be used on all the compilers we
+// support), so creating and destroying values on the thread which created
+// them takes no locks. Only the owning thread touches the free values in its
+// slabs: a value destroyed on another thread (which happens to shared values)
+// is put on the owning cache's list of remote values instead, under the
+// cache's lock, and the owner collects them when it next runs out of values.
+//
+// A slab is freed when all its values are free and its size class has free
+// values elsewhere, and MCValuePoolTrim frees every slab which is entirely
+// free. When a thread exits its cache is trimmed - if any of its values are
+// still alive the cache is kept, and handed to the next thread which needs
+// one.
+//
+// Only the fixed-size value types are pooled - custom, handler and foreign
+// values have a variable size, so always come from (and go back to) the heap.
+enum
+{
+    kMCValuePoolSizeClassGranularity = 8,
+    kMCValuePoolSizeClassCount = 8,
+    kMCValuePoolSlabSize = 16384,
+    kMCValuePoolSizeClassNone = 0xff,
+};
+
+struct MCValuePoolCache;
+
+// This is the header at the start of each slab.
+struct MCValuePoolSlab
 {
+    // The cache of the thread which allocates from the slab.
+    MCValuePoolCache *cache;
+    // The slabs of a size class which have free values are kept in a list.
+    MCValuePoolSlab *next, *previous;
+    // The free values in the slab.
     __MCFreedValue *values;
+    uindex_t used, capacity;
+    uint8_t size_class;
+};
+
+// The values in a slab start after its header, suitably aligned.
+static const size_t kMCValuePoolSlabHeaderSize = (sizeof(MCValuePoolSlab) + 15) & ~size_t(15);
+
+struct MCValuePool
+{
+    // The slabs with free values, and the number of free values in them.
+    MCValuePoolSlab *slabs;
     uindex_t count;
 };
-static MCValuePool *s_value_pools;
 
-// Stores the number of pools that we have.
-uindex_t kMCValuePoolCount = kMCValueTypeCodeList + 1;
+struct MCValuePoolCache
+{
+    MCValuePool pools[kMCValuePoolSizeClassCount];
+    MCValuePoolStatistics statistics;
+
+    // Values in this cache's slabs which were destroyed on other threads.
+    // These (and the count) are guarded by the lock.
+    __MCFreedValue *remote_values;
+    uint32_t remote_count;
+    uint32_t lock;
+
+    // The next cache left by a thread which has exited.
+    MCValuePoolCache *next_abandoned;
+
+    void Lock(void);
+    void Unlock(void);
+    bool Allocate(uint8_t p_size_class, void*& r_value);
+    void Release(__MCFreedValue *p_value);
+    void ReleaseRemote(__MCFreedValue *p_value);
+    void CollectRemote(void);
+    void Trim(void);
+};
+
+// Caches left by threads which have exited while their values were still
+// alive, guarded by the abandoned lock.
+static MCValuePoolCache *s_value_pool_abandoned = nil;
+static uint32_t s_value_pool_abandoned_lock = 0;
 
-bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_value)
+static void __MCValuePoolThreadExited(MCValuePoolCache *p_cache);
+
+#if defined(__WINDOWS__)
+static DWORD s_value_pool_key = FLS_OUT_OF_INDEXES;
+
+static void WINAPI __MCValuePoolFlsCallback(void *p_cache)
 {
-	void *t_value;
-	
-    // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, and the
-    //   pool isn't empty grab the ptr from there.
-    if (p_type_code <= kMCValueTypeCodeList && s_value_pools[p_type_code] . count > 0)
+    if (p_cache != nil)
+        __MCValuePoolThreadExited((MCValuePoolCache *)p_cache);
+}
+
+static bool __MCValuePoolInitializeKey(void)
+{
+    if (s_value_pool_key == FLS_OUT_OF_INDEXES)
+        s_value_pool_key = FlsAlloc(__MCValuePoolFlsCallback);
+    return s_value_pool_key != FLS_OUT_OF_INDEXES;
+}
+
+static inline MCValuePoolCache *__MCValuePoolGetThreadCache(void)
+{
+    return (MCValuePoolCache *)FlsGetValue(s_value_pool_key);
+}
+
+static inline bool __MCValuePoolSetThreadCache(MCValuePoolCache *p_cache)
+{
+    return FlsSetValue(s_value_pool_key, p_cache) != FALSE;
+}
+
+static void *__MCValuePoolAllocateSlab(void)
+{
+    return _aligned_malloc(kMCValuePoolSlabSize, kMCValuePoolSlabSize);
+}
+
+static void __MCValuePoolDeallocateSlab(void *p_slab)
+{
+    _aligned_free(p_slab);
+}
+#else
+static pthread_key_t s_value_pool_key;
+static bool s_value_pool_key_created = false;
+
+static void __MCValuePoolKeyDestructor(void *p_cache)
+{
+    __MCValuePoolThreadExited((MCValuePoolCache *)p_cache);
+}
+
+static bool __MCValuePoolInitializeKey(void)
+{
+    if (!s_value_pool_key_created)
+        s_value_pool_key_created = pthread_key_create(&s_value_pool_key, __MCValuePoolKeyDestructor) == 0;
+    return s_value_pool_key_created;
+}
+
+static inline MCValuePoolCache *__MCValuePoolGetThreadCache(void)
+{
+    return (MCValuePoolCache *)pthread_getspecific(s_value_pool_key);
+}
+
+static inline bool __MCValuePoolSetThreadCache(MCValuePoolCache *p_cache)
+{
+    return pthread_setspecific(s_value_pool_key, p_cache) == 0;
+}
+
+static void *__MCValuePoolAllocateSlab(void)
+{
+    void *t_slab;
+    if (posix_memalign(&t_slab, kMCValuePoolSlabSize, kMCValuePoolSlabSize) != 0)
+        return nil;
+    return t_slab;
+}
+
+static void __MCValuePoolDeallocateSlab(void *p_slab)
+{
+    free(p_slab);
+}
+#endif
+
+// Evaluates to the size class used to pool values of the given size. This is
+// a macro so that the table below is a constant.
+#define __MCValuePoolSizeClassForSize(p_size) \
+    ((p_size) < sizeof(__MCFreedValue) ? \
+        uint8_t((sizeof(__MCFreedValue) + kMCValuePoolSizeClassGranularity - 1) / kMCValuePoolSizeClassGranularity - 1) : \
+     (p_size) > kMCValuePoolSizeClassCount * kMCValuePoolSizeClassGranularity ? \
+        uint8_t(kMCValuePoolSizeClassNone) : \
+        uint8_t(((p_size) + kMCValuePoolSizeClassGranularity - 1) / kMCValuePoolSizeClassGranularity - 1))
+
+// Maps each typecode to the size class its values are pooled in.
+static const uint8_t kMCValuePoolSizeClasses[] =
+{
+    __MCValuePoolSizeClassForSize(sizeof(__MCNull)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCBoolean)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCNumber)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCName)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCString)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCData)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCArray)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCList)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCSet)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCProperList)),
+    kMCValuePoolSizeClassNone, /* Custom */
+    __MCValuePoolSizeClassForSize(sizeof(__MCRecord)),
+    kMCValuePoolSizeClassNone, /* Handler */
+    __MCValuePoolSizeClassForSize(sizeof(__MCTypeInfo)),
+    __MCValuePoolSizeClassForSize(sizeof(__MCError)),
+    kMCValuePoolSizeClassNone, /* ForeignValue */
+};
+
+static inline MCValuePoolSlab *__MCValuePoolGetSlab(void *p_value)
+{
+    return (MCValuePoolSlab *)(uintptr_t(p_value) & ~uintptr_t(kMCValuePoolSlabSize - 1));
+}
+
+static inline size_t __MCValuePoolGetValueSize(uint8_t p_size_class)
+{
+    return (p_size_class + 1) * kMCValuePoolSizeClassGranularity;
+}
+
+static void __MCValuePoolLinkSlab(MCValuePool& x_pool, MCValuePoolSlab *p_slab)
+{
+    p_slab -> previous = nil;
+    p_slab -> next = x_pool . slabs;
+    if (x_pool . slabs != nil)
+        x_pool . slabs -> previous = p_slab;
+    x_pool . slabs = p_slab;
+}
+
+static void __MCValuePoolUnlinkSlab(MCValuePool& x_pool, MCValuePoolSlab *p_slab)
+{
+    if (p_slab -> previous != nil)
+        p_slab -> previous -> next = p_slab -> next;
+    else
+        x_pool . slabs = p_slab -> next;
+    if (p_slab -> next != nil)
+        p_slab -> next -> previous = p_slab -> previous;
+}
+
+void MCValuePoolCache::Lock(void)
+{
+    // The lock is only ever held for a few instructions, so just spin.
+    while(!__MCAtomicCompareAndSwap(lock, 0, 1))
+        continue;
+}
+
+void MCValuePoolCache::Unlock(void)
+{
+    __MCAtomicCompareAndSwap(lock, 1, 0);
+}
+
+bool MCValuePoolCache::Allocate(uint8_t p_size_class, void*& r_value)
+{
+    MCValuePool& t_pool = pools[p_size_class];
+
+    // If the pool is empty, values destroyed on other threads might refill it.
+    if (t_pool . slabs == nil)
+        CollectRemote();
+
+    MCValuePoolSlab *t_slab;
+    t_slab = t_pool . slabs;
+    if (t_slab != nil)
+        statistics . hits += 1;
+    else
     {
-        t_value = s_value_pools[p_type_code] . values;
+        t_slab = (MCValuePoolSlab *)__MCValuePoolAllocateSlab();
+        if (t_slab == nil)
+            return MCErrorThrowOutOfMemory();
+
+        size_t t_value_size;
+        t_value_size = __MCValuePoolGetValueSize(p_size_class);
+
+        t_slab -> cache = this;
+        t_slab -> values = nil;
+        t_slab -> used = 0;
+        t_slab -> capacity = uindex_t((kMCValuePoolSlabSize - kMCValuePoolSlabHeaderSize) / t_value_size);
+        t_slab -> size_class = p_size_class;
+
+        // Chain the values so that they are handed out in address order.
+        for(uindex_t i = t_slab -> capacity; i > 0; i--)
+        {
+            __MCFreedValue *t_value;
+            t_value = (__MCFreedValue *)((byte_t *)t_slab + kMCValuePoolSlabHeaderSize + (i - 1) * t_value_size);
+            t_value -> references = 0;
+            t_value -> flags = UINT32_MAX;
+            t_value -> next = t_slab -> values;
+            t_slab -> values = t_value;
 
 #ifdef HAVE_VALGRIND
-		/* Valgrind support */
-		/* Verify that the next buffer in the free list has actually
-		 * been previously allocated to us and we're allowed to use
-		 * it.  The first few bytes of the buffer should contain the
-		 * address of the following buffer (if there is one). */
-		VALGRIND_MAKE_MEM_UNDEFINED(t_value, p_size);
-		VALGRIND_MAKE_MEM_DEFINED(t_value, sizeof (__MCFreedValue));
+            /* Valgrind support */
+            /* Mark the pooled buffer as inaccessible. If anything tries
+             * to access it, Valgrind will log an error message. */
+            VALGRIND_MAKE_MEM_NOACCESS(t_value, t_value_size);
 #endif /* HAVE_VALGRIND */
+        }
+
+        __MCValuePoolLinkSlab(t_pool, t_slab);
+        t_pool . count += t_slab -> capacity;
+
+        statistics . misses += 1;
+        statistics . slabs += 1;
+    }
+
+    __MCFreedValue *t_value;
+    t_value = t_slab -> values;
+
+#ifdef HAVE_VALGRIND
+    /* Valgrind support */
+    /* Verify that the next buffer in the free list has actually
+     * been previously allocated to us and we're allowed to use
+     * it.  The first few bytes of the buffer should contain the
+     * address of the following buffer (if there is one). */
+    VALGRIND_MAKE_MEM_UNDEFINED(t_value, __MCValuePoolGetValueSize(p_size_class));
+    VALGRIND_MAKE_MEM_DEFINED(t_value, sizeof (__MCFreedValue));
+#endif /* HAVE_VALGRIND */
+
+    // Check that the value we are about to return has not been corrupted
+    // due to a dangling reference.
+    MCAssert(t_value -> references == 0 &&
+             t_value -> flags == UINT32_MAX);
+
+    t_slab -> values = t_value -> next;
+    t_slab -> used += 1;
+    t_pool . count -= 1;
+
+    // Full slabs don't stay in the pool.
+    if (t_slab -> values == nil)
+        __MCValuePoolUnlinkSlab(t_pool, t_slab);
+
+    r_value = t_value;
+
+    return true;
+}
+
+void MCValuePoolCache::Release(__MCFreedValue *p_value)
+{
+    MCValuePoolSlab *t_slab;
+    t_slab = __MCValuePoolGetSlab(p_value);
+
+    MCValuePool& t_pool = pools[t_slab -> size_class];
+
+    // A full slab goes back into the pool when one of its values is freed.
+    if (t_slab -> values == nil)
+        __MCValuePoolLinkSlab(t_pool, t_slab);
+
+    p_value -> next = t_slab -> values;
+    t_slab -> values = p_value;
+    t_slab -> used -= 1;
+    t_pool . count += 1;
+
+#ifdef HAVE_VALGRIND
+    /* Valgrind support */
+    /* Mark the pooled buffer as inaccessible. If anything tries
+     * to access it, Valgrind will log an error message. */
+    VALGRIND_MAKE_MEM_NOACCESS(p_value, __MCValuePoolGetValueSize(t_slab -> size_class));
+#endif /* HAVE_VALGRIND */
+
+    // Free the slab once it is empty, as long as the pool has other values
+    // to hand out - otherwise a value being repeatedly created and destroyed
+    // would allocate and free a slab every time.
+    if (t_slab -> used == 0 &&
+        t_pool . count > t_slab -> capacity)
+    {
+        __MCValuePoolUnlinkSlab(t_pool, t_slab);
+        t_pool . count -= t_slab -> capacity;
+        statistics . slabs -= 1;
+        __MCValuePoolDeallocateSlab(t_slab);
+    }
+}
+
+void MCValuePoolCache::ReleaseRemote(__MCFreedValue *p_value)
+{
+    Lock();
+    p_value -> next = remote_values;
+    remote_values = p_value;
+    __MCAtomicIncrement(remote_count);
+    Unlock();
+}
+
+void MCValuePoolCache::CollectRemote(void)
+{
+    // Checking the count first means the lock is only taken when there is
+    // something to collect.
+    uint32_t t_count;
+    t_count = __MCAtomicLoad(remote_count);
+    if (t_count == 0)
+        return;
+
+    Lock();
+    __MCFreedValue *t_values;
+    t_values = remote_values;
+    remote_values = nil;
+    __MCAtomicCompareAndSwap(remote_count, __MCAtomicLoad(remote_count), 0);
+    Unlock();
+
+    while(t_values != nil)
+    {
+        __MCFreedValue *t_value;
+        t_value = t_values;
+        t_values = t_value -> next;
+        Release(t_value);
+    }
+}
+
+void MCValuePoolCache::Trim(void)
+{
+    CollectRemote();
+
+    for(uindex_t i = 0; i < kMCValuePoolSizeClassCount; i++)
+    {
+        MCValuePoolSlab *t_slab;
+        t_slab = pools[i] . slabs;
+        while(t_slab != nil)
+        {
+            MCValuePoolSlab *t_next;
+            t_next = t_slab -> next;
+            if (t_slab -> used == 0)
+            {
+                __MCValuePoolUnlinkSlab(pools[i], t_slab);
+                pools[i] . count -= t_slab -> capacity;
+                statistics . slabs -= 1;
+                __MCValuePoolDeallocateSlab(t_slab);
+            }
+            t_slab = t_next;
+        }
+    }
+
+    statistics . trims += 1;
+}
+
+// Fetch the calling thread's cache, creating it (or adopting one left by an
+// exited thread) if it has none.
+static MCValuePoolCache *__MCValuePoolFetchThreadCache(void)
+{
+    MCValuePoolCache *t_cache;
+    t_cache = __MCValuePoolGetThreadCache();
+    if (t_cache != nil)
+        return t_cache;
+
+    while(!__MCAtomicCompareAndSwap(s_value_pool_abandoned_lock, 0, 1))
+        continue;
+    t_cache = s_value_pool_abandoned;
+    if (t_cache != nil)
+        s_value_pool_abandoned = t_cache -> next_abandoned;
+    __MCAtomicCompareAndSwap(s_value_pool_abandoned_lock, 1, 0);
+
+    if (t_cache != nil)
+        t_cache -> next_abandoned = nil;
+    else if (!MCMemoryNew(t_cache))
+        return nil;
+
+    if (!__MCValuePoolSetThreadCache(t_cache))
+    {
+        __MCValuePoolThreadExited(t_cache);
+        MCErrorThrowOutOfMemory();
+        return nil;
+    }
+
+    return t_cache;
+}
+
+static void __MCValuePoolThreadExited(MCValuePoolCache *p_cache)
+{
+    p_cache -> Trim();
+
+    // If there are no slabs left, nothing can refer to the cache any more.
+    if (p_cache -> statistics . slabs == 0)
+    {
+        MCMemoryDelete(p_cache);
+        return;
+    }
+
+    while(!__MCAtomicCompareAndSwap(s_value_pool_abandoned_lock, 0, 1))
+        continue;
+    p_cache -> next_abandoned = s_value_pool_abandoned;
+    s_value_pool_abandoned = p_cache;
+    __MCAtomicCompareAndSwap(s_value_pool_abandoned_lock, 1, 0);
+}
+
+bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_value)
+{
+	void *t_value;
+
+    uint8_t t_size_class;
+    t_size_class = kMCValuePoolSizeClasses[p_type_code];
+
+    // All values of a pooled typecode must fit in its size class.
+    MCAssert(t_size_class == kMCValuePoolSizeClassNone ||
+             p_size <= __MCValuePoolGetValueSize(t_size_class));
+
+    // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, take the
+    //   value from the calling thread's pool.
+    if (t_size_class != kMCValuePoolSizeClassNone)
+    {
+        MCValuePoolCache *t_cache;
+        t_cache = __MCValuePoolFetchThreadCache();
+        if (t_cache == nil ||
+            !t_cache -> Allocate(t_size_class, t_value))
+            return false;
 
-        // Check that the value we are about to return has not been corrupted
-        // due to a dangling reference.
-        MCAssert(((__MCFreedValue *)t_value) -> references == 0 &&
-                 ((__MCFreedValue *)t_value) -> flags == UINT32_MAX);
-        
-        s_value_pools[p_type_code] . count -= 1;
-        s_value_pools[p_type_code] . values = ((__MCFreedValue *)t_value) -> next;
         MCMemoryClear(t_value, p_size);
 	}
     else
     {
-        // The minimum size of a valueref has to be sizeof(MCValuePoolLink).
-        // This is to ensure we have enough space to chain in the free list.
-        
+        // The minimum size of a valueref has to be sizeof(__MCFreedValue) as
+        // that is what pooled values need.
         if (p_size < sizeof(__MCFreedValue))
             p_size = sizeof(__MCFreedValue);
-        
+
         if (!MCMemoryNew(p_size, t_value))
             return false;
     }
-    
+
 	__MCValue *self = (__MCValue *)t_value;
 
 	self -> references = 1;
 	self -> flags = (p_type_code << 28);
-    
+
 	r_value = self;
 
 	return true;
 }
 
+// Return the memory of a value with the given typecode to where it came from.
+static void __MCValueFree(__MCValue *self, MCValueTypeCode p_type_code)
+{
+    // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, return it
+    //   to the pool of the thread which created it.
+    uint8_t t_size_class;
+    t_size_class = kMCValuePoolSizeClasses[p_type_code];
+    if (t_size_class != kMCValuePoolSizeClassNone)
+    {
+        // The pool's checks need these whether or not this is a debug build.
+        self -> references = 0;
+        self -> flags = UINT32_MAX;
+
+        MCValuePoolCache *t_cache;
+        t_cache = __MCValuePoolGetSlab(self) -> cache;
+        if (t_cache == __MCValuePoolGetThreadCache())
+            t_cache -> Release((__MCFreedValue *)self);
+        else
+            t_cache -> ReleaseRemote((__MCFreedValue *)self);
+
+		return;
+    }
+
+	MCMemoryDelete(self);
+}
+
 void __MCValueDestroy(__MCValue *self)
 {
     MCValueTypeCode t_code;
@@ -665,40 +1290,44 @@ void __MCValueDestroy(__MCValue *self)
 	self -> flags = UINT32_MAX;
 #endif
 
-    // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, and the
-    //   pool isn't full, add it to the pool.
-    if (t_code <= kMCValueTypeCodeList && s_value_pools[t_code] . count < 32)
-    {
-        s_value_pools[t_code] . count += 1;
-        ((__MCFreedValue *)self) -> next = s_value_pools[t_code] . values;
-        s_value_pools[t_code] . values = (__MCFreedValue *)self;
+    __MCValueFree(self, t_code);
+}
 
-#ifdef HAVE_VALGRIND
-		/* Valgrind support */
-		/* Mark the pooled buffer as inaccessible. If anything tries
-		 * to access it, Valgrind will log an error message. */
-		size_t t_size;
-		switch (t_code)
-		{
-		case kMCValueTypeCodeNull:    t_size = sizeof(__MCNull);    break;
-		case kMCValueTypeCodeBoolean: t_size = sizeof(__MCBoolean); break;
-		case kMCValueTypeCodeNumber:  t_size = sizeof(__MCNumber);  break;
-		case kMCValueTypeCodeName:    t_size = sizeof(__MCName);    break;
-		case kMCValueTypeCodeString:  t_size = sizeof(__MCString);  break;
-		case kMCValueTypeCodeData:    t_size = sizeof(__MCData);    break;
-		case kMCValueTypeCodeArray:   t_size = sizeof(__MCArray);   break;
-		case kMCValueTypeCodeList:    t_size = sizeof(__MCList);    break;
-		default:                      MCUnreachable();
-		}
-		VALGRIND_MAKE_MEM_NOACCESS(self, t_size);
-#endif /* HAVE_VALGRIND */
+void __MCValueDelete(__MCValue *self)
+{
+    if (self != nil)
+        __MCValueFree(self, __MCValueGetTypeCode(self));
+}
 
-		return;
-    }
-	
-	MCMemoryDelete(self);
+MC_DLLEXPORT_DEF
+void MCValuePoolTrim(void)
+{
+    MCValuePoolCache *t_cache;
+    t_cache = __MCValuePoolGetThreadCache();
+    if (t_cache != nil)
+        t_cache -> Trim();
 }
 
+MC_DLLEXPORT_DEF
+void MCValuePoolGetStatistics(MCValuePoolStatistics& r_statistics)
+{
+    MCValuePoolCache *t_cache;
+    t_cache = __MCValuePoolGetThreadCache();
+    if (t_cache == nil)
+    {
+        MCMemoryClear(&r_statistics, sizeof(r_statistics));
+        return;
+    }
+
+    r_statistics = t_cache -> statistics;
+    r_statistics . pooled = 0;
+    r_statistics . pooled_bytes = 0;
+    for(uindex_t i = 0; i < kMCValuePoolSizeClassCount; i++)
+    {
+        r_statistics . pooled += t_cache -> pools[i] . count;
+        r_statistics . pooled_bytes += t_cache -> pools[i] . count * __MCValuePoolGetValueSize(uint8_t(i));
+    }
+}
 ////////////////////////////////////////////////////////////////////////////////
 
 struct __MCUniqueValueBucket
@@ -1155,9 +1784,11 @@ MC_DLLEXPORT_DEF MCBooleanRef kMCFalse;
 
 bool __MCValueInitialize(void)
 {
-    if (!MCMemoryNewArray(kMCValuePoolCount, s_value_pools))
+    // The value pools need the key for the per-thread caches before any
+    // values can be created.
+    if (!__MCValuePoolInitializeKey())
         return false;
-    
+
 	if (!__MCValueCreate(kMCValueTypeCodeNull, kMCNull))
 		return false;
 
@@ -1191,27 +1822,9 @@ void __MCValueFinalize(void)
     s_unique_value_count = 0;
     s_unique_value_capacity_idx = 0;
     
-    // Make sure to delete the value pools last, as they need to be around until
+    // Make sure to trim the value pools last, as they need to be around until
     // all other valuerefs have been deleted.
-    for(uindex_t i = 0; i < kMCValuePoolCount; i++)
-        while(s_value_pools[i] . count > 0)
-        {
-            __MCFreedValue *t_value;
-            t_value = s_value_pools[i] . values;
-            
-#ifdef HAVE_VALGRIND
-			/* Valgrind support */
-			/* The first few bytes of the buffer actually contain the
-			 * address of the following buffer. */
-			VALGRIND_MAKE_MEM_DEFINED(t_value, sizeof (__MCFreedValue));
-#endif /* HAVE_VALGRIND */
-            
-			s_value_pools[i] . values = t_value -> next;
-			s_value_pools[i] . count -= 1;
-            MCMemoryDelete(t_value);
-        }
-	MCMemoryDeleteArray(s_value_pools);
-    s_value_pools = nil;
+    MCValuePoolTrim();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
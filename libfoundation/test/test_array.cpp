@@ -0,0 +1,643 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+static void make_key(uindex_t p_index, MCNameRef& r_key)
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringFormat(&t_string, "key%u", p_index));
+    ASSERT_TRUE(MCNameCreate(*t_string, r_key));
+}
+
+static bool fetch_key(MCArrayRef p_array, bool p_case_sensitive, const char *p_key, MCValueRef& r_value)
+{
+    MCNewAutoNameRef t_key;
+    if (!MCNameCreateWithNativeChars((const char_t *)p_key, strlen(p_key), &t_key))
+        return false;
+    return MCArrayFetchValue(p_array, p_case_sensitive, *t_key, r_value);
+}
+
+TEST(array, store_fetch_remove)
+{
+    const uindex_t kCount = 5000;
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        MCAutoNumberRef t_value;
+        ASSERT_TRUE(MCNumberCreateWithUnsignedInteger(i, &t_value));
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, *t_value));
+    }
+    EXPECT_EQ(MCArrayGetCount(*t_array), kCount);
+
+    // Remove every other key, which leaves deleted slots behind.
+    for(uindex_t i = 0; i < kCount; i += 2)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, *t_key));
+    }
+    EXPECT_EQ(MCArrayGetCount(*t_array), kCount / 2);
+
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        MCValueRef t_value;
+        if (i % 2 == 0)
+            EXPECT_FALSE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+        else
+        {
+            ASSERT_TRUE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+            EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)t_value), i);
+        }
+    }
+
+    // Iteration must visit each remaining key exactly once.
+    uindex_t t_visited = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+        t_visited += 1;
+    EXPECT_EQ(t_visited, kCount / 2);
+}
+
+TEST(array, churn)
+{
+    // Repeatedly removing and adding keys must not grow the table without
+    // bound, nor lose any keys.
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    for(uindex_t i = 0; i < 20000; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+
+        if (i >= 100)
+        {
+            MCNewAutoNameRef t_old_key;
+            make_key(i - 100, &t_old_key);
+            ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, *t_old_key));
+        }
+    }
+
+    EXPECT_EQ(MCArrayGetCount(*t_array), 100u);
+
+    MCValueRef t_value;
+    EXPECT_TRUE(fetch_key(*t_array, false, "key19999", t_value));
+    EXPECT_TRUE(fetch_key(*t_array, false, "key19900", t_value));
+    EXPECT_FALSE(fetch_key(*t_array, false, "key19899", t_value));
+}
+
+TEST(array, case_sensitivity)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    MCNewAutoNameRef t_key;
+    ASSERT_TRUE(MCNameCreate(MCSTR("Key"), &t_key));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, true, *t_key, kMCTrue));
+
+    MCValueRef t_value;
+    EXPECT_TRUE(fetch_key(*t_array, false, "KEY", t_value));
+    EXPECT_FALSE(fetch_key(*t_array, true, "KEY", t_value));
+    EXPECT_TRUE(fetch_key(*t_array, true, "Key", t_value));
+}
+
+TEST(array, copy_on_write)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    for(uindex_t i = 0; i < 100; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+    }
+
+    // Mutating a copy must leave the original untouched.
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_array, &t_copy));
+
+    MCNewAutoNameRef t_key;
+    make_key(0, &t_key);
+    ASSERT_TRUE(MCArrayRemoveValue(*t_copy, false, *t_key));
+    ASSERT_TRUE(MCArrayStoreValue(*t_copy, false, kMCEmptyName, kMCFalse));
+
+    EXPECT_EQ(MCArrayGetCount(*t_array), 100u);
+    EXPECT_EQ(MCArrayGetCount(*t_copy), 100u);
+
+    MCValueRef t_value;
+    EXPECT_TRUE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+    EXPECT_FALSE(MCArrayFetchValue(*t_copy, false, *t_key, t_value));
+    EXPECT_FALSE(MCValueIsEqualTo(*t_array, *t_copy));
+}
+
+TEST(array, dense_indices)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    for(index_t i = 1; i <= 1000; i++)
+    {
+        MCAutoNumberRef t_value;
+        ASSERT_TRUE(MCNumberCreateWithInteger(i, &t_value));
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, i, *t_value));
+    }
+    EXPECT_EQ(MCArrayGetCount(*t_array), 1000u);
+
+    // Index and name lookups must agree.
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 500, t_value));
+    EXPECT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 500);
+    ASSERT_TRUE(fetch_key(*t_array, false, "500", t_value));
+    EXPECT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 500);
+    EXPECT_FALSE(fetch_key(*t_array, false, "0500", t_value));
+    EXPECT_FALSE(fetch_key(*t_array, false, "1001", t_value));
+    EXPECT_FALSE(MCArrayFetchValueAtIndex(*t_array, 0, t_value));
+
+    // Iteration must produce each index once.
+    uindex_t t_key_sum = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+    {
+        MCNewAutoNameRef t_expected_key;
+        ASSERT_TRUE(MCNameCreateWithIndex(MCNumberFetchAsInteger((MCNumberRef)t_value), &t_expected_key));
+        EXPECT_EQ(t_key, *t_expected_key);
+        t_key_sum += MCNumberFetchAsInteger((MCNumberRef)t_value);
+    }
+    EXPECT_EQ(t_key_sum, 1000u * 1001u / 2);
+
+    // Removing the last index, then a middle one.
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 1000));
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 10));
+    EXPECT_EQ(MCArrayGetCount(*t_array), 998u);
+    EXPECT_FALSE(MCArrayFetchValueAtIndex(*t_array, 10, t_value));
+    EXPECT_FALSE(MCArrayFetchValueAtIndex(*t_array, 1000, t_value));
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 999, t_value));
+    EXPECT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 999);
+}
+
+TEST(array, dense_remove_at_index)
+{
+    // Nothing here touches the keys by name, so none of them are interned
+    // when the middle index is removed.
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(index_t i = 1; i <= 1000; i++)
+    {
+        MCAutoNumberRef t_value;
+        ASSERT_TRUE(MCNumberCreateWithInteger(i, &t_value));
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, i, *t_value));
+    }
+
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 777));
+    EXPECT_EQ(MCArrayGetCount(*t_array), 999u);
+
+    MCValueRef t_value;
+    EXPECT_FALSE(MCArrayFetchValueAtIndex(*t_array, 777, t_value));
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 778, t_value));
+    EXPECT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 778);
+
+    // Out of range indexes are ignored.
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 0));
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 1001));
+    EXPECT_EQ(MCArrayGetCount(*t_array), 999u);
+}
+
+TEST(array, dense_to_table)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(index_t i = 1; i <= 3; i++)
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, i, kMCTrue));
+
+    // Copies taken while dense must be unaffected by later changes.
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayCopy(*t_array, &t_copy));
+
+    // A non-index key and a gap both revert to a key-value table.
+    MCNewAutoNameRef t_key;
+    ASSERT_TRUE(MCNameCreate(MCSTR("name"), &t_key));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCFalse));
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, 10, kMCFalse));
+    EXPECT_EQ(MCArrayGetCount(*t_array), 5u);
+
+    MCValueRef t_value;
+    for(index_t i = 1; i <= 3; i++)
+    {
+        ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, i, t_value));
+        EXPECT_EQ(t_value, kMCTrue);
+    }
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 10, t_value));
+    EXPECT_EQ(t_value, kMCFalse);
+
+    EXPECT_EQ(MCArrayGetCount(*t_copy), 3u);
+    EXPECT_FALSE(MCArrayFetchValue(*t_copy, false, *t_key, t_value));
+}
+
+static bool apply_check_index(void *p_context, MCArrayRef p_array, MCNameRef p_key, MCValueRef p_value)
+{
+    uindex_t& x_count = *static_cast<uindex_t *>(p_context);
+    x_count += 1;
+
+    MCNewAutoNameRef t_expected_key;
+    if (!MCNameCreateWithIndex(x_count, &t_expected_key))
+        return false;
+    return MCNameIsEqualToCaseless(p_key, *t_expected_key);
+}
+
+TEST(array, dense_apply_past_index_name_cache)
+{
+    // Large enough to run past the end of the index name cache.
+    const uindex_t kCount = 70000;
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(uindex_t i = 1; i <= kCount; i++)
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, i, kMCTrue));
+
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayCopy(*t_array, &t_copy));
+
+    uindex_t t_count = 0;
+    ASSERT_TRUE(MCArrayApply(*t_copy, apply_check_index, &t_count));
+    EXPECT_EQ(t_count, kCount);
+
+    // Iteration still visits every key.
+    t_count = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    while(MCArrayIterate(*t_copy, t_iterator, t_key, t_value))
+        t_count += 1;
+    EXPECT_EQ(t_count, kCount);
+}
+
+TEST(array, dense_equality_and_paths)
+{
+    // Build the same array densely and (out of order) as a table.
+    MCAutoArrayRef t_dense, t_table;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_dense));
+    ASSERT_TRUE(MCArrayCreateMutable(&t_table));
+    for(index_t i = 1; i <= 20; i++)
+    {
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_dense, i, kMCTrue));
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_table, 21 - i, kMCTrue));
+    }
+    EXPECT_TRUE(MCValueIsEqualTo(*t_dense, *t_table));
+    EXPECT_TRUE(MCValueIsEqualTo(*t_table, *t_dense));
+
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_table, 20, kMCFalse));
+    EXPECT_FALSE(MCValueIsEqualTo(*t_dense, *t_table));
+
+    // Storing on a path through a dense array.
+    MCNewAutoNameRef t_index, t_key;
+    ASSERT_TRUE(MCNameCreateWithIndex(21, &t_index));
+    ASSERT_TRUE(MCNameCreate(MCSTR("inner"), &t_key));
+    MCNameRef t_path[2] = { *t_index, *t_key };
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_dense, false, t_path, 2, kMCFalse));
+    EXPECT_EQ(MCArrayGetCount(*t_dense), 21u);
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_dense, false, t_path, 2, t_value));
+    EXPECT_EQ(t_value, kMCFalse);
+}
+
+TEST(array, trie_copy_on_write)
+{
+    const uindex_t kCount = 2000;
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        MCAutoNumberRef t_value;
+        ASSERT_TRUE(MCNumberCreateWithUnsignedInteger(i, &t_value));
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, *t_value));
+    }
+
+    // Copying and then changing a large array switches it to a trie, which
+    // is shared by any further copies.
+    MCAutoArrayRef t_copy, t_second_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_array, &t_copy));
+    MCNewAutoNameRef t_first_key;
+    make_key(0, &t_first_key);
+    ASSERT_TRUE(MCArrayRemoveValue(*t_copy, false, *t_first_key));
+    ASSERT_TRUE(MCArrayMutableCopy(*t_copy, &t_second_copy));
+    EXPECT_TRUE(MCValueIsEqualTo(*t_copy, *t_second_copy));
+
+    MCNewAutoNameRef t_new_key;
+    make_key(kCount, &t_new_key);
+    ASSERT_TRUE(MCArrayStoreValue(*t_second_copy, false, *t_new_key, kMCTrue));
+    for(uindex_t i = 1; i < kCount; i += 2)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_second_copy, false, *t_key, kMCFalse));
+    }
+
+    EXPECT_EQ(MCArrayGetCount(*t_array), kCount);
+    EXPECT_EQ(MCArrayGetCount(*t_copy), kCount - 1);
+    EXPECT_EQ(MCArrayGetCount(*t_second_copy), kCount);
+    EXPECT_FALSE(MCValueIsEqualTo(*t_copy, *t_second_copy));
+
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+
+        MCValueRef t_value;
+        ASSERT_TRUE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+        EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)t_value), i);
+
+        if (i == 0)
+        {
+            EXPECT_FALSE(MCArrayFetchValue(*t_copy, false, *t_key, t_value));
+            EXPECT_FALSE(MCArrayFetchValue(*t_second_copy, false, *t_key, t_value));
+            continue;
+        }
+
+        ASSERT_TRUE(MCArrayFetchValue(*t_copy, false, *t_key, t_value));
+        EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)t_value), i);
+
+        ASSERT_TRUE(MCArrayFetchValue(*t_second_copy, false, *t_key, t_value));
+        if (i % 2 == 1)
+            EXPECT_EQ(t_value, kMCFalse);
+        else
+            EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)t_value), i);
+    }
+
+    // Iteration must visit each key exactly once.
+    uindex_t t_visited = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    while(MCArrayIterate(*t_second_copy, t_iterator, t_key, t_value))
+    {
+        MCValueRef t_fetched;
+        ASSERT_TRUE(MCArrayFetchValue(*t_second_copy, false, t_key, t_fetched));
+        EXPECT_EQ(t_fetched, t_value);
+        t_visited += 1;
+    }
+    EXPECT_EQ(t_visited, kCount);
+
+    // Removing everything leaves an ordinary empty array.
+    for(uindex_t i = 0; i <= kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayRemoveValue(*t_second_copy, false, *t_key));
+    }
+    EXPECT_TRUE(MCArrayIsEmpty(*t_second_copy));
+    ASSERT_TRUE(MCArrayStoreValue(*t_second_copy, false, *t_first_key, kMCTrue));
+    EXPECT_EQ(MCArrayGetCount(*t_second_copy), 1u);
+}
+
+TEST(array, trie_case_sensitivity_and_paths)
+{
+    const uindex_t kCount = 1000;
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        make_key(i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, true, *t_key, kMCTrue));
+    }
+
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_array, &t_copy));
+
+    // Keys differing only in case have the same hash, so end up together.
+    MCNewAutoNameRef t_lower, t_upper, t_child;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"mixed", 5, &t_lower));
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"MIXED", 5, &t_upper));
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"child", 5, &t_child));
+    ASSERT_TRUE(MCArrayStoreValue(*t_copy, true, *t_lower, kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValue(*t_copy, true, *t_upper, kMCFalse));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(fetch_key(*t_copy, true, "mixed", t_value));
+    EXPECT_EQ(t_value, kMCTrue);
+    ASSERT_TRUE(fetch_key(*t_copy, true, "MIXED", t_value));
+    EXPECT_EQ(t_value, kMCFalse);
+    EXPECT_FALSE(fetch_key(*t_copy, true, "Mixed", t_value));
+    EXPECT_TRUE(fetch_key(*t_copy, false, "Mixed", t_value));
+
+    ASSERT_TRUE(MCArrayRemoveValue(*t_copy, true, *t_upper));
+    ASSERT_TRUE(fetch_key(*t_copy, true, "mixed", t_value));
+    EXPECT_FALSE(fetch_key(*t_copy, true, "MIXED", t_value));
+
+    // Storing on a path creates a nested array in the copy only.
+    MCNameRef t_path[2] = { *t_lower, *t_child };
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_copy, true, t_path, 2, kMCTrue));
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_copy, true, t_path, 2, t_value));
+    EXPECT_EQ(t_value, kMCTrue);
+    EXPECT_FALSE(MCArrayFetchValueOnPath(*t_array, true, t_path, 2, t_value));
+    ASSERT_TRUE(MCArrayRemoveValueOnPath(*t_copy, true, t_path, 2));
+    EXPECT_FALSE(MCArrayFetchValueOnPath(*t_copy, true, t_path, 2, t_value));
+
+    // Sharing a trie converts it back to a key-value table.
+    MCAutoArrayRef t_immutable, t_shared;
+    ASSERT_TRUE(MCArrayCopy(*t_copy, &t_immutable));
+    ASSERT_TRUE(MCValueShare(*t_immutable, &t_shared));
+    EXPECT_EQ(MCArrayGetCount(*t_shared), kCount + 1);
+    ASSERT_TRUE(fetch_key(*t_shared, true, "key7", t_value));
+    EXPECT_EQ(t_value, kMCTrue);
+}
+
+TEST(array, nested_store_in_place)
+{
+    MCNewAutoNameRef t_first, t_second, t_third;
+    make_key(1, &t_first);
+    make_key(2, &t_second);
+    make_key(3, &t_third);
+    MCNameRef t_path[3] = { *t_first, *t_second, *t_third };
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_array, false, t_path, 3, kMCTrue));
+
+    MCValueRef t_outer, t_inner;
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 1, t_outer));
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 2, t_inner));
+
+    // Copying the array makes the nested arrays immutable, but once the copy
+    // has gone every level is uniquely referenced again so stores on the path
+    // must change the existing arrays rather than copies.
+    {
+        MCAutoArrayRef t_copy;
+        ASSERT_TRUE(MCArrayCopy(*t_array, &t_copy));
+    }
+
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_array, false, t_path, 3, kMCFalse));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 1, t_value));
+    EXPECT_EQ(t_value, t_outer);
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 2, t_value));
+    EXPECT_EQ(t_value, t_inner);
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 3, t_value));
+    EXPECT_EQ(t_value, kMCFalse);
+
+    // While a copy is alive, the path is copied and the copy is unchanged.
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayCopy(*t_array, &t_copy));
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_array, false, t_path, 3, kMCTrue));
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_copy, false, t_path, 3, t_value));
+    EXPECT_EQ(t_value, kMCFalse);
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 2, t_value));
+    EXPECT_NE(t_value, t_inner);
+}
+
+static void expect_order(MCArrayRef p_array, const uindex_t *p_keys, uindex_t p_count)
+{
+    uindex_t t_visited = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    while(MCArrayIterate(p_array, t_iterator, t_key, t_value))
+    {
+        ASSERT_LT(t_visited, p_count);
+        MCNewAutoNameRef t_expected;
+        make_key(p_keys[t_visited], &t_expected);
+        EXPECT_TRUE(MCNameIsEqualToCaseless(t_key, *t_expected));
+        t_visited += 1;
+    }
+    EXPECT_EQ(t_visited, p_count);
+}
+
+TEST(array, ordered_iteration)
+{
+    const uindex_t kCount = 1000;
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutableWithOptions(kMCArrayOptionKeepOrder, &t_array));
+    EXPECT_TRUE(MCArrayIsOrdered(*t_array));
+
+    // Store the keys in a scrambled order, enough of them to rehash a few
+    // times.
+    uindex_t t_order[kCount];
+    for(uindex_t i = 0; i < kCount; i++)
+    {
+        t_order[i] = (i * 7919) % kCount;
+
+        MCNewAutoNameRef t_key;
+        make_key(t_order[i], &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+    }
+    expect_order(*t_array, t_order, kCount);
+
+    // Storing to an existing key keeps its position, while removing a key and
+    // storing it again moves it to the end.
+    MCNewAutoNameRef t_first;
+    make_key(t_order[0], &t_first);
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_first, kMCFalse));
+    expect_order(*t_array, t_order, kCount);
+
+    ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, *t_first));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_first, kMCTrue));
+    uindex_t t_moved = t_order[0];
+    MCMemoryMove(t_order, t_order + 1, (kCount - 1) * sizeof(uindex_t));
+    t_order[kCount - 1] = t_moved;
+    expect_order(*t_array, t_order, kCount);
+
+    // Churn through removing and re-adding keys so that the order list fills
+    // up with removed entries.
+    for(uindex_t t_round = 0; t_round < 3; t_round++)
+        for(uindex_t i = 0; i < kCount / 2; i++)
+        {
+            MCNewAutoNameRef t_key;
+            make_key(t_order[0], &t_key);
+            ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, *t_key));
+            ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+
+            t_moved = t_order[0];
+            MCMemoryMove(t_order, t_order + 1, (kCount - 1) * sizeof(uindex_t));
+            t_order[kCount - 1] = t_moved;
+        }
+    expect_order(*t_array, t_order, kCount);
+
+    // Copies keep the order, and stay ordered when changed.
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_array, &t_copy));
+    EXPECT_TRUE(MCArrayIsOrdered(*t_copy));
+    MCNewAutoNameRef t_new_key;
+    make_key(kCount, &t_new_key);
+    ASSERT_TRUE(MCArrayStoreValue(*t_copy, false, *t_new_key, kMCTrue));
+    expect_order(*t_array, t_order, kCount);
+
+    uindex_t t_copy_order[kCount + 1];
+    MCMemoryCopy(t_copy_order, t_order, sizeof(t_order));
+    t_copy_order[kCount] = kCount;
+    expect_order(*t_copy, t_copy_order, kCount + 1);
+}
+
+TEST(array, ordered_dense)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutableWithOptions(kMCArrayOptionKeepOrder, &t_array));
+
+    for(uindex_t i = 1; i <= 3; i++)
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, i, kMCTrue));
+
+    // A key which isn't the next index converts the dense array to a table,
+    // which must carry on from the indices in order.
+    MCNewAutoNameRef t_key;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"name", 4, &t_key));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, 0, kMCTrue));
+
+    const char *t_expected[] = { "1", "2", "3", "name", "0" };
+    uindex_t t_visited = 0;
+    uintptr_t t_iterator = 0;
+    MCNameRef t_iterated_key;
+    MCValueRef t_value;
+    while(MCArrayIterate(*t_array, t_iterator, t_iterated_key, t_value))
+    {
+        ASSERT_LT(t_visited, 5u);
+        EXPECT_TRUE(MCStringIsEqualToCString(MCNameGetString(t_iterated_key), t_expected[t_visited], kMCStringOptionCompareExact));
+        t_visited += 1;
+    }
+    EXPECT_EQ(t_visited, 5u);
+
+    // Order doesn't affect equality.
+    MCAutoArrayRef t_other;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_other));
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_other, 0, kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValue(*t_other, false, *t_key, kMCTrue));
+    for(uindex_t i = 3; i >= 1; i--)
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_other, i, kMCTrue));
+    EXPECT_FALSE(MCArrayIsOrdered(*t_other));
+    EXPECT_TRUE(MCValueIsEqualTo(*t_array, *t_other));
+}
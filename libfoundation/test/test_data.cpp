@@ -0,0 +1,118 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+static void release_bytes(void *p_context)
+{
+    *static_cast<bool *>(p_context) = true;
+}
+
+TEST(data, copy_range)
+{
+    byte_t t_bytes[1000];
+    for(uindex_t i = 0; i < sizeof(t_bytes); i++)
+        t_bytes[i] = byte_t(i * 7);
+    
+    MCAutoDataRef t_data;
+    ASSERT_TRUE(MCDataCreateWithBytes(t_bytes, sizeof(t_bytes), &t_data));
+    
+    // Ranges of a range, short and long, outliving the data they came from.
+    MCAutoDataRef t_long, t_short;
+    {
+        MCAutoDataRef t_range;
+        ASSERT_TRUE(MCDataCopyRange(*t_data, MCRangeMake(100, 800), &t_range));
+        ASSERT_TRUE(MCDataCopyRange(*t_range, MCRangeMake(50, 500), &t_long));
+        ASSERT_TRUE(MCDataCopyRange(*t_range, MCRangeMake(10, 5), &t_short));
+    }
+    t_data.Reset();
+    
+    ASSERT_EQ(MCDataGetLength(*t_long), 500u);
+    EXPECT_EQ(memcmp(MCDataGetBytePtr(*t_long), t_bytes + 150, 500), 0);
+    ASSERT_EQ(MCDataGetLength(*t_short), 5u);
+    EXPECT_EQ(memcmp(MCDataGetBytePtr(*t_short), t_bytes + 110, 5), 0);
+    
+    // Changing a mutable copy of a range changes only the copy.
+    MCAutoDataRef t_mutable;
+    ASSERT_TRUE(MCDataMutableCopy(*t_long, &t_mutable));
+    ASSERT_TRUE(MCDataAppendByte(*t_mutable, 1));
+    ASSERT_TRUE(MCDataReplaceBytes(*t_mutable, MCRangeMake(0, 1), t_bytes, 1));
+    EXPECT_EQ(MCDataGetLength(*t_mutable), 501u);
+    EXPECT_EQ(MCDataGetByteAtIndex(*t_mutable, 0), t_bytes[0]);
+    EXPECT_EQ(MCDataGetByteAtIndex(*t_long, 0), t_bytes[150]);
+    
+    MCDataRef t_taken;
+    t_taken = MCValueRetain(*t_long);
+    t_long.Reset();
+    ASSERT_TRUE(MCDataMutableCopyAndRelease(t_taken, t_taken));
+    ASSERT_TRUE(MCDataAppendByte(t_taken, 2));
+    EXPECT_EQ(MCDataGetByteAtIndex(t_taken, 500), 2);
+    EXPECT_EQ(memcmp(MCDataGetBytePtr(t_taken), t_bytes + 150, 500), 0);
+    MCValueRelease(t_taken);
+}
+
+TEST(data, external_bytes)
+{
+    static byte_t s_bytes[256];
+    
+    bool t_released;
+    t_released = false;
+    {
+        MCAutoDataRef t_data;
+        ASSERT_TRUE(MCDataCreateWithExternalBytes(s_bytes, sizeof(s_bytes), release_bytes, &t_released, &t_data));
+        EXPECT_EQ(MCDataGetBytePtr(*t_data), s_bytes);
+        
+        // A range of the data keeps the bytes alive.
+        MCAutoDataRef t_range;
+        ASSERT_TRUE(MCDataCopyRange(*t_data, MCRangeMake(100, 100), &t_range));
+        t_data.Reset();
+        EXPECT_FALSE(t_released);
+        EXPECT_EQ(MCDataGetBytePtr(*t_range), s_bytes + 100);
+        
+        // A mutable copy has its own bytes.
+        MCAutoDataRef t_mutable;
+        ASSERT_TRUE(MCDataMutableCopy(*t_range, &t_mutable));
+        ASSERT_TRUE(MCDataAppendByte(*t_mutable, '!'));
+        EXPECT_EQ(MCDataGetLength(*t_mutable), 101u);
+        EXPECT_NE(MCDataGetBytePtr(*t_mutable), s_bytes + 100);
+    }
+    EXPECT_TRUE(t_released);
+}
+
+TEST(data, detach_external_bytes)
+{
+    static byte_t s_bytes[256];
+    s_bytes[150] = 42;
+    
+    bool t_released;
+    t_released = false;
+    
+    MCAutoDataRef t_data;
+    ASSERT_TRUE(MCDataCreateWithExternalBytes(s_bytes, sizeof(s_bytes), release_bytes, &t_released, &t_data));
+    MCAutoDataRef t_range;
+    ASSERT_TRUE(MCDataCopyRange(*t_data, MCRangeMake(100, 100), &t_range));
+    
+    // Detaching copies the bytes and releases the external ones at once, and
+    // the range follows the data it was taken from.
+    ASSERT_TRUE(MCDataDetachExternalBytes(*t_data));
+    EXPECT_TRUE(t_released);
+    EXPECT_NE(MCDataGetBytePtr(*t_data), s_bytes);
+    EXPECT_NE(MCDataGetBytePtr(*t_range), s_bytes + 100);
+    EXPECT_EQ(MCDataGetByteAtIndex(*t_range, 50), 42);
+}
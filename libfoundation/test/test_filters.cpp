@@ -0,0 +1,307 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+#include "foundation-filters.h"
+
+static void _filters_fill(byte_t *p_bytes, uindex_t p_count)
+{
+    uint32_t t_seed = 12345;
+    for(uindex_t i = 0; i < p_count; i++)
+    {
+        t_seed = t_seed * 1103515245 + 12345;
+        p_bytes[i] = byte_t(t_seed >> 16);
+    }
+}
+
+// A plain encoder to check the result of MCFiltersBase64Encode against.
+static std::string _filters_base64(const byte_t *p_bytes, uindex_t p_count)
+{
+    static const char s_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string t_result;
+    uindex_t t_groups = 0;
+    for(uindex_t i = 0; i < p_count; i += 3)
+    {
+        uint32_t t_bits = p_bytes[i] << 16;
+        if (i + 1 < p_count)
+            t_bits |= p_bytes[i + 1] << 8;
+        if (i + 2 < p_count)
+            t_bits |= p_bytes[i + 2];
+        t_result += s_chars[t_bits >> 18];
+        t_result += s_chars[(t_bits >> 12) & 0x3f];
+        t_result += i + 1 < p_count ? s_chars[(t_bits >> 6) & 0x3f] : '=';
+        t_result += i + 2 < p_count ? s_chars[t_bits & 0x3f] : '=';
+        if (++t_groups % 18 == 0)
+            t_result += '\n';
+    }
+    return t_result;
+}
+
+TEST(filters, base64)
+{
+    byte_t t_bytes[300];
+    _filters_fill(t_bytes, sizeof(t_bytes));
+    
+    for(uindex_t t_count = 0; t_count <= sizeof(t_bytes); t_count++)
+    {
+        MCAutoDataRef t_data;
+        ASSERT_TRUE(MCDataCreateWithBytes(t_bytes, t_count, &t_data));
+        
+        MCAutoStringRef t_encoded;
+        ASSERT_TRUE(MCFiltersBase64Encode(*t_data, &t_encoded));
+        
+        MCAutoStringRefAsCString t_chars;
+        ASSERT_TRUE(t_chars.Lock(*t_encoded));
+        EXPECT_EQ(std::string(*t_chars), _filters_base64(t_bytes, t_count)) << t_count;
+        
+        MCAutoDataRef t_decoded;
+        ASSERT_TRUE(MCFiltersBase64Decode(*t_encoded, &t_decoded));
+        EXPECT_TRUE(MCDataIsEqualTo(*t_decoded, *t_data)) << t_count;
+    }
+}
+
+TEST(filters, base64_decode)
+{
+    struct { const char *encoded; const char *decoded; } t_cases[] =
+    {
+        // Chars outside the alphabet are skipped
+        { "SGVs bG8s\r\nIHdv-cmxk", "Hello, world" },
+        // Padding (or a nul) ends the data
+        { "SGVsbG8=IHdvcmxk", "Hello" },
+        { "SGVsbA==", "Hell" },
+        // A partial group gives what bytes it can
+        { "SGVsbG", "Hell" },
+        { "SGVsb", "Hel" },
+        { "S", "" },
+        // Long enough for whole blocks, with padding and an invalid char
+        // inside a block
+        { "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo=QUJD", "ABCDEFGHIJKLMNOPQRSTUVWXYZ" },
+        { "QUJDREVGR0hJSktM!TU5PUFFSU1RVVldYWVo", "ABCDEFGHIJKLMNOPQRSTUVWXYZ" },
+    };
+    
+    for(auto& t_case : t_cases)
+    {
+        MCAutoStringRef t_encoded;
+        ASSERT_TRUE(MCStringCreateWithCString(t_case.encoded, &t_encoded));
+        
+        MCAutoDataRef t_decoded;
+        ASSERT_TRUE(MCFiltersBase64Decode(*t_encoded, &t_decoded));
+        EXPECT_EQ(std::string((const char *)MCDataGetBytePtr(*t_decoded), MCDataGetLength(*t_decoded)),
+                  std::string(t_case.decoded)) << t_case.encoded;
+    }
+}
+
+TEST(filters, url)
+{
+    struct { const char *decoded; const char *encoded; } t_cases[] =
+    {
+        { "", "" },
+        { "hello world", "hello+world" },
+        { "a/b?c=d&e", "a%2Fb%3Fc%3Dd%26e" },
+        { "line\nbreak", "line%0D%0Abreak" },
+        { "A-Za-z0-9_.*~ and a long run of plain text",
+          "A-Za-z0-9_.*%7E+and+a+long+run+of+plain+text" },
+    };
+    
+    for(auto& t_case : t_cases)
+    {
+        MCAutoStringRef t_decoded, t_encoded;
+        ASSERT_TRUE(MCStringCreateWithCString(t_case.decoded, &t_decoded));
+        ASSERT_TRUE(MCFiltersUrlEncode(*t_decoded, &t_encoded));
+        EXPECT_TRUE(MCStringIsEqualToCString(*t_encoded, t_case.encoded, kMCStringOptionCompareExact)) << t_case.decoded;
+        
+        MCAutoStringRef t_round_trip;
+        ASSERT_TRUE(MCFiltersUrlDecode(*t_encoded, &t_round_trip));
+        EXPECT_TRUE(MCStringIsEqualTo(*t_round_trip, *t_decoded, kMCStringOptionCompareExact)) << t_case.decoded;
+    }
+    
+    // Escapes, '+' and returns anywhere in a block, and escapes cut short
+    // (whose missing digits count as zero).
+    std::string t_decode_cases[][2] =
+    {
+        { "abcdefghijklmnopqrstuvwxyz%41%42+%43", "abcdefghijklmnopqrstuvwxyzAB C" },
+        { "abcdefghijklmn\r\nopqrstuvwxyz\rA", "abcdefghijklmn\nopqrstuvwxyz\nA" },
+        { "abcdefghijklmnopqrstuvwxyz%4", "abcdefghijklmnopqrstuvwxyz@" },
+        { "abc%", std::string("abc\0", 4) },
+    };
+    for(auto& t_case : t_decode_cases)
+    {
+        MCAutoStringRef t_encoded, t_decoded;
+        ASSERT_TRUE(MCStringCreateWithCString(t_case[0].c_str(), &t_encoded));
+        ASSERT_TRUE(MCFiltersUrlDecode(*t_encoded, &t_decoded));
+        
+        MCAutoStringRefAsNativeChars t_native;
+        const char_t *t_chars;
+        uindex_t t_length;
+        ASSERT_TRUE(t_native.Lock(*t_decoded, t_chars, t_length));
+        EXPECT_EQ(std::string((const char *)t_chars, t_length), t_case[1]) << t_case[0];
+    }
+}
+
+TEST(filters, hex)
+{
+    byte_t t_bytes[70];
+    _filters_fill(t_bytes, sizeof(t_bytes));
+    
+    for(uindex_t t_count = 0; t_count <= sizeof(t_bytes); t_count++)
+    {
+        for(int t_order = 0; t_order < 2; t_order++)
+        {
+            bool t_high_first = t_order == 0;
+            
+            char_t t_chars[sizeof(t_bytes) * 2];
+            MCFiltersHexEncodeBytes(t_bytes, t_count, t_high_first, t_chars);
+            for(uindex_t i = 0; i < t_count; i++)
+            {
+                char t_expected[3];
+                sprintf(t_expected, "%02x", t_bytes[i]);
+                if (!t_high_first)
+                    std::swap(t_expected[0], t_expected[1]);
+                EXPECT_EQ(t_chars[i * 2], t_expected[0]);
+                EXPECT_EQ(t_chars[i * 2 + 1], t_expected[1]);
+            }
+            
+            byte_t t_decoded[sizeof(t_bytes)];
+            ASSERT_TRUE(MCFiltersHexDecodeChars(t_chars, t_count, t_high_first, t_decoded));
+            EXPECT_EQ(memcmp(t_decoded, t_bytes, t_count), 0);
+            
+            // Uppercase digits are accepted, and anything else is not.
+            for(uindex_t i = 0; i < t_count * 2; i++)
+                t_chars[i] = char_t(toupper(t_chars[i]));
+            ASSERT_TRUE(MCFiltersHexDecodeChars(t_chars, t_count, t_high_first, t_decoded));
+            EXPECT_EQ(memcmp(t_decoded, t_bytes, t_count), 0);
+            
+            if (t_count > 0)
+            {
+                t_chars[t_count] = 'g';
+                EXPECT_FALSE(MCFiltersHexDecodeChars(t_chars, t_count, t_high_first, t_decoded));
+            }
+        }
+    }
+}
+
+// Feed the bytes through a compression stream in chunks of the given size,
+// collecting the output as it becomes available.
+static bool _filters_stream(MCStreamRef p_stream, const byte_t *p_bytes, uindex_t p_count, uindex_t p_chunk, std::vector<byte_t>& r_output)
+{
+    for(uindex_t i = 0; i <= p_count; i += p_chunk)
+    {
+        bool t_last = i + p_chunk > p_count;
+        if (!MCStreamWrite(p_stream, p_bytes + i, t_last ? p_count - i : p_chunk))
+            return false;
+        if (t_last && !MCFiltersCompressionStreamFinish(p_stream))
+            return false;
+        
+        size_t t_available;
+        if (!MCStreamGetAvailableForRead(p_stream, t_available))
+            return false;
+        size_t t_offset = r_output.size();
+        r_output.resize(t_offset + t_available);
+        if (t_available != 0 && !MCStreamRead(p_stream, &r_output[t_offset], t_available))
+            return false;
+    }
+    
+    bool t_finished;
+    return MCStreamIsFinished(p_stream, t_finished) && t_finished;
+}
+
+TEST(filters, compression_stream)
+{
+    // Half random, half repetitive so there is something to compress.
+    std::vector<byte_t> t_bytes(200000);
+    _filters_fill(&t_bytes[0], 100000);
+    for(uindex_t i = 100000; i < t_bytes.size(); i++)
+        t_bytes[i] = byte_t("the quick brown fox "[i % 20]);
+    
+    static const MCFiltersCompressionFormat kFormats[] =
+        { kMCFiltersCompressionFormatGzip, kMCFiltersCompressionFormatZlib, kMCFiltersCompressionFormatDeflate };
+    static const uindex_t kChunks[] = { 1000, 65536, 200000 };
+    
+    for(uindex_t f = 0; f < sizeof(kFormats) / sizeof(kFormats[0]); f++)
+    {
+        for(uindex_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); c++)
+        {
+            MCAutoValueRefBase<MCStreamRef> t_compressor;
+            ASSERT_TRUE(MCFiltersCompressStreamCreate(kFormats[f], -1, &t_compressor));
+            std::vector<byte_t> t_compressed;
+            ASSERT_TRUE(_filters_stream(*t_compressor, &t_bytes[0], t_bytes.size(), kChunks[c], t_compressed));
+            EXPECT_LT(t_compressed.size(), t_bytes.size());
+            
+            MCAutoValueRefBase<MCStreamRef> t_decompressor;
+            ASSERT_TRUE(MCFiltersDecompressStreamCreate(kFormats[f], &t_decompressor));
+            std::vector<byte_t> t_decompressed;
+            ASSERT_TRUE(_filters_stream(*t_decompressor, &t_compressed[0], t_compressed.size(), kChunks[c] / 10, t_decompressed));
+            EXPECT_TRUE(t_decompressed == t_bytes);
+            
+            // The gzip format is interchangeable with the whole-buffer filters.
+            if (kFormats[f] == kMCFiltersCompressionFormatGzip)
+            {
+                MCAutoDataRef t_compressed_data, t_decompressed_data;
+                ASSERT_TRUE(MCDataCreateWithBytes(&t_compressed[0], t_compressed.size(), &t_compressed_data));
+                ASSERT_TRUE(MCFiltersDecompress(*t_compressed_data, &t_decompressed_data));
+                ASSERT_EQ(MCDataGetLength(*t_decompressed_data), t_bytes.size());
+                EXPECT_EQ(memcmp(MCDataGetBytePtr(*t_decompressed_data), &t_bytes[0], t_bytes.size()), 0);
+            }
+        }
+    }
+    
+    MCAutoDataRef t_source, t_compressed;
+    ASSERT_TRUE(MCDataCreateWithBytes(&t_bytes[0], t_bytes.size(), &t_source));
+    ASSERT_TRUE(MCFiltersCompress(*t_source, &t_compressed));
+    MCAutoValueRefBase<MCStreamRef> t_decompressor;
+    ASSERT_TRUE(MCFiltersDecompressStreamCreate(kMCFiltersCompressionFormatGzip, &t_decompressor));
+    std::vector<byte_t> t_decompressed;
+    ASSERT_TRUE(_filters_stream(*t_decompressor, MCDataGetBytePtr(*t_compressed), MCDataGetLength(*t_compressed), 777, t_decompressed));
+    EXPECT_TRUE(t_decompressed == t_bytes);
+}
+
+TEST(filters, compression_stream_errors)
+{
+    std::vector<byte_t> t_bytes(10000);
+    _filters_fill(&t_bytes[0], t_bytes.size());
+    
+    MCAutoValueRefBase<MCStreamRef> t_compressor;
+    ASSERT_TRUE(MCFiltersCompressStreamCreate(kMCFiltersCompressionFormatGzip, 9, &t_compressor));
+    std::vector<byte_t> t_compressed;
+    ASSERT_TRUE(_filters_stream(*t_compressor, &t_bytes[0], t_bytes.size(), 4096, t_compressed));
+    
+    // Truncated data is only detected when the stream is finished.
+    MCAutoValueRefBase<MCStreamRef> t_truncated;
+    ASSERT_TRUE(MCFiltersDecompressStreamCreate(kMCFiltersCompressionFormatGzip, &t_truncated));
+    EXPECT_TRUE(MCStreamWrite(*t_truncated, &t_compressed[0], t_compressed.size() - 4));
+    EXPECT_FALSE(MCFiltersCompressionStreamFinish(*t_truncated));
+    MCErrorReset();
+    
+    // As is anything after the end of the compressed data.
+    MCAutoValueRefBase<MCStreamRef> t_trailing;
+    ASSERT_TRUE(MCFiltersDecompressStreamCreate(kMCFiltersCompressionFormatGzip, &t_trailing));
+    t_compressed.push_back(0);
+    EXPECT_FALSE(MCStreamWrite(*t_trailing, &t_compressed[0], t_compressed.size()));
+    MCErrorReset();
+    
+    // And data which isn't in the expected format at all.
+    MCAutoValueRefBase<MCStreamRef> t_wrong_format;
+    ASSERT_TRUE(MCFiltersDecompressStreamCreate(kMCFiltersCompressionFormatZlib, &t_wrong_format));
+    EXPECT_FALSE(MCStreamWrite(*t_wrong_format, &t_compressed[0], t_compressed.size()));
+    MCErrorReset();
+    
+    MCStreamRef t_stream;
+    EXPECT_FALSE(MCFiltersCompressStreamCreate(kMCFiltersCompressionFormatGzip, 10, t_stream));
+    MCErrorReset();
+}
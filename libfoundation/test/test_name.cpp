@@ -19,6 +19,9 @@
 #include "foundation.h"
 #include "foundation-auto.h"
 
+#include <thread>
+#include <vector>
+
 TEST(name, index_equal_string)
 {
     static index_t s_test_indicies[] =
@@ -121,3 +124,126 @@ TEST(name, equiv_string)
         ASSERT_TRUE(MCNameIsEqualToCaseless(*t_names[i * 2], *t_names[i * 2 + 1]));
     }
 }
+
+TEST(name, table_statistics)
+{
+    MCNameTableStatistics t_before;
+    MCNameTableGetStatistics(t_before);
+    
+    MCNewAutoNameRef t_name, t_variant, t_same;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"statisticsName", 14, &t_name));
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"STATISTICSNAME", 14, &t_variant));
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"statisticsName", 14, &t_same));
+    EXPECT_EQ(*t_name, *t_same);
+    
+    // The variant shares the equivalence class of the first name.
+    MCNameTableStatistics t_after;
+    MCNameTableGetStatistics(t_after);
+    EXPECT_EQ(t_after.names, t_before.names + 2);
+    EXPECT_EQ(t_after.classes, t_before.classes + 1);
+    EXPECT_EQ(t_after.lookups, t_before.lookups + 3);
+    EXPECT_GE(t_after.capacity, t_after.classes);
+    EXPECT_LE(t_after.longest_probe, t_after.probes);
+}
+
+TEST(name, concurrent_create)
+{
+    const uindex_t kThreadCount = 4;
+    const uindex_t kNameCount = 4096;
+    
+    MCNameTableStatistics t_before;
+    MCNameTableGetStatistics(t_before);
+    
+    // Each thread repeatedly creates and releases the same set of names (in
+    // a mix of cases), enough of them to make the table grow and shrink.
+    std::vector<MCNameRef> t_names[kThreadCount];
+    std::thread t_threads[kThreadCount];
+    for(uindex_t t = 0; t < kThreadCount; t++)
+        t_threads[t] = std::thread([t, &t_names]() {
+            char t_chars[32];
+            for(uindex_t t_round = 0; t_round < 4; t_round++)
+            {
+                for(MCNameRef t_name : t_names[t])
+                    MCValueRelease(t_name);
+                t_names[t].clear();
+                
+                for(uindex_t i = 0; i < kNameCount; i++)
+                {
+                    uindex_t t_length;
+                    t_length = sprintf(t_chars, (i + t + t_round) % 2 == 0 ? "name%u" : "NAME%u", i);
+                    
+                    MCNameRef t_name;
+                    if (!MCNameCreateWithNativeChars((const char_t *)t_chars, t_length, t_name))
+                        return;
+                    t_names[t].push_back(t_name);
+                }
+            }
+        });
+    for(uindex_t t = 0; t < kThreadCount; t++)
+        t_threads[t].join();
+    
+    // Every thread must have ended up with the same names.
+    for(uindex_t t = 0; t < kThreadCount; t++)
+        ASSERT_EQ(t_names[t].size(), kNameCount);
+    for(uindex_t i = 0; i < kNameCount; i++)
+        for(uindex_t t = 1; t < kThreadCount; t++)
+        {
+            EXPECT_TRUE(MCNameIsEqualToCaseless(t_names[0][i], t_names[t][i]));
+            if (MCStringIsEqualTo(MCNameGetString(t_names[0][i]), MCNameGetString(t_names[t][i]), kMCStringOptionCompareExact))
+                EXPECT_EQ(t_names[0][i], t_names[t][i]);
+        }
+    
+    for(uindex_t t = 0; t < kThreadCount; t++)
+        for(MCNameRef t_name : t_names[t])
+            MCValueRelease(t_name);
+    
+    // Once all the names are gone the table is back to how it started.
+    MCNameTableStatistics t_after;
+    MCNameTableGetStatistics(t_after);
+    EXPECT_EQ(t_after.names, t_before.names);
+    EXPECT_EQ(t_after.classes, t_before.classes);
+}
+
+TEST(name, create_static)
+{
+    static MCNameStaticStorage s_storage[3];
+    
+    MCNameRef t_static, t_variant, t_true;
+    MCNameStaticInfo t_names[] =
+    {
+        { "staticName", 10, 0, &t_static },
+        { "STATICNAME", 10, 0, &t_variant },
+        { "true", 4, 0, &t_true },
+    };
+    for(MCNameStaticInfo& t_info : t_names)
+    {
+        MCAutoStringRef t_string;
+        ASSERT_TRUE(MCStringCreateWithCString(t_info.cstring, &t_string));
+        t_info.hash = MCStringHash(*t_string, kMCStringOptionCompareCaseless);
+    }
+    
+    MCNameCreateStatic(t_names, s_storage, 3);
+    
+    // New names are made in the storage, and existing names are used as they
+    // are.
+    EXPECT_EQ((void *)t_static, (void *)&s_storage[0]);
+    EXPECT_EQ((void *)t_variant, (void *)&s_storage[1]);
+    EXPECT_EQ(t_true, kMCTrueName);
+    
+    EXPECT_TRUE(MCNameIsEqualToCaseless(t_static, t_variant));
+    EXPECT_FALSE(MCNameIsEqualTo(t_static, t_variant, kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualToCString(MCNameGetString(t_static), "staticName", kMCStringOptionCompareExact));
+    
+    // Creating them again gives the same names.
+    MCNewAutoNameRef t_name;
+    ASSERT_TRUE(MCNameCreate(MCSTR("staticName"), &t_name));
+    EXPECT_EQ(*t_name, t_static);
+    EXPECT_EQ(MCNameLookupCaseless(MCSTR("STATICname")), t_static);
+    
+    // The names can't be destroyed.
+    MCValueRelease(t_static);
+    MCValueRelease(t_variant);
+    MCValueRelease(t_true);
+    EXPECT_EQ(MCNameLookupCaseless(MCSTR("staticname")), t_static);
+    EXPECT_EQ(MCNameLookupCaseless(MCSTR("true")), kMCTrueName);
+}
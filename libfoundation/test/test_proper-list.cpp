@@ -58,3 +58,52 @@ TEST(properlist, createwithforeignvalues_unbridgable)
         }
     }
 }
+
+TEST(properlist, push_pop_insert)
+{
+    MCAutoProperListRef t_list;
+    ASSERT_TRUE(MCProperListCreateMutable(&t_list));
+    ASSERT_TRUE(MCProperListReserve(*t_list, 16));
+    
+    // Build a list past the reserved size, with some inserts in the middle.
+    const uindex_t t_count = 10000;
+    for(uindex_t i = 0; i < t_count; i++)
+    {
+        MCAutoNumberRef t_number;
+        ASSERT_TRUE(MCNumberCreateWithUnsignedInteger(i, &t_number));
+        ASSERT_TRUE(MCProperListPushElementOntoBack(*t_list, *t_number));
+    }
+    ASSERT_TRUE(MCProperListInsertElement(*t_list, kMCNull, 5000));
+    ASSERT_TRUE(MCProperListPushElementOntoFront(*t_list, kMCTrue));
+    ASSERT_EQ(MCProperListGetLength(*t_list), t_count + 2);
+    EXPECT_EQ(MCProperListFetchElementAtIndex(*t_list, 0), kMCTrue);
+    EXPECT_EQ(MCProperListFetchElementAtIndex(*t_list, 5001), kMCNull);
+    EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)MCProperListFetchElementAtIndex(*t_list, 5002)), 5000u);
+    EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)MCProperListFetchTail(*t_list)), t_count - 1);
+    
+    // Popping most of the elements gives back room, but keeps the rest.
+    for(uindex_t i = 0; i < t_count - 10; i++)
+    {
+        MCAutoValueRef t_value;
+        ASSERT_TRUE(MCProperListPopBack(*t_list, &t_value));
+    }
+    ASSERT_EQ(MCProperListGetLength(*t_list), 12u);
+    EXPECT_EQ(MCNumberFetchAsUnsignedInteger((MCNumberRef)MCProperListFetchTail(*t_list)), 10u);
+    
+    // An immutable copy can be made mutable and changed again.
+    MCAutoProperListRef t_immutable;
+    ASSERT_TRUE(MCProperListCopy(*t_list, &t_immutable));
+    ASSERT_TRUE(MCProperListPushElementOntoBack(*t_list, kMCFalse));
+    EXPECT_EQ(MCProperListGetLength(*t_immutable), 12u);
+    EXPECT_EQ(MCProperListGetLength(*t_list), 13u);
+    
+    MCProperListRef t_mutable;
+    ASSERT_TRUE(MCProperListMutableCopy(*t_immutable, t_mutable));
+    ASSERT_TRUE(MCProperListReserve(t_mutable, 100));
+    ASSERT_TRUE(MCProperListPushElementOntoBack(t_mutable, kMCFalse));
+    
+    MCAutoProperListRef t_result;
+    ASSERT_TRUE(MCProperListCopyAndRelease(t_mutable, &t_result));
+    ASSERT_EQ(MCProperListGetLength(*t_result), 13u);
+    EXPECT_TRUE(MCProperListIsEqualTo(*t_result, *t_list));
+}
@@ -16,6 +16,8 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "gtest/gtest.h"
 
+#include <vector>
+
 #include "foundation.h"
 #include "foundation-unicode.h"
 #include "foundation-auto.h"
@@ -185,3 +187,351 @@ TEST(string, surrogate_unicode_props)
     const int kSPUA_B_Upper = 0x10FFFD + 1; // non-inclusive
     check_bidi_of_surrogate_range(kSPUA_B_Lower, kSPUA_B_Upper);
 }
+
+TEST(string, hash_cache)
+//
+// Checks that cached hashes agree with the chars, and are discarded when the
+// string changes.
+//
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateWithCString("Composite/Key/0123456789", &t_string));
+
+    hash_t t_hash, t_caseless_hash;
+    t_hash = MCStringHash(*t_string, kMCStringOptionCompareExact);
+    t_caseless_hash = MCStringHash(*t_string, kMCStringOptionCompareCaseless);
+    EXPECT_EQ(MCStringHash(*t_string, kMCStringOptionCompareExact), t_hash);
+    EXPECT_EQ(MCStringHash(*t_string, kMCStringOptionCompareCaseless), t_caseless_hash);
+
+    // A string with the same chars has the same hashes, whether or not they
+    // are cached.
+    MCAutoStringRef t_lower;
+    ASSERT_TRUE(MCStringCreateWithCString("composite/key/0123456789", &t_lower));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_string, *t_lower, kMCStringOptionCompareCaseless));
+    EXPECT_EQ(MCStringHash(*t_lower, kMCStringOptionCompareCaseless), t_caseless_hash);
+    EXPECT_NE(MCStringHash(*t_lower, kMCStringOptionCompareExact), t_hash);
+    EXPECT_FALSE(MCStringIsEqualTo(*t_string, *t_lower, kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_string, *t_lower, kMCStringOptionCompareCaseless));
+
+    // Changing a (uniquely referenced) string must discard its hashes.
+    MCStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_string.Take(), t_mutable));
+    ASSERT_TRUE(MCStringAppendNativeChars(t_mutable, (const char_t *)"!", 1));
+    EXPECT_NE(MCStringHash(t_mutable, kMCStringOptionCompareExact), t_hash);
+
+    MCAutoStringRef t_changed;
+    ASSERT_TRUE(MCStringCopyAndRelease(t_mutable, &t_changed));
+    MCAutoStringRef t_expected;
+    ASSERT_TRUE(MCStringCreateWithCString("Composite/Key/0123456789!", &t_expected));
+    EXPECT_EQ(MCStringHash(*t_changed, kMCStringOptionCompareExact),
+              MCStringHash(*t_expected, kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_changed, *t_expected, kMCStringOptionCompareExact));
+}
+
+TEST(string, native_scan)
+//
+// Checks the block-at-a-time native char searches against simple loops, with
+// matches on either side of the block boundaries.
+//
+{
+    const uindex_t kLength = 300;
+    for(uindex_t t_seed = 0; t_seed < 8; t_seed++)
+    {
+        char_t t_chars[kLength];
+        for(uindex_t i = 0; i < kLength; i++)
+        {
+            if ((i * 37 + t_seed * 11) % 23 == 0)
+                t_chars[i] = 'q';
+            else if ((i * 53 + t_seed) % 29 == 0)
+                t_chars[i] = 'Q';
+            else if (i % 41 == t_seed)
+                t_chars[i] = '\n';
+            else
+                t_chars[i] = 'x';
+        }
+        
+        MCAutoStringRef t_string;
+        ASSERT_TRUE(MCStringCreateWithNativeChars(t_chars, kLength, &t_string));
+        
+        uindex_t t_exact_count, t_caseless_count, t_pair_count;
+        uindex_t t_first_caseless, t_last_exact, t_first_upper;
+        t_exact_count = t_caseless_count = t_pair_count = 0;
+        t_first_caseless = t_last_exact = t_first_upper = UINDEX_MAX;
+        for(uindex_t i = 0; i < kLength; i++)
+        {
+            if (t_chars[i] == 'q')
+            {
+                t_exact_count += 1;
+                t_last_exact = i;
+            }
+            if (t_chars[i] == 'q' || t_chars[i] == 'Q')
+            {
+                t_caseless_count += 1;
+                if (t_first_caseless == UINDEX_MAX)
+                    t_first_caseless = i;
+            }
+            if (t_chars[i] == 'Q' && t_first_upper == UINDEX_MAX)
+                t_first_upper = i;
+            if (i > 0 && t_chars[i - 1] == 'x' && (t_chars[i] == 'q' || t_chars[i] == 'Q'))
+                t_pair_count += 1;
+        }
+        
+        EXPECT_EQ(MCStringCountChar(*t_string, MCRangeMake(0, kLength), 'q', kMCStringOptionCompareExact), t_exact_count);
+        EXPECT_EQ(MCStringCountChar(*t_string, MCRangeMake(0, kLength), 'Q', kMCStringOptionCompareCaseless), t_caseless_count);
+        EXPECT_EQ(MCStringCount(*t_string, MCRangeMake(0, kLength), MCSTR("XQ"), kMCStringOptionCompareCaseless), t_pair_count);
+        
+        uindex_t t_offset;
+        ASSERT_TRUE(MCStringFirstIndexOfChar(*t_string, 'Q', 0, kMCStringOptionCompareCaseless, t_offset));
+        EXPECT_EQ(t_offset, t_first_caseless);
+        ASSERT_TRUE(MCStringLastIndexOfChar(*t_string, 'q', kLength, kMCStringOptionCompareExact, t_offset));
+        EXPECT_EQ(t_offset, t_last_exact);
+        
+        // The index of the line containing the first 'Q'.
+        uindex_t t_line_count;
+        t_line_count = 0;
+        for(uindex_t i = 0; i < t_first_upper; i++)
+            if (t_chars[i] == '\n')
+                t_line_count += 1;
+        
+        uindex_t t_index;
+        MCRange t_found;
+        ASSERT_TRUE(MCStringDelimitedOffset(*t_string, MCRangeMake(0, kLength), MCSTR("Q"), MCSTR("\n"), 0, kMCStringOptionCompareExact, t_index, &t_found, nil, nil));
+        EXPECT_EQ(t_index, t_line_count);
+        EXPECT_EQ(t_found.offset, t_first_upper);
+        
+        // Replacing a char caselessly must replace every case of it.
+        MCAutoStringRef t_mutable;
+        ASSERT_TRUE(MCStringMutableCopy(*t_string, &t_mutable));
+        ASSERT_TRUE(MCStringFindAndReplaceChar(*t_mutable, 'q', 'z', kMCStringOptionCompareCaseless));
+        EXPECT_EQ(MCStringCountChar(*t_mutable, MCRangeMake(0, kLength), 'z', kMCStringOptionCompareExact), t_caseless_count);
+        EXPECT_EQ(MCStringCountChar(*t_mutable, MCRangeMake(0, kLength), 'q', kMCStringOptionCompareCaseless), 0u);
+    }
+}
+
+TEST(string, utf8_storage)
+//
+// Checks that strings created from UTF-8 which can't be native behave the
+// same as the equivalent unicode strings, and give back the same UTF-8.
+//
+{
+    // "Größe → 😀", in UTF-8 and UTF-16.
+    const char t_utf8[] = "Gr\xC3\xB6\xC3\x9F" "e \xE2\x86\x92 \xF0\x9F\x98\x80";
+    const unichar_t t_utf16[] = { 'G', 'r', 0xF6, 0xDF, 'e', ' ', 0x2192, ' ', 0xD83D, 0xDE00 };
+    const uindex_t t_utf16_length = sizeof(t_utf16) / sizeof(t_utf16[0]);
+    
+    MCAutoStringRef t_string, t_same, t_unicode;
+    ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_utf8, sizeof(t_utf8) - 1, kMCStringEncodingUTF8, false, &t_string));
+    ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_utf8, sizeof(t_utf8) - 1, kMCStringEncodingUTF8, false, &t_same));
+    ASSERT_TRUE(MCStringCreateWithChars(t_utf16, t_utf16_length, &t_unicode));
+    
+    EXPECT_EQ(MCStringGetLength(*t_string), t_utf16_length);
+    EXPECT_FALSE(MCStringIsNative(*t_string));
+    
+    // Converting back to UTF-8 gives the original bytes.
+    MCAutoStringRefAsUTF8String t_converted;
+    ASSERT_TRUE(t_converted.Lock(*t_string));
+    EXPECT_EQ(t_converted.Size(), sizeof(t_utf8) - 1);
+    EXPECT_STREQ(*t_converted, t_utf8);
+    
+    EXPECT_TRUE(MCStringIsEqualTo(*t_string, *t_same, kMCStringOptionCompareExact));
+    EXPECT_FALSE(MCStringIsEqualTo(*t_string, MCSTR("Gr"), kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_string, *t_unicode, kMCStringOptionCompareExact));
+    EXPECT_EQ(MCStringHash(*t_string, kMCStringOptionCompareCaseless),
+              MCStringHash(*t_unicode, kMCStringOptionCompareCaseless));
+    EXPECT_EQ(MCStringGetCharAtIndex(*t_string, 6), 0x2192);
+    
+    // Changing a (uniquely referenced) UTF-8 string.
+    MCStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_same.Take(), t_mutable));
+    ASSERT_TRUE(MCStringAppendNativeChars(t_mutable, (const char_t *)"!", 1));
+    EXPECT_EQ(MCStringGetLength(t_mutable), t_utf16_length + 1);
+    EXPECT_EQ(MCStringGetCharAtIndex(t_mutable, t_utf16_length), '!');
+    MCValueRelease(t_mutable);
+    
+    // Changing a copy of one.
+    MCAutoStringRef t_copy;
+    ASSERT_TRUE(MCStringMutableCopy(*t_string, &t_copy));
+    ASSERT_TRUE(MCStringPrependNativeChars(*t_copy, (const char_t *)"<", 1));
+    EXPECT_EQ(MCStringGetCharAtIndex(*t_copy, 0), '<');
+    EXPECT_TRUE(MCStringEndsWith(*t_copy, *t_unicode, kMCStringOptionCompareExact));
+    
+    // Invalid UTF-8 is still decoded as it always was.
+    const char t_invalid[] = "\xC0\xAF\xE2\x86\x92";
+    MCAutoStringRef t_decoded;
+    ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_invalid, sizeof(t_invalid) - 1, kMCStringEncodingUTF8, false, &t_decoded));
+    EXPECT_EQ(MCStringGetCharAtIndex(*t_decoded, MCStringGetLength(*t_decoded) - 1), 0x2192);
+}
+
+TEST(string, utf8_compare)
+//
+// Checks that UTF-8 strings, which are hashed and compared without being
+// decoded, give the same results as the equivalent unicode strings.
+//
+{
+    // "Straße →", with "é" as "e" and a combining acute, then the same
+    // uppercased and composed.
+    const char t_utf8[] = "Stra\xC3\x9F" "e\xCC\x81 \xE2\x86\x92";
+    const unichar_t t_upper[] = { 'S', 'T', 'R', 'A', 0xDF, 0xC9, ' ', 0x2192 };
+    const unichar_t t_other[] = { 'S', 't', 'r', 'a', 0xDF, 'e', ' ', 0x2192 };
+    
+    MCAutoStringRef t_string, t_upper_string, t_other_string;
+    ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_utf8, sizeof(t_utf8) - 1, kMCStringEncodingUTF8, false, &t_string));
+    ASSERT_TRUE(MCStringCreateWithChars(t_upper, sizeof(t_upper) / sizeof(t_upper[0]), &t_upper_string));
+    ASSERT_TRUE(MCStringCreateWithChars(t_other, sizeof(t_other) / sizeof(t_other[0]), &t_other_string));
+    
+    EXPECT_FALSE(MCStringIsEqualTo(*t_string, *t_upper_string, kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_string, *t_upper_string, kMCStringOptionCompareCaseless));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_upper_string, *t_string, kMCStringOptionCompareCaseless));
+    EXPECT_FALSE(MCStringIsEqualTo(*t_string, *t_other_string, kMCStringOptionCompareCaseless));
+    EXPECT_FALSE(MCStringIsEqualTo(*t_string, MCSTR("Stra"), kMCStringOptionCompareCaseless));
+    EXPECT_EQ(MCStringHash(*t_string, kMCStringOptionCompareCaseless),
+              MCStringHash(*t_upper_string, kMCStringOptionCompareCaseless));
+    
+    // The hashes must match those of the decoded string.
+    hash_t t_exact_hash, t_caseless_hash;
+    t_exact_hash = MCStringHash(*t_string, kMCStringOptionCompareExact);
+    t_caseless_hash = MCStringHash(*t_string, kMCStringOptionCompareCaseless);
+    
+    MCAutoStringRef t_decoded;
+    ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_utf8, sizeof(t_utf8) - 1, kMCStringEncodingUTF8, false, &t_decoded));
+    EXPECT_EQ(MCStringGetCharAtIndex(*t_decoded, 0), 'S');
+    EXPECT_EQ(MCStringHash(*t_decoded, kMCStringOptionCompareExact), t_exact_hash);
+    EXPECT_EQ(MCStringHash(*t_decoded, kMCStringOptionCompareCaseless), t_caseless_hash);
+}
+
+TEST(string, gap_edits)
+//
+// Checks that a run of edits in the middle of a long string (which moves the
+// free space in its buffer around) gives the same chars as the same edits on
+// a plain array.
+//
+{
+    for(int t_unicode = 0; t_unicode < 2; t_unicode++)
+    {
+        std::vector<unichar_t> t_expected;
+        for(uindex_t i = 0; i < 10000; i++)
+            t_expected.push_back('a' + i % 26);
+        
+        MCStringRef t_string;
+        ASSERT_TRUE(MCStringCreateMutable(0, t_string));
+        ASSERT_TRUE(MCStringAppendChars(t_string, t_expected.data(), t_expected.size()));
+        if (t_unicode)
+        {
+            // Arrows aren't native on any platform.
+            ASSERT_TRUE(MCStringAppendChar(t_string, 0x2192));
+            t_expected.push_back(0x2192);
+            EXPECT_FALSE(MCStringIsNative(t_string));
+        }
+        
+        uindex_t t_at;
+        t_at = 5000;
+        for(uindex_t i = 0; i < 2000; i++)
+        {
+            const unichar_t t_chars[] = { unichar_t('A' + i % 26), '-' };
+            switch(i % 5)
+            {
+                case 0:
+                case 1:
+                    ASSERT_TRUE(MCStringInsertChars(t_string, t_at, t_chars, 2));
+                    t_expected.insert(t_expected.begin() + t_at, t_chars, t_chars + 2);
+                    break;
+                case 2:
+                    ASSERT_TRUE(MCStringRemove(t_string, MCRangeMake(t_at - 3, 3)));
+                    t_expected.erase(t_expected.begin() + (t_at - 3), t_expected.begin() + t_at);
+                    break;
+                case 3:
+                {
+                    MCAutoStringRef t_replacement;
+                    ASSERT_TRUE(MCStringCreateWithChars(t_chars, 2, &t_replacement));
+                    ASSERT_TRUE(MCStringReplace(t_string, MCRangeMake(t_at, 1), *t_replacement));
+                }
+                    t_expected.erase(t_expected.begin() + t_at);
+                    t_expected.insert(t_expected.begin() + t_at, t_chars, t_chars + 2);
+                    break;
+                case 4:
+                    ASSERT_TRUE(MCStringPrependChars(t_string, t_chars, 1));
+                    t_expected.insert(t_expected.begin(), t_chars[0]);
+                    break;
+            }
+            
+            // A big insertion makes the buffer grow while there is a gap.
+            if (i == 1000)
+            {
+                std::vector<unichar_t> t_block(8000, 'z');
+                ASSERT_TRUE(MCStringInsertChars(t_string, t_at, t_block.data(), t_block.size()));
+                t_expected.insert(t_expected.begin() + t_at, t_block.begin(), t_block.end());
+            }
+            
+            // Reading a char in between edits closes the gap.
+            if (i % 100 == 0)
+                ASSERT_EQ(MCStringGetCharAtIndex(t_string, t_at), t_expected[t_at]);
+            
+            // Walk back and forth through the string.
+            t_at = (t_at + 37 * (i % 7) + 4000) % (t_expected.size() - 8) + 4;
+            ASSERT_EQ(MCStringGetLength(t_string), t_expected.size());
+        }
+        
+        // Reading the chars, and appending, closes the gap.
+        ASSERT_TRUE(MCStringAppendChars(t_string, t_expected.data(), 3));
+        t_expected.insert(t_expected.end(), t_expected.begin(), t_expected.begin() + 3);
+        
+        MCAutoStringRef t_result;
+        ASSERT_TRUE(MCStringCopyAndRelease(t_string, &t_result));
+        ASSERT_EQ(MCStringGetLength(*t_result), t_expected.size());
+        for(uindex_t i = 0; i < t_expected.size(); i++)
+            ASSERT_EQ(MCStringGetCharAtIndex(*t_result, i), t_expected[i]) << "at " << i;
+        
+        MCAutoStringRef t_expected_string;
+        ASSERT_TRUE(MCStringCreateWithChars(t_expected.data(), t_expected.size(), &t_expected_string));
+        EXPECT_TRUE(MCStringIsEqualTo(*t_result, *t_expected_string, kMCStringOptionCompareExact));
+    }
+}
+
+TEST(string, slices)
+{
+    MCAutoStringRef t_text;
+    ASSERT_TRUE(MCStringCreateWithCString("first line of the text\nsecond line of the text\nthird", &t_text));
+    
+    // Substrings of an immutable string share its chars, but must still read
+    // as NUL-terminated strings.
+    MCAutoStringRef t_line;
+    ASSERT_TRUE(MCStringCopySubstring(*t_text, MCRangeMake(23, 23), &t_line));
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_line, "second line of the text", kMCStringOptionCompareExact));
+    EXPECT_EQ(MCStringGetNativeCharAtIndex(*t_line, 23), 0);
+    EXPECT_STREQ((const char *)MCStringGetNativeCharPtr(*t_line), "second line of the text");
+    
+    // The string the slice was taken from is unchanged, even when its chars
+    // are converted.
+    MCAutoStringRef t_first_line;
+    ASSERT_TRUE(MCStringCopySubstring(*t_text, MCRangeMake(0, 22), &t_first_line));
+    const unichar_t *t_chars;
+    t_chars = MCStringGetCharPtr(*t_text);
+    ASSERT_NE(t_chars, nullptr);
+    EXPECT_EQ(t_chars[MCStringGetLength(*t_text)], 0);
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_text, "first line of the text\nsecond line of the text\nthird", kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_first_line, "first line of the text", kMCStringOptionCompareExact));
+    
+    // A slice of a slice, which outlives the string it came from.
+    MCAutoStringRef t_word;
+    {
+        MCAutoStringRef t_source, t_slice;
+        ASSERT_TRUE(MCStringCreateWithCString("a long enough string to take slices of", &t_source));
+        ASSERT_TRUE(MCStringCopySubstring(*t_source, MCRangeMake(2, 30), &t_slice));
+        ASSERT_TRUE(MCStringCopySubstring(*t_slice, MCRangeMake(5, 20), &t_word));
+    }
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_word, "enough string to tak", kMCStringOptionCompareExact));
+    
+    // Changing a mutable copy of a slice changes only the copy.
+    MCAutoStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopy(*t_word, &t_mutable));
+    ASSERT_TRUE(MCStringAppendNativeChars(*t_mutable, (const char_t *)"!", 1));
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_mutable, "enough string to tak!", kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_word, "enough string to tak", kMCStringOptionCompareExact));
+    
+    // Splitting gives slices of the string.
+    MCAutoProperListRef t_lines;
+    ASSERT_TRUE(MCStringSplitByDelimiter(*t_text, MCSTR("\n"), kMCStringOptionCompareExact, &t_lines));
+    ASSERT_EQ(MCProperListGetLength(*t_lines), 3u);
+    EXPECT_TRUE(MCStringIsEqualTo((MCStringRef)MCProperListFetchElementAtIndex(*t_lines, 0), MCSTR("first line of the text"), kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualTo((MCStringRef)MCProperListFetchElementAtIndex(*t_lines, 2), MCSTR("third"), kMCStringOptionCompareExact));
+}
@@ -22,6 +22,14 @@
 #include "foundation.h"
 #include "foundation-auto.h"
 
+#include "foundation-private.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#define GTEST_COUT std::cerr << "[          ] [ INFO ]"
+
 TEST(typeconvert, narrowcast)
 {
     /* MCNarrowCast never does any checking */
@@ -125,3 +133,161 @@ TEST(typeconvert, string_real)
 	EXPECT_FALSE(MCTypeConvertStringToReal(MCSTR("0x"), t_value, false));
 	EXPECT_EQ(t_value, 0);
 }
+
+/* A small deterministic generator of doubles across a range of magnitudes. */
+static uint64_t s_real_seed = 42;
+static real64_t _typeconvert_next_real(void)
+{
+	s_real_seed = s_real_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	real64_t t_value = real64_t(s_real_seed >> 11) / real64_t(uint64_t(1) << 53);
+	int t_scale = int((s_real_seed >> 3) % 26) - 10;
+	t_value *= pow(10.0, t_scale);
+	return (s_real_seed & 1) != 0 ? -t_value : t_value;
+}
+
+static void _typeconvert_check_fixed(real64_t p_value, uindex_t p_width, uindex_t p_precision)
+{
+	char t_expected[512];
+	snprintf(t_expected, sizeof(t_expected), "%0*.*f", int(p_width), int(p_precision), p_value);
+
+	char t_chars[512];
+	uindex_t t_length = 0;
+	ASSERT_TRUE(MCTypeConvertRealToFixedChars(p_value, p_width, p_precision, t_chars, sizeof(t_chars), t_length));
+	EXPECT_STREQ(t_chars, t_expected) << "value " << p_value << " width " << p_width << " precision " << p_precision;
+	EXPECT_EQ(t_length, strlen(t_expected));
+}
+
+TEST(typeconvert, real_fixed_chars)
+//
+// Checks fixed-point formatting matches printf()
+//
+{
+	/* Exact halves round to even */
+	_typeconvert_check_fixed(0.5, 0, 0);
+	_typeconvert_check_fixed(1.5, 0, 0);
+	_typeconvert_check_fixed(2.5, 0, 0);
+	_typeconvert_check_fixed(0.125, 0, 2);
+	_typeconvert_check_fixed(0.375, 0, 2);
+
+	/* Signs, padding and zeros */
+	_typeconvert_check_fixed(-0.0, 0, 3);
+	_typeconvert_check_fixed(-0.0001, 0, 2);
+	_typeconvert_check_fixed(-3.25, 8, 2);
+	_typeconvert_check_fixed(0.0, 5, 0);
+	_typeconvert_check_fixed(4.9e-324, 0, 20);
+
+	/* Values beyond the exact path */
+	_typeconvert_check_fixed(1e300, 0, 6);
+	_typeconvert_check_fixed(123.456, 0, 30);
+
+	for(int i = 0; i < 20000; i++)
+		_typeconvert_check_fixed(_typeconvert_next_real(), uindex_t(i % 7) * 3, uindex_t(i % 21));
+
+	/* The result must fit into the buffer */
+	char t_small[4];
+	uindex_t t_length;
+	EXPECT_FALSE(MCTypeConvertRealToFixedChars(123.5, 0, 2, t_small, sizeof(t_small), t_length));
+}
+
+TEST(typeconvert, short_decimal)
+//
+// Checks the fast path for plain decimals agrees with strtod()
+//
+{
+	const char *t_valid[] =
+	{
+		"0", "-0", "+7", "3.14159", ".5", "5.", "-0.000125", "1e5", "2.5E-3",
+		"9007199254740992", "1234567890123456e-10", "0.1", "0.3", "1e22",
+	};
+	for(const char *t_chars : t_valid)
+	{
+		real64_t t_value;
+		ASSERT_TRUE(__MCTypeConvertParseShortDecimal(t_chars, strlen(t_chars), t_value)) << t_chars;
+		real64_t t_expected = strtod(t_chars, nullptr);
+		EXPECT_EQ(memcmp(&t_value, &t_expected, sizeof(real64_t)), 0) << t_chars;
+	}
+
+	/* These are left to strtod() */
+	const char *t_invalid[] =
+	{
+		"", ".", "-", "1e", "1e+", " 1", "1 ", "0x10", "inf", "nan", "1.2.3",
+		"9007199254740993", "1e23", "12345678901234567890",
+	};
+	for(const char *t_chars : t_invalid)
+	{
+		real64_t t_value;
+		EXPECT_FALSE(__MCTypeConvertParseShortDecimal(t_chars, strlen(t_chars), t_value)) << t_chars;
+	}
+
+	for(int i = 0; i < 20000; i++)
+	{
+		char t_chars[64];
+		snprintf(t_chars, sizeof(t_chars), "%.*f", i % 9, _typeconvert_next_real());
+
+		real64_t t_value;
+		if (!__MCTypeConvertParseShortDecimal(t_chars, strlen(t_chars), t_value))
+			continue;
+		real64_t t_expected = strtod(t_chars, nullptr);
+		EXPECT_EQ(t_value, t_expected) << t_chars;
+	}
+}
+
+TEST(typeconvert, real_benchmark)
+//
+// Compares the speed of number conversion with the C library
+//
+{
+	const int kCount = 200000;
+	real64_t *t_values = new real64_t[kCount];
+	for(int i = 0; i < kCount; i++)
+		t_values[i] = _typeconvert_next_real() * 1000;
+
+	char t_chars[64];
+	uindex_t t_length;
+	real64_t t_sum = 0;
+
+	auto t_start = std::chrono::steady_clock::now();
+	for(int i = 0; i < kCount; i++)
+		t_sum += snprintf(t_chars, sizeof(t_chars), "%0*.*f", 0, 6, t_values[i]);
+	auto t_libc_format = std::chrono::steady_clock::now() - t_start;
+
+	t_start = std::chrono::steady_clock::now();
+	for(int i = 0; i < kCount; i++)
+	{
+		MCTypeConvertRealToFixedChars(t_values[i], 0, 6, t_chars, sizeof(t_chars), t_length);
+		t_sum += t_length;
+	}
+	auto t_fixed_format = std::chrono::steady_clock::now() - t_start;
+
+	char (*t_strings)[32] = new char[kCount][32];
+	for(int i = 0; i < kCount; i++)
+		snprintf(t_strings[i], sizeof(t_strings[i]), "%.*f", i % 7, t_values[i]);
+
+	t_start = std::chrono::steady_clock::now();
+	for(int i = 0; i < kCount; i++)
+		t_sum += strtod(t_strings[i], nullptr);
+	auto t_libc_parse = std::chrono::steady_clock::now() - t_start;
+
+	t_start = std::chrono::steady_clock::now();
+	for(int i = 0; i < kCount; i++)
+	{
+		real64_t t_value = 0;
+		__MCTypeConvertParseShortDecimal(t_strings[i], uindex_t(strlen(t_strings[i])), t_value);
+		t_sum += t_value;
+	}
+	auto t_short_parse = std::chrono::steady_clock::now() - t_start;
+
+	typedef std::chrono::microseconds us;
+	GTEST_COUT << " format " << kCount << " reals: snprintf "
+	           << std::chrono::duration_cast<us>(t_libc_format).count() << "us, fixed "
+	           << std::chrono::duration_cast<us>(t_fixed_format).count() << "us" << std::endl;
+	GTEST_COUT << " parse " << kCount << " reals: strtod "
+	           << std::chrono::duration_cast<us>(t_libc_parse).count() << "us, short decimal "
+	           << std::chrono::duration_cast<us>(t_short_parse).count() << "us" << std::endl;
+
+	/* Make sure the loops aren't optimized away */
+	EXPECT_NE(t_sum, 0);
+
+	delete[] t_strings;
+	delete[] t_values;
+}
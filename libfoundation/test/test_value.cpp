@@ -0,0 +1,191 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+#include <thread>
+
+TEST(value, share_array)
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateWithCString("shared", &t_string));
+
+    MCNewAutoNameRef t_key;
+    ASSERT_TRUE(MCNameCreate(MCSTR("key"), &t_key));
+
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, *t_string));
+    EXPECT_FALSE(MCValueIsShared(*t_array));
+
+    MCAutoArrayRef t_shared;
+    ASSERT_TRUE(MCValueShare(*t_array, &t_shared));
+    EXPECT_TRUE(MCValueIsShared(*t_shared));
+    EXPECT_FALSE(MCArrayIsMutable(*t_shared));
+
+    // Everything reachable from the shared value must be shared too.
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValue(*t_shared, false, *t_key, t_value));
+    EXPECT_TRUE(MCValueIsShared(t_value));
+    EXPECT_TRUE(MCValueIsShared(*t_key));
+    EXPECT_TRUE(MCValueIsShared(MCNameGetString(*t_key)));
+
+    // Retain and release must still balance.
+    uindex_t t_count;
+    t_count = MCValueGetRetainCount(*t_shared);
+    MCValueRetain(*t_shared);
+    EXPECT_EQ(MCValueGetRetainCount(*t_shared), t_count + 1);
+    MCValueRelease(*t_shared);
+    EXPECT_EQ(MCValueGetRetainCount(*t_shared), t_count);
+}
+
+TEST(value, share_unsupported)
+{
+    // Typeinfo can't be shared.
+    MCValueRef t_shared;
+    EXPECT_FALSE(MCValueShare(kMCStringTypeInfo, t_shared));
+}
+
+TEST(value, share_string_numeric_cache)
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateWithCString("42", &t_string));
+
+    MCAutoStringRef t_shared;
+    ASSERT_TRUE(MCValueShare(*t_string, &t_shared));
+
+    // Shared strings don't cache their numeric value.
+    EXPECT_FALSE(MCStringSetNumericValue(*t_shared, 42.0));
+}
+
+TEST(value, share_string_unchanged_by_reads)
+{
+    MCAutoStringRef t_string, t_slice;
+    ASSERT_TRUE(MCStringCreateWithCString("a long enough string to take slices of", &t_string));
+    ASSERT_TRUE(MCStringCopySubstring(*t_string, MCRangeMake(2, 20), &t_slice));
+
+    // A shared slice has its own NUL-terminated chars, so reading them
+    // doesn't need to change it.
+    MCAutoStringRef t_shared;
+    ASSERT_TRUE(MCValueShare(*t_slice, &t_shared));
+    const char_t *t_chars;
+    t_chars = MCStringGetNativeCharPtr(*t_shared);
+    ASSERT_TRUE(t_chars != nil);
+    EXPECT_EQ(t_chars[MCStringGetLength(*t_shared)], '\0');
+    EXPECT_EQ(MCStringGetNativeCharPtr(*t_shared), t_chars);
+
+    // A shared native string isn't converted to unicode in place.
+    EXPECT_TRUE(MCStringGetCharPtr(*t_shared) == nil);
+    EXPECT_TRUE(MCStringIsNative(*t_shared));
+    EXPECT_EQ(MCStringGetNativeCharPtr(*t_shared), t_chars);
+
+    // Substrings of shared strings are copies.
+    MCAutoStringRef t_substring;
+    ASSERT_TRUE(MCStringCopySubstring(*t_shared, MCRangeMake(0, 16), &t_substring));
+    EXPECT_FALSE(MCValueIsShared(*t_substring));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_substring, MCSTR("long enough stri"), kMCStringOptionCompareExact));
+    EXPECT_EQ(MCStringGetNativeCharPtr(*t_shared), t_chars);
+}
+
+TEST(value, pool_reuse)
+{
+    MCValuePoolStatistics t_before;
+    MCValuePoolGetStatistics(t_before);
+
+    // The second number must reuse the pooled value the first was returned
+    // to.
+    MCNumberRef t_number;
+    ASSERT_TRUE(MCNumberCreateWithInteger(1, t_number));
+    MCValueRelease(t_number);
+    ASSERT_TRUE(MCNumberCreateWithInteger(2, t_number));
+    MCValueRelease(t_number);
+
+    MCValuePoolStatistics t_after;
+    MCValuePoolGetStatistics(t_after);
+    EXPECT_EQ(t_after.hits + t_after.misses, t_before.hits + t_before.misses + 2);
+    EXPECT_GE(t_after.hits, t_before.hits + 1);
+    EXPECT_GT(t_after.pooled, 0u);
+}
+
+TEST(value, pool_trim)
+{
+    // Enough numbers to need several slabs.
+    const uindex_t kCount = 10000;
+    MCNumberRef *t_numbers;
+    ASSERT_TRUE(MCMemoryNewArray(kCount, t_numbers));
+    for(uindex_t i = 0; i < kCount; i++)
+        ASSERT_TRUE(MCNumberCreateWithInteger(integer_t(i), t_numbers[i]));
+
+    MCValuePoolStatistics t_full;
+    MCValuePoolGetStatistics(t_full);
+    EXPECT_GT(t_full.slabs, 1u);
+
+    for(uindex_t i = 0; i < kCount; i++)
+        MCValueRelease(t_numbers[i]);
+    MCMemoryDeleteArray(t_numbers);
+
+    // Empty slabs are freed as long as the pool has others, and trimming
+    // frees the rest.
+    MCValuePoolTrim();
+    MCValuePoolStatistics t_trimmed;
+    MCValuePoolGetStatistics(t_trimmed);
+    EXPECT_LT(t_trimmed.slabs, t_full.slabs);
+    EXPECT_EQ(t_trimmed.trims, t_full.trims + 1);
+    EXPECT_LE(t_trimmed.pooled_bytes, size_t(t_trimmed.slabs) * 16384);
+}
+
+TEST(value, pool_release_on_other_thread)
+{
+    MCValuePoolTrim();
+    MCValuePoolStatistics t_before;
+    MCValuePoolGetStatistics(t_before);
+
+    // Values created on a thread and destroyed on another go back to the
+    // pool of the thread which created them.
+    const uindex_t kCount = 1000;
+    MCNumberRef *t_numbers;
+    ASSERT_TRUE(MCMemoryNewArray(kCount, t_numbers));
+    for(uindex_t i = 0; i < kCount; i++)
+        ASSERT_TRUE(MCNumberCreateWithInteger(integer_t(i), t_numbers[i]));
+
+    std::thread t_thread([&] {
+        for(uindex_t i = 0; i < kCount; i++)
+            MCValueRelease(t_numbers[i]);
+
+        // Values created on this thread come from its own pool (which the
+        // first value it creates makes, or takes over from an exited thread).
+        MCNumberRef t_number;
+        ASSERT_TRUE(MCNumberCreateWithInteger(1, t_number));
+        MCValueRelease(t_number);
+
+        MCValuePoolStatistics t_thread_before, t_thread_after;
+        MCValuePoolGetStatistics(t_thread_before);
+        ASSERT_TRUE(MCNumberCreateWithInteger(2, t_number));
+        MCValueRelease(t_number);
+        MCValuePoolGetStatistics(t_thread_after);
+        EXPECT_EQ(t_thread_after.hits, t_thread_before.hits + 1);
+    });
+    t_thread.join();
+    MCMemoryDeleteArray(t_numbers);
+
+    MCValuePoolTrim();
+    MCValuePoolStatistics t_after;
+    MCValuePoolGetStatistics(t_after);
+    EXPECT_LE(t_after.slabs, t_before.slabs);
+}
@@ -94,6 +94,7 @@ extern "C" void MCMapEvalKeysOf(MCArrayRef p_target, MCProperListRef& r_output)
 {
     MCProperListRef t_list;
     if (MCProperListCreateMutable(t_list) &&
+        MCProperListReserve(t_list, MCArrayGetCount(p_target)) &&
         MCArrayApply(p_target, list_array_keys, t_list) &&
         MCProperListCopyAndRelease(t_list, r_output))
         return;
@@ -105,6 +106,7 @@ extern "C" void MCMapEvalElementsOf(MCArrayRef p_target, MCProperListRef& r_outp
 {
     MCProperListRef t_list;
     if (MCProperListCreateMutable(t_list) &&
+        MCProperListReserve(t_list, MCArrayGetCount(p_target)) &&
         MCArrayApply(p_target, list_array_elements, t_list) &&
         MCProperListCopyAndRelease(t_list, r_output))
         return;
@@ -16,7 +16,9 @@ You should have received a copy of the GNU General Public License
 along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include <foundation.h>
+#include <foundation-auto.h>
 #include <foundation-system.h>
+#include <foundation-filters.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -40,6 +42,89 @@ MCStreamExecWriteToStream(MCDataRef p_data,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static bool
+MCStreamParseCompressionFormat (MCStringRef p_format,
+                                MCFiltersCompressionFormat& r_format)
+{
+	if (MCStringIsEqualToCString (p_format, "gzip", kMCStringOptionCompareCaseless))
+		r_format = kMCFiltersCompressionFormatGzip;
+	else if (MCStringIsEqualToCString (p_format, "zlib", kMCStringOptionCompareCaseless))
+		r_format = kMCFiltersCompressionFormatZlib;
+	else if (MCStringIsEqualToCString (p_format, "deflate", kMCStringOptionCompareCaseless))
+		r_format = kMCFiltersCompressionFormatDeflate;
+	else
+	{
+		MCErrorCreateAndThrow (kMCGenericErrorTypeInfo, "reason", MCSTR("unknown compression format"), NULL);
+		return false;
+	}
+	return true;
+}
+
+extern "C" MC_DLLEXPORT_DEF void
+MCStreamExecCreateCompressingStreamWithLevel (MCStringRef p_format,
+                                              integer_t p_level,
+                                              MCStreamRef & r_stream)
+{
+	MCFiltersCompressionFormat t_format;
+	if (!MCStreamParseCompressionFormat (p_format, t_format))
+		return;
+
+	MCFiltersCompressStreamCreate (t_format, p_level, r_stream);
+}
+
+extern "C" MC_DLLEXPORT_DEF void
+MCStreamExecCreateCompressingStream (MCStringRef p_format,
+                                     MCStreamRef & r_stream)
+{
+	MCStreamExecCreateCompressingStreamWithLevel (p_format, -1, r_stream);
+}
+
+extern "C" MC_DLLEXPORT_DEF void
+MCStreamExecCreateDecompressingStream (MCStringRef p_format,
+                                       MCStreamRef & r_stream)
+{
+	MCFiltersCompressionFormat t_format;
+	if (!MCStreamParseCompressionFormat (p_format, t_format))
+		return;
+
+	MCFiltersDecompressStreamCreate (t_format, r_stream);
+}
+
+extern "C" MC_DLLEXPORT_DEF void
+MCStreamExecFinishStream (MCStreamRef p_stream)
+{
+	MCFiltersCompressionStreamFinish (p_stream);
+}
+
+extern "C" MC_DLLEXPORT_DEF void
+MCStreamExecReadAvailableFromStream (MCStreamRef p_stream,
+                                     MCDataRef & r_data)
+{
+	size_t t_available;
+	if (!MCStreamIsReadable (p_stream) ||
+	    !MCStreamGetAvailableForRead (p_stream, t_available))
+	{
+		MCErrorCreateAndThrow (kMCGenericErrorTypeInfo, "reason", MCSTR("stream is not readable"), NULL);
+		return;
+	}
+
+	uindex_t t_length;
+	if (!MCNarrow (t_available, t_length))
+	{
+		MCErrorThrowOutOfMemory ();
+		return;
+	}
+
+	MCAutoByteArray t_buffer;
+	if (!t_buffer.New (t_length) ||
+	    !MCStreamRead (p_stream, t_buffer.Bytes (), t_length))
+		return;
+
+	t_buffer.CreateDataAndRelease (r_data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 extern "C" MC_DLLEXPORT_DEF void
 MCStreamExecGetStandardOutput (MCStreamRef & r_stream)
 {
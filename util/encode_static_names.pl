@@ -0,0 +1,112 @@
+#!/usr/bin/env perl
+
+# Generate the table of names which the engine creates at startup, with the
+# hash of each computed in advance, so that they can be added to the name
+# table without hashing or allocating (see MCNameCreateStatic).
+#
+# The names are taken from the kInitialNames table in mcstring.cpp. Entries
+# whose string is a macro, or isn't ASCII, are skipped - they are created in
+# the usual way at startup. Preprocessor conditions are copied as they are.
+
+use warnings;
+use strict;
+
+use Math::BigInt;
+
+# The caseless hash of the chars, as MCStringHash computes it for a native
+# string, with the given width of hash_t.
+sub hashName
+{
+	my ($string, $bits) = @_;
+
+	my ($prime, $hash);
+	if ($bits == 64)
+	{
+		$prime = Math::BigInt->new("1099511628211");
+		$hash = Math::BigInt->new("14695981039346656037");
+	}
+	else
+	{
+		$prime = Math::BigInt->new("16777619");
+		$hash = Math::BigInt->new("2166136261");
+	}
+	my $mask = Math::BigInt->new(1)->blsft($bits)->bsub(1);
+
+	foreach my $char (split //, lc($string))
+	{
+		$hash->bxor(ord($char));
+		$hash->bmul($prime)->band($mask);
+		$hash->bmul($prime)->band($mask);
+	}
+
+	return $hash->as_hex();
+}
+
+my $sourceFile = $ARGV[0];
+my $outputFile = $ARGV[1];
+
+open SOURCE, "<$sourceFile"
+	or die "Could not open \"$sourceFile\": $!";
+my @lines = <SOURCE>;
+close SOURCE;
+
+my $entries = "";
+my $count = 0;
+my $found = 0;
+foreach my $line (@lines)
+{
+	if (!$found)
+	{
+		$found = 1 if ($line =~ /\bkInitialNames\[\]\s*=/);
+		next;
+	}
+
+	# End of the table
+	last if ($line =~ /^\s*};/);
+
+	if ($line =~ /^\s*#/)
+	{
+		$entries .= $line;
+	}
+	elsif ($line =~ /^\s*\{\s*"([\x20-\x21\x23-\x5b\x5d-\x7e]*)"\s*,\s*&(\w+)\s*\}/)
+	{
+		my ($string, $var) = ($1, $2);
+		my $hash32 = hashName($string, 32);
+		my $hash64 = hashName($string, 64);
+		$entries .= "\tSTATIC_NAME(\"${string}\", ${hash32}U, ${hash64}ULL, &${var}),\n";
+		$count++;
+	}
+}
+
+die "Could not find kInitialNames in \"$sourceFile\"" if (!$found);
+die "No static names found in \"$sourceFile\"" if ($count == 0);
+
+my $output = <<"END";
+/* This file is generated from kInitialNames in mcstring.cpp by
+ * util/encode_static_names.pl - do not edit. */
+
+#include "prefix.h"
+
+#include "globdefs.h"
+#include "objdefs.h"
+#include "mcstring.h"
+
+#ifdef __LARGE__
+#define STATIC_NAME(cstring, hash32, hash64, name_var) { cstring, sizeof(cstring) - 1, hash64, name_var }
+#else
+#define STATIC_NAME(cstring, hash32, hash64, name_var) { cstring, sizeof(cstring) - 1, hash32, name_var }
+#endif
+
+const MCNameStaticInfo kMCStaticNames[] =
+{
+${entries}};
+
+const uindex_t kMCStaticNameCount = sizeof(kMCStaticNames) / sizeof(kMCStaticNames[0]);
+
+MCNameStaticStorage kMCStaticNameStorage[sizeof(kMCStaticNames) / sizeof(kMCStaticNames[0])];
+END
+
+open OUTPUT, ">$outputFile"
+	or die "Could not open output file \"$outputFile\": $!";
+print OUTPUT $output;
+close OUTPUT;